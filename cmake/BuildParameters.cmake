@@ -169,6 +169,7 @@ endif()
 # Select the architecture
 #-------------------------------------------------------------------------------
 option(DISABLE_ADVANCE_SIMD "Disable advance use of SIMD (SSE2+ & AVX)" OFF)
+option(MULTI_ISA "Build for SSE4.1 and pick the GS SIMD code (SSE4.1/AVX/AVX2) at runtime" OFF)
 
 # Print if we are cross compiling.
 if(CMAKE_CROSSCOMPILING)
@@ -201,6 +202,8 @@ if(${PCSX2_TARGET_ARCHITECTURES} MATCHES "i386")
             else()
                 set(ARCH_FLAG "-msse -msse2 -mfxsr -march=i686")
             endif()
+        elseif (MULTI_ISA)
+            set(ARCH_FLAG "-mfxsr -msse4.1 -march=i686")
         else()
             # AVX requires some fix of the ABI (mangling) (default 2)
             # Note: V6 requires GCC 4.7
@@ -224,6 +227,8 @@ elseif(${PCSX2_TARGET_ARCHITECTURES} MATCHES "x86_64")
             else()
                 set(ARCH_FLAG "-msse -msse2 -mfxsr")
             endif()
+        elseif (MULTI_ISA)
+            set(ARCH_FLAG "-mfxsr -msse4.1")
         else()
             #set(ARCH_FLAG "-march=native -fabi-version=6")
             set(ARCH_FLAG "-march=native")
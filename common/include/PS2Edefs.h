@@ -107,6 +107,11 @@ void CALLBACK GSsetGameCRC(int crc, int gameoptions);
 // controls frame skipping in the GS, if this routine isn't present, frame skipping won't be done
 void CALLBACK GSsetFrameSkip(int frameskip);
 
+// counters of the last frame (draws, transfers, texture cache, flushes), see plugins/GS/GSPerfMon.h
+// zeroed when the GS is closed, must not be called concurrently with GSclose
+struct GSStats;
+void CALLBACK GSgetStats(struct GSStats *stats);
+
 void CALLBACK GSreset();
 void CALLBACK GSwriteCSR(u32 value);
 s32 CALLBACK GSfreeze(int mode, freezeData *data);
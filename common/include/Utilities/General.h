@@ -205,6 +205,11 @@ void MmapResetPtr(void *base, size_t size);
 // Returns NULL on allocation failure.
 extern void *Mmap(uptr base, size_t size);
 
+// Maps a read/write data block backed by large (2MB) pages where the host allows it,
+// falling back on regular pages otherwise.  Unmap with Munmap.
+// Returns NULL on allocation failure.
+extern void *MmapLargePages(size_t size);
+
 // Unmaps a block allocated by SysMmap
 extern void Munmap(uptr base, size_t size);
 
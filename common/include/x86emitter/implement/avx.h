@@ -0,0 +1,97 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2010  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Implement the VEX encoded (AVX) forms of some SSE instructions.  They take a separate
+// destination, which saves the MOVAPS otherwise needed to keep the first source intact.
+// Only the 128-bit forms are used: they zero the upper YMM lanes, so mixing them with
+// legacy SSE code doesn't need a VZEROUPPER.
+// Warning: requires x86caps.hasAVX
+
+namespace x86Emitter
+{
+
+// --------------------------------------------------------------------------------------
+//  xImplAVX_ThreeArg
+// --------------------------------------------------------------------------------------
+// to = from1 op from2
+struct xImplAVX_ThreeArg
+{
+    u8 Prefix;
+    u8 MbPrefix;
+    u8 Opcode;
+
+    void operator()(const xRegisterSSE &to, const xRegisterSSE &from1, const xRegisterSSE &from2) const;
+    void operator()(const xRegisterSSE &to, const xRegisterSSE &from1, const xIndirectVoid &from2) const;
+};
+
+// --------------------------------------------------------------------------------------
+//  xImplAVX_ThreeArgImm
+// --------------------------------------------------------------------------------------
+// to = op(from1, from2, imm)
+struct xImplAVX_ThreeArgImm
+{
+    u8 Prefix;
+    u8 MbPrefix;
+    u8 Opcode;
+
+    void operator()(const xRegisterSSE &to, const xRegisterSSE &from1, const xRegisterSSE &from2, u8 imm) const;
+    void operator()(const xRegisterSSE &to, const xRegisterSSE &from1, const xIndirectVoid &from2, u8 imm) const;
+};
+
+// --------------------------------------------------------------------------------------
+//  xImplAVX_TwoArgImm
+// --------------------------------------------------------------------------------------
+// to = op(from, imm)
+struct xImplAVX_TwoArgImm
+{
+    u8 Prefix;
+    u8 MbPrefix;
+    u8 Opcode;
+
+    void operator()(const xRegisterSSE &to, const xRegisterSSE &from, u8 imm) const;
+    void operator()(const xRegisterSSE &to, const xIndirectVoid &from, u8 imm) const;
+};
+
+// VADD / VSUB / VMUL / VDIV / VMIN / VMAX
+struct xImplAVX_ArithFloat
+{
+    const xImplAVX_ThreeArg PS;
+    const xImplAVX_ThreeArg PD;
+    const xImplAVX_ThreeArg SS;
+    const xImplAVX_ThreeArg SD;
+};
+
+// VAND / VANDN / VOR / VXOR
+struct xImplAVX_LogicFloat
+{
+    const xImplAVX_ThreeArg PS;
+    const xImplAVX_ThreeArg PD;
+};
+
+// VBLEND / VSHUF
+struct xImplAVX_FloatImm
+{
+    const xImplAVX_ThreeArgImm PS;
+    const xImplAVX_ThreeArgImm PD;
+};
+
+// VPSHUF
+struct xImplAVX_PShuffle
+{
+    const xImplAVX_TwoArgImm D;
+};
+}
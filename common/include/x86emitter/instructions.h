@@ -124,6 +124,13 @@ extern const xImpl_Set xSETA, xSETAE,
 // BMI extra instruction requires BMI1/BMI2
 extern const xImplBMI_RVM xMULX, xPDEP, xPEXT, xANDN_S; // Warning xANDN is already used by SSE
 
+// ------------------------------------------------------------------------
+// AVX (VEX.128) three operand forms, requires AVX
+extern const xImplAVX_ArithFloat xVADD, xVSUB, xVMUL, xVDIV, xVMIN, xVMAX;
+extern const xImplAVX_LogicFloat xVAND, xVANDN, xVOR, xVXOR;
+extern const xImplAVX_FloatImm xVBLEND, xVSHUF;
+extern const xImplAVX_PShuffle xVPSHUF;
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Miscellaneous Instructions
 // These are all defined inline or in ix86.cpp.
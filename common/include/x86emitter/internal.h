@@ -39,6 +39,9 @@ extern void EmitRex(const xRegisterBase &reg1, const xRegisterBase &reg2);
 extern void EmitRex(const xRegisterBase &reg1, const void *src);
 extern void EmitRex(const xRegisterBase &reg1, const xIndirectVoid &sib);
 
+extern u8 VexNotXB(const xRegisterBase &rm);
+extern u8 VexNotXB(const xIndirectVoid &sib);
+
 extern void _xMovRtoR(const xRegisterInt &to, const xRegisterInt &from);
 
 template <typename T>
@@ -120,9 +123,9 @@ __emitinline void xOpWrite0F(u16 opcode, const T1 &param1, const T2 &param2, u8
 
 // VEX 2 Bytes Prefix
 template <typename T1, typename T2, typename T3>
-__emitinline void xOpWriteC5(u8 prefix, u8 opcode, const T1 &param1, const T2 &param2, const T3 &param3)
+__emitinline void xOpWriteC5(u8 prefix, u8 opcode, const T1 &param1, const T2 &param2, const T3 &param3, int extraRIPOffset = 0)
 {
-    const xRegisterInt &reg = param1.IsReg() ? param1 : param2;
+    const xRegisterBase &reg = param1.IsReg() ? param1 : param2;
 
 #ifdef __M_X86_64
     u8 nR = reg.IsExtended() ? 0x00 : 0x80;
@@ -141,23 +144,21 @@ __emitinline void xOpWriteC5(u8 prefix, u8 opcode, const T1 &param1, const T2 &p
     xWrite8(0xC5);
     xWrite8(nR | nv | L | p);
     xWrite8(opcode);
-    EmitSibMagic(param1, param3);
+    EmitSibMagic(param1, param3, extraRIPOffset);
 }
 
 // VEX 3 Bytes Prefix
 template <typename T1, typename T2, typename T3>
-__emitinline void xOpWriteC4(u8 prefix, u8 mb_prefix, u8 opcode, const T1 &param1, const T2 &param2, const T3 &param3, int w = -1)
+__emitinline void xOpWriteC4(u8 prefix, u8 mb_prefix, u8 opcode, const T1 &param1, const T2 &param2, const T3 &param3, int w = -1, int extraRIPOffset = 0)
 {
-    const xRegisterInt &reg = param1.IsReg() ? param1 : param2;
+    const xRegisterBase &reg = param1.IsReg() ? param1 : param2;
 
 #ifdef __M_X86_64
     u8 nR = reg.IsExtended() ? 0x00 : 0x80;
-    u8 nB = param3.IsExtended() ? 0x00 : 0x20;
-    u8 nX = 0x40; // likely unused so hardwired to disabled
+    u8 nXB = VexNotXB(param3);
 #else
     u8 nR = 0x80;
-    u8 nB = 0x20;
-    u8 nX = 0x40;
+    u8 nXB = 0x60;
 #endif
     u8 L = reg.IsWideSIMD() ? 4 : 0;
     u8 W = (w == -1) ? (reg.GetOperandSize() == 8 ? 0x80 : 0) : // autodetect the size
@@ -175,9 +176,26 @@ __emitinline void xOpWriteC4(u8 prefix, u8 mb_prefix, u8 opcode, const T1 &param
                             mb_prefix == 0x38 ? 2 : 1;
 
     xWrite8(0xC4);
-    xWrite8(nR | nX | nB | m);
+    xWrite8(nR | nXB | m);
     xWrite8(W | nv | L | p);
     xWrite8(opcode);
-    EmitSibMagic(param1, param3);
+    EmitSibMagic(param1, param3, extraRIPOffset);
+}
+
+// VEX op with the shorter prefix when it can be used: the 2 bytes form has no VEX.X/B/W
+// and only covers the 0F opcode map.
+template <typename T1, typename T2, typename T3>
+__emitinline void xOpWriteVEX(u8 prefix, u8 mb_prefix, u8 opcode, const T1 &param1, const T2 &param2, const T3 &param3, int extraRIPOffset = 0)
+{
+#ifdef __M_X86_64
+    bool c5 = mb_prefix == 0 && VexNotXB(param3) == 0x60;
+#else
+    bool c5 = mb_prefix == 0;
+#endif
+
+    if (c5)
+        xOpWriteC5(prefix, opcode, param1, param2, param3, extraRIPOffset);
+    else
+        xOpWriteC4(prefix, mb_prefix, opcode, param1, param2, param3, 0, extraRIPOffset);
 }
 }
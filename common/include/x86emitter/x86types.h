@@ -1145,3 +1145,4 @@ static __fi xAddressVoid operator+(sptr addr, const xAddressReg &reg)
 #include "implement/jmpcall.h"
 
 #include "implement/bmi.h"
+#include "implement/avx.h"
@@ -159,6 +159,38 @@ void *HostSys::Mmap(uptr base, size_t size)
     return mmap((void *)base, size, PROT_EXEC | PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
 }
 
+void *HostSys::MmapLargePages(size_t size)
+{
+    static const size_t LargePageSize = 2 * 1024 * 1024;
+
+#ifdef MAP_HUGETLB
+    // Explicit huge pages need a reserved pool (vm.nr_hugepages), so this commonly fails.
+    if ((size & (LargePageSize - 1)) == 0)
+    {
+        void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (ptr != MAP_FAILED)
+            return ptr;
+    }
+#endif
+
+    // Over-allocate so the block can be trimmed to a large page boundary, which is
+    // what transparent huge pages need to kick in.
+    u8 *base = (u8 *)mmap(NULL, size + LargePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if ((void *)base == MAP_FAILED)
+        return NULL;
+
+    u8 *ptr = (u8 *)(((uptr)base + LargePageSize - 1) & ~(uptr)(LargePageSize - 1));
+    if (ptr != base)
+        munmap(base, ptr - base);
+    munmap(ptr + size, (base + LargePageSize) - ptr);
+
+#ifdef MADV_HUGEPAGE
+    madvise(ptr, size, MADV_HUGEPAGE);
+#endif
+
+    return ptr;
+}
+
 void HostSys::Munmap(uptr base, size_t size)
 {
     if (base)
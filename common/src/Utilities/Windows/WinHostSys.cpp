@@ -121,6 +121,20 @@ void *HostSys::Mmap(uptr base, size_t size)
     return VirtualAlloc((void *)base, size, MEM_RESERVE | MEM_COMMIT, PAGE_EXECUTE_READWRITE);
 }
 
+void *HostSys::MmapLargePages(size_t size)
+{
+    // Large pages need the SeLockMemoryPrivilege, so this commonly fails.
+    const SIZE_T LargePageSize = GetLargePageMinimum();
+    if (LargePageSize && (size % LargePageSize) == 0)
+    {
+        void *ptr = VirtualAlloc(NULL, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+        if (ptr)
+            return ptr;
+    }
+
+    return VirtualAlloc(NULL, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+}
+
 void HostSys::Munmap(uptr base, size_t size)
 {
     if (!base)
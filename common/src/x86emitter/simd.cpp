@@ -787,4 +787,57 @@ __emitinline void xFXRSTOR(const xIndirectVoid &src)
 {
     xOpWrite0F(0, 0xae, 1, src);
 }
+
+// =====================================================================================================
+//  AVX (VEX.128) Three Operand Instructions
+// =====================================================================================================
+
+void xImplAVX_ThreeArg::operator()(const xRegisterSSE &to, const xRegisterSSE &from1, const xRegisterSSE &from2) const { xOpWriteVEX(Prefix, MbPrefix, Opcode, to, from1, from2); }
+void xImplAVX_ThreeArg::operator()(const xRegisterSSE &to, const xRegisterSSE &from1, const xIndirectVoid &from2) const { xOpWriteVEX(Prefix, MbPrefix, Opcode, to, from1, from2); }
+
+void xImplAVX_ThreeArgImm::operator()(const xRegisterSSE &to, const xRegisterSSE &from1, const xRegisterSSE &from2, u8 imm) const
+{
+    xOpWriteVEX(Prefix, MbPrefix, Opcode, to, from1, from2, 1);
+    xWrite8(imm);
+}
+void xImplAVX_ThreeArgImm::operator()(const xRegisterSSE &to, const xRegisterSSE &from1, const xIndirectVoid &from2, u8 imm) const
+{
+    xOpWriteVEX(Prefix, MbPrefix, Opcode, to, from1, from2, 1);
+    xWrite8(imm);
+}
+
+// No second source: VEX.vvvv must be 1111b, which is what xmm0 encodes to
+void xImplAVX_TwoArgImm::operator()(const xRegisterSSE &to, const xRegisterSSE &from, u8 imm) const
+{
+    xOpWriteVEX(Prefix, MbPrefix, Opcode, to, xmm0, from, 1);
+    xWrite8(imm);
+}
+void xImplAVX_TwoArgImm::operator()(const xRegisterSSE &to, const xIndirectVoid &from, u8 imm) const
+{
+    xOpWriteVEX(Prefix, MbPrefix, Opcode, to, xmm0, from, 1);
+    xWrite8(imm);
+}
+
+#define AVX_ARITH(op) {{0x00, 0, op}, {0x66, 0, op}, {0xf3, 0, op}, {0xf2, 0, op}}
+#define AVX_LOGIC(op) {{0x00, 0, op}, {0x66, 0, op}}
+
+const xImplAVX_ArithFloat xVADD = AVX_ARITH(0x58);
+const xImplAVX_ArithFloat xVMUL = AVX_ARITH(0x59);
+const xImplAVX_ArithFloat xVSUB = AVX_ARITH(0x5c);
+const xImplAVX_ArithFloat xVMIN = AVX_ARITH(0x5d);
+const xImplAVX_ArithFloat xVDIV = AVX_ARITH(0x5e);
+const xImplAVX_ArithFloat xVMAX = AVX_ARITH(0x5f);
+
+const xImplAVX_LogicFloat xVAND  = AVX_LOGIC(0x54);
+const xImplAVX_LogicFloat xVANDN = AVX_LOGIC(0x55);
+const xImplAVX_LogicFloat xVOR   = AVX_LOGIC(0x56);
+const xImplAVX_LogicFloat xVXOR  = AVX_LOGIC(0x57);
+
+const xImplAVX_FloatImm xVBLEND = {{0x66, 0x3a, 0x0c}, {0x66, 0x3a, 0x0d}};
+const xImplAVX_FloatImm xVSHUF  = {{0x00, 0, 0xc6}, {0x66, 0, 0xc6}};
+
+const xImplAVX_PShuffle xVPSHUF = {{0x66, 0, 0x70}};
+
+#undef AVX_ARITH
+#undef AVX_LOGIC
 }
@@ -441,6 +441,24 @@ void EmitRexImplicitlyWide(const xIndirectVoid &sib)
     EmitRex(w, r, x, b);
 }
 
+// Inverted VEX.X and VEX.B bits of the r/m operand, as placed in the second byte of the
+// 3 bytes prefix (see xOpWriteC4).  0x60 means the operand needs neither.
+u8 VexNotXB(const xRegisterBase &rm)
+{
+    return rm.IsExtended() ? 0x40 : 0x60;
+}
+
+u8 VexNotXB(const xIndirectVoid &sib)
+{
+    bool x = sib.Index.IsExtended();
+    bool b = sib.Base.IsExtended();
+    if (!NeedsSibMagic(sib)) {
+        b = x;
+        x = false;
+    }
+    return (x ? 0 : 0x40) | (b ? 0 : 0x20);
+}
+
 
 // --------------------------------------------------------------------------------------
 //  xSetPtr / xAlignPtr / xGetPtr / xAdvancePtr
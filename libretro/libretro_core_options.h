@@ -245,6 +245,16 @@ struct retro_core_option_definition option_defs[] = {
 	},
 	"enabled" },
 
+	{BOOL_PCSX2_OPT_TEXTURE_HASH,
+	"Video: Texture Content Hashing",
+	"Hash the GS memory behind each cached texture block, so a block the game rewrites with the same data is not converted and uploaded again. Helps games that stream fonts or re-upload unchanged textures every frame, costs some CPU time on other games.",
+	{
+		{"disabled", NULL},
+		{"enabled", NULL},
+		{NULL, NULL},
+	},
+	"disabled" },
+
 
 	{BOOL_PCSX2_OPT_FRAMESKIP,
 	"Video: Frame Skip",
@@ -481,6 +491,38 @@ struct retro_core_option_definition option_defs[] = {
 	},
 	"2" },
 
+	{INT_PCSX2_OPT_MTGS_RING_SIZE,
+	"Emulation: MTGS Ring Buffer Size",
+	"Size of the buffer queuing GS commands between the EE and GS threads. Larger values let games with heavy GS traffic stall the EE less often. (Content restart required)",
+	{
+		{"17", "2 MB"},
+		{"18", "4 MB"},
+		{"19", "8 MB (default)"},
+		{"20", "16 MB"},
+		{NULL, NULL},
+	},
+	"19" },
+
+	{BOOL_PCSX2_OPT_BATCH_DMA_CHAINS,
+	"Emulation: Batch DMA Chains",
+	"Process whole GIF and scratchpad DMA chains in one pass instead of one tag per interrupt. Reduces EE overhead in games building long display lists, but may affect timing-sensitive games. (Content restart required)",
+	{
+		{"disabled", NULL},
+		{"enabled", NULL},
+		{NULL, NULL},
+	},
+	"disabled"},
+
+	{BOOL_PCSX2_OPT_VU0_THREAD,
+	"Emulation: VU0 Thread",
+	"Run VU0 microprograms on a separate thread. Helps games that lean heavily on VU0 micro mode, but can slow down or break games that often synchronise with it. Also enabled per game by the game database. (Content restart required)",
+	{
+		{"disabled", NULL},
+		{"enabled", NULL},
+		{NULL, NULL},
+	},
+	"disabled"},
+
 	{INT_PCSX2_OPT_EE_CLAMPING_MODE,
 	"Emulation: EE/FPU Clamping Mode",
 	"EE/FPU clamping mode can fix some bugs on some games. Default value is fine for most games. (Content restart required)",
@@ -749,6 +791,16 @@ struct retro_core_option_definition option_defs[] = {
 	},
 	"0" },
 
+	{BOOL_PCSX2_OPT_GS_CAPTURE,
+	"Debug: GS Capture",
+	"Record the GS state and every packet sent to it to an .gs.xz file in the save directory, starting at the next frame, until disabled again. The capture can be played back with the GS replay loader. Captures grow quickly, keep them short.",
+	{
+		{"disabled", NULL},
+		{"enabled", NULL},
+		{NULL, NULL},
+	},
+	"disabled" },
+
 	{NULL, NULL, NULL, {{0}}, NULL},
 };
 
@@ -59,6 +59,7 @@ int option_pad_left_deadzone = 0;
 int option_pad_right_deadzone = 0;
 bool hack_fb_conversion = false;
 bool hack_AutoFlush = false;
+bool option_gs_capture = false;
 
 std::string sel_bios_path = "";
 retro_environment_t environ_cb;
@@ -312,6 +313,7 @@ void retro_init(void)
 	option_upscale_mult = option_value(INT_PCSX2_OPT_UPSCALE_MULTIPLIER, KeyOptionInt::return_type);
 	hack_fb_conversion = option_value(BOOL_PCSX2_OPT_USERHACK_FB_CONVERSION, KeyOptionBool::return_type);
 	hack_AutoFlush = option_value(BOOL_PCSX2_OPT_USERHACK_AUTO_FLUSH, KeyOptionBool::return_type);
+	option_gs_capture = option_value(BOOL_PCSX2_OPT_GS_CAPTURE, KeyOptionBool::return_type);
 
 	wxFileName f_bios;
 	f_bios.Assign(option_value(STRING_PCSX2_OPT_BIOS, KeyOptionString::return_type));
@@ -371,6 +373,8 @@ void retro_init(void)
 		g_Conf->EnablePresets = true;
 		g_Conf->EmuOptions.EnableIPC = false;
 		g_Conf->EmuOptions.Speedhacks.fastCDVD  = option_value(BOOL_PCSX2_OPT_FASTCDVD, KeyOptionBool::return_type);
+		g_Conf->EmuOptions.Speedhacks.dmaChainBatch = option_value(BOOL_PCSX2_OPT_BATCH_DMA_CHAINS, KeyOptionBool::return_type);
+		g_Conf->EmuOptions.Speedhacks.vu0Thread = option_value(BOOL_PCSX2_OPT_VU0_THREAD, KeyOptionBool::return_type);
 
 		g_Conf->EmuOptions.EnableNointerlacingPatches = (option_value(INT_PCSX2_OPT_DEINTERLACING_MODE, KeyOptionInt::return_type) == -1);
 		g_Conf->EmuOptions.Enable60fpsPatches = (option_value(BOOL_PCSX2_OPT_ENABLE_60FPS_PATCHES, KeyOptionBool::return_type));
@@ -379,6 +383,7 @@ void retro_init(void)
 		g_Conf->EmuOptions.GS.FramesToDraw = option_value(INT_PCSX2_OPT_FRAMES_TO_DRAW, KeyOptionInt::return_type);
 		g_Conf->EmuOptions.GS.FramesToSkip = option_value(INT_PCSX2_OPT_FRAMES_TO_SKIP, KeyOptionInt::return_type);
 		g_Conf->EmuOptions.GS.VsyncQueueSize = option_value(INT_PCSX2_OPT_VSYNC_MTGS_QUEUE, KeyOptionInt::return_type);
+		g_Conf->EmuOptions.GS.RingBufferSizeFactor = option_value(INT_PCSX2_OPT_MTGS_RING_SIZE, KeyOptionInt::return_type);
 		g_Conf->EmuOptions.EnableCheats = option_value(BOOL_PCSX2_OPT_ENABLE_CHEATS, KeyOptionBool::return_type);
 
 
@@ -871,6 +876,7 @@ void retro_run(void)
 		);
 		option_pad_left_deadzone = option_value(INT_PCSX2_OPT_GAMEPAD_L_DEADZONE, KeyOptionInt::return_type);
 		option_pad_right_deadzone = option_value(INT_PCSX2_OPT_GAMEPAD_R_DEADZONE, KeyOptionInt::return_type);
+		option_gs_capture = option_value(BOOL_PCSX2_OPT_GS_CAPTURE, KeyOptionBool::return_type);
 
 	}
 
@@ -16,6 +16,10 @@
 #define BOOL_PCSX2_OPT_USERHACK_AUTO_FLUSH	 "pcsx2_userhack_auto_flush"
 #define BOOL_PCSX2_OPT_CONSERVATIVE_BUFFER	 "pcsx2_conservative_buffer"
 #define BOOL_PCSX2_OPT_ACCURATE_DATE		 "pcsx2_accurate_date"
+#define BOOL_PCSX2_OPT_TEXTURE_HASH		 "pcsx2_texture_hash"
+#define BOOL_PCSX2_OPT_BATCH_DMA_CHAINS		 "pcsx2_batch_dma_chains"
+#define BOOL_PCSX2_OPT_VU0_THREAD		 "pcsx2_vu0_thread"
+#define BOOL_PCSX2_OPT_GS_CAPTURE		 "pcsx2_gs_capture"
 
 #define STRING_PCSX2_OPT_BIOS			 "pcsx2_bios"
 #define STRING_PCSX2_OPT_RENDERER                "pcsx2_renderer"
@@ -40,6 +44,7 @@
 #define INT_PCSX2_OPT_FXAA			 "pcsx2_fxaa"
 #define INT_PCSX2_OPT_TEXTURE_FILTERING		 "pcsx2_texture_filtering"
 #define INT_PCSX2_OPT_VSYNC_MTGS_QUEUE		 "pcsx2_vsync_mtgs_queue"
+#define INT_PCSX2_OPT_MTGS_RING_SIZE		 "pcsx2_mtgs_ring_size"
 #define INT_PCSX2_OPT_MIPMAPPING		 "pcsx2_mipmapping"
 #define INT_PCSX2_OPT_EE_CLAMPING_MODE		 "pcsx2_clamping_mode"
 #define INT_PCSX2_OPT_EE_ROUND_MODE		 "pcsx2_round_mode"
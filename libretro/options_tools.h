@@ -12,6 +12,7 @@ extern int option_pad_left_deadzone;
 extern int option_pad_right_deadzone;
 extern bool hack_fb_conversion;
 extern bool hack_AutoFlush;
+extern bool option_gs_capture;
 /*
 * These are quick fixes to provide system paths at pcsx2 app startup.
 * Because of the huge refactoring, paths are not saved/loaded from inis files anymore,
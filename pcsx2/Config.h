@@ -49,6 +49,7 @@ enum SpeedhackId
 
 	Speedhack_mvuFlag = SpeedhackId_FIRST,
 	Speedhack_InstantVU1,
+	Speedhack_VU0Thread,
 
 	SpeedhackId_COUNT
 };
@@ -153,6 +154,7 @@ struct Pcsx2Config
 	struct GSOptions
 	{
 		int		VsyncQueueSize;
+		int		RingBufferSizeFactor;	// MTGS ring size as a power of 2, in qwords (applied at MTGS start)
 
 		bool		FrameSkipEnable;
 		int		FramesToDraw;	// number of consecutive frames (fields) to render
@@ -167,6 +169,7 @@ struct Pcsx2Config
 		{
 			return
 				OpEqu( VsyncQueueSize )			&&
+				OpEqu( RingBufferSizeFactor )	&&
 				
 				OpEqu( FrameSkipEnable )		&&
 
@@ -240,7 +243,9 @@ struct Pcsx2Config
 				WaitLoop		:1,		// enables constant loop detection and fast-forwarding
 				vuFlagHack		:1,		// microVU specific flag hack
 				vuThread : 1,		// Enable Threaded VU1
-				vu1Instant : 1;		// Enable Instant VU1 (Without MTVU only)
+				vu1Instant : 1,		// Enable Instant VU1 (Without MTVU only)
+				dmaChainBatch : 1,	// Walk whole source DMA chains per interrupt instead of one tag at a time
+				vu0Thread : 1;		// Run VU0 micro-mode programs on their own thread
 		BITFIELD_END
 
 		s8	EECycleRate;		// EE cycle rate selector (1.0, 1.5, 2.0)
@@ -321,6 +326,8 @@ extern Pcsx2Config EmuConfig;
 
 #define THREAD_VU1					(EmuConfig.Cpu.Recompiler.EnableVU1 && EmuConfig.Speedhacks.vuThread)
 #define INSTANT_VU1					(EmuConfig.Speedhacks.vu1Instant)
+#define BATCH_DMA_CHAINS			(EmuConfig.Speedhacks.dmaChainBatch)
+#define THREAD_VU0					(EmuConfig.Cpu.Recompiler.EnableVU0 && EmuConfig.Speedhacks.vu0Thread)
 #define CHECK_EEREC					(EmuConfig.Cpu.Recompiler.EnableEE)
 #define CHECK_IOPREC				(EmuConfig.Cpu.Recompiler.EnableIOP)
 
@@ -537,6 +537,10 @@ static DMACh& sif0ch	= (DMACh&)eeHw[0xc000];
 static DMACh& sif1ch	= (DMACh&)eeHw[0xc400];
 static DMACh& sif2dma	= (DMACh&)eeHw[0xc800];
 
+// Upper bound on the cycles a batched chain walk (see BATCH_DMA_CHAINS) may accumulate
+// before handing control back to the EE, so self-referencing chains can't stall it.
+static const u32 DmaBatchCycleLimit = 0x8000;
+
 extern void throwBusError(const char *s);
 extern void setDmacStat(u32 num);
 extern tDMA_TAG *SPRdmaGetAddr(u32 addr, bool write);
@@ -465,28 +465,35 @@ extern int g_nLeftGSFrames;
 #endif
 
 // Size of the ringbuffer as a power of 2 -- size is a multiple of simd128s.
-// (actual size is 1<<m_RingBufferSizeFactor simd vectors [128-bit values])
+// (actual size is 1<<RingBufferSizeFactor simd vectors [128-bit values])
 // A value of 19 is a 8meg ring buffer.  18 would be 4 megs, and 20 would be 16 megs.
 // Default was 2mb, but some games with lots of MTGS activity want 8mb to run fast (rama)
-static const uint RingBufferSizeFactor = 19;
+// The factor is picked at startup from EmuConfig.GS.RingBufferSizeFactor, within the
+// Min/Max range below (the Max also bounds the GIF unit's packet queue).
+static const uint RingBufferSizeFactorMin = 17;
+static const uint RingBufferSizeFactorMax = 20;
+static const uint RingBufferSizeFactorDefault = 19;
 
-// size of the ringbuffer in simd128's.
-static const uint RingBufferSize = 1<<RingBufferSizeFactor;
-
-// Mask to apply to ring buffer indices to wrap the pointer from end to
-// start (the wrapping is what makes it a ringbuffer, yo!)
-static const uint RingBufferMask = RingBufferSize - 1;
+// largest size of the ringbuffer in simd128's.
+static const uint RingBufferSizeMax = 1<<RingBufferSizeFactorMax;
 
 struct MTGS_BufferedData
 {
-	u128		m_Ring[RingBufferSize];
+	u128*		m_Ring;
+	uint		m_Size;		// size of the ringbuffer in simd128's.
+	uint		m_Mask;		// applied to ring indices to wrap the pointer from end to start
 	u8			Regs[Ps2MemSize::GSregs];
 
-	MTGS_BufferedData() {}
+	MTGS_BufferedData() : m_Ring(NULL), m_Size(0), m_Mask(0) {}
+
+	// (Re)allocates the ring, on large pages where the host allows it.  Only safe while
+	// the ring is empty and both read and write positions get reset.
+	void Alloc( uint sizeFactor );
+	void Free();
 
 	u128& operator[]( uint idx )
 	{
-		pxAssert( idx < RingBufferSize );
+		pxAssert( idx < m_Size );
 		return m_Ring[idx];
 	}
 };
@@ -369,11 +369,24 @@ static __fi tDMA_TAG* ReadTag2()
 	return ptag;
 }
 
+// Whether GIFdma can read the next tag straight away instead of waiting for the
+// interrupt, i.e. the previous packet went over completely and PATH3 is still free.
+static __fi bool GIFchainBatchable(u32 cycles)
+{
+	return BATCH_DMA_CHAINS && cycles < DmaBatchCycleLimit
+		&& gifch.chcr.MOD == CHAIN_MODE && gifch.qwc == 0 && !gif.gspath3done
+		&& !gifRegs.stat.IMT && !gifRegs.ctrl.PSE && !vif1Regs.stat.VGW
+		&& dmacRegs.ctrl.STD != STD_GIF && !CHECK_GIFFIFOHACK && gif_fifo.fifoSize == 0
+		&& gifUnit.CanDoPath3();
+}
+
 void GIFdma()
 {
+	u32 batchcycles = 0;
+
 	while (gifch.qwc > 0 || !gif.gspath3done) {
 		tDMA_TAG* ptag;
-		gif.gscycles = gif.prevcycles;
+		gif.gscycles = gif.prevcycles + batchcycles;
 
 		if (gifRegs.ctrl.PSE) { // temporarily stop
 			//log_cb(RETRO_LOG_INFO, "Gif dma temp paused? (non MFIFO GIF)\n");
@@ -433,7 +446,12 @@ void GIFdma()
 		if (gifch.qwc > 0) // Normal Mode
 		{
 			GIFchain(); // Transfers the data set by the switch
-			return;
+
+			if (!GIFchainBatchable(gif.gscycles))
+				return;
+
+			// Carry the cost over; the interrupt is pushed out to the end of the batch.
+			batchcycles = gif.gscycles;
 		}
 	}
 
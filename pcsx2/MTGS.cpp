@@ -39,6 +39,32 @@ using namespace Threading;
 __aligned(32) MTGS_BufferedData RingBuffer;
 extern bool renderswitch;
 
+void MTGS_BufferedData::Alloc( uint sizeFactor )
+{
+	sizeFactor = std::min(std::max(sizeFactor, RingBufferSizeFactorMin), RingBufferSizeFactorMax);
+	if (m_Ring && m_Size == (1u << sizeFactor)) return;
+
+	Free();
+
+	// The ring is streamed through front to back, so large pages save a lot of TLB misses.
+	m_Ring = (u128*)HostSys::MmapLargePages(sizeof(u128) << sizeFactor);
+	if (!m_Ring)
+		throw Exception::OutOfMemory(L"MTGS ring buffer");
+
+	m_Size = 1u << sizeFactor;
+	m_Mask = m_Size - 1;
+}
+
+void MTGS_BufferedData::Free()
+{
+	if (!m_Ring) return;
+
+	HostSys::Munmap(m_Ring, sizeof(u128) * m_Size);
+	m_Ring = NULL;
+	m_Size = 0;
+	m_Mask = 0;
+}
+
 
 #ifdef RINGBUF_DEBUG_STACK
 #include <list>
@@ -64,6 +90,8 @@ void SysMtgsThread::OnStart()
 {
 	m_Opened		= false;
 
+	RingBuffer.Alloc(EmuConfig.GS.RingBufferSizeFactor);
+
 	m_ReadPos			= 0;
 	m_WritePos			= 0;
 	m_RingBufferIsBusy  = false;
@@ -86,6 +114,8 @@ SysMtgsThread::~SysMtgsThread()
 		_parent::Cancel();
 	}
 	DESTRUCTOR_CATCHALL
+
+	RingBuffer.Free();
 }
 
 void SysMtgsThread::OnResumeReady()
@@ -102,6 +132,10 @@ void SysMtgsThread::ResetGS()
 	//  * Signal a reset.
 	//  * clear the path and byRegs structs (used by GIFtagDummy)
 
+	// The ring normally exists from OnStart() on; a reset ahead of it only needs some ring.
+	if (!RingBuffer.m_Ring)
+		RingBuffer.Alloc(EmuConfig.GS.RingBufferSizeFactor);
+
 	m_ReadPos             = m_WritePos.load();
 	m_QueuedFrameCount    = 0;
 	m_VsyncSignalListener = 0;
@@ -129,13 +163,13 @@ void SysMtgsThread::PostVsyncStart()
 
 	uint packsize = sizeof(RingCmdPacket_Vsync) / 16;
 	PrepDataPacket(GS_RINGTYPE_VSYNC, packsize);
-	MemCopy_WrappedDest( (u128*)PS2MEM_GS, RingBuffer.m_Ring, m_packet_writepos, RingBufferSize, 0xf );
+	MemCopy_WrappedDest( (u128*)PS2MEM_GS, RingBuffer.m_Ring, m_packet_writepos, RingBuffer.m_Size, 0xf );
 
 	u32* remainder = (u32*)GetDataPacketPtr();
 	remainder[0] = GSCSRr;
 	remainder[1] = GSIMR._u32;
 	(GSRegSIGBLID&)remainder[2] = GSSIGLBLID;
-	m_packet_writepos = (m_packet_writepos + 1) & RingBufferMask;
+	m_packet_writepos = (m_packet_writepos + 1) & RingBuffer.m_Mask;
 
 	SendDataPacket();
 
@@ -286,7 +320,7 @@ void SysMtgsThread::ExecuteTaskInThread()
 
 			const unsigned int local_ReadPos = m_ReadPos.load(std::memory_order_relaxed);
 
-			pxAssert( local_ReadPos < RingBufferSize );
+			pxAssert( local_ReadPos < RingBuffer.m_Size );
 
 			const PacketTagType& tag = (PacketTagType&)RingBuffer[local_ReadPos];
 			u32 ringposinc = 1;
@@ -353,8 +387,8 @@ void SysMtgsThread::ExecuteTaskInThread()
 							// This seemingly obtuse system is needed in order to handle cases where the vsync data wraps
 							// around the edge of the ringbuffer.  If not for that I'd just use a struct. >_<
 
-							uint datapos = (local_ReadPos+1) & RingBufferMask;
-							MemCopy_WrappedSrc( RingBuffer.m_Ring, datapos, RingBufferSize, (u128*)RingBuffer.Regs, 0xf );
+							uint datapos = (local_ReadPos+1) & RingBuffer.m_Mask;
+							MemCopy_WrappedSrc( RingBuffer.m_Ring, datapos, RingBuffer.m_Size, (u128*)RingBuffer.Regs, 0xf );
 
 							u32* remainder = (u32*)&RingBuffer[datapos];
 							((u32&)RingBuffer.Regs[0x1000])				= remainder[0];
@@ -434,7 +468,7 @@ void SysMtgsThread::ExecuteTaskInThread()
 				}
 			}
 
-			uint newringpos = (m_ReadPos.load(std::memory_order_relaxed) + ringposinc) & RingBufferMask;
+			uint newringpos = (m_ReadPos.load(std::memory_order_relaxed) + ringposinc) & RingBuffer.m_Mask;
 
 			m_ReadPos.store(newringpos, std::memory_order_release);
 
@@ -587,7 +621,7 @@ void SysMtgsThread::SetEvent()
 
 u8* SysMtgsThread::GetDataPacketPtr() const
 {
-	return (u8*)&RingBuffer[m_packet_writepos & RingBufferMask];
+	return (u8*)&RingBuffer[m_packet_writepos & RingBuffer.m_Mask];
 }
 
 // Closes the data packet send command, and initiates the gs thread (if needed).
@@ -596,9 +630,9 @@ void SysMtgsThread::SendDataPacket()
 	// make sure a previous copy block has been started somewhere.
 	pxAssert( m_packet_size != 0 );
 
-	uint actualSize = ((m_packet_writepos - m_packet_startpos) & RingBufferMask)-1;
+	uint actualSize = ((m_packet_writepos - m_packet_startpos) & RingBuffer.m_Mask)-1;
 	pxAssert( actualSize <= m_packet_size );
-	pxAssert( m_packet_writepos < RingBufferSize );
+	pxAssert( m_packet_writepos < RingBuffer.m_Size );
 
 	PacketTagType& tag = (PacketTagType&)RingBuffer[m_packet_startpos];
 	tag.data[0] = actualSize;
@@ -624,8 +658,8 @@ void SysMtgsThread::GenericStall( uint size )
 	const uint writepos = m_WritePos.load(std::memory_order_relaxed);
 
 	// Sanity checks! (within the confines of our ringbuffer please!)
-	pxAssert( size < RingBufferSize );
-	pxAssert( writepos < RingBufferSize );
+	pxAssert( size < RingBuffer.m_Size );
+	pxAssert( writepos < RingBuffer.m_Size );
 
 	// generic gs wait/stall.
 	// if the writepos is past the readpos then we're safe.
@@ -638,7 +672,7 @@ void SysMtgsThread::GenericStall( uint size )
 	if (writepos < readpos)
 		freeroom = readpos - writepos;
 	else
-		freeroom = RingBufferSize - (writepos - readpos);
+		freeroom = RingBuffer.m_Size - (writepos - readpos);
 
 	if (freeroom <= size)
 	{
@@ -650,7 +684,7 @@ void SysMtgsThread::GenericStall( uint size )
 		// the next packet will likely stall up too.  So lets set a condition for the MTGS
 		// thread to wake up the EE once there's a sizable chunk of the ringbuffer emptied.
 
-		uint somedone	= (RingBufferSize - freeroom) / 4;
+		uint somedone	= (RingBuffer.m_Size - freeroom) / 4;
 		if( somedone < size+1 ) somedone = size + 1;
 
 		// FMV Optimization: FMVs typically send *very* little data to the GS, in some cases
@@ -674,7 +708,7 @@ void SysMtgsThread::GenericStall( uint size )
 				if (writepos < readpos)
 					freeroom = readpos - writepos;
 				else
-					freeroom = RingBufferSize - (writepos - readpos);
+					freeroom = RingBuffer.m_Size - (writepos - readpos);
 
 				if (freeroom > size) break;
 			}
@@ -692,7 +726,7 @@ void SysMtgsThread::GenericStall( uint size )
 				if (writepos < readpos)
 					freeroom = readpos - writepos;
 				else
-					freeroom = RingBufferSize - (writepos - readpos);
+					freeroom = RingBuffer.m_Size - (writepos - readpos);
 
 				if (freeroom > size) break;
 			}
@@ -714,7 +748,7 @@ void SysMtgsThread::PrepDataPacket( MTGS_RingCommand cmd, u32 size )
 	tag.command = cmd;
 	tag.data[0] = m_packet_size;
 	m_packet_startpos = local_WritePos;
-	m_packet_writepos = (local_WritePos + 1) & RingBufferMask;
+	m_packet_writepos = (local_WritePos + 1) & RingBuffer.m_Mask;
 }
 
 // Returns the amount of giftag data processed (in simd128 values).
@@ -731,7 +765,7 @@ void SysMtgsThread::PrepDataPacket( GIF_PATH pathidx, u32 size )
 
 __fi void SysMtgsThread::_FinishSimplePacket()
 {
-	uint future_writepos = (m_WritePos.load(std::memory_order_relaxed) +1) & RingBufferMask;
+	uint future_writepos = (m_WritePos.load(std::memory_order_relaxed) +1) & RingBuffer.m_Mask;
 	pxAssert( future_writepos != m_ReadPos.load(std::memory_order_acquire) );
 	m_WritePos.store(future_writepos, std::memory_order_release);
 
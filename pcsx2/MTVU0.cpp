@@ -0,0 +1,128 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2010  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "Common.h"
+#include "MTVU0.h"
+
+__aligned16 VU0_Thread vu0Thread;
+
+void vu0Sync()
+{
+	if (THREAD_VU0)
+		vu0Thread.Sync(false);
+}
+
+VU0_Thread::VU0_Thread()
+{
+	m_name = L"MTVU0";
+#ifndef __LIBRETRO__
+	Reset();
+#endif
+}
+
+VU0_Thread::~VU0_Thread()
+{
+	try
+	{
+		pxThread::Cancel();
+	}
+	DESTRUCTOR_CATCHALL
+}
+
+void VU0_Thread::Reset()
+{
+	ScopedLock lock(mtxBusy);
+
+	isBusy = false;
+	isPending = false;
+	hasStat = false;
+	vpuStat = 0;
+}
+
+void VU0_Thread::ExecuteTaskInThread()
+{
+	PCSX2_PAGEFAULT_PROTECT
+	{
+		for (;;)
+		{
+			semaEvent.WaitWithoutYield();
+			ScopedLockBool lock(mtxBusy, isBusy);
+
+			// Run until E-bit termination.  M-bit breaks aren't honoured here; the EE
+			// side of an M-bit interlock simply waits for the whole program instead.
+			do {
+				CpuVU0->Execute(0x7fffffff);
+			} while (vpuStat & 1);
+
+			isPending.store(false, std::memory_order_release);
+		}
+	}
+	PCSX2_PAGEFAULT_EXCEPT;
+}
+
+void VU0_Thread::ExecuteMicro()
+{
+	pxAssert(IsDone());
+	vpuStat = VU0.VI[REG_VPU_STAT].UL & 0xff;
+	hasStat = true;
+	isPending.store(true, std::memory_order_release);
+	semaEvent.Post();
+}
+
+void VU0_Thread::WaitVU()
+{
+	while (!IsDone())
+	{
+		std::this_thread::yield(); // Give a chance to the VU0 thread to actually start
+		ScopedLock lock(mtxBusy);
+	}
+}
+
+void VU0_Thread::Complete(bool addCycles)
+{
+	if (hasStat)
+	{
+		hasStat = false;
+		VU0.VI[REG_VPU_STAT].UL = (VU0.VI[REG_VPU_STAT].UL & ~0xff) | vpuStat;
+	}
+
+	if (VU0.flags & VUFLAG_INTCINTERRUPT)
+	{
+		VU0.flags &= ~VUFLAG_INTCINTERRUPT;
+		hwIntcIrq(INTC_VU0);
+	}
+
+	// The EE kept running while VU0 did, so only stall it for the part of the
+	// program it hasn't already overlapped.
+	if (addCycles)
+	{
+		if ((s32)(VU0.cycle - cpuRegs.cycle) > 0)
+			cpuRegs.cycle = VU0.cycle;
+		VU0.cycle = cpuRegs.cycle;
+	}
+}
+
+void VU0_Thread::Sync(bool addCycles)
+{
+	WaitVU();
+	Complete(addCycles);
+}
+
+void VU0_Thread::Poll()
+{
+	if (IsDone())
+		Complete(false);
+}
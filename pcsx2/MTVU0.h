@@ -0,0 +1,75 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2010  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "System/SysThreads.h"
+#include "VUmicro.h"
+
+// Runs VU0 micro-mode programs (VCALLMS/VIF0 MSCAL) on their own thread so COP2 heavy
+// games can overlap VU0 work with the EE.  Only one microprogram is ever in flight.
+//
+// Notes:
+// - This class should only be accessed from the EE thread...
+// - The worker owns VU0's registers, memory and microVU0's program cache while a
+//   program is in flight, so every EE path that touches them must call WaitVU/Sync.
+// - The EE keeps updating VU1's bits of VPU_STAT while VU0 runs, so the worker keeps
+//   VU0's bits in vpuStat instead and Complete merges them back on the EE thread.
+//   Use IsDone() rather than VPU_STAT to know when the worker is idle.
+// - The VU0 end interrupt is left pending in VU0.flags by the worker and raised from
+//   the EE thread by Sync/Poll.
+class VU0_Thread : public pxThread {
+	// Note: keep atomic on separate cache line to avoid CPU conflict
+	__aligned(64) std::atomic<bool> isBusy;    // Is thread executing a microprogram?
+	__aligned(64) std::atomic<bool> isPending; // Kicked by the EE and not finished yet
+	Mutex     mtxBusy;
+	Semaphore semaEvent;
+	bool      hasStat;                         // vpuStat not merged into VPU_STAT yet
+
+public:
+	// VU0's bits of VPU_STAT while a microprogram is in flight (worker writes only)
+	__aligned(64) u32 vpuStat;
+
+	VU0_Thread();
+	virtual ~VU0_Thread();
+
+	void Reset();
+
+	// True when no microprogram is in flight
+	bool IsDone() const { return !isPending.load(std::memory_order_acquire); }
+
+	// Hands the microprogram set up by vu0ExecMicro to the worker
+	void ExecuteMicro();
+
+	// Waits till the worker is done, without touching EE state
+	void WaitVU();
+
+	// Waits till the worker is done, raises its pending interrupt and (optionally)
+	// stalls the EE to VU0's cycle count like the inline path does
+	void Sync(bool addCycles);
+
+	// Non-blocking version of Sync(false), called from the EE event test
+	void Poll();
+
+protected:
+	void ExecuteTaskInThread();
+
+private:
+	void Complete(bool addCycles);
+};
+
+extern __aligned16 VU0_Thread vu0Thread;
+
+// Syncs with the VU0 worker if it's enabled (called from recompiled COP2 code)
+extern void vu0Sync();
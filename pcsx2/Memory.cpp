@@ -41,6 +41,7 @@ BIOS
 #include "GS.h"
 #include "VUmicro.h"
 #include "MTVU.h"
+#include "MTVU0.h"
 
 #include "ps2/HwInternal.h"
 #include "ps2/BiosTools.h"
@@ -106,6 +107,7 @@ static vtlbHandler
 
 	vu0_micro_mem,
 	vu1_micro_mem,
+	vu0_data_mem,
 	vu1_data_mem,
 
 	hw_by_page[0x10] = { 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
@@ -135,7 +137,9 @@ void memMapVUmicro()
 
 	// VU0/VU1 memory (data)
 	// VU0 is 4k, mirrored 4 times across a 16k area.
-	vtlb_MapBlock(VU0.Mem,0x11004000,0x00004000,0x1000);
+	// With the VU0 worker enabled EE accesses go through the handlers so they can sync with it.
+	if (THREAD_VU0) vtlb_MapHandler(vu0_data_mem,0x11004000,0x00004000);
+	else            vtlb_MapBlock  (VU0.Mem,     0x11004000,0x00004000,0x1000);
 	// Note: In order for the below conditional to work correctly
 	// support needs to be coded to reset the memMappings when MTVU is
 	// turned off/on. For now we just always use the vu data handlers...
@@ -460,6 +464,7 @@ template<int vunum> static mem8_t __fc vuMicroRead8(u32 addr) {
 	addr      &= vunum ? 0x3fff: 0xfff;
 	
 	if (vunum && THREAD_VU1) vu1Thread.WaitVU();
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	return vu->Micro[addr];
 }
 template<int vunum> static mem16_t __fc vuMicroRead16(u32 addr) {
@@ -467,6 +472,7 @@ template<int vunum> static mem16_t __fc vuMicroRead16(u32 addr) {
 	addr      &= vunum ? 0x3fff: 0xfff;
 	
 	if (vunum && THREAD_VU1) vu1Thread.WaitVU();
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	return *(u16*)&vu->Micro[addr];
 }
 template<int vunum> static mem32_t __fc vuMicroRead32(u32 addr) {
@@ -474,6 +480,7 @@ template<int vunum> static mem32_t __fc vuMicroRead32(u32 addr) {
 	addr      &= vunum ? 0x3fff: 0xfff;
 	
 	if (vunum && THREAD_VU1) vu1Thread.WaitVU();
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	return *(u32*)&vu->Micro[addr];
 }
 template<int vunum> static void __fc vuMicroRead64(u32 addr,mem64_t* data) {
@@ -481,12 +488,14 @@ template<int vunum> static void __fc vuMicroRead64(u32 addr,mem64_t* data) {
 	addr      &= vunum ? 0x3fff: 0xfff;
 	
 	if (vunum && THREAD_VU1) vu1Thread.WaitVU();
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	*data=*(u64*)&vu->Micro[addr];
 }
 template<int vunum> static void __fc vuMicroRead128(u32 addr,mem128_t* data) {
 	VURegs* vu = vunum ?  &VU1 :  &VU0;
 	addr      &= vunum ? 0x3fff: 0xfff;
 	if (vunum && THREAD_VU1) vu1Thread.WaitVU();
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	
 	CopyQWC(data,&vu->Micro[addr]);
 }
@@ -497,6 +506,7 @@ template<int vunum> static void __fc vuMicroWrite8(u32 addr,mem8_t data) {
 	VURegs* vu = vunum ?  &VU1 :  &VU0;
 	addr      &= vunum ? 0x3fff: 0xfff;
 	
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	if (vunum && THREAD_VU1) {
 		vu1Thread.WriteMicroMem(addr, &data, sizeof(u8));
 		return;
@@ -510,6 +520,7 @@ template<int vunum> static void __fc vuMicroWrite16(u32 addr, mem16_t data) {
 	VURegs* vu = vunum ?  &VU1 :  &VU0;
 	addr      &= vunum ? 0x3fff: 0xfff;
 	
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	if (vunum && THREAD_VU1) {
 		vu1Thread.WriteMicroMem(addr, &data, sizeof(u16));
 		return;
@@ -523,6 +534,7 @@ template<int vunum> static void __fc vuMicroWrite32(u32 addr, mem32_t data) {
 	VURegs* vu = vunum ?  &VU1 :  &VU0;
 	addr      &= vunum ? 0x3fff: 0xfff;
 	
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	if (vunum && THREAD_VU1) {
 		vu1Thread.WriteMicroMem(addr, &data, sizeof(u32));
 		return;
@@ -536,6 +548,7 @@ template<int vunum> static void __fc vuMicroWrite64(u32 addr, const mem64_t* dat
 	VURegs* vu = vunum ?  &VU1 :  &VU0;
 	addr      &= vunum ? 0x3fff: 0xfff;
 
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	if (vunum && THREAD_VU1) {
 		vu1Thread.WriteMicroMem(addr, (void*)data, sizeof(u64));
 		return;
@@ -550,6 +563,7 @@ template<int vunum> static void __fc vuMicroWrite128(u32 addr, const mem128_t* d
 	VURegs* vu = vunum ?  &VU1 :  &VU0;
 	addr      &= vunum ? 0x3fff: 0xfff;
 
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	if (vunum && THREAD_VU1) {
 		vu1Thread.WriteMicroMem(addr, (void*)data, sizeof(u128));
 		return;
@@ -565,30 +579,35 @@ template<int vunum> static mem8_t __fc vuDataRead8(u32 addr) {
 	VURegs* vu = vunum ?  &VU1 :  &VU0;
 	addr      &= vunum ? 0x3fff: 0xfff;
 	if (vunum && THREAD_VU1) vu1Thread.WaitVU();
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	return vu->Mem[addr];
 }
 template<int vunum> static mem16_t __fc vuDataRead16(u32 addr) {
 	VURegs* vu = vunum ?  &VU1 :  &VU0;
 	addr      &= vunum ? 0x3fff: 0xfff;
 	if (vunum && THREAD_VU1) vu1Thread.WaitVU();
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	return *(u16*)&vu->Mem[addr];
 }
 template<int vunum> static mem32_t __fc vuDataRead32(u32 addr) {
 	VURegs* vu = vunum ?  &VU1 :  &VU0;
 	addr      &= vunum ? 0x3fff: 0xfff;
 	if (vunum && THREAD_VU1) vu1Thread.WaitVU();
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	return *(u32*)&vu->Mem[addr];
 }
 template<int vunum> static void __fc vuDataRead64(u32 addr, mem64_t* data) {
 	VURegs* vu = vunum ?  &VU1 :  &VU0;
 	addr      &= vunum ? 0x3fff: 0xfff;
 	if (vunum && THREAD_VU1) vu1Thread.WaitVU();
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	*data=*(u64*)&vu->Mem[addr];
 }
 template<int vunum> static void __fc vuDataRead128(u32 addr, mem128_t* data) {
 	VURegs* vu = vunum ?  &VU1 :  &VU0;
 	addr      &= vunum ? 0x3fff: 0xfff;
 	if (vunum && THREAD_VU1) vu1Thread.WaitVU();
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	CopyQWC(data,&vu->Mem[addr]);
 }
 
@@ -596,6 +615,7 @@ template<int vunum> static void __fc vuDataRead128(u32 addr, mem128_t* data) {
 template<int vunum> static void __fc vuDataWrite8(u32 addr, mem8_t data) {
 	VURegs* vu = vunum ?  &VU1 :  &VU0;
 	addr      &= vunum ? 0x3fff: 0xfff;
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	if (vunum && THREAD_VU1) {
 		vu1Thread.WriteDataMem(addr, &data, sizeof(u8));
 		return;
@@ -605,6 +625,7 @@ template<int vunum> static void __fc vuDataWrite8(u32 addr, mem8_t data) {
 template<int vunum> static void __fc vuDataWrite16(u32 addr, mem16_t data) {
 	VURegs* vu = vunum ?  &VU1 :  &VU0;
 	addr      &= vunum ? 0x3fff: 0xfff;
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	if (vunum && THREAD_VU1) {
 		vu1Thread.WriteDataMem(addr, &data, sizeof(u16));
 		return;
@@ -614,6 +635,7 @@ template<int vunum> static void __fc vuDataWrite16(u32 addr, mem16_t data) {
 template<int vunum> static void __fc vuDataWrite32(u32 addr, mem32_t data) {
 	VURegs* vu = vunum ?  &VU1 :  &VU0;
 	addr      &= vunum ? 0x3fff: 0xfff;
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	if (vunum && THREAD_VU1) {
 		vu1Thread.WriteDataMem(addr, &data, sizeof(u32));
 		return;
@@ -623,6 +645,7 @@ template<int vunum> static void __fc vuDataWrite32(u32 addr, mem32_t data) {
 template<int vunum> static void __fc vuDataWrite64(u32 addr, const mem64_t* data) {
 	VURegs* vu = vunum ?  &VU1 :  &VU0;
 	addr      &= vunum ? 0x3fff: 0xfff;
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	if (vunum && THREAD_VU1) {
 		vu1Thread.WriteDataMem(addr, (void*)data, sizeof(u64));
 		return;
@@ -632,6 +655,7 @@ template<int vunum> static void __fc vuDataWrite64(u32 addr, const mem64_t* data
 template<int vunum> static void __fc vuDataWrite128(u32 addr, const mem128_t* data) {
 	VURegs* vu = vunum ?  &VU1 :  &VU0;
 	addr      &= vunum ? 0x3fff: 0xfff;
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	if (vunum && THREAD_VU1) {
 		vu1Thread.WriteDataMem(addr, (void*)data, sizeof(u128));
 		return;
@@ -760,6 +784,7 @@ void eeMemoryReserve::Reset()
 	// Dynarec versions of VUs
 	vu0_micro_mem = vtlb_RegisterHandlerTempl1(vuMicro,0);
 	vu1_micro_mem = vtlb_RegisterHandlerTempl1(vuMicro,1);
+	vu0_data_mem  = vtlb_RegisterHandlerTempl1(vuData,0);
 	vu1_data_mem  = (1||THREAD_VU1) ? vtlb_RegisterHandlerTempl1(vuData,1) : 0;
 	
 	//////////////////////////////////////////////////////////////////////////////////////////
@@ -22,7 +22,8 @@
 const wxChar* const tbl_SpeedhackNames[] =
 {
 	L"mvuFlag",
-	L"InstantVU1" };
+	L"InstantVU1",
+	L"VU0Thread" };
 
 const __fi wxChar* EnumToString(SpeedhackId id)
 {
@@ -40,6 +41,9 @@ void Pcsx2Config::SpeedhackOptions::Set(SpeedhackId id, bool enabled)
 	case Speedhack_InstantVU1:
 		vu1Instant = enabled;
 		break;
+	case Speedhack_VU0Thread:
+		vu0Thread = enabled;
+		break;
 		jNO_DEFAULT;
 	}
 }
@@ -142,6 +146,7 @@ Pcsx2Config::GSOptions::GSOptions()
 	FrameSkipEnable			= false;
 
 	VsyncQueueSize			= 2;
+	RingBufferSizeFactor	= RingBufferSizeFactorDefault;
 
 	FramesToDraw			= 2;
 	FramesToSkip			= 2;
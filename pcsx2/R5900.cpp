@@ -23,6 +23,7 @@
 #include "VUmicro.h"
 #include "COP0.h"
 #include "MTVU.h"
+#include "MTVU0.h"
 
 #include "System/SysThreads.h"
 #include "R5900Exceptions.h"
@@ -71,6 +72,8 @@ extern SysMainMemory& GetVmMemory();
 
 void cpuReset()
 {
+	vu0Thread.WaitVU();
+	vu0Thread.Reset(); // Drop the VPU_STAT bits of the last program, VU0 is reset below
 	vu1Thread.WaitVU();
 	if (GetMTGS().IsOpen())
 		GetMTGS().WaitGS();		// GS better be done processing before we reset the EE, just in case.
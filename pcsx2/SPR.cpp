@@ -446,6 +446,54 @@ void _SPR1interleave()
 	spr1ch.qwc = 0;
 }
 
+// Batched chain mode: the scratchpad always accepts the data, so walk the source chain
+// until it ends (or the cycle budget runs out) and raise a single interrupt for the
+// accumulated cost instead of rescheduling once per tag.
+static void _SPR1chainBatched()
+{
+	u32 cycles = 0;
+
+	while (cycles < DmaBatchCycleLimit)
+	{
+		if (spr1ch.qwc > 0)
+		{
+			int transferred = _SPR1chain();
+			if (transferred < 0)
+				break;
+			cycles += transferred * BIAS;
+			continue;
+		}
+
+		if (spr1finished)
+			break;
+
+		tDMA_TAG *ptag = SPRdmaGetAddr(spr1ch.tadr, false); // Set memory pointer to TADR
+
+		if (!spr1ch.transfer("SPR1 Tag", ptag))
+		{
+			spr1finished = true;
+			break;
+		}
+
+		spr1ch.madr = ptag[1]._u32;	// MADR = ADDR field + SPR
+		cycles += 2; // 2 cycles for reading the tag QW, so chains of empty tags still end the batch
+
+		// Transfer dma tag if tte is set
+		if (spr1ch.chcr.TTE)
+			SPR1transfer(ptag, 1);
+
+		SPR_LOG("spr1 dmaChain (batched) %8.8x_%8.8x size=%d, id=%d, addr=%lx taddr=%lx saddr=%lx",
+			ptag[1]._u32, ptag[0]._u32, spr1ch.qwc, ptag->ID, spr1ch.madr, spr1ch.tadr, spr1ch.sadr);
+
+		spr1finished = hwDmacSrcChain(spr1ch, ptag->ID);
+
+		if (spr1ch.chcr.TIE && ptag->IRQ) // Check TIE bit of CHCR and IRQ bit of tag
+			spr1finished = true;
+	}
+
+	CPU_INT(DMAC_TO_SPR, cycles);
+}
+
 void _dmaSPR1()   // toSPR work function
 {
 	switch(spr1ch.chcr.MOD)
@@ -463,6 +511,12 @@ void _dmaSPR1()   // toSPR work function
 			tDMA_TAG *ptag;
 			bool done = false;
 
+			if (BATCH_DMA_CHAINS && !CHECK_IPUWAITHACK)
+			{
+				_SPR1chainBatched();
+				return;
+			}
+
 			if (spr1ch.qwc > 0)
 			{
 				SPR_LOG("spr1 Normal or in Progress size=%d, addr=%lx taddr=%lx saddr=%lx", spr1ch.qwc, spr1ch.madr, spr1ch.tadr, spr1ch.sadr);
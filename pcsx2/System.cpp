@@ -20,6 +20,7 @@
 #include "VUmicro.h"
 #include "newVif.h"
 #include "MTVU.h"
+#include "MTVU0.h"
 
 #include "Elfheader.h"
 
@@ -296,9 +297,11 @@ void SysMainMemory::DecommitAll()
 	log_cb(RETRO_LOG_INFO, "Decommitting host memory for virtual systems...\n" );
 
 	// On linux, the MTVU isn't empty and the thread still uses the m_ee/m_vu memory
+	vu0Thread.WaitVU();
 	vu1Thread.WaitVU();
 	// The EE thread must be stopped here command mustn't be send
 	// to the ring. Let's call it an extra safety valve :)
+	vu0Thread.Reset();
 	vu1Thread.Reset();
 
 	m_ee.Decommit();
@@ -26,6 +26,7 @@
 #include "Patch.h"
 #include "SysThreads.h"
 #include "MTVU.h"
+#include "MTVU0.h"
 #include "IPC.h"
 #include "FW.h"
 #include "PAD/PAD.h"
@@ -374,6 +375,7 @@ void SysCoreThread::OnCleanupInThread()
 
 	R3000A::ioman::reset();
 	// FIXME: temporary workaround for deadlock on exit, which actually should be a crash
+	vu0Thread.WaitVU();
 	vu1Thread.WaitVU();
 	modules_close();
 	modules_shutdown();
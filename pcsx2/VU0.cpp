@@ -30,6 +30,7 @@
 #include "R5900OpcodeTables.h"
 #include "VUmicro.h"
 #include "Vif_Dma.h"
+#include "MTVU0.h"
 
 #define _Ft_ _Rt_
 #define _Fs_ _Rd_
@@ -41,9 +42,10 @@
 using namespace R5900;
 
 void COP2_BC2() { Int_COP2BC2PrintTable[_Rt_]();}
-void COP2_SPECIAL() { Int_COP2SPECIAL1PrintTable[_Funct_]();}
+void COP2_SPECIAL() { vu0Sync(); Int_COP2SPECIAL1PrintTable[_Funct_]();}
 
 void COP2_SPECIAL2() {
+	vu0Sync(); // VU0 worker owns the registers while it runs
 	Int_COP2SPECIAL2PrintTable[(cpuRegs.code & 0x3) | ((cpuRegs.code >> 4) & 0x7c)]();
 }
 
@@ -56,6 +58,12 @@ void COP2_Unknown()
 
 __fi void _vu0run(bool breakOnMbit, bool addCycles) {
 
+	// The worker always runs programs to E-bit termination, so M-bit waits become full ones
+	if (THREAD_VU0) {
+		vu0Thread.Sync(addCycles);
+		return;
+	}
+
 	if (!(VU0.VI[REG_VPU_STAT].UL & 1)) return;
 
 	//VU0 is ahead of the EE and M-Bit is already encountered, so no need to wait for it, just catch up the EE
@@ -90,6 +98,7 @@ namespace Interpreter{
 namespace OpcodeImpl
 {
 	void LQC2() {
+		vu0Sync(); // VU0 worker owns the registers while it runs
 		u32 addr = cpuRegs.GPR.r[_Rs_].UL[0] + (s16)cpuRegs.code;
 		if (_Ft_) {
 			memRead128(addr, VU0.VF[_Ft_].UQ);
@@ -103,6 +112,7 @@ namespace OpcodeImpl
 	//TODO: check this
 	// HUH why ? doesn't make any sense ...
 	void SQC2() {
+		vu0Sync(); // VU0 worker owns the registers while it runs
 		u32 addr = _Imm_ + cpuRegs.GPR.r[_Rs_].UL[0];
 		memWrite128(addr, VU0.VF[_Ft_].UQ);
 	}
@@ -113,6 +123,7 @@ void QMFC2() {
 	if (cpuRegs.code & 1) {
 		_vu0FinishMicro();
 	}
+	else vu0Sync(); // VU0 worker owns the registers while it runs
 	if (_Rt_ == 0) return;
 	cpuRegs.GPR.r[_Rt_].UD[0] = VU0.VF[_Fs_].UD[0];
 	cpuRegs.GPR.r[_Rt_].UD[1] = VU0.VF[_Fs_].UD[1];
@@ -122,6 +133,7 @@ void QMTC2() {
 	if (cpuRegs.code & 1) {
 		_vu0WaitMicro();
 	}
+	else vu0Sync(); // VU0 worker owns the registers while it runs
 	if (_Fs_ == 0) return;
 	VU0.VF[_Fs_].UD[0] = cpuRegs.GPR.r[_Rt_].UD[0];
 	VU0.VF[_Fs_].UD[1] = cpuRegs.GPR.r[_Rt_].UD[1];
@@ -131,6 +143,7 @@ void CFC2() {
 	if (cpuRegs.code & 1) {
 		_vu0FinishMicro();
 	}
+	else vu0Sync(); // VU0 worker owns the registers while it runs
 	if (_Rt_ == 0) return;
 	
 	cpuRegs.GPR.r[_Rt_].UL[0] = VU0.VI[_Fs_].UL;
@@ -145,6 +158,7 @@ void CTC2() {
 	if (cpuRegs.code & 1) {
 		_vu0WaitMicro();
 	}
+	else vu0Sync(); // VU0 worker owns the registers while it runs
 	if (_Fs_ == 0) return;
 
 	switch(_Fs_) {
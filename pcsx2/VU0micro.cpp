@@ -21,6 +21,7 @@
 #include "PrecompiledHeader.h"
 #include "Common.h"
 #include "VUmicro.h"
+#include "MTVU0.h"
 
 #include <cmath>
 
@@ -37,7 +38,11 @@ void vu0ResetRegs()
 void __fastcall vu0ExecMicro(u32 addr) {
 	VUM_LOG("vu0ExecMicro %x", addr);
 
-	if(VU0.VI[REG_VPU_STAT].UL & 0x1) {
+	if (THREAD_VU0) {
+		// VPU_STAT can read idle before the worker is done, so always sync with it
+		vu0Thread.Sync(false);
+	}
+	else if(VU0.VI[REG_VPU_STAT].UL & 0x1) {
 #ifndef NDEBUG
 		log_cb(RETRO_LOG_DEBUG, "vu0ExecMicro > Stalling for previous microprogram to finish\n");
 #endif
@@ -53,5 +58,8 @@ void __fastcall vu0ExecMicro(u32 addr) {
 
 	CpuVU0->SetStartPC(VU0.VI[REG_TPC].UL << 3);
 	_vuExecMicroDebug(VU0);
-	CpuVU0->ExecuteBlock(1);
+	if (THREAD_VU0)
+		vu0Thread.ExecuteMicro();
+	else
+		CpuVU0->ExecuteBlock(1);
 }
@@ -0,0 +1,117 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2010  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Vector FMAC helpers, included by VUops.cpp. Split out so tests/ctest/vu can check
+// them against the per-field VU_MACx_UPDATE/VU_STAT_UPDATE code on its own.
+
+// ADD/SUB/MUL/MADD/MSUB (and their bc/i/q/ACC forms) compute all four fields at once.
+// The dest mask only decides which results get stored and which MAC flag fields are
+// updated, matching what the per-field code did with VU_MACx_UPDATE/VU_MACx_CLEAR.
+
+// mask ? a : b
+static __fi __m128i vuSelect(const __m128i& mask, const __m128i& a, const __m128i& b)
+{
+#ifdef __SSE4_1__
+	return _mm_castps_si128(_mm_blendv_ps(_mm_castsi128_ps(b), _mm_castsi128_ps(a), _mm_castsi128_ps(mask)));
+#else
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+#endif
+}
+
+// vuDouble() applied to all four fields
+static __fi __m128 vuDouble4(__m128i v)
+{
+#ifndef INT_VUDOUBLEHACK
+	const __m128i expMask = _mm_set1_epi32(0x7f800000);
+	const __m128i exp     = _mm_and_si128(v, expMask);
+	const __m128i sign    = _mm_and_si128(v, _mm_set1_epi32(0x80000000));
+	v = vuSelect(_mm_cmpeq_epi32(exp, _mm_setzero_si128()), sign, v);
+	v = vuSelect(_mm_cmpeq_epi32(exp, expMask), _mm_or_si128(sign, _mm_set1_epi32(0x7f7fffff)), v);
+#endif
+	return _mm_castsi128_ps(v);
+}
+
+static __fi __m128 vuDouble4(const VECTOR& v) { return vuDouble4(_mm_load_si128((const __m128i*)&v)); }
+static __fi __m128 vuDouble4(u32 f)           { return vuDouble4(_mm_set1_epi32(f)); }
+
+// Movemask with x in bit 3 and w in bit 0, the order the MAC flag fields use
+static __fi u32 vuFlagMask(const __m128i& m)
+{
+	return _mm_movemask_ps(_mm_castsi128_ps(_mm_shuffle_epi32(m, _MM_SHUFFLE(0, 1, 2, 3))));
+}
+
+// Vector equivalent of VU_MACx/y/z/w_UPDATE + VU_STAT_UPDATE for the fields in _XYZW,
+// with the masked store to dst. Fields outside the mask have their MAC flags cleared.
+static __ri void _vuFMACwrite(VURegs * VU, VECTOR * dst, const __m128& res)
+{
+	const __m128i v       = _mm_castps_si128(res);
+	const __m128i expMask = _mm_set1_epi32(0x7f800000);
+	const __m128i exp     = _mm_and_si128(v, expMask);
+	const __m128i sign    = _mm_and_si128(v, _mm_set1_epi32(0x80000000));
+	// Float compare so DAZ is honoured the same way as the scalar "f == 0" test
+	const __m128i isZero  = _mm_castps_si128(_mm_cmpeq_ps(res, _mm_setzero_ps()));
+	const __m128i isUnder = _mm_andnot_si128(isZero, _mm_cmpeq_epi32(exp, _mm_setzero_si128()));
+	const __m128i isOver  = _mm_cmpeq_epi32(exp, expMask);
+
+	__m128i out = vuSelect(isUnder, sign, v);
+	out = vuSelect(isOver, _mm_or_si128(sign, _mm_set1_epi32(0x7f7fffff)), out);
+
+	const u32 xyzw  = _XYZW;
+	const u32 s     = vuFlagMask(v) & xyzw;
+	const u32 u     = vuFlagMask(isUnder) & xyzw;
+	const u32 o     = vuFlagMask(isOver) & xyzw;
+	// Overflow leaves the previous zero flag of that field untouched
+	const u32 z     = (vuFlagMask(_mm_or_si128(isZero, isUnder)) | (o & VU->macflag)) & xyzw;
+	VU->macflag = (VU->macflag & ~0xffff) | (o << 12) | (u << 8) | (s << 4) | z;
+
+	const __m128i fieldBits = _mm_setr_epi32(8, 4, 2, 1);
+	const __m128i write     = _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(xyzw), fieldBits), fieldBits);
+	_mm_store_si128((__m128i*)dst, vuSelect(write, out, _mm_load_si128((const __m128i*)dst)));
+
+	VU_STAT_UPDATE(VU);
+}
+
+// The VU rounds the product before the add. Hide it from the optimizer so GCC/clang don't
+// contract MADD/MSUB into an FMA when the build targets -march=native.
+static __fi __m128 vuMul4(__m128 a, __m128 b)
+{
+	__m128 r = _mm_mul_ps(a, b);
+#ifndef _MSC_VER
+	__asm__("" : "+x"(r));
+#endif
+	return r;
+}
+
+#define _vuFMAC_ADD(fs, ft)  _mm_add_ps(fs, ft)
+#define _vuFMAC_SUB(fs, ft)  _mm_sub_ps(fs, ft)
+#define _vuFMAC_MUL(fs, ft)  _mm_mul_ps(fs, ft)
+#define _vuFMAC_MADD(fs, ft) _mm_add_ps(vuDouble4(VU->ACC), vuMul4(fs, ft))
+#define _vuFMAC_MSUB(fs, ft) _mm_sub_ps(vuDouble4(VU->ACC), vuMul4(fs, ft))
+
+#define _vuFMAC_Fd ((_Fd_ == 0) ? &RDzero : &VU->VF[_Fd_])
+#define _vuFMAC(OP, FT, DST) _vuFMACwrite(VU, DST, _vuFMAC_##OP(vuDouble4(VU->VF[_Fs_]), FT))
+
+#define _vuFMAC_OPS(OP, DST, SUFFIX) \
+	static __fi void _vu##OP##SUFFIX    (VURegs * VU) { _vuFMAC(OP, vuDouble4(VU->VF[_Ft_]),       DST); } \
+	static __fi void _vu##OP##SUFFIX##q (VURegs * VU) { _vuFMAC(OP, vuDouble4(VU->VI[REG_Q].UL),   DST); } \
+	static __fi void _vu##OP##SUFFIX##x (VURegs * VU) { _vuFMAC(OP, vuDouble4(VU->VF[_Ft_].i.x),  DST); } \
+	static __fi void _vu##OP##SUFFIX##y (VURegs * VU) { _vuFMAC(OP, vuDouble4(VU->VF[_Ft_].i.y),  DST); } \
+	static __fi void _vu##OP##SUFFIX##z (VURegs * VU) { _vuFMAC(OP, vuDouble4(VU->VF[_Ft_].i.z),  DST); } \
+	static __fi void _vu##OP##SUFFIX##w (VURegs * VU) { _vuFMAC(OP, vuDouble4(VU->VF[_Ft_].i.w),  DST); }
+
+#define _vuFMAC_OPS_I(OP, DST, SUFFIX) \
+	static __fi void _vu##OP##SUFFIX##i (VURegs * VU) { _vuFMAC(OP, vuDouble4(VU->VI[REG_I].UL),   DST); }
@@ -17,6 +17,7 @@
 #include "Common.h"
 #include "VUmicro.h"
 #include "MTVU.h"
+#include "MTVU0.h"
 
 // Executes a Block based on EE delta time
 void BaseVUmicroCPU::ExecuteBlock(bool startUp) {
@@ -29,6 +30,13 @@ void BaseVUmicroCPU::ExecuteBlock(bool startUp) {
 		vu1Thread.Get_GSChanges();
 	}
 
+	// The VU0 worker runs programs on its own, just pick up its end interrupt
+	if (!m_Idx && THREAD_VU0)
+	{
+		vu0Thread.Poll();
+		return;
+	}
+
 	if (!(stat & test)) return;
 
 	if (startUp && s) {  // Start Executing a microprogram
@@ -52,6 +60,11 @@ void BaseVUmicroCPU::ExecuteBlockJIT(BaseVUmicroCPU* cpu) {
 	const u32& stat	= VU0.VI[REG_VPU_STAT].UL;
 	const int  test = 1;
 
+	if (THREAD_VU0) {			// The VU0 worker is already running it
+		vu0Thread.Sync(false);
+		return;
+	}
+
 	if (stat & test) {		// VU is running
 		s32 delta = (s32)(u32)(cpuRegs.cycle - VU0.cycle);
 		s32 nextblockcycles = VU0.nextBlockCycles;
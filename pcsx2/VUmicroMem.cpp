@@ -17,6 +17,7 @@
 #include "PrecompiledHeader.h"
 #include "Common.h"
 #include "VUmicro.h"
+#include "MTVU0.h"
 
 
 __aligned16 VURegs vuRegs[2];
@@ -80,6 +81,8 @@ void SaveStateBase::vuMicroFreeze()
 {
 	FreezeTag( "vuMicroRegs" );
 
+	if (THREAD_VU0) vu0Thread.Sync(false);
+
 	Freeze(VU0.ACC);
 	Freeze(VU0.code);
 
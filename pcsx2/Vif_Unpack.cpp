@@ -18,6 +18,7 @@
 #include "Vif.h"
 #include "Vif_Dma.h"
 #include "MTVU.h"
+#include "MTVU0.h"
 
 enum UnpackOffset {
 	OFFSET_X = 0,
@@ -198,6 +199,7 @@ _vifT void vifUnpackSetup(const u32 *data) {
 		vifExecQueue(idx);
 	}
 	//if (!idx) vif0FLUSH(); // Only VU0?
+	if (!idx && THREAD_VU0) vu0Thread.WaitVU(); // Don't unpack under a running VU0 worker
 
 	vifX.usn   = (vifXRegs.code >> 14) & 0x01;
 	int vifNum = (vifXRegs.code >> 16) & 0xff;
@@ -331,12 +331,15 @@ bool AppConfig::IsOkApplyPreset(int n, bool ignoreMTVU)
 	EmuOptions.EnablePatches		= true;
 	EmuOptions.GS					= default_Pcsx2Config.GS;
 	EmuOptions.GS.VsyncQueueSize	= original_GS.VsyncQueueSize;
+	EmuOptions.GS.RingBufferSizeFactor = original_GS.RingBufferSizeFactor;
 	EmuOptions.Cpu					= default_Pcsx2Config.Cpu;
 	EmuOptions.Gamefixes			= default_Pcsx2Config.Gamefixes;
 	EmuOptions.Speedhacks			= default_Pcsx2Config.Speedhacks;
 	EmuOptions.Speedhacks.bitset	= 0; //Turn off individual hacks to make it visually clear they're not used.
 	EmuOptions.Speedhacks.vuThread	= original_SpeedHacks.vuThread;
 	EmuOptions.Speedhacks.vu1Instant = original_SpeedHacks.vu1Instant;
+	EmuOptions.Speedhacks.dmaChainBatch = original_SpeedHacks.dmaChainBatch;
+	EmuOptions.Speedhacks.vu0Thread = original_SpeedHacks.vu0Thread;
 	EnableSpeedHacks = true;
 	// Actual application of current preset over the base settings which all presets use (mostly pcsx2's default values).
 
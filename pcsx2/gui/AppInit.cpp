@@ -16,6 +16,7 @@
 #include "PrecompiledHeader.h"
 #include "App.h"
 #include "MTVU.h" // for thread cancellation on shutdown
+#include "MTVU0.h"
 
 #include <memory>
 bool Pcsx2App::DetectCpuAndUserMode()
@@ -144,6 +145,7 @@ Pcsx2App::Pcsx2App()
 Pcsx2App::~Pcsx2App()
 {
 	try {
+		vu0Thread.Cancel();
 		vu1Thread.Cancel();
 	}
 	DESTRUCTOR_CATCHALL
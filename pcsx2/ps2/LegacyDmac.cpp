@@ -18,6 +18,7 @@
 #include "Common.h"
 #include "Hardware.h"
 #include "MTVU.h"
+#include "MTVU0.h"
 
 #include "IPU/IPUdma.h"
 #include "ps2/HwInternal.h"
@@ -112,6 +113,10 @@ __fi tDMA_TAG* SPRdmaGetAddr(u32 addr, bool write)
 #endif
 			vu1Thread.WaitVU();
 		}
+		else if (addr < 0x11008000 && THREAD_VU0)
+		{
+			vu0Thread.WaitVU();
+		}
 		
 		//Access for VU Memory
 
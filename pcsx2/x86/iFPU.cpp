@@ -570,6 +570,10 @@ int recCommutativeOp(int info, int regd, int op)
 				if (CHECK_FPU_EXTRA_OVERFLOW || (op >= 2)) { fpuFloat2(regd); fpuFloat2(EEREC_S); }
 				recComOpXMM_to_XMM_REV[op](regd, EEREC_S);
 			}
+			else if (x86caps.hasAVX && (op == 1) && !CHECK_FPU_EXTRA_OVERFLOW && !CHECK_FPUMULHACK) {
+				// Non-destructive VEX form saves the copy of S into regd
+				xVMUL.SS(xRegisterSSE(regd), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
+			}
 			else {
 				xMOVSS(xRegisterSSE(regd), xRegisterSSE(EEREC_S));
 				if (CHECK_FPU_EXTRA_OVERFLOW || (op >= 2)) { fpuFloat2(regd); fpuFloat2(EEREC_T); }
@@ -20,6 +20,7 @@
 #include "R5900OpcodeTables.h"
 #include "iR5900LoadStore.h"
 #include "iR5900.h"
+#include "MTVU0.h"
 
 using namespace x86Emitter;
 
@@ -565,19 +566,27 @@ void recLQC2()
 {
 	iFlushCall(FLUSH_EVERYTHING);
 
-	xTEST(ptr32[&VU0.VI[REG_VPU_STAT].UL], 0x1);
-	xForwardJZ32 skipvuidle;
-	xMOV(eax, ptr32[&cpuRegs.cycle]);
-	xADD(eax, scaleblockcycles_clear());
-	xMOV(ptr32[&cpuRegs.cycle], eax); // update cycles
-	xSUB(eax, ptr32[&VU0.cycle]);
-	xSUB(eax, ptr32[&VU0.nextBlockCycles]);
-	xCMP(eax, 8);
-	xForwardJL32 skip;
-	xLoadFarAddr(arg1reg, CpuVU0);
-	xFastCall((void*)BaseVUmicroCPU::ExecuteBlockJIT, arg1reg);
-	skip.SetTarget();
-	skipvuidle.SetTarget();
+	if (THREAD_VU0)
+	{
+		// The VU0 worker owns VF while it runs and clears VPU_STAT early, see COP2_Interlock
+		xFastCall((void*)vu0Sync);
+	}
+	else
+	{
+		xTEST(ptr32[&VU0.VI[REG_VPU_STAT].UL], 0x1);
+		xForwardJZ32 skipvuidle;
+		xMOV(eax, ptr32[&cpuRegs.cycle]);
+		xADD(eax, scaleblockcycles_clear());
+		xMOV(ptr32[&cpuRegs.cycle], eax); // update cycles
+		xSUB(eax, ptr32[&VU0.cycle]);
+		xSUB(eax, ptr32[&VU0.nextBlockCycles]);
+		xCMP(eax, 8);
+		xForwardJL32 skip;
+		xLoadFarAddr(arg1reg, CpuVU0);
+		xFastCall((void*)BaseVUmicroCPU::ExecuteBlockJIT, arg1reg);
+		skip.SetTarget();
+		skipvuidle.SetTarget();
+	}
 
 	if (_Rt_)
 		xLEA(arg2reg, ptr[&VU0.VF[_Ft_].UD[0]]);
@@ -609,19 +618,27 @@ void recSQC2()
 {
 	iFlushCall(FLUSH_EVERYTHING);
 
-	xTEST(ptr32[&VU0.VI[REG_VPU_STAT].UL], 0x1);
-	xForwardJZ32 skipvuidle;
-	xMOV(eax, ptr32[&cpuRegs.cycle]);
-	xADD(eax, scaleblockcycles_clear());
-	xMOV(ptr32[&cpuRegs.cycle], eax); // update cycles
-	xSUB(eax, ptr32[&VU0.cycle]);
-	xSUB(eax, ptr32[&VU0.nextBlockCycles]);
-	xCMP(eax, 8);
-	xForwardJL32 skip;
-	xLoadFarAddr(arg1reg, CpuVU0);
-	xFastCall((void*)BaseVUmicroCPU::ExecuteBlockJIT, arg1reg);
-	skip.SetTarget();
-	skipvuidle.SetTarget();
+	if (THREAD_VU0)
+	{
+		// The VU0 worker owns VF while it runs and clears VPU_STAT early, see COP2_Interlock
+		xFastCall((void*)vu0Sync);
+	}
+	else
+	{
+		xTEST(ptr32[&VU0.VI[REG_VPU_STAT].UL], 0x1);
+		xForwardJZ32 skipvuidle;
+		xMOV(eax, ptr32[&cpuRegs.cycle]);
+		xADD(eax, scaleblockcycles_clear());
+		xMOV(ptr32[&cpuRegs.cycle], eax); // update cycles
+		xSUB(eax, ptr32[&VU0.cycle]);
+		xSUB(eax, ptr32[&VU0.nextBlockCycles]);
+		xCMP(eax, 8);
+		xForwardJL32 skip;
+		xLoadFarAddr(arg1reg, CpuVU0);
+		xFastCall((void*)BaseVUmicroCPU::ExecuteBlockJIT, arg1reg);
+		skip.SetTarget();
+		skipvuidle.SetTarget();
+	}
 
 	xLEA(arg2reg, ptr[&VU0.VF[_Ft_].UD[0]]);
 
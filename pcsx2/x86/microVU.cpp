@@ -318,12 +318,14 @@ _mVUt __fi void* mVUsearchProg(u32 startPC, uptr pState) {
 //------------------------------------------------------------------
 recMicroVU0::recMicroVU0()		  { m_Idx = 0; IsInterpreter = false; }
 recMicroVU1::recMicroVU1()		  { m_Idx = 1; IsInterpreter = false; }
-void recMicroVU0::Vsync() noexcept { mVUvsyncUpdate(microVU0); }
+void recMicroVU0::Vsync() noexcept { vu0Thread.WaitVU(); mVUvsyncUpdate(microVU0); }
 void recMicroVU1::Vsync() noexcept { mVUvsyncUpdate(microVU1); }
 
 void recMicroVU0::Reserve() {
-	if (m_Reserved.exchange(1) == 0)
+	if (m_Reserved.exchange(1) == 0) {
 		mVUinit(microVU0, 0);
+		vu0Thread.Start();
+	}
 }
 void recMicroVU1::Reserve() {
 	if (m_Reserved.exchange(1) == 0) {
@@ -333,8 +335,10 @@ void recMicroVU1::Reserve() {
 }
 
 void recMicroVU0::Shutdown() noexcept {
-	if (m_Reserved.exchange(0) == 1)
+	if (m_Reserved.exchange(0) == 1) {
+		vu0Thread.WaitVU();
 		mVUclose(microVU0);
+	}
 }
 void recMicroVU1::Shutdown() noexcept {
 	if (m_Reserved.exchange(0) == 1) {
@@ -345,6 +349,7 @@ void recMicroVU1::Shutdown() noexcept {
 
 void recMicroVU0::Reset() {
 	if(!pxAssertDev(m_Reserved, "MicroVU0 CPU Provider has not been reserved prior to reset!")) return;
+	vu0Thread.WaitVU();
 	mVUreset(microVU0, true);
 }
 void recMicroVU1::Reset() {
@@ -363,7 +368,7 @@ void recMicroVU0::Execute(u32 cycles) {
 
 	VU0.flags &= ~VUFLAG_MFLAGSET;
 
-	if(!(VU0.VI[REG_VPU_STAT].UL & 1)) return;
+	if(!((vu0Thread.IsSelf() ? vu0Thread.vpuStat : VU0.VI[REG_VPU_STAT].UL) & 1)) return;
 	VU0.VI[REG_TPC].UL <<= 3;
 
 	// Sometimes games spin on vu0, so be careful with this value
@@ -371,7 +376,8 @@ void recMicroVU0::Execute(u32 cycles) {
 	// Edit: Need to test this again, if anyone ever has a "Woody" game :p
 	((mVUrecCall)microVU0.startFunct)(VU0.VI[REG_TPC].UL, cycles);
 	VU0.VI[REG_TPC].UL >>= 3;
-	if(microVU0.regs().flags & 0x4)
+	// The VU0 worker leaves the interrupt pending for the EE thread to raise
+	if((microVU0.regs().flags & 0x4) && !vu0Thread.IsSelf())
 	{
 		microVU0.regs().flags &= ~0x4;
 		hwIntcIrq(6);
@@ -401,6 +407,7 @@ void recMicroVU1::Execute(u32 cycles) {
 
 void recMicroVU0::Clear(u32 addr, u32 size) {
 	pxAssert(m_Reserved); // please allocate me first! :|
+	vu0Thread.WaitVU();
 	mVUclear(microVU0, addr, size);
 }
 void recMicroVU1::Clear(u32 addr, u32 size) {
@@ -23,6 +23,7 @@ using namespace x86Emitter;
 #include "Common.h"
 #include "VU.h"
 #include "MTVU.h"
+#include "MTVU0.h"
 #include "GS.h"
 #include "Gif_Unit.h"
 #include "iR5900.h"
@@ -30,6 +30,7 @@ using namespace R5900::Dynarec;
 
 void setupMacroOp(int mode, const char* opName) {
 	printCOP2(opName);
+	vu0Thread.WaitVU(); // microVU0's compiler state is shared with the VU0 worker
 	microVU0.cop2 = 1;
 	microVU0.prog.IRinfo.curPC = 0;
 	microVU0.code = cpuRegs.code;
@@ -262,6 +263,21 @@ void recBC2TL() { _setupBranchTest(JZ32,  true);  }
 
 void COP2_Interlock(bool mBitSync) {
 
+	if (THREAD_VU0) {
+		// VPU_STAT only picks up the VU0 worker's bits when the EE syncs with it,
+		// so always call out to it rather than testing the busy bit inline.
+		iFlushCall(FLUSH_EVERYTHING);
+		if (cpuRegs.code & 1) {
+			xMOV(eax, ptr[&cpuRegs.cycle]);
+			xADD(eax, scaleblockcycles_clear());
+			xMOV(ptr[&cpuRegs.cycle], eax); // update cycles
+			if (mBitSync) xFastCall((void*)_vu0WaitMicro);
+			else		  xFastCall((void*)_vu0FinishMicro);
+		}
+		else xFastCall((void*)vu0Sync);
+		return;
+	}
+
 	if (cpuRegs.code & 1) {
 		iFlushCall(FLUSH_EVERYTHING);
 		xTEST(ptr32[&VU0.VI[REG_VPU_STAT].UL], 0x1);
@@ -570,11 +586,22 @@ namespace OpcodeImpl { void recCOP2() { recCOP2t[_Rs_](); }}}}
 void recCOP2_BC2  () { recCOP2_BC2t[_Rt_](); }
 void recCOP2_SPEC1() {
 	iFlushCall(FLUSH_EVERYTHING);
-	xTEST(ptr32[&VU0.VI[REG_VPU_STAT].UL], 0x1);
-	xForwardJZ32 skipvuidle;
-	xFastCall((void*)_vu0FinishMicro);
-	skipvuidle.SetTarget();
+	if (THREAD_VU0) xFastCall((void*)_vu0FinishMicro);
+	else {
+		xTEST(ptr32[&VU0.VI[REG_VPU_STAT].UL], 0x1);
+		xForwardJZ32 skipvuidle;
+		xFastCall((void*)_vu0FinishMicro);
+		skipvuidle.SetTarget();
+	}
 
 	recCOP2SPECIAL1t[_Funct_]();
 }
-void recCOP2_SPEC2() { recCOP2SPECIAL2t[(cpuRegs.code&3)|((cpuRegs.code>>4)&0x7c)](); }
+void recCOP2_SPEC2() {
+	// The macro ops read and write VF/VI/ACC/Q, which the VU0 worker owns while it runs
+	if (THREAD_VU0) {
+		iFlushCall(FLUSH_EVERYTHING);
+		xFastCall((void*)vu0Sync);
+	}
+
+	recCOP2SPECIAL2t[(cpuRegs.code&3)|((cpuRegs.code>>4)&0x7c)]();
+}
@@ -19,6 +19,12 @@
 // Micro VU - Reg Loading/Saving/Shuffling/Unpacking/Merging...
 //------------------------------------------------------------------
 
+// VU0 programs run by the VU0 worker keep their VPU_STAT bits in a word of their own
+__fi static u32* mVUgetVpuStat(microVU& mVU)
+{
+	return (!isVU1 && THREAD_VU0) ? &vu0Thread.vpuStat : &VU0.VI[REG_VPU_STAT].UL;
+}
+
 void mVUunpack_xyzw(const xmm& dstreg, const xmm& srcreg, int xyzw)
 {
 	switch ( xyzw ) {
@@ -74,8 +74,11 @@ static void mVUupdateFlags(mV, const xmm& reg, const xmm& regT1in = xEmptyReg, c
 
 	if (sFLAG.doFlag) {
 		//Calculate overflow
-		xMOVAPS(regT1, regT2);
-		xAND.PS(regT1, ptr128[&sse4_compvals[1][0]]); // Remove sign flags (we don't care)
+		if (x86caps.hasAVX) xVAND.PS(regT1, regT2, ptr128[&sse4_compvals[1][0]]); // Remove sign flags (we don't care)
+		else {
+			xMOVAPS(regT1, regT2);
+			xAND.PS(regT1, ptr128[&sse4_compvals[1][0]]); // Remove sign flags (we don't care)
+		}
 		xPMIN.UD(regT1, ptr128[&sse4_compvals[0][0]]); // Get the minimum value, FLT_MAX = overflow
 		xCMPEQ.PS(regT1, ptr128[&sse4_compvals[0][0]]); // Compare if T1 == FLT_MAX
 		xMOVMSKPS(gprT2, regT1); // Grab sign bits  for equal results
@@ -251,8 +254,15 @@ static void mVU_FMACb(microVU& mVU, int recPass, int opCase, int opType, microOp
 		}
 		else {
 			const xmm& tempACC = mVU.regAlloc->allocReg();
-			xMOVAPS(tempACC, ACC);
-			SSE_PS[opType](mVU, tempACC, Fs, tempFt, xEmptyReg);
+			// Without operand clamping the add/sub is a single non-destructive VEX op
+			if (x86caps.hasAVX && !clampE) {
+				if (opType == 0) xVADD.PS(tempACC, ACC, Fs);
+				else			 xVSUB.PS(tempACC, ACC, Fs);
+			}
+			else {
+				xMOVAPS(tempACC, ACC);
+				SSE_PS[opType](mVU, tempACC, Fs, tempFt, xEmptyReg);
+			}
 			mVUmergeRegs(ACC, tempACC, _X_Y_Z_W);
 			mVUupdateFlags(mVU, ACC, Fs, tempFt);
 			mVU.regAlloc->clearNeeded(tempACC);
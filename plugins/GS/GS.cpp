@@ -34,6 +34,8 @@
 
 #include "options_tools.h"
 
+#include <chrono>
+
 static bool is_d3d                  = false;
 static GSRenderer* s_gs             = NULL;
 static u8* s_basemem             = NULL;
@@ -83,7 +85,7 @@ EXPORT_C_(int) GSinit()
 	theApp.Init();
 
 	GSUtil::Init();
-	GSBlock::InitVectors();
+	GSUtil::SelectISA();
 	GSClut::InitVectors();
 	GSRendererSW::InitVectors();
 	GSVector4i::InitVectors();
@@ -91,7 +93,7 @@ EXPORT_C_(int) GSinit()
 #if _M_SSE >= 0x500
 	GSVector8::InitVectors();
 #endif
-#if _M_SSE >= 0x501
+#if defined(_M_AVX2)
 	GSVector8i::InitVectors();
 #endif
 	GSVertexTrace::InitVectors();
@@ -365,6 +367,20 @@ EXPORT_C GSvsync(int field)
    s_gs->VSync(field);
 }
 
+// Zeroed when the GS is not open. Call it from the thread that opens and closes the GS,
+// nothing stops GSclose from deleting s_gs under a concurrent call.
+
+EXPORT_C GSgetStats(GSStats* stats)
+{
+	if(s_gs == NULL)
+	{
+		memset(stats, 0, sizeof(*stats));
+		return;
+	}
+
+	s_gs->m_perfmon.Get(stats);
+}
+
 EXPORT_C_(int) GSfreeze(int mode, GSFreezeData* data)
 {
 	switch (mode)
@@ -390,6 +406,155 @@ EXPORT_C GSsetFrameSkip(int frameskip)
 	s_gs->SetFrameSkip(frameskip);
 }
 
+// Plays back a dump written by GSDumpXz. The whole packet stream is decoded
+// up front so the timed loop only measures the renderer. renderer is either
+// OGL_SW or Null; the output is never presented anywhere.
+EXPORT_C_(int) GSReplay(const char* path, int renderer, int threads, int loops)
+{
+	struct Packet {GSDumpPacketType type; u8 param; u32 offset, size;};
+
+	GSDumpFile file(path);
+
+	if(!file.IsOpen())
+		return -1;
+
+	u32 crc, state_size;
+
+	if(!file.Read(&crc, 4) || !file.Read(&state_size, 4))
+		return -1;
+
+	std::vector<u8> state(state_size);
+	GSPrivRegSet* regs = (GSPrivRegSet*)_aligned_malloc(sizeof(GSPrivRegSet), 32);
+
+	if(!file.Read(state.data(), state_size) || !file.Read(regs, sizeof(GSPrivRegSet)))
+	{
+		_aligned_free(regs);
+		return -1;
+	}
+
+	std::vector<Packet> packets;
+	std::vector<GSVector4i> data; // keeps every transfer 16 byte aligned
+
+	u8 id;
+
+	while(file.Read(&id, 1))
+	{
+		Packet p = {(GSDumpPacketType)id, 0, 0, 0};
+		bool ok = true;
+
+		switch(p.type)
+		{
+			case GSDumpPacketType::Transfer:
+				ok = file.Read(&p.param, 1) && file.Read(&p.size, 4);
+				p.offset = (u32)data.size();
+				data.resize(data.size() + (p.size + 15) / 16);
+				ok = ok && file.Read(&data[p.offset], p.size);
+				break;
+			case GSDumpPacketType::VSync:
+				ok = file.Read(&p.param, 1);
+				break;
+			case GSDumpPacketType::ReadFIFO2:
+			case GSDumpPacketType::WriteCSR:
+			case GSDumpPacketType::SoftReset:
+				ok = file.Read(&p.size, 4);
+				break;
+			case GSDumpPacketType::Registers:
+				p.offset = (u32)data.size();
+				p.size = sizeof(GSPrivRegSet);
+				data.resize(data.size() + sizeof(GSPrivRegSet) / 16);
+				ok = file.Read(&data[p.offset], p.size);
+				break;
+			default:
+				ok = false;
+				break;
+		}
+
+		if(!ok)
+		{
+			log_cb(RETRO_LOG_WARN, "GSReplay: truncated dump, stopping at packet %zu\n", packets.size());
+			break;
+		}
+
+		packets.push_back(p);
+	}
+
+	if((GSRendererType)renderer == GSRendererType::Null)
+		s_gs = new GSRendererNull();
+	else
+		s_gs = new GSRendererSW(threads);
+
+	theApp.SetCurrentRendererType((GSRendererType)renderer);
+
+	GSsetBaseMem((u8*)regs);
+
+	if(!s_gs->CreateDevice(new GSDeviceNull()))
+	{
+		GSshutdown();
+		_aligned_free(regs);
+		return -1;
+	}
+
+	GSFreezeData fd = {(int)state_size, state.data()};
+	GSPrivRegSet initial = *regs;
+	std::vector<GSVector4i> fifo;
+
+	s_gs->SetGameCRC(crc, 0);
+
+	int frames = 0;
+	int draws = GSState::s_n;
+	auto start = std::chrono::steady_clock::now();
+
+	for(int i = 0; i < loops; i++)
+	{
+		s_gs->Defrost(&fd);
+		*regs = initial;
+
+		for(const Packet& p : packets)
+		{
+			switch(p.type)
+			{
+				case GSDumpPacketType::Transfer:
+					switch(p.param)
+					{
+						case 0: s_gs->Transfer<0>((const u8*)&data[p.offset], p.size / 16); break;
+						case 1: s_gs->Transfer<1>((const u8*)&data[p.offset], p.size / 16); break;
+						case 2: s_gs->Transfer<2>((const u8*)&data[p.offset], p.size / 16); break;
+						case 3: s_gs->Transfer<3>((const u8*)&data[p.offset], p.size / 16); break;
+					}
+					break;
+				case GSDumpPacketType::VSync:
+					s_gs->VSync(p.param);
+					frames++;
+					break;
+				case GSDumpPacketType::ReadFIFO2:
+					fifo.resize(std::max<size_t>(fifo.size(), p.size));
+					s_gs->InitReadFIFO((u8*)fifo.data(), p.size);
+					s_gs->ReadFIFO((u8*)fifo.data(), p.size);
+					break;
+				case GSDumpPacketType::Registers:
+					memcpy(regs, &data[p.offset], sizeof(GSPrivRegSet));
+					break;
+				case GSDumpPacketType::WriteCSR:
+					s_gs->WriteCSR(p.size);
+					break;
+				case GSDumpPacketType::SoftReset:
+					s_gs->SoftReset(p.size);
+					break;
+			}
+		}
+	}
+
+	double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	log_cb(RETRO_LOG_INFO, "GSReplay: %d frames, %d draws in %.1f ms (%.2f ms/frame, %.1f fps)\n",
+		frames, GSState::s_n - draws, ms, frames ? ms / frames : 0.0, ms > 0 ? frames * 1000.0 / ms : 0.0);
+
+	GSshutdown();
+	_aligned_free(regs);
+
+	return frames;
+}
+
 std::string format(const char* fmt, ...)
 {
 	va_list args;
@@ -617,6 +782,7 @@ void GSdxApp::Init()
 	m_current_configuration["filter"]                                     = std::to_string(static_cast<s8>(BiFiltering::PS2));
 	m_current_configuration["force_texture_clear"]                        = "0";
 	m_current_configuration["fxaa"]                                       = "0";
+	m_current_configuration["gif_jit"]                                    = "1";
 	m_current_configuration["interlace"]                                  = "7";
 	m_current_configuration["large_framebuffer"]                          = "0";
 	m_current_configuration["linear_present"]                             = "1";
@@ -659,10 +825,14 @@ void GSdxApp::Init()
 	m_current_configuration["shaderfx"]                                   = "0";
 	m_current_configuration["shaderfx_conf"]                              = "shaders/GSdx_FX_Settings.ini";
 	m_current_configuration["shaderfx_glsl"]                              = "shaders/GSdx.fx";
+	m_current_configuration["stats_csv"]                                  = "0";
+	m_current_configuration["sw_avx512"]                                  = "0";
+	m_current_configuration["sw_merge_cpu"]                               = "1";
 	m_current_configuration["TVShader"]                                   = "0";
 	m_current_configuration["upscale_multiplier"]                         = "1";
 	m_current_configuration["UserHacks"]                                  = "0";
 	m_current_configuration["UserHacks_align_sprite_X"]                   = "0";
+	m_current_configuration["UserHacks_AsyncReadback"]                    = "0";
 	m_current_configuration["UserHacks_AutoFlush"]                        = "0";
 	m_current_configuration["UserHacks_DisableDepthSupport"]              = "0";
 	m_current_configuration["UserHacks_Disable_Safe_Features"]            = "0";
@@ -255,10 +255,10 @@ union name			\
 {					\
 	u64 U64;		\
 	u32 U32[2];	\
-	void operator = (const GSVector4i& v) {GSVector4i::storel(this, v);} \
-	bool operator == (const union name& r) const {return ((GSVector4i)r).eq(*this);} \
-	bool operator != (const union name& r) const {return !((GSVector4i)r).eq(*this);} \
-	operator GSVector4i() const {return GSVector4i::loadl(this);} \
+	__forceinline void operator = (const GSVector4i& v) {GSVector4i::storel(this, v);} \
+	__forceinline bool operator == (const union name& r) const {return ((GSVector4i)r).eq(*this);} \
+	__forceinline bool operator != (const union name& r) const {return !((GSVector4i)r).eq(*this);} \
+	__forceinline operator GSVector4i() const {return GSVector4i::loadl(this);} \
 	struct {		\
 
 #define REG128(name)\
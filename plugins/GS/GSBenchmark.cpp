@@ -0,0 +1,411 @@
+/*
+ *	Copyright (C) 2007-2009 Gabest
+ *	http://www.gabest.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNU Make; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "stdafx.h"
+#include "GS.h"
+#include "GSUtil.h"
+#include "Renderers/Null/GSRendererNull.h"
+#include "Renderers/Null/GSDeviceNull.h"
+#include "Renderers/Null/GSTextureCacheNull.h"
+#include "options_tools.h"
+
+#include <chrono>
+
+// Microbenchmarks for pcsx2_GSReplayLoader --bench, not part of the plugin.
+
+// Host to local (WriteImage), local to host (ReadImage) and texture unswizzling (ReadTexture)
+// throughput per format. The hash of vram and of the last texture read lets builds for different
+// instruction sets be compared.
+
+static void BenchmarkTransfer(int loops)
+{
+	static const struct {int psm; const char* name;} s_format[] =
+	{
+		{PSM_PSMCT32, "32"},
+		{PSM_PSMCT24, "24"},
+		{PSM_PSMCT16, "16"},
+		{PSM_PSMCT16S, "16S"},
+		{PSM_PSMT8, "8"},
+		{PSM_PSMT4, "4"},
+		{PSM_PSMT8H, "8H"},
+		{PSM_PSMT4HL, "4HL"},
+		{PSM_PSMT4HH, "4HH"},
+		{PSM_PSMZ32, "32Z"},
+		{PSM_PSMZ24, "24Z"},
+		{PSM_PSMZ16, "16Z"},
+		{PSM_PSMZ16S, "16ZS"},
+	};
+
+	static const struct {int offset, x, y, w, h; const char* name;} s_case[] =
+	{
+		{0, 0, 0, 256, 256, "aligned"},
+		{4, 0, 0, 256, 256, "src+4"}, // unaligned source, aligned rectangle
+		{0, 5, 3, 246, 250, "edges"}, // starts and ends mid block
+	};
+
+	const int n = 64 * std::max(loops, 1);
+
+	GSLocalMemory* mem = new GSLocalMemory();
+
+	u8* buff = (u8*)_aligned_malloc(1024 * 1024 * 4 + 32, 32);
+	u8* dst = (u8*)_aligned_malloc(1024 * 1024 * 4, 32);
+
+	for(int i = 0; i < 1024 * 1024 * 4 + 32; i++)
+	{
+		buff[i] = (u8)((i * 0x9e3779b1u) >> 24);
+	}
+
+	for(size_t i = 0; i < countof(s_format); i++)
+	{
+		const GSLocalMemory::psm_t& psm = GSLocalMemory::m_psm[s_format[i].psm];
+
+		memset(mem->m_vm8, 0, GSLocalMemory::m_vmsize);
+
+		u64 hash = 0xcbf29ce484222325ull;
+
+		auto add = [&hash](const void* p, int size)
+		{
+			for(int k = 0; k < size / 8; k++)
+			{
+				hash = (hash ^ ((const u64*)p)[k]) * 0x100000001b3ull;
+			}
+		};
+
+		for(size_t j = 0; j < countof(s_case); j++)
+		{
+			const u8* src = buff + s_case[j].offset;
+
+			GIFRegBITBLTBUF BITBLTBUF;
+
+			BITBLTBUF.U64 = 0;
+			BITBLTBUF.SBW = 4;
+			BITBLTBUF.SPSM = s_format[i].psm;
+			BITBLTBUF.DBW = 4;
+			BITBLTBUF.DPSM = s_format[i].psm;
+
+			GIFRegTRXPOS TRXPOS;
+
+			TRXPOS.U64 = 0;
+			TRXPOS.SSAX = TRXPOS.DSAX = s_case[j].x;
+			TRXPOS.SSAY = TRXPOS.DSAY = s_case[j].y;
+
+			GIFRegTRXREG TRXREG;
+
+			TRXREG.U64 = 0;
+			TRXREG.RRW = s_case[j].w;
+			TRXREG.RRH = s_case[j].h;
+
+			int len = s_case[j].w * s_case[j].h * psm.trbpp >> 3;
+
+			auto start = std::chrono::steady_clock::now();
+
+			for(int k = 0; k < n; k++)
+			{
+				int x = s_case[j].x;
+				int y = s_case[j].y;
+
+				psm.wi(*mem, x, y, src, len, BITBLTBUF, TRXPOS, TRXREG);
+			}
+
+			double write = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			start = std::chrono::steady_clock::now();
+
+			for(int k = 0; k < n; k++)
+			{
+				int x = s_case[j].x;
+				int y = s_case[j].y;
+
+				psm.ri(*mem, x, y, dst, len, BITBLTBUF, TRXPOS, TRXREG);
+			}
+
+			double read = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			double texture = 0;
+
+			if(j == 0)
+			{
+				GSOffset* off = mem->GetOffset(0, 4, s_format[i].psm);
+				GSVector4i r(0, 0, s_case[j].w, s_case[j].h);
+				GIFRegTEXA TEXA;
+
+				TEXA.U64 = 0;
+
+				start = std::chrono::steady_clock::now();
+
+				for(int k = 0; k < n; k++)
+				{
+					psm.rtx(*mem, off, r, dst, s_case[j].w * 4, TEXA);
+				}
+
+				texture = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+				add(dst, s_case[j].w * s_case[j].h * 4);
+			}
+
+			double mb = (double)len * n / (1024 * 1024);
+
+			std::string str = format("GSBenchmark: %-4s %-7s write %7.0f MB/s  read %7.0f MB/s", s_format[i].name, s_case[j].name, mb / write, mb / read);
+
+			if(texture > 0)
+			{
+				str += format("  texture %7.0f MB/s", s_case[j].w * s_case[j].h * 4.0 * n / (1024 * 1024) / texture);
+			}
+
+			log_cb(RETRO_LOG_INFO, "%s\n", str.c_str());
+		}
+
+		add(mem->m_vm8, GSLocalMemory::m_vmsize);
+
+		log_cb(RETRO_LOG_INFO, "GSBenchmark: %-4s hash %016llx\n", s_format[i].name, (unsigned long long)hash);
+	}
+
+	_aligned_free(dst);
+	_aligned_free(buff);
+
+	delete mem;
+}
+
+// Vertex bounds (GSVertexTrace::FindMinMax) of 3, 300 and 30000 vertex draws, the hash covers
+// the min/max it found so the instruction sets can be compared
+
+static void BenchmarkVertexTrace(int loops)
+{
+	static const struct {GS_PRIM_CLASS primclass; u32 fst; const char* name;} s_trace[] =
+	{
+		{GS_TRIANGLE_CLASS, 0, "tri stq"},
+		{GS_TRIANGLE_CLASS, 1, "tri uv"},
+		{GS_SPRITE_CLASS, 1, "sprite"},
+	};
+
+	static const int s_count[] = {3, 300, 30000};
+
+	GSRendererNull* state = new GSRendererNull();
+	GSVertexTrace* vt = new GSVertexTrace(state);
+
+	GSVertex* vertex = (GSVertex*)_aligned_malloc(sizeof(GSVertex) * 30000, 32);
+	u32* index = (u32*)_aligned_malloc(sizeof(u32) * 30000, 32);
+
+	u32 seed = 1;
+
+	auto rnd = [&seed]() {seed = seed * 1664525u + 1013904223u; return seed >> 8;};
+
+	for(int i = 0; i < 30000; i++)
+	{
+		GSVertex& v = vertex[i];
+
+		v.ST.S = (float)(rnd() & 0xffff) / 0x10000;
+		v.ST.T = (float)(rnd() & 0xffff) / 0x10000;
+		v.RGBAQ.U32[0] = rnd() | (rnd() << 24);
+		v.RGBAQ.Q = 0.5f + (float)(rnd() & 0xffff) / 0x10000;
+		v.XYZ.X = (u16)(0x8000 + (rnd() & 0x3fff));
+		v.XYZ.Y = (u16)(0x8000 + (rnd() & 0x3fff));
+		v.XYZ.Z = rnd();
+		v.UV = rnd() & 0x3fff3fff;
+		v.FOG = rnd() & 0xff;
+
+		index[i] = i;
+	}
+
+	u64 hash = 0xcbf29ce484222325ull;
+
+	for(size_t i = 0; i < countof(s_trace); i++)
+	{
+		state->PRIM->IIP = 1;
+		state->PRIM->TME = 1;
+		state->PRIM->FST = s_trace[i].fst;
+
+		for(size_t j = 0; j < countof(s_count); j++)
+		{
+			int count = s_trace[i].primclass == GS_SPRITE_CLASS ? s_count[j] & ~1 : s_count[j];
+			int n = std::max(3000000 / count, 1) * std::max(loops, 1);
+
+			auto start = std::chrono::steady_clock::now();
+
+			for(int k = 0; k < n; k++)
+			{
+				vt->Update(vertex, index, count, count, s_trace[i].primclass);
+			}
+
+			double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			const GSVertexTrace::Vertex* minmax[] = {&vt->m_min, &vt->m_max};
+
+			for(const GSVertexTrace::Vertex* m : minmax)
+			{
+				for(size_t k = 0; k < sizeof(*m) / 8; k++)
+				{
+					hash = (hash ^ ((const u64*)m)[k]) * 0x100000001b3ull;
+				}
+			}
+
+			log_cb(RETRO_LOG_INFO, "GSBenchmark: trace %-7s %5d vertices %8.1f Mvertices/s\n", s_trace[i].name, count, (double)count * n / 1000000 / t);
+		}
+	}
+
+	log_cb(RETRO_LOG_INFO, "GSBenchmark: trace hash %016llx\n", (unsigned long long)hash);
+
+	_aligned_free(index);
+	_aligned_free(vertex);
+
+	delete vt;
+	delete state;
+}
+
+// Texture cache invalidation (GSTextureCache::InvalidateVideoMem) on the null device. Each
+// frame of the sequence uploads textures, a frame sized image and a block over the texture
+// pool, and draws to a chain of post processing targets, over a cache holding the targets
+// and a few hundred small (1 to 4 pages) or large (16 to 32 pages) sources.
+
+static void BenchmarkTextureCache(int loops)
+{
+	static const struct {u32 bp, bw, psm; int w, h, type;} s_target[] =
+	{
+		{0x0000, 10, PSM_PSMCT32, 640, 448, GSTextureCache::RenderTarget},
+		{0x1180, 10, PSM_PSMZ32, 640, 448, GSTextureCache::DepthStencil},
+		{0x2300, 2, PSM_PSMCT32, 128, 128, GSTextureCache::RenderTarget},
+		{0x2400, 2, PSM_PSMCT32, 128, 128, GSTextureCache::RenderTarget},
+		{0x2500, 2, PSM_PSMCT32, 128, 128, GSTextureCache::RenderTarget},
+		{0x2600, 2, PSM_PSMCT32, 128, 128, GSTextureCache::RenderTarget},
+		{0x2700, 1, PSM_PSMCT32, 64, 64, GSTextureCache::RenderTarget},
+		{0x2720, 1, PSM_PSMCT32, 64, 64, GSTextureCache::RenderTarget},
+		{0x2740, 1, PSM_PSMCT32, 64, 64, GSTextureCache::RenderTarget},
+		{0x2760, 1, PSM_PSMCT32, 64, 64, GSTextureCache::RenderTarget},
+	};
+
+	static const struct {u32 bw, psm, tw, th;} s_texture[2][5] =
+	{
+		{
+			{2, PSM_PSMT8, 7, 7},
+			{1, PSM_PSMCT32, 6, 6},
+			{2, PSM_PSMT4, 7, 7},
+			{4, PSM_PSMCT16, 8, 6},
+			{2, PSM_PSMT8, 8, 7}, // repeating
+		},
+		{
+			{4, PSM_PSMCT32, 8, 8},
+			{8, PSM_PSMCT16, 9, 8},
+			{4, PSM_PSMT8, 8, 8},
+			{8, PSM_PSMT4, 9, 9},
+			{4, PSM_PSMCT32, 9, 8}, // repeating
+		},
+	};
+
+	static const char* s_texture_name[2] = {"small", "large"};
+
+	const int sources = 256;
+	const int frames = 200 * std::max(loops, 1);
+
+	u32 seed = 1;
+
+	auto rnd = [&seed]() {seed = seed * 1664525u + 1013904223u; return seed >> 8;};
+
+	for(int n = 0; n < 2; n++)
+	{
+		GSRendererNull* renderer = new GSRendererNull();
+
+		renderer->CreateDevice(new GSDeviceNull());
+
+		GSTextureCacheNull* tc = new GSTextureCacheNull(renderer);
+
+		GIFRegTEXA TEXA;
+
+		TEXA.U64 = 0;
+
+		std::vector<GIFRegTEX0> texture(sources);
+
+		for(int i = 0; i < sources; i++)
+		{
+			GIFRegTEX0& TEX0 = texture[i];
+
+			TEX0.U64 = 0;
+			TEX0.TBP0 = 0x2800 + (rnd() % (0x3800 - 0x2800));
+			TEX0.TBW = s_texture[n][i % 5].bw;
+			TEX0.PSM = s_texture[n][i % 5].psm;
+			TEX0.TW = s_texture[n][i % 5].tw;
+			TEX0.TH = s_texture[n][i % 5].th;
+			TEX0.TCC = 1;
+			TEX0.CBP = 0x3fc0;
+		}
+
+		double t = 0;
+		int transfers = 0;
+
+		for(int k = 0; k < frames; k++)
+		{
+			for(size_t i = 0; i < countof(s_target); i++)
+			{
+				GIFRegTEX0 TEX0;
+
+				TEX0.U64 = 0;
+				TEX0.TBP0 = s_target[i].bp;
+				TEX0.TBW = s_target[i].bw;
+				TEX0.PSM = s_target[i].psm;
+
+				tc->LookupTarget(TEX0, s_target[i].w, s_target[i].h, s_target[i].type, true);
+			}
+
+			for(const GIFRegTEX0& TEX0 : texture)
+			{
+				renderer->m_context->offset.tex = renderer->m_mem.GetOffset(TEX0.TBP0, TEX0.TBW, TEX0.PSM); // as GSState::ApplyTEX0
+
+				tc->LookupSource(TEX0, TEXA, GSVector4i(0, 0, 1 << TEX0.TW, 1 << TEX0.TH));
+			}
+
+			auto start = std::chrono::steady_clock::now();
+
+			for(int i = 0; i < 16; i++)
+			{
+				const GIFRegTEX0& TEX0 = texture[(k * 16 + i) % sources];
+
+				tc->InvalidateVideoMem(renderer->m_mem.GetOffset(TEX0.TBP0, TEX0.TBW, TEX0.PSM), GSVector4i(0, 0, 1 << TEX0.TW, 1 << TEX0.TH));
+			}
+
+			tc->InvalidateVideoMem(renderer->m_mem.GetOffset(0, 10, PSM_PSMCT32), GSVector4i(0, 0, 640, 448));
+			tc->InvalidateVideoMem(renderer->m_mem.GetOffset(0x2800 + (k & 7) * 0x200, 8, PSM_PSMCT32), GSVector4i(0, 0, 512, 256));
+
+			for(size_t i = 2; i < countof(s_target); i++)
+			{
+				tc->InvalidateVideoMem(renderer->m_mem.GetOffset(s_target[i].bp, s_target[i].bw, s_target[i].psm), GSVector4i(0, 0, s_target[i].w, s_target[i].h), false);
+			}
+
+			tc->InvalidateVideoMem(renderer->m_mem.GetOffset(0, 10, PSM_PSMCT32), GSVector4i(0, 0, 640, 448), false);
+
+			t += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			transfers += 16 + 2 + (int)countof(s_target) - 2 + 1;
+		}
+
+		log_cb(RETRO_LOG_INFO, "GSBenchmark: tc %-5s %d transfers %8.2f us/transfer\n", s_texture_name[n], transfers, t * 1000000 / transfers);
+
+		delete tc;
+		delete renderer;
+	}
+
+}
+
+int GSBenchmark(int loops)
+{
+	BenchmarkTransfer(loops);
+	BenchmarkVertexTrace(loops);
+	BenchmarkTextureCache(loops);
+
+	return 0;
+}
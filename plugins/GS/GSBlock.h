@@ -26,43 +26,35 @@
 #include "GS.h"
 #include "GSTables.h"
 #include "GSVector.h"
+#include "GSMultiISA.h"
+
+MULTI_ISA_UNSHARED_START
 
 class GSBlock
 {
-	#if _M_SSE >= 0x501
-	static GSVector8i m_r16mask;
-	#else
-	static GSVector4i m_r16mask;
-	#endif
-	static GSVector4i m_r8mask;
-	static GSVector4i m_r4mask;
-
-	#if _M_SSE >= 0x501
-	static GSVector8i m_xxxa;
-	static GSVector8i m_xxbx;
-	static GSVector8i m_xgxx;
-	static GSVector8i m_rxxx;
+	// The masks are built in place rather than kept in statics so the class carries no
+	// state of its own and can be compiled once per instruction set.
+
+	#if defined(_M_AVX2)
+	__forceinline static GSVector8i r16mask() {return GSVector8i(0, 1, 4, 5, 2, 3, 6, 7, 8, 9, 12, 13, 10, 11, 14, 15, 0, 1, 4, 5, 2, 3, 6, 7, 8, 9, 12, 13, 10, 11, 14, 15);}
 	#else
-	static GSVector4i m_xxxa;
-	static GSVector4i m_xxbx;
-	static GSVector4i m_xgxx;
-	static GSVector4i m_rxxx;
+	__forceinline static GSVector4i r16mask() {return GSVector4i(0, 1, 4, 5, 2, 3, 6, 7, 8, 9, 12, 13, 10, 11, 14, 15);}
 	#endif
+	__forceinline static GSVector4i r8mask() {return GSVector4i(0, 4, 2, 6, 8, 12, 10, 14, 1, 5, 3, 7, 9, 13, 11, 15);}
+	__forceinline static GSVector4i r4mask() {return GSVector4i(0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15);}
 
-	static GSVector4i m_uw8hmask0;
-	static GSVector4i m_uw8hmask1;
-	static GSVector4i m_uw8hmask2;
-	static GSVector4i m_uw8hmask3;
+	__forceinline static GSVector4i uw8hmask0() {return GSVector4i(0, 0, 0, 0, 1, 1, 1, 1, 8, 8, 8, 8, 9, 9, 9, 9);}
+	__forceinline static GSVector4i uw8hmask1() {return GSVector4i(2, 2, 2, 2, 3, 3, 3, 3, 10, 10, 10, 10, 11, 11, 11, 11);}
+	__forceinline static GSVector4i uw8hmask2() {return GSVector4i(4, 4, 4, 4, 5, 5, 5, 5, 12, 12, 12, 12, 13, 13, 13, 13);}
+	__forceinline static GSVector4i uw8hmask3() {return GSVector4i(6, 6, 6, 6, 7, 7, 7, 7, 14, 14, 14, 14, 15, 15, 15, 15);}
 
 public:
-	static void InitVectors();
-
 	template<int i, int alignment, u32 mask> __forceinline static void WriteColumn32(u8* RESTRICT dst, const u8* RESTRICT src, int srcpitch)
 	{
 		const u8* RESTRICT s0 = &src[srcpitch * 0];
 		const u8* RESTRICT s1 = &src[srcpitch * 1];
 
-		#if _M_SSE >= 0x501
+		#if defined(_M_AVX2)
 
 		GSVector8i v0, v1;
 
@@ -198,7 +190,7 @@ public:
 
 		// for(int j = 0; j < 16; j++) {((u16*)s0)[j] = columnTable16[0][j]; ((u16*)s1)[j] = columnTable16[1][j];}
 
-		#if _M_SSE >= 0x501
+		#if defined(_M_AVX2)
 
 		GSVector8i v0, v1;
 
@@ -268,7 +260,7 @@ public:
 	{
 		// TODO: read unaligned as WriteColumn32 does and try saving a few shuffles
 
-		#if _M_SSE >= 0x501
+		#if defined(_M_AVX2)
 
 		GSVector4i v4 = GSVector4i::load<alignment != 0>(&src[srcpitch * 0]);
 		GSVector4i v5 = GSVector4i::load<alignment != 0>(&src[srcpitch * 1]);
@@ -334,6 +326,42 @@ public:
 
 		// TODO: pshufb
 
+		#if defined(_M_AVX2)
+
+		GSVector4i v4 = GSVector4i::load<alignment != 0>(&src[srcpitch * 0]);
+		GSVector4i v5 = GSVector4i::load<alignment != 0>(&src[srcpitch * 1]);
+		GSVector4i v6 = GSVector4i::load<alignment != 0>(&src[srcpitch * 2]);
+		GSVector4i v7 = GSVector4i::load<alignment != 0>(&src[srcpitch * 3]);
+
+		if((i & 1) == 0)
+		{
+			v6 = v6.yxwzlh();
+			v7 = v7.yxwzlh();
+		}
+		else
+		{
+			v4 = v4.yxwzlh();
+			v5 = v5.yxwzlh();
+		}
+
+		// same swizzle as below with rows 0/1 and 2/3 sharing a register, the final
+		// sw64 and the register pairing it needs fold into a single qword permute
+
+		GSVector8i v0(v4, v5);
+		GSVector8i v1(v6, v7);
+
+		GSVector8i::sw4(v0, v1);
+		GSVector8i::sw8(v0, v1);
+		GSVector8i::sw8(v0, v1);
+
+		v0 = v0.acbd();
+		v1 = v1.acbd();
+
+		((GSVector8i*)dst)[i * 2 + 0] = v0;
+		((GSVector8i*)dst)[i * 2 + 1] = v1;
+
+		#else
+
 		GSVector4i v0 = GSVector4i::load<alignment != 0>(&src[srcpitch * 0]);
 		GSVector4i v1 = GSVector4i::load<alignment != 0>(&src[srcpitch * 1]);
 		GSVector4i v2 = GSVector4i::load<alignment != 0>(&src[srcpitch * 2]);
@@ -359,6 +387,8 @@ public:
 		((GSVector4i*)dst)[i * 4 + 1] = v1;
 		((GSVector4i*)dst)[i * 4 + 2] = v2;
 		((GSVector4i*)dst)[i * 4 + 3] = v3;
+
+		#endif
 	}
 
 	template<int alignment, u32 mask> static void WriteColumn32(int y, u8* RESTRICT dst, const u8* RESTRICT src, int srcpitch)
@@ -455,7 +485,7 @@ public:
 
 	template<int i> __forceinline static void ReadColumn32(const u8* RESTRICT src, u8* RESTRICT dst, int dstpitch)
 	{
-		#if _M_SSE >= 0x501
+		#if defined(_M_AVX2)
 
 		const GSVector8i* s = (const GSVector8i*)src;
 		
@@ -492,12 +522,12 @@ public:
 
 	template<int i> __forceinline static void ReadColumn16(const u8* RESTRICT src, u8* RESTRICT dst, int dstpitch)
 	{
-		#if _M_SSE >= 0x501
+		#if defined(_M_AVX2)
 
 		const GSVector8i* s = (const GSVector8i*)src;
 		
-		GSVector8i v0 = s[i * 2 + 0].shuffle8(m_r16mask);
-		GSVector8i v1 = s[i * 2 + 1].shuffle8(m_r16mask);
+		GSVector8i v0 = s[i * 2 + 0].shuffle8(r16mask());
+		GSVector8i v1 = s[i * 2 + 1].shuffle8(r16mask());
 
 		GSVector8i::sw128(v0, v1);
 		GSVector8i::sw32(v0, v1);
@@ -512,10 +542,10 @@ public:
 
 		const GSVector4i* s = (const GSVector4i*)src;
 
-		GSVector4i v0 = s[i * 4 + 0].shuffle8(m_r16mask);
-		GSVector4i v1 = s[i * 4 + 1].shuffle8(m_r16mask);
-		GSVector4i v2 = s[i * 4 + 2].shuffle8(m_r16mask);
-		GSVector4i v3 = s[i * 4 + 3].shuffle8(m_r16mask);
+		GSVector4i v0 = s[i * 4 + 0].shuffle8(r16mask());
+		GSVector4i v1 = s[i * 4 + 1].shuffle8(r16mask());
+		GSVector4i v2 = s[i * 4 + 2].shuffle8(r16mask());
+		GSVector4i v3 = s[i * 4 + 3].shuffle8(r16mask());
 
 		GSVector4i::sw32(v0, v1, v2, v3);
 		GSVector4i::sw64(v0, v1, v2, v3);
@@ -603,10 +633,10 @@ public:
 			v1 = s[i * 4 + 3];
 		}
 
-		v0 = v0.shuffle8(m_r8mask);
-		v1 = v1.shuffle8(m_r8mask);
-		v2 = v2.shuffle8(m_r8mask);
-		v3 = v3.shuffle8(m_r8mask);
+		v0 = v0.shuffle8(r8mask());
+		v1 = v1.shuffle8(r8mask());
+		v2 = v2.shuffle8(r8mask());
+		v3 = v3.shuffle8(r8mask());
 
 		GSVector4i::sw16(v0, v1, v2, v3);
 		GSVector4i::sw32(v0, v1, v3, v2);
@@ -666,10 +696,10 @@ public:
 		GSVector4i::sw4(v0, v2, v1, v3);
 		GSVector4i::sw8(v0, v1, v2, v3);
 
-		v0 = v0.shuffle8(m_r4mask);
-		v1 = v1.shuffle8(m_r4mask);
-		v2 = v2.shuffle8(m_r4mask);
-		v3 = v3.shuffle8(m_r4mask);
+		v0 = v0.shuffle8(r4mask());
+		v1 = v1.shuffle8(r4mask());
+		v2 = v2.shuffle8(r4mask());
+		v3 = v3.shuffle8(r4mask());
 
 		if((i & 1) == 0)
 		{
@@ -884,7 +914,7 @@ public:
 
 	__forceinline static void ReadBlock8HP(const u8* RESTRICT src, u8* RESTRICT dst, int dstpitch)
 	{
-		#if _M_SSE >= 0x501
+		#if defined(_M_AVX2)
 
 		u8* RESTRICT d0 = &dst[dstpitch * 0];
 		u8* RESTRICT d1 = &dst[dstpitch * 4];
@@ -955,7 +985,7 @@ public:
 
 	__forceinline static void ReadBlock4HLP(const u8* RESTRICT src, u8* RESTRICT dst, int dstpitch)
 	{
-		#if _M_SSE >= 0x501
+		#if defined(_M_AVX2)
 
 		u8* RESTRICT d0 = &dst[dstpitch * 0];
 		u8* RESTRICT d1 = &dst[dstpitch * 4];
@@ -1029,7 +1059,7 @@ public:
 
 	__forceinline static void ReadBlock4HHP(const u8* RESTRICT src, u8* RESTRICT dst, int dstpitch)
 	{
-		#if _M_SSE >= 0x501
+		#if defined(_M_AVX2)
 
 		u8* RESTRICT d0 = &dst[dstpitch * 0];
 		u8* RESTRICT d1 = &dst[dstpitch * 4];
@@ -1105,12 +1135,12 @@ public:
 
 	template<bool AEM, class V> __forceinline static V Expand16to32(const V& c, const V& TA0, const V& TA1)
 	{
-		return ((c & m_rxxx) << 3) | ((c & m_xgxx) << 6) | ((c & m_xxbx) << 9) | (AEM ? TA0.blend8(TA1, c.sra16(15)).andnot(c == V::zero()) : TA0.blend(TA1, c.sra16(15)));
+		return ((c & V(0x0000001f)) << 3) | ((c & V(0x000003e0)) << 6) | ((c & V(0x00007c00)) << 9) | (AEM ? TA0.blend8(TA1, c.sra16(15)).andnot(c == V::zero()) : TA0.blend(TA1, c.sra16(15)));
 	}
 
 	template<bool AEM> static void ExpandBlock24(const u32* RESTRICT src, u8* RESTRICT dst, int dstpitch, const GIFRegTEXA& TEXA)
 	{
-		#if _M_SSE >= 0x501
+		#if defined(_M_AVX2)
 
 		const GSVector8i* s = (const GSVector8i*)src;
 
@@ -1157,7 +1187,7 @@ public:
 
 	template<bool AEM> static void ExpandBlock16(const u16* RESTRICT src, u8* RESTRICT dst, int dstpitch, const GIFRegTEXA& TEXA) // do not inline, uses too many xmm regs
 	{
-		#if _M_SSE >= 0x501
+		#if defined(_M_AVX2)
 		
 		const GSVector8i* s = (const GSVector8i*)src;
 
@@ -1334,7 +1364,7 @@ public:
 
 	__forceinline static void UnpackAndWriteBlock24(const u8* RESTRICT src, int srcpitch, u8* RESTRICT dst)
 	{
-		#if _M_SSE >= 0x501
+		#if defined(_M_AVX2)
 
 		const u8* RESTRICT s0 = &src[srcpitch * 0];
 		const u8* RESTRICT s1 = &src[srcpitch * 1];
@@ -1423,7 +1453,7 @@ public:
 	{
 		GSVector4i v4, v5, v6, v7;
 
-		#if _M_SSE >= 0x501
+		#if defined(_M_AVX2)
 
 		GSVector8i v0, v1, v2, v3;
 		GSVector8i mask = GSVector8i::xff000000();
@@ -1470,10 +1500,10 @@ public:
 
 		GSVector4i v0, v1, v2, v3;
 		GSVector4i mask = GSVector4i::xff000000();
-		GSVector4i mask0 = m_uw8hmask0;
-		GSVector4i mask1 = m_uw8hmask1;
-		GSVector4i mask2 = m_uw8hmask2;
-		GSVector4i mask3 = m_uw8hmask3;
+		GSVector4i mask0 = uw8hmask0();
+		GSVector4i mask1 = uw8hmask1();
+		GSVector4i mask2 = uw8hmask2();
+		GSVector4i mask3 = uw8hmask3();
 
 		for(int i = 0; i < 4; i++, src += srcpitch * 2)
 		{
@@ -1532,7 +1562,7 @@ public:
 
 		GSVector4i v4, v5, v6, v7;
 
-		#if _M_SSE >= 0x501
+		#if defined(_M_AVX2)
 
 		GSVector8i v0, v1, v2, v3;
 		GSVector8i mask(0x0f000000);
@@ -1579,10 +1609,10 @@ public:
 
 		GSVector4i v0, v1, v2, v3;
 		GSVector4i mask = GSVector4i(0x0f000000);
-		GSVector4i mask0 = m_uw8hmask0;
-		GSVector4i mask1 = m_uw8hmask1;
-		GSVector4i mask2 = m_uw8hmask2;
-		GSVector4i mask3 = m_uw8hmask3;
+		GSVector4i mask0 = uw8hmask0();
+		GSVector4i mask1 = uw8hmask1();
+		GSVector4i mask2 = uw8hmask2();
+		GSVector4i mask3 = uw8hmask3();
 
 		for(int i = 0; i < 2; i++, src += srcpitch * 4)
 		{
@@ -1660,7 +1690,7 @@ public:
 	{
 		GSVector4i v4, v5, v6, v7;
 
-		#if _M_SSE >= 0x501
+		#if defined(_M_AVX2)
 
 		GSVector8i v0, v1, v2, v3;
 		GSVector8i mask = GSVector8i::xf0000000();
@@ -1707,10 +1737,10 @@ public:
 
 		GSVector4i v0, v1, v2, v3;
 		GSVector4i mask = GSVector4i::xf0000000();
-		GSVector4i mask0 = m_uw8hmask0;
-		GSVector4i mask1 = m_uw8hmask1;
-		GSVector4i mask2 = m_uw8hmask2;
-		GSVector4i mask3 = m_uw8hmask3;
+		GSVector4i mask0 = uw8hmask0();
+		GSVector4i mask1 = uw8hmask1();
+		GSVector4i mask2 = uw8hmask2();
+		GSVector4i mask3 = uw8hmask3();
 
 		for(int i = 0; i < 2; i++, src += srcpitch * 4)
 		{
@@ -1786,7 +1816,7 @@ public:
 
 	template<bool AEM> __forceinline static void ReadAndExpandBlock24(const u8* RESTRICT src, u8* RESTRICT dst, int dstpitch, const GIFRegTEXA& TEXA)
 	{
-		#if _M_SSE >= 0x501
+		#if defined(_M_AVX2)
 
 		const GSVector8i* s = (const GSVector8i*)src;
 		
@@ -1862,7 +1892,7 @@ public:
 
 	template<bool AEM> __forceinline static void ReadAndExpandBlock16(const u8* RESTRICT src, u8* RESTRICT dst, int dstpitch, const GIFRegTEXA& TEXA)
 	{
-		#if _M_SSE >= 0x501
+		#if defined(_M_AVX2)
 
 		const GSVector8i* s = (const GSVector8i*)src;
 
@@ -1871,8 +1901,8 @@ public:
 
 		for(int i = 0; i < 4; i++, dst += dstpitch * 2)
 		{
-			GSVector8i v0 = s[i * 2 + 0].shuffle8(m_r16mask);
-			GSVector8i v1 = s[i * 2 + 1].shuffle8(m_r16mask);
+			GSVector8i v0 = s[i * 2 + 0].shuffle8(r16mask());
+			GSVector8i v1 = s[i * 2 + 1].shuffle8(r16mask());
 
 			GSVector8i::sw128(v0, v1);
 			GSVector8i::sw32(v0, v1);
@@ -1939,7 +1969,7 @@ public:
 		const GSVector4i* s = (const GSVector4i*)src;
 
 		GSVector4i v0, v1, v2, v3;
-		GSVector4i mask = m_r8mask;
+		GSVector4i mask = r8mask();
 
 		for(int i = 0; i < 2; i++)
 		{
@@ -2000,7 +2030,7 @@ public:
 		const GSVector4i* s = (const GSVector4i*)src;
 
 		GSVector4i v0, v1, v2, v3;
-		GSVector4i mask = m_r4mask;
+		GSVector4i mask = r4mask();
 
 		for(int i = 0; i < 2; i++)
 		{
@@ -2197,3 +2227,5 @@ public:
 
 	// TODO: ReadAndExpandBlock4HH_16
 };
+
+MULTI_ISA_UNSHARED_END
@@ -22,6 +22,8 @@
 #include "stdafx.h"
 #include "GSClut.h"
 #include "GSLocalMemory.h"
+#include "GSUtil.h"
+#include "options_tools.h"
 
 #define CLUT_ALLOC_SIZE (2 * 4096)
 
@@ -36,6 +38,23 @@ GSClut::GSClut(GSLocalMemory* mem)
 	m_write.dirty = true;
 	m_read.dirty = true;
 
+	m_base32 = m_buff32;
+	m_base64 = m_buff64;
+
+	m_cache = (CacheEntry*)_aligned_malloc(sizeof(CacheEntry) * CACHE_SIZE, 32);
+
+	for (int i = 0; i < CACHE_SIZE; i++)
+	{
+		m_cache[i].key = 0;
+		m_cache[i].used = 0;
+	}
+
+	m_entry = NULL;
+	m_pending = false;
+	m_used = 0;
+
+	memset(&m_stats, 0, sizeof(m_stats));
+
 	for (int i = 0; i < 16; i++)
 	{
 		for (int j = 0; j < 64; j++)
@@ -105,6 +124,14 @@ GSClut::GSClut(GSLocalMemory* mem)
 
 GSClut::~GSClut()
 {
+	if (m_stats.hits + m_stats.misses > 0)
+	{
+		log_cb(RETRO_LOG_INFO, "GSdx: clut cache hit %llu of %llu loads\n",
+			(unsigned long long)m_stats.hits, (unsigned long long)(m_stats.hits + m_stats.misses));
+	}
+
+	_aligned_free(m_cache);
+
 	vmfree(m_clut, CLUT_ALLOC_SIZE);
 }
 
@@ -163,7 +190,172 @@ void GSClut::Write(const GIFRegTEX0& TEX0, const GIFRegTEXCLUT& TEXCLUT)
 	m_write.dirty = false;
 	m_read.dirty = true;
 
-	(this->*m_wc[TEX0.CSM][TEX0.CPSM][TEX0.PSM])(TEX0, TEXCLUT);
+	writeCLUT wc = m_wc[TEX0.CSM][TEX0.CPSM][TEX0.PSM];
+
+	if (TEX0.CSM == 0 && wc != &GSClut::WriteCLUT_NULL)
+	{
+		// the blocks WriteCLUT*_CSM1 read from (same count as ApplyTEX0 invalidates)
+
+		int blocks = 4;
+
+		if (GSLocalMemory::m_psm[TEX0.CPSM].bpp == 16)
+			blocks >>= 1;
+
+		if (GSLocalMemory::m_psm[TEX0.PSM].bpp == 4)
+			blocks >>= 1;
+
+		// CBP + i wraps at the end of local memory like the reads of WriteCLUT*_CSM1 do
+
+		const u8* src[4];
+
+		u64 key = 0;
+
+		for (int i = 0; i < blocks; i++)
+		{
+			src[i] = m_mem->BlockPtr(TEX0.CBP + i);
+
+			key = (key ^ GSUtil::HashBlock(src[i])) * 0x9e3779b97f4a7c15ull;
+		}
+
+		key |= 1;
+
+		u32 desc = CacheDesc(TEX0);
+
+		CacheEntry* lru = &m_cache[0];
+
+		for (int i = 0; i < CACHE_SIZE; i++)
+		{
+			CacheEntry* e = &m_cache[i];
+
+			if (e->key == key && e->desc == desc && SameBlocks(e, src, blocks))
+			{
+				m_stats.hits++;
+
+				e->used = ++m_used;
+
+				if (e != m_entry)
+				{
+					// a load with the same desc overwrites exactly the words of the pending one
+
+					if (m_pending && m_entry->desc != desc)
+						LoadEntry(m_entry);
+
+					m_entry = e;
+					m_pending = true;
+				}
+
+				SelectBuffers(e);
+
+				return;
+			}
+
+			if (e->used < lru->used)
+				lru = e;
+		}
+
+		m_stats.misses++;
+
+		if (m_pending && m_entry->desc != desc)
+			LoadEntry(m_entry);
+
+		m_pending = false;
+
+		(this->*wc)(TEX0, TEXCLUT);
+
+		StoreEntry(lru, TEX0);
+
+		for (int i = 0; i < blocks; i++)
+		{
+			memcpy(&lru->src[i << 8], src[i], 256);
+		}
+
+		lru->key = key;
+		lru->desc = desc;
+		lru->used = ++m_used;
+		lru->read.dirty = true;
+
+		m_entry = lru;
+
+		SelectBuffers(lru);
+
+		return;
+	}
+
+	if (m_pending)
+		LoadEntry(m_entry);
+
+	m_pending = false;
+	m_entry = NULL;
+
+	SelectBuffers(NULL);
+
+	(this->*wc)(TEX0, TEXCLUT);
+}
+
+bool GSClut::SameBlocks(const CacheEntry* e, const u8* const* src, int blocks)
+{
+	// the key is only a hash, the palette itself decides
+
+	for (int i = 0; i < blocks; i++)
+	{
+		if (memcmp(&e->src[i << 8], src[i], 256) != 0)
+			return false;
+	}
+
+	return true;
+}
+
+u32 GSClut::CacheDesc(const GIFRegTEX0& TEX0)
+{
+	return TEX0.CPSM | ((TEX0.PSM & 7) << 4) | (TEX0.CSA << 8);
+}
+
+void GSClut::StoreEntry(CacheEntry* e, const GIFRegTEX0& TEX0)
+{
+	const bool i8 = (TEX0.PSM & 7) == 3;
+
+	e->ct32 = GSLocalMemory::m_psm[TEX0.CPSM].bpp == 32;
+
+	if (e->ct32)
+	{
+		e->start = (TEX0.CSA & 15) << 4;
+		e->count = i8 ? 256 - e->start : 16;
+
+		memcpy(&e->clut[256], &m_clut[256 + e->start], e->count * sizeof(u16));
+	}
+	else
+	{
+		e->start = TEX0.CSA << 4;
+		e->count = i8 ? 256 : 16;
+	}
+
+	memcpy(&e->clut[0], &m_clut[e->start], e->count * sizeof(u16));
+}
+
+void GSClut::LoadEntry(const CacheEntry* e)
+{
+	memcpy(&m_clut[e->start], &e->clut[0], e->count * sizeof(u16));
+
+	if (e->ct32)
+	{
+		memcpy(&m_clut[256 + e->start], &e->clut[256], e->count * sizeof(u16));
+	}
+}
+
+void GSClut::SelectBuffers(CacheEntry* e)
+{
+	if (e != NULL)
+	{
+		m_buff32 = e->buff32;
+		m_buff64 = e->buff64;
+		m_read = e->read;
+	}
+	else
+	{
+		m_buff32 = m_base32;
+		m_buff64 = m_base64;
+		m_read.dirty = true;
+	}
 }
 
 void GSClut::WriteCLUT32_I8_CSM1(const GIFRegTEX0& TEX0, const GIFRegTEXCLUT& TEXCLUT)
@@ -308,6 +500,20 @@ void GSClut::Read32(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA)
 {
 	if (m_read.IsDirty(TEX0, TEXA))
 	{
+		// a palette read the way it was loaded is expanded into the buffers of its cache entry
+
+		CacheEntry* e = m_entry != NULL && m_entry->desc == CacheDesc(TEX0) ? m_entry : NULL;
+
+		if (m_pending)
+		{
+			LoadEntry(m_entry);
+
+			m_pending = false;
+		}
+
+		m_buff32 = e != NULL ? e->buff32 : m_base32;
+		m_buff64 = e != NULL ? e->buff64 : m_base64;
+
 		m_read.TEX0 = TEX0;
 		m_read.TEXA = TEXA;
 		m_read.dirty = false;
@@ -352,6 +558,11 @@ void GSClut::Read32(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA)
 					break;
 			}
 		}
+
+		if (e != NULL)
+		{
+			e->read = m_read;
+		}
 	}
 }
 
@@ -416,6 +627,11 @@ void GSClut::GetAlphaMinMax32(int& amin_out, int& amax_out)
 			m_read.amin = v0.min_i16(v1).extract16<0>();
 			m_read.amax = v0.max_i16(v1).extract16<1>();
 		}
+
+		if (m_entry != NULL && m_buff32 == m_entry->buff32)
+		{
+			m_entry->read = m_read;
+		}
 	}
 
 	amin_out = m_read.amin;
@@ -779,5 +995,9 @@ bool GSClut::ReadState::IsDirty(const GIFRegTEX0& TEX0)
 
 bool GSClut::ReadState::IsDirty(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA)
 {
-	return dirty || !GSVector4i::load<true>(this).eq(GSVector4i::load(&TEX0, &TEXA));
+	// only PSM, CPSM and CSA of TEX0 change the expanded clut
+
+	const GSVector4i mask(0x03f00000, 0x1f780000, 0xffffffff, 0xffffffff);
+
+	return dirty || !((GSVector4i::load<true>(this) ^ GSVector4i::load(&TEX0, &TEXA)) & mask).eq(GSVector4i::zero());
 }
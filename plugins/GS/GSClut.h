@@ -30,6 +30,10 @@ class GSLocalMemory;
 
 class alignas(32) GSClut : public GSAlignedClass<32>
 {
+public:
+	struct CacheStats {u64 hits, misses;};
+
+private:
 	static GSVector4i m_bm;
 	static GSVector4i m_gm;
 	static GSVector4i m_rm;
@@ -60,6 +64,42 @@ class alignas(32) GSClut : public GSAlignedClass<32>
 		bool IsDirty(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA);
 	} m_read;
 
+	// Expanded cluts of recent CSM1 loads, keyed by the content of the palette blocks. A hit
+	// restores the clut words the load produced and the expanded m_buff32/m_buff64 without
+	// reading local memory or expanding again. The key is a hash of the blocks, so a hit is
+	// only taken once the blocks also compare equal to the copy kept in the entry.
+
+	enum { CACHE_SIZE = 8 };
+
+	struct alignas(32) CacheEntry
+	{
+		ReadState read; // read state the buffers were expanded for
+		u64 key;        // 0: unused
+		u32 desc;       // CPSM, index size and CSA of the load
+		u32 used;
+		u16 start, count; // m_clut words written by the load
+		bool ct32;        // the upper halves are at +256
+		alignas(32) u8 src[1024]; // the palette blocks the load read
+		alignas(32) u16 clut[512];
+		alignas(32) u32 buff32[256];
+		alignas(32) u64 buff64[256];
+	};
+
+	CacheEntry* m_cache;
+	CacheEntry* m_entry; // the cached load m_clut holds, its words are not copied into m_clut yet while m_pending
+	bool m_pending;
+	u32 m_used;
+	u32* m_base32;
+	u64* m_base64;
+
+	CacheStats m_stats;
+
+	static u32 CacheDesc(const GIFRegTEX0& TEX0);
+	static bool SameBlocks(const CacheEntry* e, const u8* const* src, int blocks);
+	void StoreEntry(CacheEntry* e, const GIFRegTEX0& TEX0);
+	void LoadEntry(const CacheEntry* e);
+	void SelectBuffers(CacheEntry* e);
+
 	typedef void (GSClut::*writeCLUT)(const GIFRegTEX0& TEX0, const GIFRegTEXCLUT& TEXCLUT);
 
 	writeCLUT m_wc[2][16][64];
@@ -110,8 +150,10 @@ public:
 	void Read32(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA);
 	void GetAlphaMinMax32(int& amin, int& amax);
 
+	const CacheStats& GetCacheStats() const {return m_stats;}
+
 	u32 operator [] (size_t i) const {return m_buff32[i];}
 
-	operator const u32*() const  {return m_buff32;}
-	operator const u64*() const {return m_buff64;}
+	__forceinline operator const u32*() const {return m_buff32;}
+	__forceinline operator const u64*() const {return m_buff64;}
 };
@@ -180,6 +180,7 @@ public:
 	{
 		PointListPalette = 1,
 		TextureInsideRt = 2,
+		AsyncReadback = 4, // local -> host transfers of targets may return the previous frame
 	};
 
 	struct Game
@@ -0,0 +1,248 @@
+/*
+ *	Copyright (C) 2007-2009 Gabest
+ *	http://www.gabest.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNU Make; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "stdafx.h"
+#include "GSDump.h"
+#include "options_tools.h"
+
+GSDumpBase::GSDumpBase(const std::string& fn)
+	: m_frames(0)
+{
+	m_gs = fopen(fn.c_str(), "wb");
+	if (!m_gs)
+		log_cb(RETRO_LOG_ERROR, "GSdx: Error creating dump file %s\n", fn.c_str());
+}
+
+GSDumpBase::~GSDumpBase()
+{
+	if (m_gs)
+		fclose(m_gs);
+}
+
+void GSDumpBase::AddHeader(u32 crc, const GSFreezeData& fd, const GSPrivRegSet* regs)
+{
+	AppendRawData(&crc, 4);
+	AppendRawData(&fd.size, 4);
+	AppendRawData(fd.data, fd.size);
+	AppendRawData(regs, sizeof(*regs));
+}
+
+void GSDumpBase::Transfer(int index, const u8* mem, size_t size)
+{
+	if (size == 0)
+		return;
+
+	AppendRawData(static_cast<u8>(GSDumpPacketType::Transfer));
+	AppendRawData(static_cast<u8>(index));
+	u32 bytes = static_cast<u32>(size);
+	AppendRawData(&bytes, 4);
+	AppendRawData(mem, size);
+}
+
+void GSDumpBase::ReadFIFO(u32 size)
+{
+	if (size == 0)
+		return;
+
+	AppendRawData(static_cast<u8>(GSDumpPacketType::ReadFIFO2));
+	AppendRawData(&size, 4);
+}
+
+void GSDumpBase::WriteCSR(u32 csr)
+{
+	AppendRawData(static_cast<u8>(GSDumpPacketType::WriteCSR));
+	AppendRawData(&csr, 4);
+}
+
+void GSDumpBase::SoftReset(u32 mask)
+{
+	AppendRawData(static_cast<u8>(GSDumpPacketType::SoftReset));
+	AppendRawData(&mask, 4);
+}
+
+void GSDumpBase::VSync(int field, const GSPrivRegSet* regs)
+{
+	AppendRawData(static_cast<u8>(GSDumpPacketType::Registers));
+	AppendRawData(regs, sizeof(*regs));
+
+	AppendRawData(static_cast<u8>(GSDumpPacketType::VSync));
+	AppendRawData(static_cast<u8>(field));
+
+	m_frames++;
+}
+
+void GSDumpBase::Write(const void* data, size_t size)
+{
+	if (!m_gs || size == 0)
+		return;
+
+	size_t written = fwrite(data, 1, size, m_gs);
+	if (written != size)
+		log_cb(RETRO_LOG_ERROR, "GSdx: Error writing dump file\n");
+}
+
+//////////////////////////////////////////////////////////////////////
+// XZ dump
+//////////////////////////////////////////////////////////////////////
+
+GSDumpXz::GSDumpXz(const std::string& fn, u32 crc, const GSFreezeData& fd, const GSPrivRegSet* regs)
+	: GSDumpBase(fn + ".gs.xz")
+{
+	m_strm = LZMA_STREAM_INIT;
+	lzma_ret ret = lzma_easy_encoder(&m_strm, 6 /*level*/, LZMA_CHECK_CRC64);
+	if (ret != LZMA_OK)
+	{
+		log_cb(RETRO_LOG_ERROR, "GSdx: Error initializing LZMA encoder ! (error code %u)\n", ret);
+		return;
+	}
+
+	AddHeader(crc, fd, regs);
+}
+
+GSDumpXz::~GSDumpXz()
+{
+	Flush();
+
+	// Finish the stream
+	m_strm.avail_in = 0;
+	Compress(LZMA_FINISH, LZMA_STREAM_END);
+
+	lzma_end(&m_strm);
+}
+
+void GSDumpXz::AppendRawData(const void* data, size_t size)
+{
+	size_t old_size = m_in_buff.size();
+	m_in_buff.resize(old_size + size);
+	memcpy(&m_in_buff[old_size], data, size);
+
+	// Compress in chunks so long captures don't keep the whole stream in memory.
+	// Each flush stalls the GS thread for a moment, which is fine for a debug tool.
+	if (m_in_buff.size() > 32 * 1024 * 1024)
+		Flush();
+}
+
+void GSDumpXz::AppendRawData(u8 c)
+{
+	m_in_buff.push_back(c);
+}
+
+void GSDumpXz::Flush()
+{
+	if (m_in_buff.empty())
+		return;
+
+	m_strm.next_in = m_in_buff.data();
+	m_strm.avail_in = m_in_buff.size();
+
+	Compress(LZMA_RUN, LZMA_OK);
+
+	m_in_buff.clear();
+}
+
+void GSDumpXz::Compress(lzma_action action, lzma_ret expected_status)
+{
+	std::vector<u8> out_buff(1024 * 1024);
+	do
+	{
+		m_strm.next_out = out_buff.data();
+		m_strm.avail_out = out_buff.size();
+
+		lzma_ret ret = lzma_code(&m_strm, action);
+
+		if (ret != expected_status)
+		{
+			log_cb(RETRO_LOG_ERROR, "GSdx: Error %d\n", (int)ret);
+			return;
+		}
+
+		size_t write_size = out_buff.size() - m_strm.avail_out;
+		Write(out_buff.data(), write_size);
+
+	} while (m_strm.avail_out == 0);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Dump reader
+//////////////////////////////////////////////////////////////////////
+
+GSDumpFile::GSDumpFile(const std::string& fn)
+	: m_eof(false)
+{
+	m_fp = fopen(fn.c_str(), "rb");
+	if (!m_fp)
+		return;
+
+	m_strm = LZMA_STREAM_INIT;
+	lzma_ret ret = lzma_stream_decoder(&m_strm, UINT32_MAX, LZMA_CONCATENATED);
+	if (ret != LZMA_OK)
+	{
+		log_cb(RETRO_LOG_ERROR, "GSdx: Error initializing LZMA decoder ! (error code %u)\n", ret);
+		fclose(m_fp);
+		m_fp = nullptr;
+		return;
+	}
+
+	m_inbuf.resize(128 * 1024);
+	m_strm.avail_in = 0;
+}
+
+GSDumpFile::~GSDumpFile()
+{
+	if (m_fp)
+	{
+		lzma_end(&m_strm);
+		fclose(m_fp);
+	}
+}
+
+bool GSDumpFile::Read(void* ptr, size_t size)
+{
+	m_strm.next_out = static_cast<u8*>(ptr);
+	m_strm.avail_out = size;
+
+	while (m_strm.avail_out != 0)
+	{
+		if (m_strm.avail_in == 0 && !feof(m_fp))
+		{
+			m_strm.next_in = m_inbuf.data();
+			m_strm.avail_in = fread(m_inbuf.data(), 1, m_inbuf.size(), m_fp);
+		}
+
+		// liblzma wants LZMA_FINISH on every call once the input is exhausted
+		lzma_ret ret = lzma_code(&m_strm, feof(m_fp) ? LZMA_FINISH : LZMA_RUN);
+
+		if (ret == LZMA_STREAM_END)
+		{
+			m_eof = true;
+			break;
+		}
+
+		if (ret != LZMA_OK)
+		{
+			log_cb(RETRO_LOG_ERROR, "GSdx: Error while decompressing dump (error code %d)\n", (int)ret);
+			m_eof = true;
+			break;
+		}
+	}
+
+	return m_strm.avail_out == 0;
+}
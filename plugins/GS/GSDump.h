@@ -0,0 +1,125 @@
+/*
+ *	Copyright (C) 2007-2009 Gabest
+ *	http://www.gabest.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNU Make; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#pragma once
+
+#include "GS.h"
+#include <lzma.h>
+#include <string>
+#include <vector>
+
+/*
+
+Dump file format:
+- [crc/4] [state size/4] [state data/size] [PMODE/0x2000] [id/1] [data/?] .. [id/1] [data/?]
+
+Transfer data (id == 0)
+- [0 (path1) .. 3 (path4)/1] [size/4] [data/size]
+
+VSync data (id == 1)
+- [field/1]
+
+ReadFIFO2 data (id == 2)
+- [size/4]
+
+Regs data (id == 3)
+- [PMODE/0x2000]
+
+WriteCSR data (id == 4)
+- [csr/4]
+
+SoftReset data (id == 5)
+- [mask/4]
+
+The whole stream is xz compressed.
+
+*/
+
+enum class GSDumpPacketType : u8
+{
+	Transfer  = 0,
+	VSync     = 1,
+	ReadFIFO2 = 2,
+	Registers = 3,
+	WriteCSR  = 4,
+	SoftReset = 5,
+};
+
+class GSDumpBase
+{
+	int m_frames;
+	FILE* m_gs;
+
+protected:
+	void AddHeader(u32 crc, const GSFreezeData& fd, const GSPrivRegSet* regs);
+	void Write(const void* data, size_t size);
+
+	virtual void AppendRawData(const void* data, size_t size) = 0;
+	virtual void AppendRawData(u8 c) = 0;
+
+public:
+	GSDumpBase(const std::string& fn);
+	virtual ~GSDumpBase();
+
+	bool IsOpen() const { return m_gs != nullptr; }
+
+	void ReadFIFO(u32 size);
+	void Transfer(int index, const u8* mem, size_t size);
+	void WriteCSR(u32 csr);
+	void SoftReset(u32 mask);
+	void VSync(int field, const GSPrivRegSet* regs);
+	int GetFrames() const { return m_frames; }
+};
+
+class GSDumpXz final : public GSDumpBase
+{
+	lzma_stream m_strm;
+
+	std::vector<u8> m_in_buff;
+
+	void Flush();
+	void Compress(lzma_action action, lzma_ret expected_status);
+	void AppendRawData(const void* data, size_t size) final;
+	void AppendRawData(u8 c) final;
+
+public:
+	GSDumpXz(const std::string& fn, u32 crc, const GSFreezeData& fd, const GSPrivRegSet* regs);
+	virtual ~GSDumpXz();
+};
+
+// Reads back a dump written by GSDumpXz
+class GSDumpFile
+{
+	FILE* m_fp;
+	lzma_stream m_strm;
+
+	std::vector<u8> m_inbuf;
+	bool m_eof;
+
+public:
+	GSDumpFile(const std::string& fn);
+	virtual ~GSDumpFile();
+
+	bool IsOpen() const { return m_fp != nullptr; }
+	bool IsEof() const { return m_eof; }
+
+	bool Read(void* ptr, size_t size);
+};
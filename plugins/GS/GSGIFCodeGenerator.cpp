@@ -0,0 +1,347 @@
+/*
+ *	Copyright (C) 2007-2009 Gabest
+ *	http://www.gabest.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNU Make; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "GSGIFCodeGenerator.h"
+#include "GSState.h"
+
+using namespace Xbyak;
+
+GSGIFCodeGenerator::GSGIFCodeGenerator(void* param, u64 key, void* code, size_t maxsize)
+	: GSCodeGenerator(code, maxsize)
+	, m_state((GSState*)param)
+{
+	m_sel.key = key;
+
+#if defined(_M_AMD64) || defined(_WIN64)
+	Generate();
+#else
+	ret();
+#endif
+}
+
+#if defined(_M_AMD64) || defined(_WIN64)
+
+// plain SSE2 is enough here, the vector work is a handful of shuffles per vertex
+
+alignas(16) static const u32 s_mask[3][4] =
+{
+	{0x000000ff, 0x000000ff, 0x000000ff, 0x000000ff}, // packed RGBA
+	{0x00ffffff, 0x000000ff, 0x00000000, 0x00000000}, // packed XYZF2, Z:F after srl32(4)
+	{0xffffffff, 0x00ffffff, 0x00000000, 0x00000000}, // XYZF2, XYZ
+};
+
+// rbx = mem, r12 = nloop, r13 = &m_v, r14 = s_mask
+
+void GSGIFCodeGenerator::Generate()
+{
+	push(rbx);
+	push(r12);
+	push(r13);
+	push(r14);
+#ifdef _WIN64
+	sub(rsp, 8 + 32);
+#else
+	sub(rsp, 8);
+#endif
+
+	mov(rbx, a0);
+	mov(r12d, a1.cvt32());
+	mov(r13, (size_t)&m_state->m_v);
+	mov(r14, (size_t)&s_mask[0][0]);
+
+	int size = m_sel.reglist ? sizeof(GIFReg) : sizeof(GIFPackedReg);
+
+	align(16);
+
+	L("loop");
+
+	for(u32 i = 0; i < m_sel.nreg; i++)
+	{
+		u32 reg = (m_sel.regs >> (i * 4)) & 15;
+
+		if(m_sel.reglist)
+		{
+			RegList(reg, i * size);
+		}
+		else
+		{
+			Packed(reg, i * size);
+		}
+	}
+
+	add(rbx, m_sel.nreg * size);
+	dec(r12d);
+	jnz("loop", T_NEAR);
+
+#ifdef _WIN64
+	add(rsp, 8 + 32);
+#else
+	add(rsp, 8);
+#endif
+	pop(r14);
+	pop(r13);
+	pop(r12);
+	pop(rbx);
+
+	ret();
+}
+
+void GSGIFCodeGenerator::Packed(u32 reg, int offset)
+{
+	const int q = (int)((u8*)&m_state->m_q - (u8*)&m_state->m_v);
+
+	switch(reg)
+	{
+	case GIF_REG_RGBA:
+
+		// m_v.RGBAQ.U32[0] = (GSVector4i::load<false>(r) & GSVector4i::x000000ff()).ps32().pu16();
+		// m_v.RGBAQ.Q = m_q;
+
+		movdqu(xmm0, ptr[rbx + offset]);
+		pand(xmm0, ptr[r14 + 0]);
+		packssdw(xmm0, xmm0);
+		packuswb(xmm0, xmm0);
+		movd(ptr[r13 + offsetof(GSVertex, RGBAQ)], xmm0);
+		mov(eax, ptr[r13 + q]);
+		mov(ptr[r13 + offsetof(GSVertex, RGBAQ) + 4], eax);
+
+		break;
+
+	case GIF_REG_STQ:
+
+		// m_v.ST = r->STQ.ST; m_q = r->STQ.Q (see GIFPackedRegHandlerSTQ)
+
+		mov(rax, ptr[rbx + offset]);
+		mov(ptr[r13 + offsetof(GSVertex, ST)], rax);
+		mov(eax, ptr[rbx + offset + 8]);
+		Q();
+		mov(ptr[r13 + q], eax);
+
+		break;
+
+	case GIF_REG_UV:
+
+		// m_v.UV = (r->U & 0x3fff) | ((r->V & 0x3fff) << 16);
+
+		mov(eax, ptr[rbx + offset]);
+		mov(ecx, ptr[rbx + offset + 4]);
+		and(eax, 0x3fff);
+		and(ecx, 0x3fff);
+		shl(ecx, 16);
+		or(eax, ecx);
+		mov(ptr[r13 + offsetof(GSVertex, UV)], eax);
+
+		if(m_sel.wildhack)
+		{
+			mov(byte[r13 + (int)((u8*)&m_state->m_isPackedUV_HackFlag - (u8*)&m_state->m_v)], 1);
+		}
+
+		break;
+
+	case GIF_REG_XYZF2:
+	case GIF_REG_XYZF3:
+
+		// m_v.m[1] = [X | Y << 16, Z, UV, F] in one store, VertexKick reads it back as a whole
+
+		movq(xmm0, ptr[rbx + offset]);
+		movq(xmm1, ptr[rbx + offset + 8]);
+		movd(xmm2, ptr[r13 + offsetof(GSVertex, UV)]);
+		pshuflw(xmm0, xmm0, _MM_SHUFFLE(3, 3, 2, 0));
+		psrld(xmm1, 4);
+		pand(xmm1, ptr[r14 + 16]);
+		punpckldq(xmm0, xmm2);
+		punpckldq(xmm0, xmm1);
+		movdqa(ptr[r13 + offsetof(GSVertex, XYZ)], xmm0);
+
+		if(reg == GIF_REG_XYZF2)
+		{
+			mov(a1.cvt32(), ptr[rbx + offset + 12]);
+			and(a1.cvt32(), 0x8000);
+		}
+		else
+		{
+			mov(a1.cvt32(), 1);
+		}
+
+		Kick();
+
+		break;
+
+	case GIF_REG_XYZ2:
+	case GIF_REG_XYZ3:
+
+		// m_v.m[1] = [X | Y << 16, Z, UV, FOG]
+
+		movq(xmm0, ptr[rbx + offset]);
+		movd(xmm1, ptr[rbx + offset + 8]);
+		movq(xmm2, ptr[r13 + offsetof(GSVertex, UV)]);
+		pshuflw(xmm0, xmm0, _MM_SHUFFLE(3, 3, 2, 0));
+		punpckldq(xmm0, xmm1);
+		punpcklqdq(xmm0, xmm2);
+		movdqa(ptr[r13 + offsetof(GSVertex, XYZ)], xmm0);
+
+		if(reg == GIF_REG_XYZ2)
+		{
+			mov(a1.cvt32(), ptr[rbx + offset + 12]);
+			and(a1.cvt32(), 0x8000);
+		}
+		else
+		{
+			mov(a1.cvt32(), 1);
+		}
+
+		Kick();
+
+		break;
+
+	case GIF_REG_FOG:
+
+		mov(eax, ptr[rbx + offset + 12]);
+		shr(eax, 4);
+		and(eax, 0xff);
+		mov(ptr[r13 + offsetof(GSVertex, FOG)], eax);
+
+		break;
+
+	case GIF_REG_NOP:
+
+		break;
+
+	default:
+
+		ASSERT(0);
+	}
+}
+
+void GSGIFCodeGenerator::RegList(u32 reg, int offset)
+{
+	switch(reg)
+	{
+	case GIF_A_D_REG_RGBAQ:
+
+		// m_v.RGBAQ = r->RGBAQ, Q fixed up like GIFRegHandlerRGBAQ, m_q is not touched
+
+		mov(eax, ptr[rbx + offset]);
+		mov(ptr[r13 + offsetof(GSVertex, RGBAQ)], eax);
+		mov(eax, ptr[rbx + offset + 4]);
+		Q();
+		mov(ptr[r13 + offsetof(GSVertex, RGBAQ) + 4], eax);
+
+		break;
+
+	case GIF_A_D_REG_ST:
+
+		mov(rax, ptr[rbx + offset]);
+		mov(ptr[r13 + offsetof(GSVertex, ST)], rax);
+
+		break;
+
+	case GIF_A_D_REG_UV:
+
+		mov(eax, ptr[rbx + offset]);
+		and(eax, 0x3fff3fff);
+		mov(ptr[r13 + offsetof(GSVertex, UV)], eax);
+
+		if(m_sel.wildhack)
+		{
+			mov(byte[r13 + (int)((u8*)&m_state->m_isPackedUV_HackFlag - (u8*)&m_state->m_v)], 0);
+		}
+
+		break;
+
+	case GIF_A_D_REG_XYZF2:
+	case GIF_A_D_REG_XYZF3:
+
+		// m_v.m[1] = [XYZ & 0x00ffffff_ffffffff, UV, F]
+
+		movq(xmm0, ptr[rbx + offset]);
+		movdqa(xmm1, xmm0);
+		movd(xmm2, ptr[r13 + offsetof(GSVertex, UV)]);
+		pand(xmm0, ptr[r14 + 32]);
+		psrld(xmm1, 24);
+		psrldq(xmm1, 4);
+		punpckldq(xmm2, xmm1);
+		punpcklqdq(xmm0, xmm2);
+		movdqa(ptr[r13 + offsetof(GSVertex, XYZ)], xmm0);
+
+		mov(a1.cvt32(), reg == GIF_A_D_REG_XYZF3 ? 1 : 0);
+
+		Kick();
+
+		break;
+
+	case GIF_A_D_REG_XYZ2:
+	case GIF_A_D_REG_XYZ3:
+
+		// m_v.m[1] = [XYZ, UV, FOG]
+
+		movq(xmm0, ptr[rbx + offset]);
+		movq(xmm1, ptr[r13 + offsetof(GSVertex, UV)]);
+		punpcklqdq(xmm0, xmm1);
+		movdqa(ptr[r13 + offsetof(GSVertex, XYZ)], xmm0);
+
+		mov(a1.cvt32(), reg == GIF_A_D_REG_XYZ3 ? 1 : 0);
+
+		Kick();
+
+		break;
+
+	case GIF_A_D_REG_FOG:
+
+		movzx(eax, byte[rbx + offset + 7]);
+		mov(ptr[r13 + offsetof(GSVertex, FOG)], eax);
+
+		break;
+
+	case GIF_A_D_REG_NOP:
+
+		break;
+
+	default:
+
+		ASSERT(0);
+	}
+}
+
+void GSGIFCodeGenerator::Q()
+{
+	// eax = q == 0 ? 1.0f : isnan(q) ? FLT_MAX : q
+
+	mov(ecx, 0x3f800000);
+	test(eax, eax);
+	cmovz(eax, ecx);
+	mov(ecx, eax);
+	and(ecx, 0x7fffffff);
+	mov(edx, 0x7f7fffff);
+	cmp(ecx, 0x7f800000);
+	cmova(eax, edx);
+}
+
+void GSGIFCodeGenerator::Kick()
+{
+	// a1 = skip
+
+	mov(a0, (size_t)m_state);
+	mov(rax, (size_t)m_state->m_fpGIFVertexKick[m_sel.prim]);
+	call(rax);
+}
+
+#endif
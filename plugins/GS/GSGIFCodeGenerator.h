@@ -0,0 +1,66 @@
+/*
+ *	Copyright (C) 2007-2009 Gabest
+ *	http://www.gabest.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNU Make; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#pragma once
+
+#include "Pcsx2Types.h"
+
+#include "Renderers/Common/GSFunctionMap.h"
+
+class GSState;
+
+// key layout, see GSState::GetGIFRegLoop
+
+union GSGIFLoopSelector
+{
+	struct
+	{
+		u64 regs:48; // up to 12 register ids, 4 bits each
+		u64 nreg:4;
+		u64 prim:3;
+		u64 auto_flush:1;
+		u64 wildhack:1;
+		u64 reglist:1;
+	};
+
+	u64 key;
+};
+
+// unrolls one NLOOP iteration of a GIFtag whose registers only feed the vertex (RGBAQ, ST, UV, XYZ, FOG, NOP)
+
+class GSGIFCodeGenerator : public GSCodeGenerator
+{
+	void operator = (const GSGIFCodeGenerator&);
+
+	GSState* m_state;
+	GSGIFLoopSelector m_sel;
+
+#if defined(_M_AMD64) || defined(_WIN64)
+	void Generate();
+	void Packed(u32 reg, int offset);
+	void RegList(u32 reg, int offset);
+	void Q();
+	void Kick();
+#endif
+
+public:
+	GSGIFCodeGenerator(void* param, u64 key, void* code, size_t maxsize);
+};
@@ -0,0 +1,320 @@
+/*
+ *	Copyright (C) 2007-2009 Gabest
+ *	http://www.gabest.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNU Make; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "stdafx.h"
+#include "GS.h"
+#include "Renderers/Null/GSRendererNull.h"
+#include "options_tools.h"
+
+// pcsx2_GSReplayLoader --gif-test, run by ctest (GS_gif_loop), not part of the plugin.
+//
+// Sends the same random PACKED and REGLIST vertex packets through a GSState with the compiled
+// GIFtag loops (GSGIFCodeGenerator) and through one with gif_jit off, which unpacks them with
+// the handler tables. Every draw and the state left at the end must match.
+
+class GSRendererGIFTest : public GSRendererNull
+{
+	u64 m_hash;
+
+	void Add(const void* p, size_t size)
+	{
+		for(size_t i = 0; i < size / 4; i++)
+		{
+			m_hash = (m_hash ^ ((const u32*)p)[i]) * 0x100000001b3ull;
+		}
+	}
+
+protected:
+	void Draw()
+	{
+		Add(&PRIM->U64, sizeof(PRIM->U64));
+		Add(m_vertex.buff, sizeof(GSVertex) * m_vertex.next);
+		Add(m_index.buff, sizeof(u32) * m_index.tail);
+
+		m_draws++;
+	}
+
+public:
+	int m_draws;
+
+	GSRendererGIFTest()
+		: m_hash(0xcbf29ce484222325ull)
+		, m_draws(0)
+	{
+	}
+
+	u64 GetHash()
+	{
+		// the vertex being assembled and the primitives not drawn yet
+
+		Add(&m_v, sizeof(m_v));
+		Add(&m_q, sizeof(m_q));
+		Add(&m_vertex.head, sizeof(m_vertex.head));
+		Add(&m_vertex.tail, sizeof(m_vertex.tail));
+		Add(&m_vertex.next, sizeof(m_vertex.next));
+		Add(m_vertex.buff, sizeof(GSVertex) * m_vertex.next);
+		Add(&m_index.tail, sizeof(m_index.tail));
+		Add(m_index.buff, sizeof(u32) * m_index.tail);
+
+		return m_hash;
+	}
+};
+
+class GIFPacketWriter
+{
+	u32 m_seed;
+
+public:
+	std::vector<u64> m_data;
+	std::vector<u32> m_split; // qwords where a transfer may end, see GSGIFLoopTest
+
+	GIFPacketWriter(u32 seed) : m_seed(seed) {}
+
+	u32 Rnd()
+	{
+		m_seed = m_seed * 1664525u + 1013904223u;
+
+		return m_seed ^ (m_seed >> 15);
+	}
+
+	u32 Q()
+	{
+		// Q = 0 and NaN are replaced on the way in
+
+		static const u32 s_q[] = {0x00000000, 0x80000000, 0x7f800000, 0xff800000, 0x7fc00000, 0x7f800001};
+
+		return Rnd() % 4 == 0 ? s_q[Rnd() % countof(s_q)] : 0x3f000000 + (Rnd() & 0x00ffffff);
+	}
+
+	u32 XY()
+	{
+		// mostly inside the scissor, the rest culled
+
+		return Rnd() % 8 == 0 ? Rnd() & 0xffff : 0x8000 + Rnd() % (700 << 4);
+	}
+
+	void Tag(u32 nloop, u32 flg, u32 nreg, u64 regs, u32 pre = 0, u32 prim = 0)
+	{
+		m_split.push_back((u32)m_data.size() / 2);
+
+		m_data.push_back(nloop | ((u64)pre << 46) | ((u64)prim << 47) | ((u64)flg << 58) | ((u64)(nreg & 15) << 60));
+		m_data.push_back(regs);
+	}
+
+	void AD(u32 reg, u64 value)
+	{
+		m_data.push_back(value);
+		m_data.push_back(reg);
+	}
+
+	void Packed(u32 reg)
+	{
+		u32 r[4] = {Rnd(), Rnd(), Rnd(), Rnd()};
+
+		switch(reg)
+		{
+		case GIF_REG_STQ:
+			r[2] = Q();
+			break;
+		case GIF_REG_XYZF2:
+		case GIF_REG_XYZ2:
+		case GIF_REG_XYZF3:
+		case GIF_REG_XYZ3:
+			r[0] = (Rnd() % 4 == 0 ? Rnd() & 0xffff0000 : 0) | XY();
+			r[1] = (Rnd() % 4 == 0 ? Rnd() & 0xffff0000 : 0) | XY();
+			r[3] = Rnd() % 8 == 0 ? r[3] : r[3] & ~0x8000; // ADC
+			break;
+		}
+
+		m_data.push_back(r[0] | ((u64)r[1] << 32));
+		m_data.push_back(r[2] | ((u64)r[3] << 32));
+	}
+
+	void RegList(u32 reg)
+	{
+		u64 r = Rnd() | ((u64)Rnd() << 32);
+
+		switch(reg)
+		{
+		case GIF_A_D_REG_RGBAQ:
+			r = (u32)r | ((u64)Q() << 32);
+			break;
+		case GIF_A_D_REG_XYZF2:
+		case GIF_A_D_REG_XYZ2:
+		case GIF_A_D_REG_XYZF3:
+		case GIF_A_D_REG_XYZ3:
+			r = (r & 0xffffffff00000000ull) | XY() | (XY() << 16);
+			break;
+		}
+
+		m_data.push_back(r);
+	}
+
+	void Vertices()
+	{
+		// the registers the compiled loops handle, a few tags also get one they leave to the handlers
+
+		static const u32 s_packed[] = {GIF_REG_RGBA, GIF_REG_STQ, GIF_REG_UV, GIF_REG_XYZF2, GIF_REG_XYZ2, GIF_REG_FOG, GIF_REG_XYZF3, GIF_REG_XYZ3, GIF_REG_NOP};
+		static const u32 s_reglist[] = {GIF_A_D_REG_RGBAQ, GIF_A_D_REG_ST, GIF_A_D_REG_UV, GIF_A_D_REG_XYZF2, GIF_A_D_REG_XYZ2, GIF_A_D_REG_FOG, GIF_A_D_REG_XYZF3, GIF_A_D_REG_XYZ3, GIF_A_D_REG_NOP};
+
+		u32 flg = Rnd() % 2 ? GIF_FLG_REGLIST : GIF_FLG_PACKED;
+		u32 nreg = Rnd() % 8 == 0 ? 13 + Rnd() % 4 : 1 + Rnd() % 12;
+		u32 nloop = 1 + Rnd() % 40;
+
+		u32 reg[16];
+		u64 regs = 0;
+
+		for(u32 i = 0; i < nreg; i++)
+		{
+			reg[i] = flg == GIF_FLG_REGLIST ? s_reglist[Rnd() % countof(s_reglist)] : s_packed[Rnd() % countof(s_packed)];
+
+			if(Rnd() % 64 == 0)
+			{
+				reg[i] = GIF_REG_TEX0_2;
+			}
+
+			regs |= (u64)reg[i] << (i * 4);
+		}
+
+		u32 pre = flg == GIF_FLG_PACKED && Rnd() % 8 == 0;
+
+		Tag(nloop, flg, nreg, regs, pre, Rnd() % 7);
+
+		for(u32 n = 0; n < nloop; n++)
+		{
+			for(u32 i = 0; i < nreg; i++)
+			{
+				if(flg == GIF_FLG_REGLIST) RegList(reg[i]);
+				else Packed(reg[i]);
+			}
+
+			if((m_data.size() & 1) == 0)
+			{
+				m_split.push_back((u32)m_data.size() / 2);
+			}
+		}
+
+		if(m_data.size() & 1)
+		{
+			m_data.push_back(Rnd()); // odd REGLIST register counts are padded to a qword
+		}
+	}
+};
+
+int GSGIFLoopTest()
+{
+	int failed = 0;
+
+	for(int auto_flush = 0; auto_flush < 2; auto_flush++)
+	{
+		hack_AutoFlush = auto_flush != 0;
+
+		GSRendererGIFTest* state[2];
+
+		for(int i = 0; i < 2; i++)
+		{
+			theApp.SetConfig("gif_jit", i == 0 ? 1 : 0);
+
+			state[i] = new GSRendererGIFTest();
+
+			state[i]->SetRegsMem((u8*)_aligned_malloc(sizeof(GSPrivRegSet), 32));
+
+			memset(state[i]->m_regs, 0, sizeof(GSPrivRegSet));
+		}
+
+		theApp.SetConfig("gif_jit", 1);
+
+		GIFPacketWriter w(1234 + auto_flush);
+
+		for(int it = 0; it < 500; it++)
+		{
+			w.m_data.clear();
+			w.m_split.clear();
+
+			// the whole frame, a random primitive, then a few vertex tags
+
+			w.Tag(5, GIF_FLG_PACKED, 1, GIF_REG_A_D);
+			w.AD(GIF_A_D_REG_FRAME_1, 10 << 16);
+			w.AD(GIF_A_D_REG_XYOFFSET_1, 0x8000 | (0x8000ull << 32));
+			w.AD(GIF_A_D_REG_SCISSOR_1, (639 << 16) | (447ull << 48));
+			w.AD(GIF_A_D_REG_TEST_1, 0);
+			w.AD(GIF_A_D_REG_PRIM, (w.Rnd() % 7) | (w.Rnd() & 0x7f8));
+
+			for(int i = w.Rnd() % 8; i >= 0; i--)
+			{
+				w.Vertices();
+			}
+
+			w.Tag(0, GIF_FLG_PACKED, 0, 0);
+			w.m_data[w.m_data.size() - 2] |= 1 << 15; // EOP
+
+			// in pieces now and then, so some tags start in one transfer and end in the next. Only
+			// between NLOOP iterations, Transfer does not handle a PACKED transfer that resumes in
+			// the middle of one and runs out before the next.
+
+			w.m_split.push_back((u32)w.m_data.size() / 2);
+
+			u32 start = 0;
+
+			for(size_t i = 1; i < w.m_split.size(); i++)
+			{
+				u32 end = w.m_split[i];
+
+				if(end > start && (i == w.m_split.size() - 1 || w.Rnd() % 4 == 0))
+				{
+					for(int j = 0; j < 2; j++)
+					{
+						state[j]->Transfer<3>((const u8*)&w.m_data[start * 2], end - start);
+					}
+
+					start = end;
+				}
+			}
+		}
+
+		u64 hash[2];
+
+		for(int i = 0; i < 2; i++)
+		{
+			hash[i] = state[i]->GetHash();
+		}
+
+		log_cb(RETRO_LOG_INFO, "GSGIFLoopTest: auto flush %d, %d draws, hash %016llx\n", auto_flush, state[0]->m_draws, (unsigned long long)hash[0]);
+
+		if(hash[0] != hash[1] || state[0]->m_draws != state[1]->m_draws)
+		{
+			log_cb(RETRO_LOG_ERROR, "GSGIFLoopTest: the handler tables give %d draws, hash %016llx\n", state[1]->m_draws, (unsigned long long)hash[1]);
+
+			failed++;
+		}
+
+		for(int i = 0; i < 2; i++)
+		{
+			_aligned_free(state[i]->m_regs);
+
+			delete state[i];
+		}
+	}
+
+	hack_AutoFlush = false;
+
+	return failed ? 1 : 0;
+}
@@ -32,24 +32,6 @@
 #include "GSLocalMemory.h"
 #include "GS.h"
 
-#define ASSERT_BLOCK(r, w, h) \
-	ASSERT((r).width() >= (w) && (r).height() >= (h) && !((r).left & ((w) - 1)) && !((r).top & ((h) - 1)) && !((r).right & ((w) - 1)) && !((r).bottom & ((h) - 1))); \
-
-#define FOREACH_BLOCK_START(r, w, h, bpp) \
-	ASSERT_BLOCK(r, w, h); \
-	GSVector4i _r = (r) >> 3; \
-	u8* _dst = dst - _r.left * (bpp); \
-	int _offset = dstpitch * (h); \
-	for(int y = _r.top; y < _r.bottom; y += (h) >> 3, _dst += _offset) \
-	{ \
-		u32 _base = off->block.row[y]; \
-		for(int x = _r.left; x < _r.right; x += (w) >> 3) \
-		{ \
-			const u8* src = BlockPtr(_base + off->block.col[x]); \
-			u8* read_dst = &_dst[x * (bpp)]; \
-
-#define FOREACH_BLOCK_END }}
-
 //
 
 u32 GSLocalMemory::pageOffset32[32][32][64];
@@ -234,12 +216,6 @@ GSLocalMemory::GSLocalMemory()
 		m_psm[i].rt = &GSLocalMemory::ReadTexel32;
 		m_psm[i].rta = &GSLocalMemory::ReadTexel32;
 		m_psm[i].wfa = &GSLocalMemory::WritePixel32;
-		m_psm[i].wi = &GSLocalMemory::WriteImage<PSM_PSMCT32, 8, 8, 32>;
-		m_psm[i].ri = &GSLocalMemory::ReadImageX; // TODO
-		m_psm[i].rtx = &GSLocalMemory::ReadTexture32;
-		m_psm[i].rtxP = &GSLocalMemory::ReadTexture32;
-		m_psm[i].rtxb = &GSLocalMemory::ReadTextureBlock32;
-		m_psm[i].rtxbP = &GSLocalMemory::ReadTextureBlock32;
 		m_psm[i].bpp = m_psm[i].trbpp = 32;
 		m_psm[i].pal = 0;
 		m_psm[i].bs = GSVector2i(8, 8);
@@ -356,71 +332,7 @@ GSLocalMemory::GSLocalMemory()
 	m_psm[PSM_PSMZ16].wfa = &GSLocalMemory::WriteFrame16;
 	m_psm[PSM_PSMZ16S].wfa = &GSLocalMemory::WriteFrame16;
 
-	m_psm[PSM_PSMCT24].wi = &GSLocalMemory::WriteImage24; // TODO
-	m_psm[PSM_PSMCT16].wi = &GSLocalMemory::WriteImage<PSM_PSMCT16, 16, 8, 16>;
-	m_psm[PSM_PSMCT16S].wi = &GSLocalMemory::WriteImage<PSM_PSMCT16S, 16, 8, 16>;
-	m_psm[PSM_PSMT8].wi = &GSLocalMemory::WriteImage<PSM_PSMT8, 16, 16, 8>;
-	m_psm[PSM_PSMT4].wi = &GSLocalMemory::WriteImage<PSM_PSMT4, 32, 16, 4>;
-	m_psm[PSM_PSMT8H].wi = &GSLocalMemory::WriteImage8H; // TODO
-	m_psm[PSM_PSMT4HL].wi = &GSLocalMemory::WriteImage4HL; // TODO
-	m_psm[PSM_PSMT4HH].wi = &GSLocalMemory::WriteImage4HH; // TODO
-	m_psm[PSM_PSMZ32].wi = &GSLocalMemory::WriteImage<PSM_PSMZ32, 8, 8, 32>;
-	m_psm[PSM_PSMZ24].wi = &GSLocalMemory::WriteImage24Z; // TODO
-	m_psm[PSM_PSMZ16].wi = &GSLocalMemory::WriteImage<PSM_PSMZ16, 16, 8, 16>;
-	m_psm[PSM_PSMZ16S].wi = &GSLocalMemory::WriteImage<PSM_PSMZ16S, 16, 8, 16>;
-
-	m_psm[PSM_PSMCT24].rtx = &GSLocalMemory::ReadTexture24;
-	m_psm[PSM_PSGPU24].rtx = &GSLocalMemory::ReadTextureGPU24;
-	m_psm[PSM_PSMCT16].rtx = &GSLocalMemory::ReadTexture16;
-	m_psm[PSM_PSMCT16S].rtx = &GSLocalMemory::ReadTexture16;
-	m_psm[PSM_PSMT8].rtx = &GSLocalMemory::ReadTexture8;
-	m_psm[PSM_PSMT4].rtx = &GSLocalMemory::ReadTexture4;
-	m_psm[PSM_PSMT8H].rtx = &GSLocalMemory::ReadTexture8H;
-	m_psm[PSM_PSMT4HL].rtx = &GSLocalMemory::ReadTexture4HL;
-	m_psm[PSM_PSMT4HH].rtx = &GSLocalMemory::ReadTexture4HH;
-	m_psm[PSM_PSMZ32].rtx = &GSLocalMemory::ReadTexture32;
-	m_psm[PSM_PSMZ24].rtx = &GSLocalMemory::ReadTexture24;
-	m_psm[PSM_PSMZ16].rtx = &GSLocalMemory::ReadTexture16;
-	m_psm[PSM_PSMZ16S].rtx = &GSLocalMemory::ReadTexture16;
-
-	m_psm[PSM_PSMCT24].rtxP = &GSLocalMemory::ReadTexture24;
-	m_psm[PSM_PSMCT16].rtxP = &GSLocalMemory::ReadTexture16;
-	m_psm[PSM_PSMCT16S].rtxP = &GSLocalMemory::ReadTexture16;
-	m_psm[PSM_PSMT8].rtxP = &GSLocalMemory::ReadTexture8P;
-	m_psm[PSM_PSMT4].rtxP = &GSLocalMemory::ReadTexture4P;
-	m_psm[PSM_PSMT8H].rtxP = &GSLocalMemory::ReadTexture8HP;
-	m_psm[PSM_PSMT4HL].rtxP = &GSLocalMemory::ReadTexture4HLP;
-	m_psm[PSM_PSMT4HH].rtxP = &GSLocalMemory::ReadTexture4HHP;
-	m_psm[PSM_PSMZ32].rtxP = &GSLocalMemory::ReadTexture32;
-	m_psm[PSM_PSMZ24].rtxP = &GSLocalMemory::ReadTexture24;
-	m_psm[PSM_PSMZ16].rtxP = &GSLocalMemory::ReadTexture16;
-	m_psm[PSM_PSMZ16S].rtxP = &GSLocalMemory::ReadTexture16;
-
-	m_psm[PSM_PSMCT24].rtxb = &GSLocalMemory::ReadTextureBlock24;
-	m_psm[PSM_PSMCT16].rtxb = &GSLocalMemory::ReadTextureBlock16;
-	m_psm[PSM_PSMCT16S].rtxb = &GSLocalMemory::ReadTextureBlock16;
-	m_psm[PSM_PSMT8].rtxb = &GSLocalMemory::ReadTextureBlock8;
-	m_psm[PSM_PSMT4].rtxb = &GSLocalMemory::ReadTextureBlock4;
-	m_psm[PSM_PSMT8H].rtxb = &GSLocalMemory::ReadTextureBlock8H;
-	m_psm[PSM_PSMT4HL].rtxb = &GSLocalMemory::ReadTextureBlock4HL;
-	m_psm[PSM_PSMT4HH].rtxb = &GSLocalMemory::ReadTextureBlock4HH;
-	m_psm[PSM_PSMZ32].rtxb = &GSLocalMemory::ReadTextureBlock32;
-	m_psm[PSM_PSMZ24].rtxb = &GSLocalMemory::ReadTextureBlock24;
-	m_psm[PSM_PSMZ16].rtxb = &GSLocalMemory::ReadTextureBlock16;
-	m_psm[PSM_PSMZ16S].rtxb = &GSLocalMemory::ReadTextureBlock16;
-
-	m_psm[PSM_PSMCT24].rtxbP = &GSLocalMemory::ReadTextureBlock24;
-	m_psm[PSM_PSMCT16].rtxbP = &GSLocalMemory::ReadTextureBlock16;
-	m_psm[PSM_PSMCT16S].rtxbP = &GSLocalMemory::ReadTextureBlock16;
-	m_psm[PSM_PSMT8].rtxbP = &GSLocalMemory::ReadTextureBlock8P;
-	m_psm[PSM_PSMT4].rtxbP = &GSLocalMemory::ReadTextureBlock4P;
-	m_psm[PSM_PSMT8H].rtxbP = &GSLocalMemory::ReadTextureBlock8HP;
-	m_psm[PSM_PSMT4HL].rtxbP = &GSLocalMemory::ReadTextureBlock4HLP;
-	m_psm[PSM_PSMT4HH].rtxbP = &GSLocalMemory::ReadTextureBlock4HHP;
-	m_psm[PSM_PSMZ32].rtxbP = &GSLocalMemory::ReadTextureBlock32;
-	m_psm[PSM_PSMZ24].rtxbP = &GSLocalMemory::ReadTextureBlock24;
-	m_psm[PSM_PSMZ16].rtxbP = &GSLocalMemory::ReadTextureBlock16;
-	m_psm[PSM_PSMZ16S].rtxbP = &GSLocalMemory::ReadTextureBlock16;
+	MULTI_ISA_SELECT(GSLocalMemoryPopulateFunctions)(m_psm);
 
 	m_psm[PSM_PSGPU24].bpp = 16;
 	m_psm[PSM_PSMCT16].bpp = m_psm[PSM_PSMCT16S].bpp = 16;
@@ -497,30 +409,27 @@ GSLocalMemory::~GSLocalMemory()
 	else
 		vmfree(m_vm8, m_vmsize * 4);
 
-	for(auto &i : m_omap) delete i.second;
-	for(auto &i : m_pomap) _aligned_free(i.second);
-	for(auto &i : m_po4map) _aligned_free(i.second);
+	// the pixel offsets are plain data in m_offset_arena, only GSOffset owns buffers
 
-	for(auto &i : m_p2tmap)
-	{
-		delete [] i.second;
-	}
+	m_omap.ForEach([](GSOffset* off) {off->~GSOffset();});
+
+	m_p2tmap.ForEach([](std::vector<GSVector2i>* p2t) {delete [] p2t;});
 }
 
 GSOffset* GSLocalMemory::GetOffset(u32 bp, u32 bw, u32 psm)
 {
 	u32 hash = bp | (bw << 14) | (psm << 20);
 
-	auto i = m_omap.find(hash);
+	GSOffset* off = m_omap.Find(hash);
 
-	if(i != m_omap.end())
+	if(off != NULL)
 	{
-		return i->second;
+		return off;
 	}
 
-	GSOffset* off = new GSOffset(bp, bw, psm);
+	off = ::new(m_offset_arena.Alloc(sizeof(GSOffset))) GSOffset(bp, bw, psm);
 
-	m_omap[hash] = off;
+	m_omap.Insert(hash, off);
 
 	return off;
 }
@@ -542,14 +451,14 @@ GSPixelOffset* GSLocalMemory::GetPixelOffset(const GIFRegFRAME& FRAME, const GIF
 
 	u32 hash = (FRAME.FBP << 0) | (ZBUF.ZBP << 9) | (bw << 18) | (fpsm_hash << 24) | (zpsm_hash << 28);
 
-	auto it = m_pomap.find(hash);
+	GSPixelOffset* off = m_pomap.Find(hash);
 
-	if(it != m_pomap.end())
+	if(off != NULL)
 	{
-		return it->second;
+		return off;
 	}
 
-	GSPixelOffset* off = (GSPixelOffset*)_aligned_malloc(sizeof(GSPixelOffset), 32);
+	off = (GSPixelOffset*)m_offset_arena.Alloc(sizeof(GSPixelOffset));
 
 	off->hash = hash;
 	off->fbp = fbp;
@@ -576,7 +485,7 @@ GSPixelOffset* GSLocalMemory::GetPixelOffset(const GIFRegFRAME& FRAME, const GIF
 		off->col[i].y = m_psm[zpsm].rowOffset[0][i] << zs;
 	}
 
-	m_pomap[hash] = off;
+	m_pomap.Insert(hash, off);
 
 	return off;
 }
@@ -598,14 +507,14 @@ GSPixelOffset4* GSLocalMemory::GetPixelOffset4(const GIFRegFRAME& FRAME, const G
 
 	u32 hash = (FRAME.FBP << 0) | (ZBUF.ZBP << 9) | (bw << 18) | (fpsm_hash << 24) | (zpsm_hash << 28);
 
-	auto it = m_po4map.find(hash);
+	GSPixelOffset4* off = m_po4map.Find(hash);
 
-	if(it != m_po4map.end())
+	if(off != NULL)
 	{
-		return it->second;
+		return off;
 	}
 
-	GSPixelOffset4* off = (GSPixelOffset4*)_aligned_malloc(sizeof(GSPixelOffset4), 32);
+	off = (GSPixelOffset4*)m_offset_arena.Alloc(sizeof(GSPixelOffset4));
 
 	off->hash = hash;
 	off->fbp = fbp;
@@ -632,7 +541,7 @@ GSPixelOffset4* GSLocalMemory::GetPixelOffset4(const GIFRegFRAME& FRAME, const G
 		off->col[i].y = m_psm[zpsm].rowOffset[0][i * 4] << zs;
 	}
 
-	m_po4map[hash] = off;
+	m_po4map.Insert(hash, off);
 
 	return off;
 }
@@ -643,11 +552,11 @@ std::vector<GSVector2i>* GSLocalMemory::GetPage2TileMap(const GIFRegTEX0& TEX0)
 {
 	u64 hash = TEX0.U64 & 0x3ffffffffull; // TBP0 TBW PSM TW TH
 
-	auto it = m_p2tmap.find(hash);
+	std::vector<GSVector2i>* cached = m_p2tmap.Find(hash);
 
-	if(it != m_p2tmap.end())
+	if(cached != NULL)
 	{
-		return it->second;
+		return cached;
 	}
 
 	GSVector2i bs = m_psm[TEX0.PSM].bs;
@@ -713,1303 +622,92 @@ std::vector<GSVector2i>* GSLocalMemory::GetPage2TileMap(const GIFRegTEX0& TEX0)
 		std::sort(p2t[page].begin(), p2t[page].end(), cmp_vec2x);
 	}
 
-	m_p2tmap[hash] = p2t;
+	m_p2tmap.Insert(hash, p2t);
 
 	return p2t;
 }
 
-////////////////////
-
-template<int psm, int bsx, int bsy, int alignment>
-void GSLocalMemory::WriteImageColumn(int l, int r, int y, int h, const u8* src, int srcpitch, const GIFRegBITBLTBUF& BITBLTBUF)
-{
-	u32 bp = BITBLTBUF.DBP;
-	u32 bw = BITBLTBUF.DBW;
-
-	const int csy = bsy / 4;
-
-	for(int offset = srcpitch * csy; h >= csy; h -= csy, y += csy, src += offset)
-	{
-		for(int x = l; x < r; x += bsx)
-		{
-			switch(psm)
-			{
-			case PSM_PSMCT32: GSBlock::WriteColumn32<alignment, 0xffffffff>(y, BlockPtr32(x, y, bp, bw), &src[x * 4], srcpitch); break;
-			case PSM_PSMCT16: GSBlock::WriteColumn16<alignment>(y, BlockPtr16(x, y, bp, bw), &src[x * 2], srcpitch); break;
-			case PSM_PSMCT16S: GSBlock::WriteColumn16<alignment>(y, BlockPtr16S(x, y, bp, bw), &src[x * 2], srcpitch); break;
-			case PSM_PSMT8: GSBlock::WriteColumn8<alignment>(y, BlockPtr8(x, y, bp, bw), &src[x], srcpitch); break;
-			case PSM_PSMT4: GSBlock::WriteColumn4<alignment>(y, BlockPtr4(x, y, bp, bw), &src[x >> 1], srcpitch); break;
-			case PSM_PSMZ32: GSBlock::WriteColumn32<alignment, 0xffffffff>(y, BlockPtr32Z(x, y, bp, bw), &src[x * 4], srcpitch); break;
-			case PSM_PSMZ16: GSBlock::WriteColumn16<alignment>(y, BlockPtr16Z(x, y, bp, bw), &src[x * 2], srcpitch); break;
-			case PSM_PSMZ16S: GSBlock::WriteColumn16<alignment>(y, BlockPtr16SZ(x, y, bp, bw), &src[x * 2], srcpitch); break;
-			// TODO
-			default: __assume(0);
-			}
-		}
-	}
-}
-
-template<int psm, int bsx, int bsy, int alignment>
-void GSLocalMemory::WriteImageBlock(int l, int r, int y, int h, const u8* src, int srcpitch, const GIFRegBITBLTBUF& BITBLTBUF)
-{
-	u32 bp = BITBLTBUF.DBP;
-	u32 bw = BITBLTBUF.DBW;
-
-	for(int offset = srcpitch * bsy; h >= bsy; h -= bsy, y += bsy, src += offset)
-	{
-		for(int x = l; x < r; x += bsx)
-		{
-			switch(psm)
-			{
-			case PSM_PSMCT32: GSBlock::WriteBlock32<alignment, 0xffffffff>(BlockPtr32(x, y, bp, bw), &src[x * 4], srcpitch); break;
-			case PSM_PSMCT16: GSBlock::WriteBlock16<alignment>(BlockPtr16(x, y, bp, bw), &src[x * 2], srcpitch); break;
-			case PSM_PSMCT16S: GSBlock::WriteBlock16<alignment>(BlockPtr16S(x, y, bp, bw), &src[x * 2], srcpitch); break;
-			case PSM_PSMT8: GSBlock::WriteBlock8<alignment>(BlockPtr8(x, y, bp, bw), &src[x], srcpitch); break;
-			case PSM_PSMT4: GSBlock::WriteBlock4<alignment>(BlockPtr4(x, y, bp, bw), &src[x >> 1], srcpitch); break;
-			case PSM_PSMZ32: GSBlock::WriteBlock32<alignment, 0xffffffff>(BlockPtr32Z(x, y, bp, bw), &src[x * 4], srcpitch); break;
-			case PSM_PSMZ16: GSBlock::WriteBlock16<alignment>(BlockPtr16Z(x, y, bp, bw), &src[x * 2], srcpitch); break;
-			case PSM_PSMZ16S: GSBlock::WriteBlock16<alignment>(BlockPtr16SZ(x, y, bp, bw), &src[x * 2], srcpitch); break;
-			// TODO
-			default: __assume(0);
-			}
-		}
-	}
-}
-
-template<int psm, int bsx, int bsy>
-void GSLocalMemory::WriteImageLeftRight(int l, int r, int y, int h, const u8* src, int srcpitch, const GIFRegBITBLTBUF& BITBLTBUF)
-{
-	u32 bp = BITBLTBUF.DBP;
-	u32 bw = BITBLTBUF.DBW;
-
-	for(; h > 0; y++, h--, src += srcpitch)
-	{
-		for(int x = l; x < r; x++)
-		{
-			switch(psm)
-			{
-			case PSM_PSMCT32: WritePixel32(x, y, *(u32*)&src[x * 4], bp, bw); break;
-			case PSM_PSMCT16: WritePixel16(x, y, *(u16*)&src[x * 2], bp, bw); break;
-			case PSM_PSMCT16S: WritePixel16S(x, y, *(u16*)&src[x * 2], bp, bw); break;
-			case PSM_PSMT8: WritePixel8(x, y, src[x], bp, bw); break;
-			case PSM_PSMT4: WritePixel4(x, y, src[x >> 1] >> ((x & 1) << 2), bp, bw); break;
-			case PSM_PSMZ32: WritePixel32Z(x, y, *(u32*)&src[x * 4], bp, bw); break;
-			case PSM_PSMZ16: WritePixel16Z(x, y, *(u16*)&src[x * 2], bp, bw); break;
-			case PSM_PSMZ16S: WritePixel16SZ(x, y, *(u16*)&src[x * 2], bp, bw); break;
-			// TODO
-			default: __assume(0);
-			}
-		}
-	}
-}
+///////////////////
 
-template<int psm, int bsx, int bsy, int trbpp>
-void GSLocalMemory::WriteImageTopBottom(int l, int r, int y, int h, const u8* src, int srcpitch, const GIFRegBITBLTBUF& BITBLTBUF)
+void GSLocalMemory::ReadTexture(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
 {
-	alignas(32) u8 buff[64]; // merge buffer for one column
-
-	u32 bp = BITBLTBUF.DBP;
-	u32 bw = BITBLTBUF.DBW;
-
-	const int csy = bsy / 4;
-
-	// merge incomplete column
-
-	int y2 = y & (csy - 1);
-
-	if(y2 > 0)
-	{
-		int h2 = std::min(h, csy - y2);
-
-		for(int x = l; x < r; x += bsx)
-		{
-			u8* dst = NULL;
-
-			switch(psm)
-			{
-			case PSM_PSMCT32: dst = BlockPtr32(x, y, bp, bw); break;
-			case PSM_PSMCT16: dst = BlockPtr16(x, y, bp, bw); break;
-			case PSM_PSMCT16S: dst = BlockPtr16S(x, y, bp, bw); break;
-			case PSM_PSMT8: dst = BlockPtr8(x, y, bp, bw); break;
-			case PSM_PSMT4: dst = BlockPtr4(x, y, bp, bw); break;
-			case PSM_PSMZ32: dst = BlockPtr32Z(x, y, bp, bw); break;
-			case PSM_PSMZ16: dst = BlockPtr16Z(x, y, bp, bw); break;
-			case PSM_PSMZ16S: dst = BlockPtr16SZ(x, y, bp, bw); break;
-			// TODO
-			default: __assume(0);
-			}
-
-			switch(psm)
-			{
-			case PSM_PSMCT32:
-			case PSM_PSMZ32:
-				GSBlock::ReadColumn32(y, dst, buff, 32);
-				memcpy(&buff[32], &src[x * 4], 32);
-				GSBlock::WriteColumn32<32, 0xffffffff>(y, dst, buff, 32);
-				break;
-			case PSM_PSMCT16:
-			case PSM_PSMCT16S:
-			case PSM_PSMZ16:
-			case PSM_PSMZ16S:
-				GSBlock::ReadColumn16(y, dst, buff, 32);
-				memcpy(&buff[32], &src[x * 2], 32);
-				GSBlock::WriteColumn16<32>(y, dst, buff, 32);
-				break;
-			case PSM_PSMT8:
-				GSBlock::ReadColumn8(y, dst, buff, 16);
-				for(int i = 0, j = y2; i < h2; i++, j++) memcpy(&buff[j * 16], &src[i * srcpitch + x], 16);
-				GSBlock::WriteColumn8<32>(y, dst, buff, 16);
-				break;
-			case PSM_PSMT4:
-				GSBlock::ReadColumn4(y, dst, buff, 16);
-				for(int i = 0, j = y2; i < h2; i++, j++) memcpy(&buff[j * 16], &src[i * srcpitch + (x >> 1)], 16);
-				GSBlock::WriteColumn4<32>(y, dst, buff, 16);
-				break;
-			// TODO
-			default:
-				__assume(0);
-			}
-		}
-
-		src += srcpitch * h2;
-		y += h2;
-		h -= h2;
-	}
+	const psm_t& psm = m_psm[off->psm];
 
-	// write whole columns
+	readTexel rt = psm.rt;
+	readTexture rtx = psm.rtx;
 
+	if(r.width() < psm.bs.x || r.height() < psm.bs.y
+	|| (r.left & (psm.bs.x - 1)) || (r.top & (psm.bs.y - 1))
+	|| (r.right & (psm.bs.x - 1)) || (r.bottom & (psm.bs.y - 1)))
 	{
-		int h2 = h & ~(csy - 1);
-
-		if(h2 > 0)
-		{
-			size_t addr = (size_t)&src[l * trbpp >> 3];
+		GIFRegTEX0 TEX0;
 
-			if((addr & 31) == 0 && (srcpitch & 31) == 0)
-			{
-				WriteImageColumn<psm, bsx, bsy, 32>(l, r, y, h2, src, srcpitch, BITBLTBUF);
-			}
-			else if((addr & 15) == 0 && (srcpitch & 15) == 0)
-			{
-				WriteImageColumn<psm, bsx, bsy, 16>(l, r, y, h2, src, srcpitch, BITBLTBUF);
-			}
-			else
-			{
-				WriteImageColumn<psm, bsx, bsy, 0>(l, r, y, h2, src, srcpitch, BITBLTBUF);
-			}
+		TEX0.TBP0 = off->bp;
+		TEX0.TBW = off->bw;
+		TEX0.PSM = off->psm;
 
-			src += srcpitch * h2;
-			y += h2;
-			h -= h2;
-		}
-	}
+		GSVector4i cr = r.ralign<Align_Inside>(psm.bs);
 
-	// merge incomplete column
+		bool aligned = ((size_t)(dst + (cr.left - r.left) * sizeof(u32)) & 0xf) == 0;
 
-	if(h >= 1)
-	{
-		for(int x = l; x < r; x += bsx)
+		if(cr.rempty() || !aligned)
 		{
-			u8* dst = NULL;
-
-			switch(psm)
-			{
-			case PSM_PSMCT32: dst = BlockPtr32(x, y, bp, bw); break;
-			case PSM_PSMCT16: dst = BlockPtr16(x, y, bp, bw); break;
-			case PSM_PSMCT16S: dst = BlockPtr16S(x, y, bp, bw); break;
-			case PSM_PSMT8: dst = BlockPtr8(x, y, bp, bw); break;
-			case PSM_PSMT4: dst = BlockPtr4(x, y, bp, bw); break;
-			case PSM_PSMZ32: dst = BlockPtr32Z(x, y, bp, bw); break;
-			case PSM_PSMZ16: dst = BlockPtr16Z(x, y, bp, bw); break;
-			case PSM_PSMZ16S: dst = BlockPtr16SZ(x, y, bp, bw); break;
-			// TODO
-			default: __assume(0);
-			}
+			// TODO: expand r to block size, read into temp buffer
+#ifndef NDEBUG
+			if(!aligned) printf("unaligned memory pointer passed to ReadTexture\n");
+#endif
 
-			switch(psm)
+			for(int y = r.top; y < r.bottom; y++, dst += dstpitch)
 			{
-			case PSM_PSMCT32:
-			case PSM_PSMZ32:
-				GSBlock::ReadColumn32(y, dst, buff, 32);
-				memcpy(&buff[0], &src[x * 4], 32);
-				GSBlock::WriteColumn32<32, 0xffffffff>(y, dst, buff, 32);
-				break;
-			case PSM_PSMCT16:
-			case PSM_PSMCT16S:
-			case PSM_PSMZ16:
-			case PSM_PSMZ16S:
-				GSBlock::ReadColumn16(y, dst, buff, 32);
-				memcpy(&buff[0], &src[x * 2], 32);
-				GSBlock::WriteColumn16<32>(y, dst, buff, 32);
-				break;
-			case PSM_PSMT8:
-				GSBlock::ReadColumn8(y, dst, buff, 16);
-				for(int i = 0; i < h; i++) memcpy(&buff[i * 16], &src[i * srcpitch + x], 16);
-				GSBlock::WriteColumn8<32>(y, dst, buff, 16);
-				break;
-			case PSM_PSMT4:
-				GSBlock::ReadColumn4(y, dst, buff, 16);
-				for(int i = 0; i < h; i++) memcpy(&buff[i * 16], &src[i * srcpitch + (x >> 1)], 16);
-				GSBlock::WriteColumn4<32>(y, dst, buff, 16);
-				break;
-			// TODO
-			default:
-				__assume(0);
+				for(int x = r.left, i = 0; x < r.right; x++, i++)
+				{
+					((u32*)dst)[i] = (this->*rt)(x, y, TEX0, TEXA);
+				}
 			}
 		}
-	}
-}
-
-template<int psm, int bsx, int bsy, int trbpp>
-void GSLocalMemory::WriteImage(int& tx, int& ty, const u8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
-{
-	if(TRXREG.RRW == 0) return;
-
-	int l = (int)TRXPOS.DSAX;
-	int r = l + (int)TRXREG.RRW;
-
-	// finish the incomplete row first
-
-	if(tx != l)
-	{
-		int n = std::min(len, (r - tx) * trbpp >> 3);
-		WriteImageX(tx, ty, src, n, BITBLTBUF, TRXPOS, TRXREG);
-		src += n;
-		len -= n;
-	}
-
-	int la = (l + (bsx - 1)) & ~(bsx - 1);
-	int ra = r & ~(bsx - 1);
-	int srcpitch = (r - l) * trbpp >> 3;
-	int h = len / srcpitch;
-
-	if(ra - la >= bsx && h > 0) // "transfer width" >= "block width" && there is at least one full row
-	{
-		const u8* s = &src[-l * trbpp >> 3];
-
-		src += srcpitch * h;
-		len -= srcpitch * h;
-
-		// left part
-
-		if(l < la)
-		{
-			WriteImageLeftRight<psm, bsx, bsy>(l, la, ty, h, s, srcpitch, BITBLTBUF);
-		}
-
-		// right part
-
-		if(ra < r)
-		{
-			WriteImageLeftRight<psm, bsx, bsy>(ra, r, ty, h, s, srcpitch, BITBLTBUF);
-		}
-
-		// horizontally aligned part
-
-		if(la < ra)
+		else
 		{
-			// top part
-
+			for(int y = r.top; y < cr.top; y++, dst += dstpitch)
 			{
-				int h2 = std::min(h, bsy - (ty & (bsy - 1)));
-
-				if(h2 < bsy)
+				for(int x = r.left, i = 0; x < r.right; x++, i++)
 				{
-					WriteImageTopBottom<psm, bsx, bsy, trbpp>(la, ra, ty, h2, s, srcpitch, BITBLTBUF);
-
-					s += srcpitch * h2;
-					ty += h2;
-					h -= h2;
+					((u32*)dst)[i] = (this->*rt)(x, y, TEX0, TEXA);
 				}
 			}
 
-			// horizontally and vertically aligned part
-
+			for(int y = cr.bottom; y < r.bottom; y++, dst += dstpitch)
 			{
-				int h2 = h & ~(bsy - 1);
-
-				if(h2 > 0)
+				for(int x = r.left, i = 0; x < r.right; x++, i++)
 				{
-					size_t addr = (size_t)&s[la * trbpp >> 3];
-
-					if((addr & 31) == 0 && (srcpitch & 31) == 0)
-					{
-						WriteImageBlock<psm, bsx, bsy, 32>(la, ra, ty, h2, s, srcpitch, BITBLTBUF);
-					}
-					else if((addr & 15) == 0 && (srcpitch & 15) == 0)
-					{
-						WriteImageBlock<psm, bsx, bsy, 16>(la, ra, ty, h2, s, srcpitch, BITBLTBUF);
-					}
-					else
-					{
-						WriteImageBlock<psm, bsx, bsy, 0>(la, ra, ty, h2, s, srcpitch, BITBLTBUF);
-					}
-
-					s += srcpitch * h2;
-					ty += h2;
-					h -= h2;
+					((u32*)dst)[i] = (this->*rt)(x, y, TEX0, TEXA);
 				}
 			}
 
-			// bottom part
-
-			if(h > 0)
-			{
-				WriteImageTopBottom<psm, bsx, bsy, trbpp>(la, ra, ty, h, s, srcpitch, BITBLTBUF);
-
-				// s += srcpitch * h;
-				ty += h;
-				// h -= h;
-			}
-		}
-	}
-
-	// the rest
-
-	if(len > 0)
-	{
-		WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
-	}
-}
-
-
-static bool IsTopLeftAligned(int dsax, int tx, int ty, int bw, int bh)
-{
-	return ((dsax & (bw-1)) == 0 && (tx & (bw-1)) == 0 && dsax == tx && (ty & (bh-1)) == 0);
-}
-
-void GSLocalMemory::WriteImage24(int& tx, int& ty, const u8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
-{
-	if(TRXREG.RRW == 0) return;
-
-	u32 bp = BITBLTBUF.DBP;
-	u32 bw = BITBLTBUF.DBW;
-
-	int tw = TRXPOS.DSAX + TRXREG.RRW, srcpitch = TRXREG.RRW * 3;
-	int th = len / srcpitch;
-
-	bool aligned = IsTopLeftAligned(TRXPOS.DSAX, tx, ty, 8, 8);
-
-	if(!aligned || (tw & 7) || (th & 7) || (len % srcpitch))
-	{
-		// TODO
-
-		WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
-	}
-	else
-	{
-		th += ty;
-
-		for(int y = ty; y < th; y += 8, src += srcpitch * 8)
-		{
-			for(int x = tx; x < tw; x += 8)
-			{
-				GSBlock::UnpackAndWriteBlock24(src + (x - tx) * 3, srcpitch, BlockPtr32(x, y, bp, bw));
-			}
-		}
-
-		ty = th;
-	}
-}
-
-void GSLocalMemory::WriteImage8H(int& tx, int& ty, const u8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
-{
-	if(TRXREG.RRW == 0) return;
-
-	u32 bp = BITBLTBUF.DBP;
-	u32 bw = BITBLTBUF.DBW;
-
-	int tw = TRXPOS.DSAX + TRXREG.RRW, srcpitch = TRXREG.RRW;
-	int th = len / srcpitch;
-
-	bool aligned = IsTopLeftAligned(TRXPOS.DSAX, tx, ty, 8, 8);
-
-	if(!aligned || (tw & 7) || (th & 7) || (len % srcpitch))
-	{
-		// TODO
-
-		WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
-	}
-	else
-	{
-		th += ty;
-
-		for(int y = ty; y < th; y += 8, src += srcpitch * 8)
-		{
-			for(int x = tx; x < tw; x += 8)
+			for(int y = cr.top; y < cr.bottom; y++, dst += dstpitch)
 			{
-				GSBlock::UnpackAndWriteBlock8H(src + (x - tx), srcpitch, BlockPtr32(x, y, bp, bw));
-			}
-		}
-
-		ty = th;
-	}
-}
-
-void GSLocalMemory::WriteImage4HL(int& tx, int& ty, const u8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
-{
-	if(TRXREG.RRW == 0) return;
-
-	u32 bp = BITBLTBUF.DBP;
-	u32 bw = BITBLTBUF.DBW;
-
-	int tw = TRXPOS.DSAX + TRXREG.RRW, srcpitch = TRXREG.RRW / 2;
-	int th = len / srcpitch;
-
-	bool aligned = IsTopLeftAligned(TRXPOS.DSAX, tx, ty, 8, 8);
-
-	if(!aligned || (tw & 7) || (th & 7) || (len % srcpitch))
-	{
-		// TODO
-
-		WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
-	}
-	else
-	{
-		th += ty;
+				for(int x = r.left, i = 0; x < cr.left; x++, i++)
+				{
+					((u32*)dst)[i] = (this->*rt)(x, y, TEX0, TEXA);
+				}
 
-		for(int y = ty; y < th; y += 8, src += srcpitch * 8)
-		{
-			for(int x = tx; x < tw; x += 8)
-			{
-				GSBlock::UnpackAndWriteBlock4HL(src + (x - tx) / 2, srcpitch, BlockPtr32(x, y, bp, bw));
+				for(int x = cr.right, i = x - r.left; x < r.right; x++, i++)
+				{
+					((u32*)dst)[i] = (this->*rt)(x, y, TEX0, TEXA);
+				}
 			}
-		}
-
-		ty = th;
-	}
-}
-
-void GSLocalMemory::WriteImage4HH(int& tx, int& ty, const u8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
-{
-	if(TRXREG.RRW == 0) return;
-
-	u32 bp = BITBLTBUF.DBP;
-	u32 bw = BITBLTBUF.DBW;
-
-	int tw = TRXPOS.DSAX + TRXREG.RRW, srcpitch = TRXREG.RRW / 2;
-	int th = len / srcpitch;
 
-	bool aligned = IsTopLeftAligned(TRXPOS.DSAX, tx, ty, 8, 8);
-
-	if(!aligned || (tw & 7) || (th & 7) || (len % srcpitch))
-	{
-		// TODO
-
-		WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
-	}
-	else
-	{
-		th += ty;
-
-		for(int y = ty; y < th; y += 8, src += srcpitch * 8)
-		{
-			for(int x = tx; x < tw; x += 8)
+			if(!cr.rempty())
 			{
-				GSBlock::UnpackAndWriteBlock4HH(src + (x - tx) / 2, srcpitch, BlockPtr32(x, y, bp, bw));
+				rtx(*this, off, cr, dst + (cr.left - r.left) * sizeof(u32), dstpitch, TEXA);
 			}
 		}
-
-		ty = th;
-	}
-}
-
-void GSLocalMemory::WriteImage24Z(int& tx, int& ty, const u8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
-{
-	if(TRXREG.RRW == 0) return;
-
-	u32 bp = BITBLTBUF.DBP;
-	u32 bw = BITBLTBUF.DBW;
-
-	int tw = TRXPOS.DSAX + TRXREG.RRW, srcpitch = TRXREG.RRW * 3;
-	int th = len / srcpitch;
-
-	bool aligned = IsTopLeftAligned(TRXPOS.DSAX, tx, ty, 8, 8);
-
-	if(!aligned || (tw & 7) || (th & 7) || (len % srcpitch))
-	{
-		// TODO
-
-		WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
 	}
 	else
 	{
-		th += ty;
-
-		for(int y = ty; y < th; y += 8, src += srcpitch * 8)
-		{
-			for(int x = tx; x < tw; x += 8)
-			{
-				GSBlock::UnpackAndWriteBlock24(src + (x - tx) * 3, srcpitch, BlockPtr32Z(x, y, bp, bw));
-			}
-		}
-
-		ty = th;
+		rtx(*this, off, r, dst, dstpitch, TEXA);
 	}
 }
 
-void GSLocalMemory::WriteImageX(int& tx, int& ty, const u8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
-{
-	if(len <= 0) return;
-
-	const u8* pb = (u8*)src;
-	const u16* pw = (u16*)src;
-	const u32* pd = (u32*)src;
-
-	u32 bp = BITBLTBUF.DBP;
-	u32 bw = BITBLTBUF.DBW;
-	psm_t* psm = &m_psm[BITBLTBUF.DPSM];
-
-	int x = tx;
-	int y = ty;
-	int sx = (int)TRXPOS.DSAX;
-	int ex = sx + (int)TRXREG.RRW;
-
-	switch(BITBLTBUF.DPSM)
-	{
-	case PSM_PSMCT32:
-	case PSM_PSMZ32:
-
-		len /= 4;
-
-		while(len > 0)
-		{
-			u32 addr = psm->pa(0, y, bp, bw);
-			int* offset = psm->rowOffset[y & 7];
-
-			for(; len > 0 && x < ex; len--, x++, pd++)
-			{
-				WritePixel32(addr + offset[x], *pd);
-			}
-
-			if(x >= ex) {x = sx; y++;}
-		}
-
-		break;
-
-	case PSM_PSMCT24:
-	case PSM_PSMZ24:
-
-		len /= 3;
-
-		while(len > 0)
-		{
-			u32 addr = psm->pa(0, y, bp, bw);
-			int* offset = psm->rowOffset[y & 7];
-
-			for(; len > 0 && x < ex; len--, x++, pb += 3)
-			{
-				WritePixel24(addr + offset[x], *(u32*)pb);
-			}
-
-			if(x >= ex) {x = sx; y++;}
-		}
-
-		break;
-
-	case PSM_PSMCT16:
-	case PSM_PSMCT16S:
-	case PSM_PSMZ16:
-	case PSM_PSMZ16S:
-
-		len /= 2;
-
-		while(len > 0)
-		{
-			u32 addr = psm->pa(0, y, bp, bw);
-			int* offset = psm->rowOffset[y & 7];
-
-			for(; len > 0 && x < ex; len--, x++, pw++)
-			{
-				WritePixel16(addr + offset[x], *pw);
-			}
-
-			if(x >= ex) {x = sx; y++;}
-		}
-
-		break;
-
-	case PSM_PSMT8:
-
-		while(len > 0)
-		{
-			u32 addr = psm->pa(0, y, bp, bw);
-			int* offset = psm->rowOffset[y & 7];
-
-			for(; len > 0 && x < ex; len--, x++, pb++)
-			{
-				WritePixel8(addr + offset[x], *pb);
-			}
-
-			if(x >= ex) {x = sx; y++;}
-		}
-
-		break;
-
-	case PSM_PSMT4:
-
-		while(len > 0)
-		{
-			u32 addr = psm->pa(0, y, bp, bw);
-			int* offset = psm->rowOffset[y & 7];
-
-			for(; len > 0 && x < ex; len--, x += 2, pb++)
-			{
-				WritePixel4(addr + offset[x + 0], *pb & 0xf);
-				WritePixel4(addr + offset[x + 1], *pb >> 4);
-			}
-
-			if(x >= ex) {x = sx; y++;}
-		}
-
-		break;
-
-	case PSM_PSMT8H:
-
-		while(len > 0)
-		{
-			u32 addr = psm->pa(0, y, bp, bw);
-			int* offset = psm->rowOffset[y & 7];
-
-			for(; len > 0 && x < ex; len--, x++, pb++)
-			{
-				WritePixel8H(addr + offset[x], *pb);
-			}
-
-			if(x >= ex) {x = sx; y++;}
-		}
-
-		break;
-
-	case PSM_PSMT4HL:
-
-		while(len > 0)
-		{
-			u32 addr = psm->pa(0, y, bp, bw);
-			int* offset = psm->rowOffset[y & 7];
-
-			for(; len > 0 && x < ex; len--, x += 2, pb++)
-			{
-				WritePixel4HL(addr + offset[x + 0], *pb & 0xf);
-				WritePixel4HL(addr + offset[x + 1], *pb >> 4);
-			}
-
-			if(x >= ex) {x = sx; y++;}
-		}
-
-		break;
-
-	case PSM_PSMT4HH:
-
-		while(len > 0)
-		{
-			u32 addr = psm->pa(0, y, bp, bw);
-			int* offset = psm->rowOffset[y & 7];
-
-			for(; len > 0 && x < ex; len--, x += 2, pb++)
-			{
-				WritePixel4HH(addr + offset[x + 0], *pb & 0xf);
-				WritePixel4HH(addr + offset[x + 1], *pb >> 4);
-			}
-
-			if(x >= ex) {x = sx; y++;}
-		}
-
-		break;
-	}
-
-	tx = x;
-	ty = y;
-}
-
-//
-
-void GSLocalMemory::ReadImageX(int& tx, int& ty, u8* dst, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG) const
-{
-	if(len <= 0) return;
-
-	u8* RESTRICT pb = (u8*)dst;
-	u16* RESTRICT pw = (u16*)dst;
-	u32* RESTRICT pd = (u32*)dst;
-
-	u32 bp = BITBLTBUF.SBP;
-	u32 bw = BITBLTBUF.SBW;
-	psm_t* RESTRICT psm = &m_psm[BITBLTBUF.SPSM];
-
-	int x = tx;
-	int y = ty;
-	int sx = (int)TRXPOS.SSAX;
-	int ex = sx + (int)TRXREG.RRW;
-
-	// printf("spsm=%d x=%d ex=%d y=%d len=%d\n", BITBLTBUF.SPSM, x, ex, y, len);
-
-	switch(BITBLTBUF.SPSM)
-	{
-	case PSM_PSMCT32:
-	case PSM_PSMZ32:
-
-		// MGS1 intro, fade effect between two scenes (airplane outside-inside transition)
-
-		len /= 4;
-
-		while(len > 0)
-		{
-			int* RESTRICT offset = psm->rowOffset[y & 7];
-			u32* RESTRICT ps = &m_vm32[psm->pa(0, y, bp, bw)];
-
-			for(; len > 0 && x < ex && (x & 7); len--, x++, pd++) 
-			{
-				*pd = ps[offset[x]];
-			}
-
-			// aligned to a column
-
-			for(int ex8 = ex - 8; len >= 8 && x <= ex8; len -= 8, x += 8, pd += 8)
-			{
-				int off = offset[x];
-
-				GSVector4i::store<false>(&pd[0], GSVector4i::load(&ps[off + 0], &ps[off + 4]));
-				GSVector4i::store<false>(&pd[4], GSVector4i::load(&ps[off + 8], &ps[off + 12]));
-
-				for(int i = 0; i < 8; i++) ASSERT(pd[i] == ps[offset[x + i]]);
-			}
-
-			for(; len > 0 && x < ex; len--, x++, pd++)
-			{
-				*pd = ps[offset[x]];
-			}
-
-			if(x == ex) {x = sx; y++;}
-		}
-
-		break;
-
-	case PSM_PSMCT24:
-	case PSM_PSMZ24:
-
-		len /= 3;
-
-		while(len > 0)
-		{
-			int* RESTRICT offset = psm->rowOffset[y & 7];
-			u32* RESTRICT ps = &m_vm32[psm->pa(0, y, bp, bw)];
-
-			for(; len > 0 && x < ex; len--, x++, pb += 3)
-			{
-				u32 c = ps[offset[x]];
-
-				pb[0] = (u8)(c);
-				pb[1] = (u8)(c >> 8);
-				pb[2] = (u8)(c >> 16);
-			}
-
-			if(x == ex) {x = sx; y++;}
-		}
-
-		break;
-
-	case PSM_PSMCT16:
-	case PSM_PSMCT16S:
-	case PSM_PSMZ16:
-	case PSM_PSMZ16S:
-
-		len /= 2;
-
-		while(len > 0)
-		{
-			int* RESTRICT offset = psm->rowOffset[y & 7];
-			u16* RESTRICT ps = &m_vm16[psm->pa(0, y, bp, bw)];
-
-			for(int ex4 = ex - 4; len >= 4 && x <= ex4; len -= 4, x += 4, pw += 4)
-			{
-				pw[0] = ps[offset[x + 0]];
-				pw[1] = ps[offset[x + 1]];
-				pw[2] = ps[offset[x + 2]];
-				pw[3] = ps[offset[x + 3]];
-			}
-
-			for(; len > 0 && x < ex; len--, x++, pw++)
-			{
-				*pw = ps[offset[x]];
-			}
-
-			if(x == ex) {x = sx; y++;}
-		}
-
-		break;
-
-	case PSM_PSMT8:
-
-		while(len > 0)
-		{
-			int* RESTRICT offset = psm->rowOffset[y & 7];
-			u8* RESTRICT ps = &m_vm8[psm->pa(0, y, bp, bw)];
-
-			for(int ex4 = ex - 4; len >= 4 && x <= ex4; len -= 4, x += 4, pb += 4)
-			{
-				pb[0] = ps[offset[x + 0]];
-				pb[1] = ps[offset[x + 1]];
-				pb[2] = ps[offset[x + 2]];
-				pb[3] = ps[offset[x + 3]];
-			}
-
-			for(; len > 0 && x < ex; len--, x++, pb++)
-			{
-				*pb = ps[offset[x]];
-			}
-
-			if(x == ex) {x = sx; y++;}
-		}
-
-		break;
-
-	case PSM_PSMT4:
-
-		while(len > 0)
-		{
-			u32 addr = psm->pa(0, y, bp, bw);
-			int* RESTRICT offset = psm->rowOffset[y & 7];
-
-			for(; len > 0 && x < ex; len--, x += 2, pb++)
-			{
-				*pb = (u8)(ReadPixel4(addr + offset[x + 0]) | (ReadPixel4(addr + offset[x + 1]) << 4));
-			}
-
-			if(x == ex) {x = sx; y++;}
-		}
-
-		break;
-
-	case PSM_PSMT8H:
-
-		while(len > 0)
-		{
-			int* RESTRICT offset = psm->rowOffset[y & 7];
-			u32* RESTRICT ps = &m_vm32[psm->pa(0, y, bp, bw)];
-
-			for(int ex4 = ex - 4; len >= 4 && x <= ex4; len -= 4, x += 4, pb += 4)
-			{
-				pb[0] = (u8)(ps[offset[x + 0]] >> 24);
-				pb[1] = (u8)(ps[offset[x + 1]] >> 24);
-				pb[2] = (u8)(ps[offset[x + 2]] >> 24);
-				pb[3] = (u8)(ps[offset[x + 3]] >> 24);
-			}
-
-			for(; len > 0 && x < ex; len--, x++, pb++)
-			{
-				*pb = (u8)(ps[offset[x]] >> 24);
-			}
-
-			if(x == ex) {x = sx; y++;}
-		}
-
-		break;
-
-	case PSM_PSMT4HL:
-
-		while(len > 0)
-		{
-			int* offset = psm->rowOffset[y & 7];
-			u32* RESTRICT ps = &m_vm32[psm->pa(0, y, bp, bw)];
-
-			for(; len > 0 && x < ex; len--, x += 2, pb++)
-			{
-				u32 c0 = (ps[offset[x + 0]] >> 24) & 0x0f;
-				u32 c1 = (ps[offset[x + 1]] >> 20) & 0xf0;
-
-				*pb = (u8)(c0 | c1);
-			}
-
-			if(x == ex) {x = sx; y++;}
-		}
-
-		break;
-
-	case PSM_PSMT4HH:
-
-		while(len > 0)
-		{
-			int* RESTRICT offset = psm->rowOffset[y & 7];
-			u32* RESTRICT ps = &m_vm32[psm->pa(0, y, bp, bw)];
-
-			for(; len > 0 && x < ex; len--, x += 2, pb++)
-			{
-				u32 c0 = (ps[offset[x + 0]] >> 28) & 0x0f;
-				u32 c1 = (ps[offset[x + 1]] >> 24) & 0xf0;
-
-				*pb = (u8)(c0 | c1);
-			}
-
-			if(x == ex) {x = sx; y++;}
-		}
-
-		break;
-	}
-
-	tx = x;
-	ty = y;
-}
-
-///////////////////
-
-void GSLocalMemory::ReadTexture32(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
-{
-	FOREACH_BLOCK_START(r, 8, 8, 32)
-	{
-		GSBlock::ReadBlock32(src, read_dst, dstpitch);
-	}
-	FOREACH_BLOCK_END
-}
-
-void GSLocalMemory::ReadTexture24(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
-{
-	if(TEXA.AEM)
-	{
-		FOREACH_BLOCK_START(r, 8, 8, 32)
-		{
-			GSBlock::ReadAndExpandBlock24<true>(src, read_dst, dstpitch, TEXA);
-		}
-		FOREACH_BLOCK_END
-	}
-	else
-	{
-		FOREACH_BLOCK_START(r, 8, 8, 32)
-		{
-			GSBlock::ReadAndExpandBlock24<false>(src, read_dst, dstpitch, TEXA);
-		}
-		FOREACH_BLOCK_END
-	}
-}
-
-void GSLocalMemory::ReadTextureGPU24(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
-{
-	FOREACH_BLOCK_START(r, 16, 8, 16)
-	{
-		GSBlock::ReadBlock16(src, read_dst, dstpitch);
-	}
-	FOREACH_BLOCK_END
-
-	// Convert packed RGB scanline to 32 bits RGBA
-	ASSERT(dstpitch >= r.width() * 4);
-	for(int y = r.top; y < r.bottom; y ++) {
-		u8* line = dst + y * dstpitch;
-
-		for(int x = r.right; x >= r.left; x--) {
-			*(u32*)&line[x * 4] = *(u32*)&line[x * 3] & 0xFFFFFF;
-		}
-	}
-}
-
-void GSLocalMemory::ReadTexture16(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
-{
-	if(TEXA.AEM)
-	{
-		FOREACH_BLOCK_START(r, 16, 8, 32)
-		{
-			GSBlock::ReadAndExpandBlock16<true>(src, read_dst, dstpitch, TEXA);
-		}
-		FOREACH_BLOCK_END
-	}
-	else
-	{
-		FOREACH_BLOCK_START(r, 16, 8, 32)
-		{
-			GSBlock::ReadAndExpandBlock16<false>(src, read_dst, dstpitch, TEXA);
-		}
-		FOREACH_BLOCK_END
-	}
-}
-
-void GSLocalMemory::ReadTexture8(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
-{
-	const u32* pal = m_clut;
-
-	FOREACH_BLOCK_START(r, 16, 16, 32)
-	{
-		GSBlock::ReadAndExpandBlock8_32(src, read_dst, dstpitch, pal);
-	}
-	FOREACH_BLOCK_END
-}
-
-void GSLocalMemory::ReadTexture4(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
-{
-	const u64* pal = m_clut;
-
-	FOREACH_BLOCK_START(r, 32, 16, 32)
-	{
-		GSBlock::ReadAndExpandBlock4_32(src, read_dst, dstpitch, pal);
-	}
-	FOREACH_BLOCK_END
-}
-
-void GSLocalMemory::ReadTexture8H(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
-{
-	const u32* pal = m_clut;
-
-	FOREACH_BLOCK_START(r, 8, 8, 32)
-	{
-		GSBlock::ReadAndExpandBlock8H_32(src, read_dst, dstpitch, pal);
-	}
-	FOREACH_BLOCK_END
-}
-
-void GSLocalMemory::ReadTexture4HL(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
-{
-	const u32* pal = m_clut;
-
-	FOREACH_BLOCK_START(r, 8, 8, 32)
-	{
-		GSBlock::ReadAndExpandBlock4HL_32(src, read_dst, dstpitch, pal);
-	}
-	FOREACH_BLOCK_END
-}
-
-void GSLocalMemory::ReadTexture4HH(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
-{
-	const u32* pal = m_clut;
-
-	FOREACH_BLOCK_START(r, 8, 8, 32)
-	{
-		GSBlock::ReadAndExpandBlock4HH_32(src, read_dst, dstpitch, pal);
-	}
-	FOREACH_BLOCK_END
-}
-
-///////////////////
-
-void GSLocalMemory::ReadTextureBlock32(u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
-{
-	ALIGN_STACK(32);
-
-	GSBlock::ReadBlock32(BlockPtr(bp), dst, dstpitch);
-}
-
-void GSLocalMemory::ReadTextureBlock24(u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
-{
-	ALIGN_STACK(32);
-
-	if(TEXA.AEM)
-	{
-		GSBlock::ReadAndExpandBlock24<true>(BlockPtr(bp), dst, dstpitch, TEXA);
-	}
-	else
-	{
-		GSBlock::ReadAndExpandBlock24<false>(BlockPtr(bp), dst, dstpitch, TEXA);
-	}
-}
-
-void GSLocalMemory::ReadTextureBlock16(u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
-{
-	ALIGN_STACK(32);
-
-	if(TEXA.AEM)
-	{
-		GSBlock::ReadAndExpandBlock16<true>(BlockPtr(bp), dst, dstpitch, TEXA);
-	}
-	else
-	{
-		GSBlock::ReadAndExpandBlock16<false>(BlockPtr(bp), dst, dstpitch, TEXA);
-	}
-}
-
-void GSLocalMemory::ReadTextureBlock8(u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
-{
-	ALIGN_STACK(32);
-
-	GSBlock::ReadAndExpandBlock8_32(BlockPtr(bp), dst, dstpitch, m_clut);
-}
-
-void GSLocalMemory::ReadTextureBlock4(u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
-{
-	ALIGN_STACK(32);
-
-	GSBlock::ReadAndExpandBlock4_32(BlockPtr(bp), dst, dstpitch, m_clut);
-}
-
-void GSLocalMemory::ReadTextureBlock8H(u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
-{
-	ALIGN_STACK(32);
-
-	GSBlock::ReadAndExpandBlock8H_32(BlockPtr(bp), dst, dstpitch, m_clut);
-}
-
-void GSLocalMemory::ReadTextureBlock4HL(u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
-{
-	ALIGN_STACK(32);
-
-	GSBlock::ReadAndExpandBlock4HL_32(BlockPtr(bp), dst, dstpitch, m_clut);
-}
-
-void GSLocalMemory::ReadTextureBlock4HH(u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
-{
-	ALIGN_STACK(32);
-
-	GSBlock::ReadAndExpandBlock4HH_32(BlockPtr(bp), dst, dstpitch, m_clut);
-}
-
-///////////////////
-
-void GSLocalMemory::ReadTexture(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
-{
-	const psm_t& psm = m_psm[off->psm];
-
-	readTexel rt = psm.rt;
-	readTexture rtx = psm.rtx;
-
-	if(r.width() < psm.bs.x || r.height() < psm.bs.y
-	|| (r.left & (psm.bs.x - 1)) || (r.top & (psm.bs.y - 1))
-	|| (r.right & (psm.bs.x - 1)) || (r.bottom & (psm.bs.y - 1)))
-	{
-		GIFRegTEX0 TEX0;
-
-		TEX0.TBP0 = off->bp;
-		TEX0.TBW = off->bw;
-		TEX0.PSM = off->psm;
-
-		GSVector4i cr = r.ralign<Align_Inside>(psm.bs);
-
-		bool aligned = ((size_t)(dst + (cr.left - r.left) * sizeof(u32)) & 0xf) == 0;
-
-		if(cr.rempty() || !aligned)
-		{
-			// TODO: expand r to block size, read into temp buffer
-#ifndef NDEBUG
-			if(!aligned) printf("unaligned memory pointer passed to ReadTexture\n");
-#endif
-
-			for(int y = r.top; y < r.bottom; y++, dst += dstpitch)
-			{
-				for(int x = r.left, i = 0; x < r.right; x++, i++)
-				{
-					((u32*)dst)[i] = (this->*rt)(x, y, TEX0, TEXA);
-				}
-			}
-		}
-		else
-		{
-			for(int y = r.top; y < cr.top; y++, dst += dstpitch)
-			{
-				for(int x = r.left, i = 0; x < r.right; x++, i++)
-				{
-					((u32*)dst)[i] = (this->*rt)(x, y, TEX0, TEXA);
-				}
-			}
-
-			for(int y = cr.bottom; y < r.bottom; y++, dst += dstpitch)
-			{
-				for(int x = r.left, i = 0; x < r.right; x++, i++)
-				{
-					((u32*)dst)[i] = (this->*rt)(x, y, TEX0, TEXA);
-				}
-			}
-
-			for(int y = cr.top; y < cr.bottom; y++, dst += dstpitch)
-			{
-				for(int x = r.left, i = 0; x < cr.left; x++, i++)
-				{
-					((u32*)dst)[i] = (this->*rt)(x, y, TEX0, TEXA);
-				}
-
-				for(int x = cr.right, i = x - r.left; x < r.right; x++, i++)
-				{
-					((u32*)dst)[i] = (this->*rt)(x, y, TEX0, TEXA);
-				}
-			}
-
-			if(!cr.rempty())
-			{
-				(this->*rtx)(off, cr, dst + (cr.left - r.left) * sizeof(u32), dstpitch, TEXA);
-			}
-		}
-	}
-	else
-	{
-		(this->*rtx)(off, r, dst, dstpitch, TEXA);
-	}
-}
-
-// 32/8
-
-void GSLocalMemory::ReadTexture8P(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
-{
-	FOREACH_BLOCK_START(r, 16, 16, 8)
-	{
-		GSBlock::ReadBlock8(src, read_dst, dstpitch);
-	}
-	FOREACH_BLOCK_END
-}
-
-void GSLocalMemory::ReadTexture4P(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
-{
-	FOREACH_BLOCK_START(r, 32, 16, 8)
-	{
-		GSBlock::ReadBlock4P(src, read_dst, dstpitch);
-	}
-	FOREACH_BLOCK_END
-}
-
-void GSLocalMemory::ReadTexture8HP(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
-{
-	FOREACH_BLOCK_START(r, 8, 8, 8)
-	{
-		GSBlock::ReadBlock8HP(src, read_dst, dstpitch);
-	}
-	FOREACH_BLOCK_END
-}
-
-void GSLocalMemory::ReadTexture4HLP(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
-{
-	FOREACH_BLOCK_START(r, 8, 8, 8)
-	{
-		GSBlock::ReadBlock4HLP(src, read_dst, dstpitch);
-	}
-	FOREACH_BLOCK_END
-}
-
-void GSLocalMemory::ReadTexture4HHP(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
-{
-	FOREACH_BLOCK_START(r, 8, 8, 8)
-	{
-		GSBlock::ReadBlock4HHP(src, read_dst, dstpitch);
-	}
-	FOREACH_BLOCK_END
-}
-
-//
-
-void GSLocalMemory::ReadTextureBlock8P(u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
-{
-	GSBlock::ReadBlock8(BlockPtr(bp), dst, dstpitch);
-}
-
-void GSLocalMemory::ReadTextureBlock4P(u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
-{
-	ALIGN_STACK(32);
-
-	GSBlock::ReadBlock4P(BlockPtr(bp), dst, dstpitch);
-}
-
-void GSLocalMemory::ReadTextureBlock8HP(u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
-{
-	ALIGN_STACK(32);
-
-	GSBlock::ReadBlock8HP(BlockPtr(bp), dst, dstpitch);
-}
-
-void GSLocalMemory::ReadTextureBlock4HLP(u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
-{
-	ALIGN_STACK(32);
-
-	GSBlock::ReadBlock4HLP(BlockPtr(bp), dst, dstpitch);
-}
-
-void GSLocalMemory::ReadTextureBlock4HHP(u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
-{
-	ALIGN_STACK(32);
-
-	GSBlock::ReadBlock4HHP(BlockPtr(bp), dst, dstpitch);
-}
-
 //
 
 #include "Renderers/SW/GSTextureSW.h"
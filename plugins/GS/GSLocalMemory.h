@@ -29,8 +29,8 @@
 #include "GS.h"
 #include "GSTables.h"
 #include "GSVector.h"
-#include "GSBlock.h"
 #include "GSClut.h"
+#include "GSMultiISA.h"
 
 class GSOffset : public GSAlignedClass<32>
 {
@@ -84,6 +84,170 @@ struct GSPixelOffset4
 	u32 fbp, zbp, fpsm, zpsm, bw;
 };
 
+// Flat open addressed key -> offset table with a direct mapped cache of recent lookups in front.
+// Offsets are never removed, the owner frees the values.
+
+template<class K, class V> class GSOffsetMap
+{
+	struct Slot {K key; V* value;}; // value NULL: empty
+
+	enum {FRONT_BITS = 4};
+
+	Slot m_front[1 << FRONT_BITS];
+	Slot* m_table;
+	u32 m_bits;
+	u32 m_count;
+
+	static u64 Mix(K key)
+	{
+		u64 k = (u64)key;
+
+		return (k ^ (k >> 32)) * 0x9e3779b97f4a7c15ull;
+	}
+
+	static void Place(Slot* table, u32 bits, K key, V* value)
+	{
+		u32 mask = (1u << bits) - 1;
+		u32 i = (u32)(Mix(key) >> (64 - bits));
+
+		while(table[i].value != NULL)
+		{
+			i = (i + 1) & mask;
+		}
+
+		table[i].key = key;
+		table[i].value = value;
+	}
+
+public:
+	GSOffsetMap()
+		: m_bits(6)
+		, m_count(0)
+	{
+		memset(m_front, 0, sizeof(m_front));
+
+		m_table = (Slot*)calloc(1u << m_bits, sizeof(Slot));
+	}
+
+	~GSOffsetMap()
+	{
+		free(m_table);
+	}
+
+	V* Find(K key)
+	{
+		u64 h = Mix(key);
+
+		Slot& front = m_front[h >> (64 - FRONT_BITS)];
+
+		if(front.value != NULL && front.key == key)
+		{
+			return front.value;
+		}
+
+		u32 mask = (1u << m_bits) - 1;
+
+		for(u32 i = (u32)(h >> (64 - m_bits)); m_table[i].value != NULL; i = (i + 1) & mask)
+		{
+			if(m_table[i].key == key)
+			{
+				front = m_table[i];
+
+				return front.value;
+			}
+		}
+
+		return NULL;
+	}
+
+	void Insert(K key, V* value)
+	{
+		if(++m_count * 2 > (1u << m_bits))
+		{
+			Slot* table = (Slot*)calloc(2u << m_bits, sizeof(Slot));
+
+			for(u32 i = 0; i < (1u << m_bits); i++)
+			{
+				if(m_table[i].value != NULL)
+				{
+					Place(table, m_bits + 1, m_table[i].key, m_table[i].value);
+				}
+			}
+
+			free(m_table);
+
+			m_table = table;
+			m_bits++;
+		}
+
+		Place(m_table, m_bits, key, value);
+
+		Slot& front = m_front[Mix(key) >> (64 - FRONT_BITS)];
+
+		front.key = key;
+		front.value = value;
+	}
+
+	template<class F> void ForEach(F f) const
+	{
+		for(u32 i = 0; i < (1u << m_bits); i++)
+		{
+			if(m_table[i].value != NULL)
+			{
+				f(m_table[i].value);
+			}
+		}
+	}
+};
+
+// Bump allocator for the offset tables, everything is released at once with the local memory
+
+class GSOffsetArena
+{
+	enum {CHUNK_SIZE = 1 << 20};
+
+	std::vector<u8*> m_chunks;
+	u8* m_ptr;
+	size_t m_left;
+
+public:
+	GSOffsetArena()
+		: m_ptr(NULL)
+		, m_left(0)
+	{
+	}
+
+	~GSOffsetArena()
+	{
+		for(u8* p : m_chunks)
+		{
+			_aligned_free(p);
+		}
+	}
+
+	void* Alloc(size_t size) // 32 byte aligned
+	{
+		size = (size + 31) & ~(size_t)31;
+
+		if(size > m_left)
+		{
+			m_left = std::max<size_t>(size, CHUNK_SIZE);
+			m_ptr = (u8*)_aligned_malloc(m_left, 32);
+
+			m_chunks.push_back(m_ptr);
+		}
+
+		void* p = m_ptr;
+
+		m_ptr += size;
+		m_left -= size;
+
+		return p;
+	}
+};
+
+MULTI_ISA_DEF(class GSLocalMemoryFunctions;)
+
 class GSLocalMemory : public GSAlignedClass<32>
 {
 public:
@@ -96,10 +260,10 @@ public:
 	typedef void (GSLocalMemory::*writeFrameAddr)(u32 addr, u32 c);
 	typedef u32 (GSLocalMemory::*readPixelAddr)(u32 addr) const;
 	typedef u32 (GSLocalMemory::*readTexelAddr)(u32 addr, const GIFRegTEXA& TEXA) const;
-	typedef void (GSLocalMemory::*writeImage)(int& tx, int& ty, const u8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG);
-	typedef void (GSLocalMemory::*readImage)(int& tx, int& ty, u8* dst, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG) const;
-	typedef void (GSLocalMemory::*readTexture)(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
-	typedef void (GSLocalMemory::*readTextureBlock)(u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA) const;
+	typedef void (*writeImage)(GSLocalMemory& mem, int& tx, int& ty, const u8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG);
+	typedef void (*readImage)(const GSLocalMemory& mem, int& tx, int& ty, u8* dst, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG);
+	typedef void (*readTexture)(GSLocalMemory& mem, const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
+	typedef void (*readTextureBlock)(const GSLocalMemory& mem, u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
 
 	struct alignas(128) psm_t
 	{
@@ -175,13 +339,15 @@ protected:
 	// TODO
 
 	friend class GSClut;
+	MULTI_ISA_FRIEND(GSLocalMemoryFunctions)
 
 	//
 
-	std::unordered_map<u32, GSOffset*> m_omap;
-	std::unordered_map<u32, GSPixelOffset*> m_pomap;
-	std::unordered_map<u32, GSPixelOffset4*> m_po4map;
-	std::unordered_map<u64, std::vector<GSVector2i>*> m_p2tmap;
+	GSOffsetArena m_offset_arena;
+	GSOffsetMap<u32, GSOffset> m_omap;
+	GSOffsetMap<u32, GSPixelOffset> m_pomap;
+	GSOffsetMap<u32, GSPixelOffset4> m_po4map;
+	GSOffsetMap<u64, std::vector<GSVector2i>> m_p2tmap;
 
 public:
 	GSLocalMemory();
@@ -194,91 +360,91 @@ public:
 
 	// address
 
-	static u32 BlockNumber32(int x, int y, u32 bp, u32 bw)
+	static __forceinline u32 BlockNumber32(int x, int y, u32 bp, u32 bw)
 	{
 		return bp + (y & ~0x1f) * bw + ((x >> 1) & ~0x1f) + blockTable32[(y >> 3) & 3][(x >> 3) & 7];
 	}
 
-	static u32 BlockNumber16(int x, int y, u32 bp, u32 bw)
+	static __forceinline u32 BlockNumber16(int x, int y, u32 bp, u32 bw)
 	{
 		return bp + ((y >> 1) & ~0x1f) * bw + ((x >> 1) & ~0x1f) + blockTable16[(y >> 3) & 7][(x >> 4) & 3];
 	}
 
-	static u32 BlockNumber16S(int x, int y, u32 bp, u32 bw)
+	static __forceinline u32 BlockNumber16S(int x, int y, u32 bp, u32 bw)
 	{
 		return bp + ((y >> 1) & ~0x1f) * bw + ((x >> 1) & ~0x1f) + blockTable16S[(y >> 3) & 7][(x >> 4) & 3];
 	}
 
-	static u32 BlockNumber8(int x, int y, u32 bp, u32 bw)
+	static __forceinline u32 BlockNumber8(int x, int y, u32 bp, u32 bw)
 	{
 		// ASSERT((bw & 1) == 0); // allowed for mipmap levels
 
 		return bp + ((y >> 1) & ~0x1f) * (bw >> 1) + ((x >> 2) & ~0x1f) + blockTable8[(y >> 4) & 3][(x >> 4) & 7];
 	}
 
-	static u32 BlockNumber4(int x, int y, u32 bp, u32 bw)
+	static __forceinline u32 BlockNumber4(int x, int y, u32 bp, u32 bw)
 	{
 		// ASSERT((bw & 1) == 0); // allowed for mipmap levels
 
 		return bp + ((y >> 2) & ~0x1f) * (bw >> 1) + ((x >> 2) & ~0x1f) + blockTable4[(y >> 4) & 7][(x >> 5) & 3];
 	}
 
-	static u32 BlockNumber32Z(int x, int y, u32 bp, u32 bw)
+	static __forceinline u32 BlockNumber32Z(int x, int y, u32 bp, u32 bw)
 	{
 		return bp + (y & ~0x1f) * bw + ((x >> 1) & ~0x1f) + blockTable32Z[(y >> 3) & 3][(x >> 3) & 7];
 	}
 
-	static u32 BlockNumber16Z(int x, int y, u32 bp, u32 bw)
+	static __forceinline u32 BlockNumber16Z(int x, int y, u32 bp, u32 bw)
 	{
 		return bp + ((y >> 1) & ~0x1f) * bw + ((x >> 1) & ~0x1f) + blockTable16Z[(y >> 3) & 7][(x >> 4) & 3];
 	}
 
-	static u32 BlockNumber16SZ(int x, int y, u32 bp, u32 bw)
+	static __forceinline u32 BlockNumber16SZ(int x, int y, u32 bp, u32 bw)
 	{
 		return bp + ((y >> 1) & ~0x1f) * bw + ((x >> 1) & ~0x1f) + blockTable16SZ[(y >> 3) & 7][(x >> 4) & 3];
 	}
 
-	u8* BlockPtr(u32 bp) const
+	__forceinline u8* BlockPtr(u32 bp) const
 	{
 		return &m_vm8[(bp % MAX_BLOCKS) << 8];
 	}
 
-	u8* BlockPtr32(int x, int y, u32 bp, u32 bw) const
+	__forceinline u8* BlockPtr32(int x, int y, u32 bp, u32 bw) const
 	{
 		return &m_vm8[BlockNumber32(x, y, bp, bw) << 8];
 	}
 
-	u8* BlockPtr16(int x, int y, u32 bp, u32 bw) const
+	__forceinline u8* BlockPtr16(int x, int y, u32 bp, u32 bw) const
 	{
 		return &m_vm8[BlockNumber16(x, y, bp, bw) << 8];
 	}
 
-	u8* BlockPtr16S(int x, int y, u32 bp, u32 bw) const
+	__forceinline u8* BlockPtr16S(int x, int y, u32 bp, u32 bw) const
 	{
 		return &m_vm8[BlockNumber16S(x, y, bp, bw) << 8];
 	}
 
-	u8* BlockPtr8(int x, int y, u32 bp, u32 bw) const
+	__forceinline u8* BlockPtr8(int x, int y, u32 bp, u32 bw) const
 	{
 		return &m_vm8[BlockNumber8(x, y, bp, bw) << 8];
 	}
 
-	u8* BlockPtr4(int x, int y, u32 bp, u32 bw) const
+	__forceinline u8* BlockPtr4(int x, int y, u32 bp, u32 bw) const
 	{
 		return &m_vm8[BlockNumber4(x, y, bp, bw) << 8];
 	}
 
-	u8* BlockPtr32Z(int x, int y, u32 bp, u32 bw) const
+	__forceinline u8* BlockPtr32Z(int x, int y, u32 bp, u32 bw) const
 	{
 		return &m_vm8[BlockNumber32Z(x, y, bp, bw) << 8];
 	}
 
-	u8* BlockPtr16Z(int x, int y, u32 bp, u32 bw) const
+	__forceinline u8* BlockPtr16Z(int x, int y, u32 bp, u32 bw) const
 	{
 		return &m_vm8[BlockNumber16Z(x, y, bp, bw) << 8];
 	}
 
-	u8* BlockPtr16SZ(int x, int y, u32 bp, u32 bw) const
+	__forceinline u8* BlockPtr16SZ(int x, int y, u32 bp, u32 bw) const
 	{
 		return &m_vm8[BlockNumber16SZ(x, y, bp, bw) << 8];
 	}
@@ -853,75 +1019,13 @@ public:
 
 	//
 
-	template<int psm, int bsx, int bsy, int alignment>
-	void WriteImageColumn(int l, int r, int y, int h, const u8* src, int srcpitch, const GIFRegBITBLTBUF& BITBLTBUF);
-
-	template<int psm, int bsx, int bsy, int alignment>
-	void WriteImageBlock(int l, int r, int y, int h, const u8* src, int srcpitch, const GIFRegBITBLTBUF& BITBLTBUF);
-
-	template<int psm, int bsx, int bsy>
-	void WriteImageLeftRight(int l, int r, int y, int h, const u8* src, int srcpitch, const GIFRegBITBLTBUF& BITBLTBUF);
-
-	template<int psm, int bsx, int bsy, int trbpp>
-	void WriteImageTopBottom(int l, int r, int y, int h, const u8* src, int srcpitch, const GIFRegBITBLTBUF& BITBLTBUF);
-
-	template<int psm, int bsx, int bsy, int trbpp>
-	void WriteImage(int& tx, int& ty, const u8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG);
-
-	void WriteImage24(int& tx, int& ty, const u8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG);
-	void WriteImage8H(int& tx, int& ty, const u8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG);
-	void WriteImage4HL(int& tx, int& ty, const u8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG);
-	void WriteImage4HH(int& tx, int& ty, const u8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG);
-	void WriteImage24Z(int& tx, int& ty, const u8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG);
-	void WriteImageX(int& tx, int& ty, const u8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG);
-
-	// TODO: ReadImage32/24/...
-
-	void ReadImageX(int& tx, int& ty, u8* dst, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG) const;
-
-	// * => 32
-
-	void ReadTexture32(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
-	void ReadTextureGPU24(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
-	void ReadTexture24(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
-	void ReadTexture16(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
-	void ReadTexture8(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
-	void ReadTexture4(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
-	void ReadTexture8H(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
-	void ReadTexture4HL(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
-	void ReadTexture4HH(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
+	// The transfer and unswizzle functions of the psm table live in GSLocalMemoryMultiISA.cpp
 
 	void ReadTexture(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
 
-	void ReadTextureBlock32(u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA) const;
-	void ReadTextureBlock24(u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA) const;
-	void ReadTextureBlock16(u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA) const;
-	void ReadTextureBlock8(u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA) const;
-	void ReadTextureBlock4(u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA) const;
-	void ReadTextureBlock8H(u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA) const;
-	void ReadTextureBlock4HL(u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA) const;
-	void ReadTextureBlock4HH(u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA) const;
-
-	// pal ? 8 : 32
-
-	void ReadTexture8P(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
-	void ReadTexture4P(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
-	void ReadTexture8HP(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
-	void ReadTexture4HLP(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
-	void ReadTexture4HHP(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
-
-	void ReadTextureBlock8P(u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA) const;
-	void ReadTextureBlock4P(u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA) const;
-	void ReadTextureBlock8HP(u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA) const;
-	void ReadTextureBlock4HLP(u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA) const;
-	void ReadTextureBlock4HHP(u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA) const;
-
-	//
-
-	template<typename T> void ReadTexture(const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
-
 	//
 
 	void SaveBMP(const std::string& fn, u32 bp, u32 bw, u32 psm, int w, int h);
 };
 
+MULTI_ISA_DEF(void GSLocalMemoryPopulateFunctions(GSLocalMemory::psm_t* psm);)
@@ -0,0 +1,1505 @@
+/*
+ *	Copyright (C) 2007-2009 Gabest
+ *	http://www.gabest.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNU Make; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ *	Special Notes:
+ *
+ *	Based on Page.c from GSSoft
+ *	Copyright (C) 2002-2004 GSsoft Team
+ *
+ */
+
+#include "Pcsx2Types.h"
+
+#include "GSLocalMemory.h"
+#include "GSBlock.h"
+
+// Host to local, local to host and texture unswizzling. The file is built once per
+// instruction set (see GSMultiISA.h), GSLocalMemory only sees the entry points that
+// PopulateFunctions puts into its psm table.
+
+#define ASSERT_BLOCK(r, w, h) \
+	ASSERT((r).width() >= (w) && (r).height() >= (h) && !((r).left & ((w) - 1)) && !((r).top & ((h) - 1)) && !((r).right & ((w) - 1)) && !((r).bottom & ((h) - 1))); \
+
+#define FOREACH_BLOCK_START(r, w, h, bpp) \
+	ASSERT_BLOCK(r, w, h); \
+	GSVector4i _r = (r) >> 3; \
+	u8* _dst = dst - _r.left * (bpp); \
+	int _offset = dstpitch * (h); \
+	for(int y = _r.top; y < _r.bottom; y += (h) >> 3, _dst += _offset) \
+	{ \
+		u32 _base = off->block.row[y]; \
+		for(int x = _r.left; x < _r.right; x += (w) >> 3) \
+		{ \
+			const u8* src = mem.BlockPtr(_base + off->block.col[x]); \
+			u8* read_dst = &_dst[x * (bpp)]; \
+
+#define FOREACH_BLOCK_END }}
+
+MULTI_ISA_UNSHARED_START
+
+class GSLocalMemoryFunctions
+{
+	template<int psm, int bsx, int bsy, int alignment>
+	static void WriteImageColumn(GSLocalMemory& mem, int l, int r, int y, int h, const u8* src, int srcpitch, const GIFRegBITBLTBUF& BITBLTBUF);
+
+	template<int psm, int bsx, int bsy, int alignment>
+	static void WriteImageBlock(GSLocalMemory& mem, int l, int r, int y, int h, const u8* src, int srcpitch, const GIFRegBITBLTBUF& BITBLTBUF);
+
+	template<int psm, int bsx, int bsy, int trbpp>
+	static void WriteImageLeftRight(GSLocalMemory& mem, int l, int r, int y, int h, const u8* src, int srcpitch, const GIFRegBITBLTBUF& BITBLTBUF);
+
+	template<int psm, int bsx, int bsy, int trbpp>
+	static void WriteImageTopBottom(GSLocalMemory& mem, int l, int r, int y, int h, const u8* src, int srcpitch, const GIFRegBITBLTBUF& BITBLTBUF);
+
+	template<int psm, int bsx, int bsy, int trbpp>
+	static void WriteImage(GSLocalMemory& mem, int& tx, int& ty, const u8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG);
+
+	static void WriteImage24(GSLocalMemory& mem, int& tx, int& ty, const u8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG);
+	static void WriteImage8H(GSLocalMemory& mem, int& tx, int& ty, const u8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG);
+	static void WriteImage4HL(GSLocalMemory& mem, int& tx, int& ty, const u8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG);
+	static void WriteImage4HH(GSLocalMemory& mem, int& tx, int& ty, const u8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG);
+	static void WriteImage24Z(GSLocalMemory& mem, int& tx, int& ty, const u8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG);
+	static void WriteImageX(GSLocalMemory& mem, int& tx, int& ty, const u8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG);
+
+	// TODO: ReadImage32/24/...
+
+	static void ReadImageX(const GSLocalMemory& mem, int& tx, int& ty, u8* dst, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG);
+
+	// * => 32
+
+	static void ReadTexture32(GSLocalMemory& mem, const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
+	static void ReadTextureGPU24(GSLocalMemory& mem, const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
+	static void ReadTexture24(GSLocalMemory& mem, const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
+	static void ReadTexture16(GSLocalMemory& mem, const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
+	static void ReadTexture8(GSLocalMemory& mem, const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
+	static void ReadTexture4(GSLocalMemory& mem, const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
+	static void ReadTexture8H(GSLocalMemory& mem, const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
+	static void ReadTexture4HL(GSLocalMemory& mem, const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
+	static void ReadTexture4HH(GSLocalMemory& mem, const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
+
+	static void ReadTextureBlock32(const GSLocalMemory& mem, u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
+	static void ReadTextureBlock24(const GSLocalMemory& mem, u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
+	static void ReadTextureBlock16(const GSLocalMemory& mem, u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
+	static void ReadTextureBlock8(const GSLocalMemory& mem, u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
+	static void ReadTextureBlock4(const GSLocalMemory& mem, u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
+	static void ReadTextureBlock8H(const GSLocalMemory& mem, u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
+	static void ReadTextureBlock4HL(const GSLocalMemory& mem, u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
+	static void ReadTextureBlock4HH(const GSLocalMemory& mem, u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
+
+	// pal ? 8 : 32
+
+	static void ReadTexture8P(GSLocalMemory& mem, const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
+	static void ReadTexture4P(GSLocalMemory& mem, const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
+	static void ReadTexture8HP(GSLocalMemory& mem, const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
+	static void ReadTexture4HLP(GSLocalMemory& mem, const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
+	static void ReadTexture4HHP(GSLocalMemory& mem, const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
+
+	static void ReadTextureBlock8P(const GSLocalMemory& mem, u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
+	static void ReadTextureBlock4P(const GSLocalMemory& mem, u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
+	static void ReadTextureBlock8HP(const GSLocalMemory& mem, u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
+	static void ReadTextureBlock4HLP(const GSLocalMemory& mem, u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
+	static void ReadTextureBlock4HHP(const GSLocalMemory& mem, u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA);
+
+public:
+	static void PopulateFunctions(GSLocalMemory::psm_t* psm);
+};
+
+void GSLocalMemoryPopulateFunctions(GSLocalMemory::psm_t* psm)
+{
+	GSLocalMemoryFunctions::PopulateFunctions(psm);
+}
+
+void GSLocalMemoryFunctions::PopulateFunctions(GSLocalMemory::psm_t* psm)
+{
+	for(size_t i = 0; i < 64; i++)
+	{
+		psm[i].wi = &GSLocalMemoryFunctions::WriteImage<PSM_PSMCT32, 8, 8, 32>;
+		psm[i].ri = &GSLocalMemoryFunctions::ReadImageX; // TODO
+		psm[i].rtx = &GSLocalMemoryFunctions::ReadTexture32;
+		psm[i].rtxP = &GSLocalMemoryFunctions::ReadTexture32;
+		psm[i].rtxb = &GSLocalMemoryFunctions::ReadTextureBlock32;
+		psm[i].rtxbP = &GSLocalMemoryFunctions::ReadTextureBlock32;
+	}
+
+	psm[PSM_PSMCT24].wi = &GSLocalMemoryFunctions::WriteImage24; // TODO
+	psm[PSM_PSMCT16].wi = &GSLocalMemoryFunctions::WriteImage<PSM_PSMCT16, 16, 8, 16>;
+	psm[PSM_PSMCT16S].wi = &GSLocalMemoryFunctions::WriteImage<PSM_PSMCT16S, 16, 8, 16>;
+	psm[PSM_PSMT8].wi = &GSLocalMemoryFunctions::WriteImage<PSM_PSMT8, 16, 16, 8>;
+	psm[PSM_PSMT4].wi = &GSLocalMemoryFunctions::WriteImage<PSM_PSMT4, 32, 16, 4>;
+	psm[PSM_PSMT8H].wi = &GSLocalMemoryFunctions::WriteImage8H; // TODO
+	psm[PSM_PSMT4HL].wi = &GSLocalMemoryFunctions::WriteImage4HL; // TODO
+	psm[PSM_PSMT4HH].wi = &GSLocalMemoryFunctions::WriteImage4HH; // TODO
+	psm[PSM_PSMZ32].wi = &GSLocalMemoryFunctions::WriteImage<PSM_PSMZ32, 8, 8, 32>;
+	psm[PSM_PSMZ24].wi = &GSLocalMemoryFunctions::WriteImage24Z; // TODO
+	psm[PSM_PSMZ16].wi = &GSLocalMemoryFunctions::WriteImage<PSM_PSMZ16, 16, 8, 16>;
+	psm[PSM_PSMZ16S].wi = &GSLocalMemoryFunctions::WriteImage<PSM_PSMZ16S, 16, 8, 16>;
+
+	psm[PSM_PSMCT24].rtx = &GSLocalMemoryFunctions::ReadTexture24;
+	psm[PSM_PSGPU24].rtx = &GSLocalMemoryFunctions::ReadTextureGPU24;
+	psm[PSM_PSMCT16].rtx = &GSLocalMemoryFunctions::ReadTexture16;
+	psm[PSM_PSMCT16S].rtx = &GSLocalMemoryFunctions::ReadTexture16;
+	psm[PSM_PSMT8].rtx = &GSLocalMemoryFunctions::ReadTexture8;
+	psm[PSM_PSMT4].rtx = &GSLocalMemoryFunctions::ReadTexture4;
+	psm[PSM_PSMT8H].rtx = &GSLocalMemoryFunctions::ReadTexture8H;
+	psm[PSM_PSMT4HL].rtx = &GSLocalMemoryFunctions::ReadTexture4HL;
+	psm[PSM_PSMT4HH].rtx = &GSLocalMemoryFunctions::ReadTexture4HH;
+	psm[PSM_PSMZ32].rtx = &GSLocalMemoryFunctions::ReadTexture32;
+	psm[PSM_PSMZ24].rtx = &GSLocalMemoryFunctions::ReadTexture24;
+	psm[PSM_PSMZ16].rtx = &GSLocalMemoryFunctions::ReadTexture16;
+	psm[PSM_PSMZ16S].rtx = &GSLocalMemoryFunctions::ReadTexture16;
+
+	psm[PSM_PSMCT24].rtxP = &GSLocalMemoryFunctions::ReadTexture24;
+	psm[PSM_PSMCT16].rtxP = &GSLocalMemoryFunctions::ReadTexture16;
+	psm[PSM_PSMCT16S].rtxP = &GSLocalMemoryFunctions::ReadTexture16;
+	psm[PSM_PSMT8].rtxP = &GSLocalMemoryFunctions::ReadTexture8P;
+	psm[PSM_PSMT4].rtxP = &GSLocalMemoryFunctions::ReadTexture4P;
+	psm[PSM_PSMT8H].rtxP = &GSLocalMemoryFunctions::ReadTexture8HP;
+	psm[PSM_PSMT4HL].rtxP = &GSLocalMemoryFunctions::ReadTexture4HLP;
+	psm[PSM_PSMT4HH].rtxP = &GSLocalMemoryFunctions::ReadTexture4HHP;
+	psm[PSM_PSMZ32].rtxP = &GSLocalMemoryFunctions::ReadTexture32;
+	psm[PSM_PSMZ24].rtxP = &GSLocalMemoryFunctions::ReadTexture24;
+	psm[PSM_PSMZ16].rtxP = &GSLocalMemoryFunctions::ReadTexture16;
+	psm[PSM_PSMZ16S].rtxP = &GSLocalMemoryFunctions::ReadTexture16;
+
+	psm[PSM_PSMCT24].rtxb = &GSLocalMemoryFunctions::ReadTextureBlock24;
+	psm[PSM_PSMCT16].rtxb = &GSLocalMemoryFunctions::ReadTextureBlock16;
+	psm[PSM_PSMCT16S].rtxb = &GSLocalMemoryFunctions::ReadTextureBlock16;
+	psm[PSM_PSMT8].rtxb = &GSLocalMemoryFunctions::ReadTextureBlock8;
+	psm[PSM_PSMT4].rtxb = &GSLocalMemoryFunctions::ReadTextureBlock4;
+	psm[PSM_PSMT8H].rtxb = &GSLocalMemoryFunctions::ReadTextureBlock8H;
+	psm[PSM_PSMT4HL].rtxb = &GSLocalMemoryFunctions::ReadTextureBlock4HL;
+	psm[PSM_PSMT4HH].rtxb = &GSLocalMemoryFunctions::ReadTextureBlock4HH;
+	psm[PSM_PSMZ32].rtxb = &GSLocalMemoryFunctions::ReadTextureBlock32;
+	psm[PSM_PSMZ24].rtxb = &GSLocalMemoryFunctions::ReadTextureBlock24;
+	psm[PSM_PSMZ16].rtxb = &GSLocalMemoryFunctions::ReadTextureBlock16;
+	psm[PSM_PSMZ16S].rtxb = &GSLocalMemoryFunctions::ReadTextureBlock16;
+
+	psm[PSM_PSMCT24].rtxbP = &GSLocalMemoryFunctions::ReadTextureBlock24;
+	psm[PSM_PSMCT16].rtxbP = &GSLocalMemoryFunctions::ReadTextureBlock16;
+	psm[PSM_PSMCT16S].rtxbP = &GSLocalMemoryFunctions::ReadTextureBlock16;
+	psm[PSM_PSMT8].rtxbP = &GSLocalMemoryFunctions::ReadTextureBlock8P;
+	psm[PSM_PSMT4].rtxbP = &GSLocalMemoryFunctions::ReadTextureBlock4P;
+	psm[PSM_PSMT8H].rtxbP = &GSLocalMemoryFunctions::ReadTextureBlock8HP;
+	psm[PSM_PSMT4HL].rtxbP = &GSLocalMemoryFunctions::ReadTextureBlock4HLP;
+	psm[PSM_PSMT4HH].rtxbP = &GSLocalMemoryFunctions::ReadTextureBlock4HHP;
+	psm[PSM_PSMZ32].rtxbP = &GSLocalMemoryFunctions::ReadTextureBlock32;
+	psm[PSM_PSMZ24].rtxbP = &GSLocalMemoryFunctions::ReadTextureBlock24;
+	psm[PSM_PSMZ16].rtxbP = &GSLocalMemoryFunctions::ReadTextureBlock16;
+	psm[PSM_PSMZ16S].rtxbP = &GSLocalMemoryFunctions::ReadTextureBlock16;
+}
+
+template<int psm, int bsx, int bsy, int alignment>
+void GSLocalMemoryFunctions::WriteImageColumn(GSLocalMemory& mem, int l, int r, int y, int h, const u8* src, int srcpitch, const GIFRegBITBLTBUF& BITBLTBUF)
+{
+	u32 bp = BITBLTBUF.DBP;
+	u32 bw = BITBLTBUF.DBW;
+
+	const int csy = bsy / 4;
+
+	for(int offset = srcpitch * csy; h >= csy; h -= csy, y += csy, src += offset)
+	{
+		for(int x = l; x < r; x += bsx)
+		{
+			switch(psm)
+			{
+			case PSM_PSMCT32: GSBlock::WriteColumn32<alignment, 0xffffffff>(y, mem.BlockPtr32(x, y, bp, bw), &src[x * 4], srcpitch); break;
+			case PSM_PSMCT16: GSBlock::WriteColumn16<alignment>(y, mem.BlockPtr16(x, y, bp, bw), &src[x * 2], srcpitch); break;
+			case PSM_PSMCT16S: GSBlock::WriteColumn16<alignment>(y, mem.BlockPtr16S(x, y, bp, bw), &src[x * 2], srcpitch); break;
+			case PSM_PSMT8: GSBlock::WriteColumn8<alignment>(y, mem.BlockPtr8(x, y, bp, bw), &src[x], srcpitch); break;
+			case PSM_PSMT4: GSBlock::WriteColumn4<alignment>(y, mem.BlockPtr4(x, y, bp, bw), &src[x >> 1], srcpitch); break;
+			case PSM_PSMZ32: GSBlock::WriteColumn32<alignment, 0xffffffff>(y, mem.BlockPtr32Z(x, y, bp, bw), &src[x * 4], srcpitch); break;
+			case PSM_PSMZ16: GSBlock::WriteColumn16<alignment>(y, mem.BlockPtr16Z(x, y, bp, bw), &src[x * 2], srcpitch); break;
+			case PSM_PSMZ16S: GSBlock::WriteColumn16<alignment>(y, mem.BlockPtr16SZ(x, y, bp, bw), &src[x * 2], srcpitch); break;
+			// TODO
+			default: __assume(0);
+			}
+		}
+	}
+}
+
+template<int psm, int bsx, int bsy, int alignment>
+void GSLocalMemoryFunctions::WriteImageBlock(GSLocalMemory& mem, int l, int r, int y, int h, const u8* src, int srcpitch, const GIFRegBITBLTBUF& BITBLTBUF)
+{
+	u32 bp = BITBLTBUF.DBP;
+	u32 bw = BITBLTBUF.DBW;
+
+	for(int offset = srcpitch * bsy; h >= bsy; h -= bsy, y += bsy, src += offset)
+	{
+		for(int x = l; x < r; x += bsx)
+		{
+			switch(psm)
+			{
+			case PSM_PSMCT32: GSBlock::WriteBlock32<alignment, 0xffffffff>(mem.BlockPtr32(x, y, bp, bw), &src[x * 4], srcpitch); break;
+			case PSM_PSMCT16: GSBlock::WriteBlock16<alignment>(mem.BlockPtr16(x, y, bp, bw), &src[x * 2], srcpitch); break;
+			case PSM_PSMCT16S: GSBlock::WriteBlock16<alignment>(mem.BlockPtr16S(x, y, bp, bw), &src[x * 2], srcpitch); break;
+			case PSM_PSMT8: GSBlock::WriteBlock8<alignment>(mem.BlockPtr8(x, y, bp, bw), &src[x], srcpitch); break;
+			case PSM_PSMT4: GSBlock::WriteBlock4<alignment>(mem.BlockPtr4(x, y, bp, bw), &src[x >> 1], srcpitch); break;
+			case PSM_PSMZ32: GSBlock::WriteBlock32<alignment, 0xffffffff>(mem.BlockPtr32Z(x, y, bp, bw), &src[x * 4], srcpitch); break;
+			case PSM_PSMZ16: GSBlock::WriteBlock16<alignment>(mem.BlockPtr16Z(x, y, bp, bw), &src[x * 2], srcpitch); break;
+			case PSM_PSMZ16S: GSBlock::WriteBlock16<alignment>(mem.BlockPtr16SZ(x, y, bp, bw), &src[x * 2], srcpitch); break;
+			// TODO
+			default: __assume(0);
+			}
+		}
+	}
+}
+
+template<int psm, int bsx, int bsy, int trbpp>
+void GSLocalMemoryFunctions::WriteImageLeftRight(GSLocalMemory& mem, int l, int r, int y, int h, const u8* src, int srcpitch, const GIFRegBITBLTBUF& BITBLTBUF)
+{
+	alignas(32) u8 buff[64]; // merge buffer for one column
+
+	u32 bp = BITBLTBUF.DBP;
+	u32 bw = BITBLTBUF.DBW;
+
+	if(r - l < bsx / 2)
+	{
+		// a few pixels per row, cheaper to address them one by one than to swizzle whole columns
+
+		for(; h > 0; y++, h--, src += srcpitch)
+		{
+			for(int x = l; x < r; x++)
+			{
+				switch(psm)
+				{
+				case PSM_PSMCT32: mem.WritePixel32(x, y, *(u32*)&src[x * 4], bp, bw); break;
+				case PSM_PSMCT16: mem.WritePixel16(x, y, *(u16*)&src[x * 2], bp, bw); break;
+				case PSM_PSMCT16S: mem.WritePixel16S(x, y, *(u16*)&src[x * 2], bp, bw); break;
+				case PSM_PSMT8: mem.WritePixel8(x, y, src[x], bp, bw); break;
+				case PSM_PSMT4: mem.WritePixel4(x, y, src[x >> 1] >> ((x & 1) << 2), bp, bw); break;
+				case PSM_PSMZ32: mem.WritePixel32Z(x, y, *(u32*)&src[x * 4], bp, bw); break;
+				case PSM_PSMZ16: mem.WritePixel16Z(x, y, *(u16*)&src[x * 2], bp, bw); break;
+				case PSM_PSMZ16S: mem.WritePixel16SZ(x, y, *(u16*)&src[x * 2], bp, bw); break;
+				// TODO
+				default: __assume(0);
+				}
+			}
+		}
+
+		return;
+	}
+
+	// the edge is narrower than a block, merge it into each column it crosses
+
+	const int csy = bsy / 4;
+	const int pitch = bsx * trbpp >> 3;
+
+	int x = l & ~(bsx - 1);
+
+	for(int cy = y & ~(csy - 1), y2 = y + h; cy < y2; cy += csy)
+	{
+		u8* dst = NULL;
+
+		switch(psm)
+		{
+		case PSM_PSMCT32: dst = mem.BlockPtr32(x, cy, bp, bw); break;
+		case PSM_PSMCT16: dst = mem.BlockPtr16(x, cy, bp, bw); break;
+		case PSM_PSMCT16S: dst = mem.BlockPtr16S(x, cy, bp, bw); break;
+		case PSM_PSMT8: dst = mem.BlockPtr8(x, cy, bp, bw); break;
+		case PSM_PSMT4: dst = mem.BlockPtr4(x, cy, bp, bw); break;
+		case PSM_PSMZ32: dst = mem.BlockPtr32Z(x, cy, bp, bw); break;
+		case PSM_PSMZ16: dst = mem.BlockPtr16Z(x, cy, bp, bw); break;
+		case PSM_PSMZ16S: dst = mem.BlockPtr16SZ(x, cy, bp, bw); break;
+		// TODO
+		default: __assume(0);
+		}
+
+		switch(trbpp)
+		{
+		case 32: GSBlock::ReadColumn32(cy, dst, buff, pitch); break;
+		case 16: GSBlock::ReadColumn16(cy, dst, buff, pitch); break;
+		case 8: GSBlock::ReadColumn8(cy, dst, buff, pitch); break;
+		case 4: GSBlock::ReadColumn4(cy, dst, buff, pitch); break;
+		default: __assume(0);
+		}
+
+		for(int i = y > cy ? y : cy, j = y2 < cy + csy ? y2 : cy + csy; i < j; i++)
+		{
+			const u8* s = &src[(i - y) * srcpitch];
+			u8* d = &buff[(i - cy) * pitch];
+
+			if(trbpp == 4)
+			{
+				// x is even, the nibbles of d and s line up, only an odd l or r splits a byte
+
+				int k0 = l;
+				int k1 = r;
+
+				if(k0 & 1)
+				{
+					d[(k0 - x) >> 1] = (u8)((d[(k0 - x) >> 1] & 0x0f) | (s[k0 >> 1] & 0xf0));
+					k0++;
+				}
+
+				if(k1 & 1)
+				{
+					k1--;
+					d[(k1 - x) >> 1] = (u8)((d[(k1 - x) >> 1] & 0xf0) | (s[k1 >> 1] & 0x0f));
+				}
+
+				memcpy(&d[(k0 - x) >> 1], &s[k0 >> 1], (k1 - k0) >> 1);
+			}
+			else
+			{
+				memcpy(&d[(l - x) * trbpp >> 3], &s[l * trbpp >> 3], (r - l) * trbpp >> 3);
+			}
+		}
+
+		switch(trbpp)
+		{
+		case 32: GSBlock::WriteColumn32<32, 0xffffffff>(cy, dst, buff, pitch); break;
+		case 16: GSBlock::WriteColumn16<32>(cy, dst, buff, pitch); break;
+		case 8: GSBlock::WriteColumn8<32>(cy, dst, buff, pitch); break;
+		case 4: GSBlock::WriteColumn4<32>(cy, dst, buff, pitch); break;
+		default: __assume(0);
+		}
+	}
+}
+
+template<int psm, int bsx, int bsy, int trbpp>
+void GSLocalMemoryFunctions::WriteImageTopBottom(GSLocalMemory& mem, int l, int r, int y, int h, const u8* src, int srcpitch, const GIFRegBITBLTBUF& BITBLTBUF)
+{
+	alignas(32) u8 buff[64]; // merge buffer for one column
+
+	u32 bp = BITBLTBUF.DBP;
+	u32 bw = BITBLTBUF.DBW;
+
+	const int csy = bsy / 4;
+
+	// merge incomplete column
+
+	int y2 = y & (csy - 1);
+
+	if(y2 > 0)
+	{
+		int h2 = h < csy - y2 ? h : csy - y2;
+
+		for(int x = l; x < r; x += bsx)
+		{
+			u8* dst = NULL;
+
+			switch(psm)
+			{
+			case PSM_PSMCT32: dst = mem.BlockPtr32(x, y, bp, bw); break;
+			case PSM_PSMCT16: dst = mem.BlockPtr16(x, y, bp, bw); break;
+			case PSM_PSMCT16S: dst = mem.BlockPtr16S(x, y, bp, bw); break;
+			case PSM_PSMT8: dst = mem.BlockPtr8(x, y, bp, bw); break;
+			case PSM_PSMT4: dst = mem.BlockPtr4(x, y, bp, bw); break;
+			case PSM_PSMZ32: dst = mem.BlockPtr32Z(x, y, bp, bw); break;
+			case PSM_PSMZ16: dst = mem.BlockPtr16Z(x, y, bp, bw); break;
+			case PSM_PSMZ16S: dst = mem.BlockPtr16SZ(x, y, bp, bw); break;
+			// TODO
+			default: __assume(0);
+			}
+
+			switch(psm)
+			{
+			case PSM_PSMCT32:
+			case PSM_PSMZ32:
+				GSBlock::ReadColumn32(y, dst, buff, 32);
+				memcpy(&buff[32], &src[x * 4], 32);
+				GSBlock::WriteColumn32<32, 0xffffffff>(y, dst, buff, 32);
+				break;
+			case PSM_PSMCT16:
+			case PSM_PSMCT16S:
+			case PSM_PSMZ16:
+			case PSM_PSMZ16S:
+				GSBlock::ReadColumn16(y, dst, buff, 32);
+				memcpy(&buff[32], &src[x * 2], 32);
+				GSBlock::WriteColumn16<32>(y, dst, buff, 32);
+				break;
+			case PSM_PSMT8:
+				GSBlock::ReadColumn8(y, dst, buff, 16);
+				for(int i = 0, j = y2; i < h2; i++, j++) memcpy(&buff[j * 16], &src[i * srcpitch + x], 16);
+				GSBlock::WriteColumn8<32>(y, dst, buff, 16);
+				break;
+			case PSM_PSMT4:
+				GSBlock::ReadColumn4(y, dst, buff, 16);
+				for(int i = 0, j = y2; i < h2; i++, j++) memcpy(&buff[j * 16], &src[i * srcpitch + (x >> 1)], 16);
+				GSBlock::WriteColumn4<32>(y, dst, buff, 16);
+				break;
+			// TODO
+			default:
+				__assume(0);
+			}
+		}
+
+		src += srcpitch * h2;
+		y += h2;
+		h -= h2;
+	}
+
+	// write whole columns
+
+	{
+		int h2 = h & ~(csy - 1);
+
+		if(h2 > 0)
+		{
+			size_t addr = (size_t)&src[l * trbpp >> 3];
+
+			if((addr & 31) == 0 && (srcpitch & 31) == 0)
+			{
+				WriteImageColumn<psm, bsx, bsy, 32>(mem, l, r, y, h2, src, srcpitch, BITBLTBUF);
+			}
+			else if((addr & 15) == 0 && (srcpitch & 15) == 0)
+			{
+				WriteImageColumn<psm, bsx, bsy, 16>(mem, l, r, y, h2, src, srcpitch, BITBLTBUF);
+			}
+			else
+			{
+				WriteImageColumn<psm, bsx, bsy, 0>(mem, l, r, y, h2, src, srcpitch, BITBLTBUF);
+			}
+
+			src += srcpitch * h2;
+			y += h2;
+			h -= h2;
+		}
+	}
+
+	// merge incomplete column
+
+	if(h >= 1)
+	{
+		for(int x = l; x < r; x += bsx)
+		{
+			u8* dst = NULL;
+
+			switch(psm)
+			{
+			case PSM_PSMCT32: dst = mem.BlockPtr32(x, y, bp, bw); break;
+			case PSM_PSMCT16: dst = mem.BlockPtr16(x, y, bp, bw); break;
+			case PSM_PSMCT16S: dst = mem.BlockPtr16S(x, y, bp, bw); break;
+			case PSM_PSMT8: dst = mem.BlockPtr8(x, y, bp, bw); break;
+			case PSM_PSMT4: dst = mem.BlockPtr4(x, y, bp, bw); break;
+			case PSM_PSMZ32: dst = mem.BlockPtr32Z(x, y, bp, bw); break;
+			case PSM_PSMZ16: dst = mem.BlockPtr16Z(x, y, bp, bw); break;
+			case PSM_PSMZ16S: dst = mem.BlockPtr16SZ(x, y, bp, bw); break;
+			// TODO
+			default: __assume(0);
+			}
+
+			switch(psm)
+			{
+			case PSM_PSMCT32:
+			case PSM_PSMZ32:
+				GSBlock::ReadColumn32(y, dst, buff, 32);
+				memcpy(&buff[0], &src[x * 4], 32);
+				GSBlock::WriteColumn32<32, 0xffffffff>(y, dst, buff, 32);
+				break;
+			case PSM_PSMCT16:
+			case PSM_PSMCT16S:
+			case PSM_PSMZ16:
+			case PSM_PSMZ16S:
+				GSBlock::ReadColumn16(y, dst, buff, 32);
+				memcpy(&buff[0], &src[x * 2], 32);
+				GSBlock::WriteColumn16<32>(y, dst, buff, 32);
+				break;
+			case PSM_PSMT8:
+				GSBlock::ReadColumn8(y, dst, buff, 16);
+				for(int i = 0; i < h; i++) memcpy(&buff[i * 16], &src[i * srcpitch + x], 16);
+				GSBlock::WriteColumn8<32>(y, dst, buff, 16);
+				break;
+			case PSM_PSMT4:
+				GSBlock::ReadColumn4(y, dst, buff, 16);
+				for(int i = 0; i < h; i++) memcpy(&buff[i * 16], &src[i * srcpitch + (x >> 1)], 16);
+				GSBlock::WriteColumn4<32>(y, dst, buff, 16);
+				break;
+			// TODO
+			default:
+				__assume(0);
+			}
+		}
+	}
+}
+
+template<int psm, int bsx, int bsy, int trbpp>
+void GSLocalMemoryFunctions::WriteImage(GSLocalMemory& mem, int& tx, int& ty, const u8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
+{
+	if(TRXREG.RRW == 0) return;
+
+	int l = (int)TRXPOS.DSAX;
+	int r = l + (int)TRXREG.RRW;
+
+	// finish the incomplete row first
+
+	if(tx != l)
+	{
+		int n = (r - tx) * trbpp >> 3;
+
+		if(n > len) n = len;
+
+		WriteImageX(mem, tx, ty, src, n, BITBLTBUF, TRXPOS, TRXREG);
+		src += n;
+		len -= n;
+	}
+
+	int la = (l + (bsx - 1)) & ~(bsx - 1);
+	int ra = r & ~(bsx - 1);
+	int srcpitch = (r - l) * trbpp >> 3;
+	int h = len / srcpitch;
+
+	if(ra - la >= bsx && h > 0) // "transfer width" >= "block width" && there is at least one full row
+	{
+		const u8* s = &src[-l * trbpp >> 3];
+
+		src += srcpitch * h;
+		len -= srcpitch * h;
+
+		// left part
+
+		if(l < la)
+		{
+			WriteImageLeftRight<psm, bsx, bsy, trbpp>(mem, l, la, ty, h, s, srcpitch, BITBLTBUF);
+		}
+
+		// right part
+
+		if(ra < r)
+		{
+			WriteImageLeftRight<psm, bsx, bsy, trbpp>(mem, ra, r, ty, h, s, srcpitch, BITBLTBUF);
+		}
+
+		// horizontally aligned part
+
+		if(la < ra)
+		{
+			// top part
+
+			{
+				int h2 = bsy - (ty & (bsy - 1));
+
+				if(h2 > h) h2 = h;
+
+				if(h2 < bsy)
+				{
+					WriteImageTopBottom<psm, bsx, bsy, trbpp>(mem, la, ra, ty, h2, s, srcpitch, BITBLTBUF);
+
+					s += srcpitch * h2;
+					ty += h2;
+					h -= h2;
+				}
+			}
+
+			// horizontally and vertically aligned part
+
+			{
+				int h2 = h & ~(bsy - 1);
+
+				if(h2 > 0)
+				{
+					size_t addr = (size_t)&s[la * trbpp >> 3];
+
+					if((addr & 31) == 0 && (srcpitch & 31) == 0)
+					{
+						WriteImageBlock<psm, bsx, bsy, 32>(mem, la, ra, ty, h2, s, srcpitch, BITBLTBUF);
+					}
+					else if((addr & 15) == 0 && (srcpitch & 15) == 0)
+					{
+						WriteImageBlock<psm, bsx, bsy, 16>(mem, la, ra, ty, h2, s, srcpitch, BITBLTBUF);
+					}
+					else
+					{
+						WriteImageBlock<psm, bsx, bsy, 0>(mem, la, ra, ty, h2, s, srcpitch, BITBLTBUF);
+					}
+
+					s += srcpitch * h2;
+					ty += h2;
+					h -= h2;
+				}
+			}
+
+			// bottom part
+
+			if(h > 0)
+			{
+				WriteImageTopBottom<psm, bsx, bsy, trbpp>(mem, la, ra, ty, h, s, srcpitch, BITBLTBUF);
+
+				// s += srcpitch * h;
+				ty += h;
+				// h -= h;
+			}
+		}
+	}
+
+	// the rest
+
+	if(len > 0)
+	{
+		WriteImageX(mem, tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
+	}
+}
+
+
+static bool IsTopLeftAligned(int dsax, int tx, int ty, int bw, int bh)
+{
+	return ((dsax & (bw-1)) == 0 && (tx & (bw-1)) == 0 && dsax == tx && (ty & (bh-1)) == 0);
+}
+
+void GSLocalMemoryFunctions::WriteImage24(GSLocalMemory& mem, int& tx, int& ty, const u8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
+{
+	if(TRXREG.RRW == 0) return;
+
+	u32 bp = BITBLTBUF.DBP;
+	u32 bw = BITBLTBUF.DBW;
+
+	int tw = TRXPOS.DSAX + TRXREG.RRW, srcpitch = TRXREG.RRW * 3;
+	int th = len / srcpitch;
+
+	bool aligned = IsTopLeftAligned(TRXPOS.DSAX, tx, ty, 8, 8);
+
+	if(!aligned || (tw & 7) || (th & 7) || (len % srcpitch))
+	{
+		// TODO
+
+		WriteImageX(mem, tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
+	}
+	else
+	{
+		th += ty;
+
+		for(int y = ty; y < th; y += 8, src += srcpitch * 8)
+		{
+			for(int x = tx; x < tw; x += 8)
+			{
+				GSBlock::UnpackAndWriteBlock24(src + (x - tx) * 3, srcpitch, mem.BlockPtr32(x, y, bp, bw));
+			}
+		}
+
+		ty = th;
+	}
+}
+
+void GSLocalMemoryFunctions::WriteImage8H(GSLocalMemory& mem, int& tx, int& ty, const u8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
+{
+	if(TRXREG.RRW == 0) return;
+
+	u32 bp = BITBLTBUF.DBP;
+	u32 bw = BITBLTBUF.DBW;
+
+	int tw = TRXPOS.DSAX + TRXREG.RRW, srcpitch = TRXREG.RRW;
+	int th = len / srcpitch;
+
+	bool aligned = IsTopLeftAligned(TRXPOS.DSAX, tx, ty, 8, 8);
+
+	if(!aligned || (tw & 7) || (th & 7) || (len % srcpitch))
+	{
+		// TODO
+
+		WriteImageX(mem, tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
+	}
+	else
+	{
+		th += ty;
+
+		for(int y = ty; y < th; y += 8, src += srcpitch * 8)
+		{
+			for(int x = tx; x < tw; x += 8)
+			{
+				GSBlock::UnpackAndWriteBlock8H(src + (x - tx), srcpitch, mem.BlockPtr32(x, y, bp, bw));
+			}
+		}
+
+		ty = th;
+	}
+}
+
+void GSLocalMemoryFunctions::WriteImage4HL(GSLocalMemory& mem, int& tx, int& ty, const u8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
+{
+	if(TRXREG.RRW == 0) return;
+
+	u32 bp = BITBLTBUF.DBP;
+	u32 bw = BITBLTBUF.DBW;
+
+	int tw = TRXPOS.DSAX + TRXREG.RRW, srcpitch = TRXREG.RRW / 2;
+	int th = len / srcpitch;
+
+	bool aligned = IsTopLeftAligned(TRXPOS.DSAX, tx, ty, 8, 8);
+
+	if(!aligned || (tw & 7) || (th & 7) || (len % srcpitch))
+	{
+		// TODO
+
+		WriteImageX(mem, tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
+	}
+	else
+	{
+		th += ty;
+
+		for(int y = ty; y < th; y += 8, src += srcpitch * 8)
+		{
+			for(int x = tx; x < tw; x += 8)
+			{
+				GSBlock::UnpackAndWriteBlock4HL(src + (x - tx) / 2, srcpitch, mem.BlockPtr32(x, y, bp, bw));
+			}
+		}
+
+		ty = th;
+	}
+}
+
+void GSLocalMemoryFunctions::WriteImage4HH(GSLocalMemory& mem, int& tx, int& ty, const u8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
+{
+	if(TRXREG.RRW == 0) return;
+
+	u32 bp = BITBLTBUF.DBP;
+	u32 bw = BITBLTBUF.DBW;
+
+	int tw = TRXPOS.DSAX + TRXREG.RRW, srcpitch = TRXREG.RRW / 2;
+	int th = len / srcpitch;
+
+	bool aligned = IsTopLeftAligned(TRXPOS.DSAX, tx, ty, 8, 8);
+
+	if(!aligned || (tw & 7) || (th & 7) || (len % srcpitch))
+	{
+		// TODO
+
+		WriteImageX(mem, tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
+	}
+	else
+	{
+		th += ty;
+
+		for(int y = ty; y < th; y += 8, src += srcpitch * 8)
+		{
+			for(int x = tx; x < tw; x += 8)
+			{
+				GSBlock::UnpackAndWriteBlock4HH(src + (x - tx) / 2, srcpitch, mem.BlockPtr32(x, y, bp, bw));
+			}
+		}
+
+		ty = th;
+	}
+}
+
+void GSLocalMemoryFunctions::WriteImage24Z(GSLocalMemory& mem, int& tx, int& ty, const u8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
+{
+	if(TRXREG.RRW == 0) return;
+
+	u32 bp = BITBLTBUF.DBP;
+	u32 bw = BITBLTBUF.DBW;
+
+	int tw = TRXPOS.DSAX + TRXREG.RRW, srcpitch = TRXREG.RRW * 3;
+	int th = len / srcpitch;
+
+	bool aligned = IsTopLeftAligned(TRXPOS.DSAX, tx, ty, 8, 8);
+
+	if(!aligned || (tw & 7) || (th & 7) || (len % srcpitch))
+	{
+		// TODO
+
+		WriteImageX(mem, tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
+	}
+	else
+	{
+		th += ty;
+
+		for(int y = ty; y < th; y += 8, src += srcpitch * 8)
+		{
+			for(int x = tx; x < tw; x += 8)
+			{
+				GSBlock::UnpackAndWriteBlock24(src + (x - tx) * 3, srcpitch, mem.BlockPtr32Z(x, y, bp, bw));
+			}
+		}
+
+		ty = th;
+	}
+}
+
+void GSLocalMemoryFunctions::WriteImageX(GSLocalMemory& mem, int& tx, int& ty, const u8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
+{
+	if(len <= 0) return;
+
+	const u8* pb = (u8*)src;
+	const u16* pw = (u16*)src;
+	const u32* pd = (u32*)src;
+
+	u32 bp = BITBLTBUF.DBP;
+	u32 bw = BITBLTBUF.DBW;
+	GSLocalMemory::psm_t* psm = &GSLocalMemory::m_psm[BITBLTBUF.DPSM];
+
+	int x = tx;
+	int y = ty;
+	int sx = (int)TRXPOS.DSAX;
+	int ex = sx + (int)TRXREG.RRW;
+
+	switch(BITBLTBUF.DPSM)
+	{
+	case PSM_PSMCT32:
+	case PSM_PSMZ32:
+
+		len /= 4;
+
+		while(len > 0)
+		{
+			u32 addr = psm->pa(0, y, bp, bw);
+			int* offset = psm->rowOffset[y & 7];
+
+			for(; len > 0 && x < ex; len--, x++, pd++)
+			{
+				mem.WritePixel32(addr + offset[x], *pd);
+			}
+
+			if(x >= ex) {x = sx; y++;}
+		}
+
+		break;
+
+	case PSM_PSMCT24:
+	case PSM_PSMZ24:
+
+		len /= 3;
+
+		while(len > 0)
+		{
+			u32 addr = psm->pa(0, y, bp, bw);
+			int* offset = psm->rowOffset[y & 7];
+
+			for(; len > 0 && x < ex; len--, x++, pb += 3)
+			{
+				mem.WritePixel24(addr + offset[x], *(u32*)pb);
+			}
+
+			if(x >= ex) {x = sx; y++;}
+		}
+
+		break;
+
+	case PSM_PSMCT16:
+	case PSM_PSMCT16S:
+	case PSM_PSMZ16:
+	case PSM_PSMZ16S:
+
+		len /= 2;
+
+		while(len > 0)
+		{
+			u32 addr = psm->pa(0, y, bp, bw);
+			int* offset = psm->rowOffset[y & 7];
+
+			for(; len > 0 && x < ex; len--, x++, pw++)
+			{
+				mem.WritePixel16(addr + offset[x], *pw);
+			}
+
+			if(x >= ex) {x = sx; y++;}
+		}
+
+		break;
+
+	case PSM_PSMT8:
+
+		while(len > 0)
+		{
+			u32 addr = psm->pa(0, y, bp, bw);
+			int* offset = psm->rowOffset[y & 7];
+
+			for(; len > 0 && x < ex; len--, x++, pb++)
+			{
+				mem.WritePixel8(addr + offset[x], *pb);
+			}
+
+			if(x >= ex) {x = sx; y++;}
+		}
+
+		break;
+
+	case PSM_PSMT4:
+
+		while(len > 0)
+		{
+			u32 addr = psm->pa(0, y, bp, bw);
+			int* offset = psm->rowOffset[y & 7];
+
+			for(; len > 0 && x < ex; len--, x += 2, pb++)
+			{
+				mem.WritePixel4(addr + offset[x + 0], *pb & 0xf);
+				mem.WritePixel4(addr + offset[x + 1], *pb >> 4);
+			}
+
+			if(x >= ex) {x = sx; y++;}
+		}
+
+		break;
+
+	case PSM_PSMT8H:
+
+		while(len > 0)
+		{
+			u32 addr = psm->pa(0, y, bp, bw);
+			int* offset = psm->rowOffset[y & 7];
+
+			for(; len > 0 && x < ex; len--, x++, pb++)
+			{
+				mem.WritePixel8H(addr + offset[x], *pb);
+			}
+
+			if(x >= ex) {x = sx; y++;}
+		}
+
+		break;
+
+	case PSM_PSMT4HL:
+
+		while(len > 0)
+		{
+			u32 addr = psm->pa(0, y, bp, bw);
+			int* offset = psm->rowOffset[y & 7];
+
+			for(; len > 0 && x < ex; len--, x += 2, pb++)
+			{
+				mem.WritePixel4HL(addr + offset[x + 0], *pb & 0xf);
+				mem.WritePixel4HL(addr + offset[x + 1], *pb >> 4);
+			}
+
+			if(x >= ex) {x = sx; y++;}
+		}
+
+		break;
+
+	case PSM_PSMT4HH:
+
+		while(len > 0)
+		{
+			u32 addr = psm->pa(0, y, bp, bw);
+			int* offset = psm->rowOffset[y & 7];
+
+			for(; len > 0 && x < ex; len--, x += 2, pb++)
+			{
+				mem.WritePixel4HH(addr + offset[x + 0], *pb & 0xf);
+				mem.WritePixel4HH(addr + offset[x + 1], *pb >> 4);
+			}
+
+			if(x >= ex) {x = sx; y++;}
+		}
+
+		break;
+	}
+
+	tx = x;
+	ty = y;
+}
+
+//
+
+void GSLocalMemoryFunctions::ReadImageX(const GSLocalMemory& mem, int& tx, int& ty, u8* dst, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
+{
+	if(len <= 0) return;
+
+	u8* RESTRICT pb = (u8*)dst;
+	u16* RESTRICT pw = (u16*)dst;
+	u32* RESTRICT pd = (u32*)dst;
+
+	u32 bp = BITBLTBUF.SBP;
+	u32 bw = BITBLTBUF.SBW;
+	GSLocalMemory::psm_t* RESTRICT psm = &GSLocalMemory::m_psm[BITBLTBUF.SPSM];
+
+	int x = tx;
+	int y = ty;
+	int sx = (int)TRXPOS.SSAX;
+	int ex = sx + (int)TRXREG.RRW;
+
+	// printf("spsm=%d x=%d ex=%d y=%d len=%d\n", BITBLTBUF.SPSM, x, ex, y, len);
+
+	switch(BITBLTBUF.SPSM)
+	{
+	case PSM_PSMCT32:
+	case PSM_PSMZ32:
+
+		// MGS1 intro, fade effect between two scenes (airplane outside-inside transition)
+
+		len /= 4;
+
+		while(len > 0)
+		{
+			int* RESTRICT offset = psm->rowOffset[y & 7];
+			u32* RESTRICT ps = &mem.m_vm32[psm->pa(0, y, bp, bw)];
+
+			for(; len > 0 && x < ex && (x & 7); len--, x++, pd++) 
+			{
+				*pd = ps[offset[x]];
+			}
+
+			// aligned to a column
+
+			for(int ex8 = ex - 8; len >= 8 && x <= ex8; len -= 8, x += 8, pd += 8)
+			{
+				int off = offset[x];
+
+				GSVector4i::store<false>(&pd[0], GSVector4i::load(&ps[off + 0], &ps[off + 4]));
+				GSVector4i::store<false>(&pd[4], GSVector4i::load(&ps[off + 8], &ps[off + 12]));
+
+				for(int i = 0; i < 8; i++) ASSERT(pd[i] == ps[offset[x + i]]);
+			}
+
+			for(; len > 0 && x < ex; len--, x++, pd++)
+			{
+				*pd = ps[offset[x]];
+			}
+
+			if(x == ex) {x = sx; y++;}
+		}
+
+		break;
+
+	case PSM_PSMCT24:
+	case PSM_PSMZ24:
+
+		len /= 3;
+
+		while(len > 0)
+		{
+			int* RESTRICT offset = psm->rowOffset[y & 7];
+			u32* RESTRICT ps = &mem.m_vm32[psm->pa(0, y, bp, bw)];
+
+			for(; len > 0 && x < ex; len--, x++, pb += 3)
+			{
+				u32 c = ps[offset[x]];
+
+				pb[0] = (u8)(c);
+				pb[1] = (u8)(c >> 8);
+				pb[2] = (u8)(c >> 16);
+			}
+
+			if(x == ex) {x = sx; y++;}
+		}
+
+		break;
+
+	case PSM_PSMCT16:
+	case PSM_PSMCT16S:
+	case PSM_PSMZ16:
+	case PSM_PSMZ16S:
+
+		len /= 2;
+
+		while(len > 0)
+		{
+			int* RESTRICT offset = psm->rowOffset[y & 7];
+			u16* RESTRICT ps = &mem.m_vm16[psm->pa(0, y, bp, bw)];
+
+			for(int ex4 = ex - 4; len >= 4 && x <= ex4; len -= 4, x += 4, pw += 4)
+			{
+				pw[0] = ps[offset[x + 0]];
+				pw[1] = ps[offset[x + 1]];
+				pw[2] = ps[offset[x + 2]];
+				pw[3] = ps[offset[x + 3]];
+			}
+
+			for(; len > 0 && x < ex; len--, x++, pw++)
+			{
+				*pw = ps[offset[x]];
+			}
+
+			if(x == ex) {x = sx; y++;}
+		}
+
+		break;
+
+	case PSM_PSMT8:
+
+		while(len > 0)
+		{
+			int* RESTRICT offset = psm->rowOffset[y & 7];
+			u8* RESTRICT ps = &mem.m_vm8[psm->pa(0, y, bp, bw)];
+
+			for(int ex4 = ex - 4; len >= 4 && x <= ex4; len -= 4, x += 4, pb += 4)
+			{
+				pb[0] = ps[offset[x + 0]];
+				pb[1] = ps[offset[x + 1]];
+				pb[2] = ps[offset[x + 2]];
+				pb[3] = ps[offset[x + 3]];
+			}
+
+			for(; len > 0 && x < ex; len--, x++, pb++)
+			{
+				*pb = ps[offset[x]];
+			}
+
+			if(x == ex) {x = sx; y++;}
+		}
+
+		break;
+
+	case PSM_PSMT4:
+
+		while(len > 0)
+		{
+			u32 addr = psm->pa(0, y, bp, bw);
+			int* RESTRICT offset = psm->rowOffset[y & 7];
+
+			for(; len > 0 && x < ex; len--, x += 2, pb++)
+			{
+				*pb = (u8)(mem.ReadPixel4(addr + offset[x + 0]) | (mem.ReadPixel4(addr + offset[x + 1]) << 4));
+			}
+
+			if(x == ex) {x = sx; y++;}
+		}
+
+		break;
+
+	case PSM_PSMT8H:
+
+		while(len > 0)
+		{
+			int* RESTRICT offset = psm->rowOffset[y & 7];
+			u32* RESTRICT ps = &mem.m_vm32[psm->pa(0, y, bp, bw)];
+
+			for(int ex4 = ex - 4; len >= 4 && x <= ex4; len -= 4, x += 4, pb += 4)
+			{
+				pb[0] = (u8)(ps[offset[x + 0]] >> 24);
+				pb[1] = (u8)(ps[offset[x + 1]] >> 24);
+				pb[2] = (u8)(ps[offset[x + 2]] >> 24);
+				pb[3] = (u8)(ps[offset[x + 3]] >> 24);
+			}
+
+			for(; len > 0 && x < ex; len--, x++, pb++)
+			{
+				*pb = (u8)(ps[offset[x]] >> 24);
+			}
+
+			if(x == ex) {x = sx; y++;}
+		}
+
+		break;
+
+	case PSM_PSMT4HL:
+
+		while(len > 0)
+		{
+			int* offset = psm->rowOffset[y & 7];
+			u32* RESTRICT ps = &mem.m_vm32[psm->pa(0, y, bp, bw)];
+
+			for(; len > 0 && x < ex; len--, x += 2, pb++)
+			{
+				u32 c0 = (ps[offset[x + 0]] >> 24) & 0x0f;
+				u32 c1 = (ps[offset[x + 1]] >> 20) & 0xf0;
+
+				*pb = (u8)(c0 | c1);
+			}
+
+			if(x == ex) {x = sx; y++;}
+		}
+
+		break;
+
+	case PSM_PSMT4HH:
+
+		while(len > 0)
+		{
+			int* RESTRICT offset = psm->rowOffset[y & 7];
+			u32* RESTRICT ps = &mem.m_vm32[psm->pa(0, y, bp, bw)];
+
+			for(; len > 0 && x < ex; len--, x += 2, pb++)
+			{
+				u32 c0 = (ps[offset[x + 0]] >> 28) & 0x0f;
+				u32 c1 = (ps[offset[x + 1]] >> 24) & 0xf0;
+
+				*pb = (u8)(c0 | c1);
+			}
+
+			if(x == ex) {x = sx; y++;}
+		}
+
+		break;
+	}
+
+	tx = x;
+	ty = y;
+}
+
+///////////////////
+
+void GSLocalMemoryFunctions::ReadTexture32(GSLocalMemory& mem, const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	FOREACH_BLOCK_START(r, 8, 8, 32)
+	{
+		GSBlock::ReadBlock32(src, read_dst, dstpitch);
+	}
+	FOREACH_BLOCK_END
+}
+
+void GSLocalMemoryFunctions::ReadTexture24(GSLocalMemory& mem, const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	if(TEXA.AEM)
+	{
+		FOREACH_BLOCK_START(r, 8, 8, 32)
+		{
+			GSBlock::ReadAndExpandBlock24<true>(src, read_dst, dstpitch, TEXA);
+		}
+		FOREACH_BLOCK_END
+	}
+	else
+	{
+		FOREACH_BLOCK_START(r, 8, 8, 32)
+		{
+			GSBlock::ReadAndExpandBlock24<false>(src, read_dst, dstpitch, TEXA);
+		}
+		FOREACH_BLOCK_END
+	}
+}
+
+void GSLocalMemoryFunctions::ReadTextureGPU24(GSLocalMemory& mem, const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	FOREACH_BLOCK_START(r, 16, 8, 16)
+	{
+		GSBlock::ReadBlock16(src, read_dst, dstpitch);
+	}
+	FOREACH_BLOCK_END
+
+	// Convert packed RGB scanline to 32 bits RGBA
+	ASSERT(dstpitch >= r.width() * 4);
+	for(int y = r.top; y < r.bottom; y ++) {
+		u8* line = dst + y * dstpitch;
+
+		for(int x = r.right; x >= r.left; x--) {
+			*(u32*)&line[x * 4] = *(u32*)&line[x * 3] & 0xFFFFFF;
+		}
+	}
+}
+
+void GSLocalMemoryFunctions::ReadTexture16(GSLocalMemory& mem, const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	if(TEXA.AEM)
+	{
+		FOREACH_BLOCK_START(r, 16, 8, 32)
+		{
+			GSBlock::ReadAndExpandBlock16<true>(src, read_dst, dstpitch, TEXA);
+		}
+		FOREACH_BLOCK_END
+	}
+	else
+	{
+		FOREACH_BLOCK_START(r, 16, 8, 32)
+		{
+			GSBlock::ReadAndExpandBlock16<false>(src, read_dst, dstpitch, TEXA);
+		}
+		FOREACH_BLOCK_END
+	}
+}
+
+void GSLocalMemoryFunctions::ReadTexture8(GSLocalMemory& mem, const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	const u32* pal = mem.m_clut;
+
+	FOREACH_BLOCK_START(r, 16, 16, 32)
+	{
+		GSBlock::ReadAndExpandBlock8_32(src, read_dst, dstpitch, pal);
+	}
+	FOREACH_BLOCK_END
+}
+
+void GSLocalMemoryFunctions::ReadTexture4(GSLocalMemory& mem, const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	const u64* pal = mem.m_clut;
+
+	FOREACH_BLOCK_START(r, 32, 16, 32)
+	{
+		GSBlock::ReadAndExpandBlock4_32(src, read_dst, dstpitch, pal);
+	}
+	FOREACH_BLOCK_END
+}
+
+void GSLocalMemoryFunctions::ReadTexture8H(GSLocalMemory& mem, const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	const u32* pal = mem.m_clut;
+
+	FOREACH_BLOCK_START(r, 8, 8, 32)
+	{
+		GSBlock::ReadAndExpandBlock8H_32(src, read_dst, dstpitch, pal);
+	}
+	FOREACH_BLOCK_END
+}
+
+void GSLocalMemoryFunctions::ReadTexture4HL(GSLocalMemory& mem, const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	const u32* pal = mem.m_clut;
+
+	FOREACH_BLOCK_START(r, 8, 8, 32)
+	{
+		GSBlock::ReadAndExpandBlock4HL_32(src, read_dst, dstpitch, pal);
+	}
+	FOREACH_BLOCK_END
+}
+
+void GSLocalMemoryFunctions::ReadTexture4HH(GSLocalMemory& mem, const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	const u32* pal = mem.m_clut;
+
+	FOREACH_BLOCK_START(r, 8, 8, 32)
+	{
+		GSBlock::ReadAndExpandBlock4HH_32(src, read_dst, dstpitch, pal);
+	}
+	FOREACH_BLOCK_END
+}
+
+///////////////////
+
+void GSLocalMemoryFunctions::ReadTextureBlock32(const GSLocalMemory& mem, u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	ALIGN_STACK(32);
+
+	GSBlock::ReadBlock32(mem.BlockPtr(bp), dst, dstpitch);
+}
+
+void GSLocalMemoryFunctions::ReadTextureBlock24(const GSLocalMemory& mem, u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	ALIGN_STACK(32);
+
+	if(TEXA.AEM)
+	{
+		GSBlock::ReadAndExpandBlock24<true>(mem.BlockPtr(bp), dst, dstpitch, TEXA);
+	}
+	else
+	{
+		GSBlock::ReadAndExpandBlock24<false>(mem.BlockPtr(bp), dst, dstpitch, TEXA);
+	}
+}
+
+void GSLocalMemoryFunctions::ReadTextureBlock16(const GSLocalMemory& mem, u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	ALIGN_STACK(32);
+
+	if(TEXA.AEM)
+	{
+		GSBlock::ReadAndExpandBlock16<true>(mem.BlockPtr(bp), dst, dstpitch, TEXA);
+	}
+	else
+	{
+		GSBlock::ReadAndExpandBlock16<false>(mem.BlockPtr(bp), dst, dstpitch, TEXA);
+	}
+}
+
+void GSLocalMemoryFunctions::ReadTextureBlock8(const GSLocalMemory& mem, u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	ALIGN_STACK(32);
+
+	GSBlock::ReadAndExpandBlock8_32(mem.BlockPtr(bp), dst, dstpitch, mem.m_clut);
+}
+
+void GSLocalMemoryFunctions::ReadTextureBlock4(const GSLocalMemory& mem, u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	ALIGN_STACK(32);
+
+	GSBlock::ReadAndExpandBlock4_32(mem.BlockPtr(bp), dst, dstpitch, mem.m_clut);
+}
+
+void GSLocalMemoryFunctions::ReadTextureBlock8H(const GSLocalMemory& mem, u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	ALIGN_STACK(32);
+
+	GSBlock::ReadAndExpandBlock8H_32(mem.BlockPtr(bp), dst, dstpitch, mem.m_clut);
+}
+
+void GSLocalMemoryFunctions::ReadTextureBlock4HL(const GSLocalMemory& mem, u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	ALIGN_STACK(32);
+
+	GSBlock::ReadAndExpandBlock4HL_32(mem.BlockPtr(bp), dst, dstpitch, mem.m_clut);
+}
+
+void GSLocalMemoryFunctions::ReadTextureBlock4HH(const GSLocalMemory& mem, u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	ALIGN_STACK(32);
+
+	GSBlock::ReadAndExpandBlock4HH_32(mem.BlockPtr(bp), dst, dstpitch, mem.m_clut);
+}
+// 32/8
+
+void GSLocalMemoryFunctions::ReadTexture8P(GSLocalMemory& mem, const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	FOREACH_BLOCK_START(r, 16, 16, 8)
+	{
+		GSBlock::ReadBlock8(src, read_dst, dstpitch);
+	}
+	FOREACH_BLOCK_END
+}
+
+void GSLocalMemoryFunctions::ReadTexture4P(GSLocalMemory& mem, const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	FOREACH_BLOCK_START(r, 32, 16, 8)
+	{
+		GSBlock::ReadBlock4P(src, read_dst, dstpitch);
+	}
+	FOREACH_BLOCK_END
+}
+
+void GSLocalMemoryFunctions::ReadTexture8HP(GSLocalMemory& mem, const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	FOREACH_BLOCK_START(r, 8, 8, 8)
+	{
+		GSBlock::ReadBlock8HP(src, read_dst, dstpitch);
+	}
+	FOREACH_BLOCK_END
+}
+
+void GSLocalMemoryFunctions::ReadTexture4HLP(GSLocalMemory& mem, const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	FOREACH_BLOCK_START(r, 8, 8, 8)
+	{
+		GSBlock::ReadBlock4HLP(src, read_dst, dstpitch);
+	}
+	FOREACH_BLOCK_END
+}
+
+void GSLocalMemoryFunctions::ReadTexture4HHP(GSLocalMemory& mem, const GSOffset* RESTRICT off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	FOREACH_BLOCK_START(r, 8, 8, 8)
+	{
+		GSBlock::ReadBlock4HHP(src, read_dst, dstpitch);
+	}
+	FOREACH_BLOCK_END
+}
+
+//
+
+void GSLocalMemoryFunctions::ReadTextureBlock8P(const GSLocalMemory& mem, u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	GSBlock::ReadBlock8(mem.BlockPtr(bp), dst, dstpitch);
+}
+
+void GSLocalMemoryFunctions::ReadTextureBlock4P(const GSLocalMemory& mem, u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	ALIGN_STACK(32);
+
+	GSBlock::ReadBlock4P(mem.BlockPtr(bp), dst, dstpitch);
+}
+
+void GSLocalMemoryFunctions::ReadTextureBlock8HP(const GSLocalMemory& mem, u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	ALIGN_STACK(32);
+
+	GSBlock::ReadBlock8HP(mem.BlockPtr(bp), dst, dstpitch);
+}
+
+void GSLocalMemoryFunctions::ReadTextureBlock4HLP(const GSLocalMemory& mem, u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	ALIGN_STACK(32);
+
+	GSBlock::ReadBlock4HLP(mem.BlockPtr(bp), dst, dstpitch);
+}
+
+void GSLocalMemoryFunctions::ReadTextureBlock4HHP(const GSLocalMemory& mem, u32 bp, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	ALIGN_STACK(32);
+
+	GSBlock::ReadBlock4HHP(mem.BlockPtr(bp), dst, dstpitch);
+}
+
+MULTI_ISA_UNSHARED_END
@@ -0,0 +1,77 @@
+/*
+ *	Copyright (C) 2007-2009 Gabest
+ *	http://www.gabest.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNU Make; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#pragma once
+
+// With MULTI_ISA the sources in GSdxISASources (see CMakeLists.txt) are compiled once
+// per instruction set, each copy in its own namespace so the inlined GSVector/GSBlock
+// code of one level never ends up in another. GSinit picks the best level the CPU
+// supports and everything else reaches that code through MULTI_ISA_SELECT.
+// Without MULTI_ISA there is a single copy built with the global ARCH_FLAG.
+//
+// The copies share the headers they include. An inline function of those headers that
+// one copy emits out of line is a weak symbol, and the linker keeps whichever copy it
+// sees first, so base code could call the AVX2 one. Header code reached from the ISA
+// sources is therefore __forceinline (GSVector, the GIFReg conversions, the
+// GSLocalMemory block addressing), and the ISA sources keep off std::min/max and headers
+// they do not need. tests/ctest/GS checks the objects for symbols outside the namespace.
+
+enum class GSISA
+{
+	Native,
+	SSE41,
+	AVX,
+	AVX2,
+};
+
+extern GSISA g_gs_isa;
+
+#ifdef MULTI_ISA
+
+#define MULTI_ISA_DEF(...) \
+	namespace GSSSE41 {__VA_ARGS__} \
+	namespace GSAVX {__VA_ARGS__} \
+	namespace GSAVX2 {__VA_ARGS__}
+
+#define MULTI_ISA_FRIEND(klass) \
+	friend class GSSSE41::klass; \
+	friend class GSAVX::klass; \
+	friend class GSAVX2::klass;
+
+#define MULTI_ISA_SELECT(fn) \
+	(g_gs_isa == GSISA::AVX2 ? GSAVX2::fn : g_gs_isa == GSISA::AVX ? GSAVX::fn : GSSSE41::fn)
+
+#else
+
+#define MULTI_ISA_DEF(...) namespace GSNative {__VA_ARGS__}
+#define MULTI_ISA_FRIEND(klass) friend class GSNative::klass;
+#define MULTI_ISA_SELECT(fn) (GSNative::fn)
+
+#endif
+
+// MULTI_ISA_NAMESPACE is set by the build for each copy of the ISA sources
+
+#ifndef MULTI_ISA_NAMESPACE
+#define MULTI_ISA_NAMESPACE GSNative
+#endif
+
+#define MULTI_ISA_UNSHARED_START namespace MULTI_ISA_NAMESPACE {
+#define MULTI_ISA_UNSHARED_END }
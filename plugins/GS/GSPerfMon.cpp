@@ -0,0 +1,178 @@
+/*
+ *	Copyright (C) 2007-2009 Gabest
+ *	http://www.gabest.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNU Make; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "GSPerfMon.h"
+#include "options_tools.h"
+
+#include <cstring>
+
+static const char* s_flush_reason[FLUSHREASON_LAST] =
+{
+	"unknown", "context", "clut", "transfer", "dirtytex", "fifo", "savestate", "loadstate", "autoflush", "vsync",
+};
+
+GSPerfMon::GSPerfMon()
+	: m_frame(0)
+	, m_depth(0)
+	, m_csv(NULL)
+{
+	Clear();
+
+	memset(&m_last, 0, sizeof(m_last));
+}
+
+GSPerfMon::~GSPerfMon()
+{
+	if(m_csv != NULL)
+	{
+		fclose(m_csv);
+	}
+}
+
+void GSPerfMon::Clear()
+{
+	memset(m_counters, 0, sizeof(m_counters));
+	memset(m_flush, 0, sizeof(m_flush));
+	memset(m_sync, 0, sizeof(m_sync));
+
+	m_busy_us = 0;
+}
+
+void GSPerfMon::Start()
+{
+	if(m_depth++ == 0)
+	{
+		m_start = std::chrono::steady_clock::now();
+	}
+}
+
+void GSPerfMon::Stop()
+{
+	if(--m_depth == 0)
+	{
+		m_busy_us += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start).count();
+	}
+}
+
+void GSPerfMon::Update()
+{
+	// a vsync is itself timed, the part of it after this point goes to the next frame
+
+	if(m_depth > 0)
+	{
+		auto now = std::chrono::steady_clock::now();
+
+		m_busy_us += std::chrono::duration_cast<std::chrono::microseconds>(now - m_start).count();
+
+		m_start = now;
+	}
+
+	GSStats s;
+
+	s.frame = ++m_frame;
+	s.draws = m_counters[Draw];
+	s.prims = m_counters[Prim];
+	s.vertices = m_counters[Vertex];
+	s.pixels = m_counters[Fillrate];
+	s.write_bytes = m_counters[WriteBytes];
+	s.read_bytes = m_counters[ReadBytes];
+	s.tex_hits = m_counters[TextureHit];
+	s.tex_misses = m_counters[TextureMiss];
+	s.tex_uploads = m_counters[TextureUpload];
+	s.clut_loads = m_counters[ClutLoad];
+	memcpy(s.flush, m_flush, sizeof(s.flush));
+	memcpy(s.sync, m_sync, sizeof(s.sync));
+	s.busy_us = m_busy_us;
+
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+
+		m_last = s;
+	}
+
+	if(m_csv != NULL)
+	{
+		WriteCSV(s);
+	}
+
+	Clear();
+}
+
+void GSPerfMon::Get(GSStats* stats)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	*stats = m_last;
+}
+
+void GSPerfMon::OpenCSV(const char* path)
+{
+	if(m_csv != NULL)
+	{
+		return;
+	}
+
+	m_csv = fopen(path, "w");
+
+	if(m_csv == NULL)
+	{
+		log_cb(RETRO_LOG_WARN, "GSdx: cannot open %s for the frame stats\n", path);
+
+		return;
+	}
+
+	fprintf(m_csv, "frame,draws,prims,vertices,pixels,write_bytes,read_bytes,tex_hits,tex_misses,tex_uploads,clut_loads");
+
+	for(int i = 0; i < FLUSHREASON_LAST; i++)
+	{
+		fprintf(m_csv, ",flush_%s", s_flush_reason[i]);
+	}
+
+	for(int i = 0; i < 9; i++)
+	{
+		fprintf(m_csv, ",sync_%d", i - 1);
+	}
+
+	fprintf(m_csv, ",busy_us\n");
+
+	log_cb(RETRO_LOG_INFO, "GSdx: writing frame stats to %s\n", path);
+}
+
+void GSPerfMon::WriteCSV(const GSStats& s)
+{
+	fprintf(m_csv, "%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu",
+		(unsigned long long)s.frame, (unsigned long long)s.draws, (unsigned long long)s.prims,
+		(unsigned long long)s.vertices, (unsigned long long)s.pixels, (unsigned long long)s.write_bytes,
+		(unsigned long long)s.read_bytes, (unsigned long long)s.tex_hits, (unsigned long long)s.tex_misses,
+		(unsigned long long)s.tex_uploads, (unsigned long long)s.clut_loads);
+
+	for(int i = 0; i < FLUSHREASON_LAST; i++)
+	{
+		fprintf(m_csv, ",%llu", (unsigned long long)s.flush[i]);
+	}
+
+	for(int i = 0; i < 9; i++)
+	{
+		fprintf(m_csv, ",%llu", (unsigned long long)s.sync[i]);
+	}
+
+	fprintf(m_csv, ",%llu\n", (unsigned long long)s.busy_us);
+}
@@ -0,0 +1,133 @@
+/*
+ *	Copyright (C) 2007-2009 Gabest
+ *	http://www.gabest.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNU Make; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#pragma once
+
+#include "Pcsx2Types.h"
+
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+
+// why the pending primitives were drawn
+
+enum GSFlushReason
+{
+	UNKNOWN = 0,
+	CONTEXTCHANGE,   // a register the pending primitives depend on
+	CLUTCHANGE,      // TEX0 loads a new clut
+	GSTRANSFER,      // TRXDIR starts a transfer
+	UPLOADDIRTYTEX,  // a transfer writes the texture or the clut of the pending primitives
+	DOWNLOADFIFO,
+	SAVESTATE,
+	LOADSTATE,
+	AUTOFLUSH,       // the pending primitives sample their own frame buffer
+	VSYNC,
+	FLUSHREASON_LAST
+};
+
+// Counters of one frame, from one vsync to the next. Everything is counted on the GS
+// thread, GSgetStats returns the last finished frame.
+
+struct GSStats
+{
+	u64 frame;          // number of vsyncs so far
+	u64 draws;
+	u64 prims;
+	u64 vertices;
+	u64 pixels;         // pixels filled, software renderer only
+	u64 write_bytes;    // host -> local transfers
+	u64 read_bytes;     // local -> host transfers
+	u64 tex_hits;       // texture cache lookups
+	u64 tex_misses;
+	u64 tex_uploads;    // HW: rectangles written to a texture, SW: texture updates that read blocks
+	u64 clut_loads;
+	u64 flush[FLUSHREASON_LAST];
+	u64 sync[9];        // software renderer waits for its threads, by reason -1 .. 7
+	u64 busy_us;        // time spent in the GS entry points
+};
+
+class GSPerfMon
+{
+public:
+	enum counter_t
+	{
+		Draw,
+		Prim,
+		Vertex,
+		Fillrate,
+		WriteBytes,
+		ReadBytes,
+		TextureHit,
+		TextureMiss,
+		TextureUpload,
+		ClutLoad,
+		CounterLast
+	};
+
+private:
+	u64 m_frame;
+	u64 m_counters[CounterLast];
+	u64 m_flush[FLUSHREASON_LAST];
+	u64 m_sync[9];
+	u64 m_busy_us;
+
+	int m_depth;
+	std::chrono::steady_clock::time_point m_start;
+
+	GSStats m_last;
+	std::mutex m_lock; // m_last may be read by another thread
+
+	FILE* m_csv;
+
+	void Clear();
+	void WriteCSV(const GSStats& s);
+
+public:
+	GSPerfMon();
+	virtual ~GSPerfMon();
+
+	void Put(counter_t c, u64 n = 1) {m_counters[c] += n;}
+	void Flush(GSFlushReason reason) {m_flush[reason]++;}
+	void Sync(int reason) {m_sync[reason + 1]++;}
+
+	// busy time, nested calls are only counted once
+
+	void Start();
+	void Stop();
+
+	// closes the frame, called at vsync
+
+	void Update();
+
+	void Get(GSStats* stats);
+
+	void OpenCSV(const char* path);
+};
+
+class GSPerfMonAutoTimer
+{
+	GSPerfMon& m_perfmon;
+
+public:
+	GSPerfMonAutoTimer(GSPerfMon& perfmon) : m_perfmon(perfmon) {m_perfmon.Start();}
+	~GSPerfMonAutoTimer() {m_perfmon.Stop();}
+};
@@ -0,0 +1,95 @@
+/*
+ *	Copyright (C) 2007-2009 Gabest
+ *	http://www.gabest.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNU Make; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "stdafx.h"
+#include "GS.h"
+#include "options_tools.h"
+
+#include <cstdarg>
+
+// Standalone player for .gs.xz captures. GSdx is built against the libretro
+// frontend glue, so the few globals it reaches for are provided here.
+
+static bool RETRO_CALLCONV replay_environ(unsigned cmd, void* data) { return false; }
+static void RETRO_CALLCONV replay_video(const void* data, unsigned width, unsigned height, size_t pitch) {}
+
+static void RETRO_CALLCONV replay_log(enum retro_log_level level, const char* fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+	vfprintf(level >= RETRO_LOG_WARN ? stderr : stdout, fmt, args);
+	va_end(args);
+}
+
+retro_environment_t environ_cb = replay_environ;
+retro_video_refresh_t video_cb = replay_video;
+retro_log_printf_t log_cb = replay_log;
+retro_hw_render_callback hw_render = {};
+
+int option_upscale_mult = 1;
+bool hack_AutoFlush = false;
+bool hack_fb_conversion = false;
+bool option_gs_capture = false;
+
+EXPORT_C_(int) GSinit();
+EXPORT_C_(int) GSReplay(const char* path, int renderer, int threads, int loops);
+int GSBenchmark(int loops); // GSBenchmark.cpp
+int GSGIFLoopTest(); // GSGIFLoopTest.cpp
+
+int main(int argc, char* argv[])
+{
+	if(argc < 2)
+	{
+		fprintf(stderr, "usage: %s <dump.gs.xz> [sw|null] [loops] [extra threads]\n", argv[0]);
+		fprintf(stderr, "       %s --bench [loops]\n", argv[0]);
+		fprintf(stderr, "       %s --gif-test\n", argv[0]);
+		return 1;
+	}
+
+	if(strcmp(argv[1], "--bench") == 0)
+	{
+		if(GSinit() != 0)
+			return 1;
+
+		return GSBenchmark(argc > 2 ? atoi(argv[2]) : 1);
+	}
+
+	if(strcmp(argv[1], "--gif-test") == 0)
+	{
+		if(GSinit() != 0)
+			return 1;
+
+		return GSGIFLoopTest();
+	}
+
+	GSRendererType renderer = GSRendererType::OGL_SW;
+
+	if(argc > 2 && strcmp(argv[2], "null") == 0)
+		renderer = GSRendererType::Null;
+
+	int loops = argc > 3 ? std::max(atoi(argv[3]), 1) : 1;
+	int threads = argc > 4 ? atoi(argv[4]) : 2;
+
+	if(GSinit() != 0)
+		return 1;
+
+	return GSReplay(argv[1], (int)renderer, threads, loops) > 0 ? 0 : 1;
+}
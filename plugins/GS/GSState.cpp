@@ -27,7 +27,10 @@
 int GSState::s_n = 0;
 
 GSState::GSState()
-	: m_version(6)
+	: m_gif_loop_map("GSGIFLoop", this)
+	, m_gif_loop(NULL)
+	, m_gif_loop_key(0)
+	, m_version(6)
 	, m_gsc(NULL)
 	, m_skip(0)
 	, m_skip_offset(0)
@@ -44,6 +47,21 @@ GSState::GSState()
 	m_mipmap                = theApp.GetConfigI("mipmap");
 	m_NTSC_Saturation       = theApp.GetConfigB("NTSC_Saturation");
 	m_clut_load_before_draw = theApp.GetConfigB("clut_load_before_draw");
+	m_gif_jit               = theApp.GetConfigB("gif_jit");
+
+	memset(&m_merge_stats, 0, sizeof(m_merge_stats));
+
+	// one line per frame, same fields as GSStats
+
+	if(theApp.GetConfigB("stats_csv"))
+	{
+		const char* save_dir = nullptr;
+
+		if(!environ_cb(RETRO_ENVIRONMENT_GET_SAVE_DIRECTORY, &save_dir) || !save_dir)
+			save_dir = ".";
+
+		m_perfmon.OpenCSV((std::string(save_dir) + "/gs_stats.csv").c_str());
+	}
 
 
 	// this hack will be called only once while system init
@@ -141,6 +159,12 @@ GSState::GSState()
 
 GSState::~GSState()
 {
+	if(m_merge_stats.draws > 0)
+	{
+		log_cb(RETRO_LOG_INFO, "GSdx: %llu draws, %llu state changes merged into pending draws\n",
+			(unsigned long long)m_merge_stats.draws, (unsigned long long)m_merge_stats.merged);
+	}
+
 	if(m_vertex.buff) _aligned_free(m_vertex.buff);
 	if(m_index.buff) _aligned_free(m_index.buff);
 }
@@ -249,6 +273,7 @@ void GSState::ResetHandlers()
 		m_fpGIFRegHandlerXYZ[P][3] = &GSState::GIFRegHandlerXYZ2<P, 1, auto_flush>; \
 		m_fpGIFPackedRegHandlerSTQRGBAXYZF2[P] = &GSState::GIFPackedRegHandlerSTQRGBAXYZF2<P, auto_flush>; \
 		m_fpGIFPackedRegHandlerSTQRGBAXYZ2[P] = &GSState::GIFPackedRegHandlerSTQRGBAXYZ2<P, auto_flush>; \
+		m_fpGIFVertexKick[P] = &GSState::GIFVertexKick<P, auto_flush>; \
 
 	if (m_userhacks_auto_flush) {
 		SetHandlerXYZ(GS_POINTLIST, true);
@@ -676,6 +701,61 @@ void GSState::GIFPackedRegHandlerNOP(const GIFPackedReg* RESTRICT r, u32 size)
 {
 }
 
+template<u32 prim, bool auto_flush>
+void GSState::GIFVertexKick(GSState* RESTRICT state, u32 skip)
+{
+	state->VertexKick<prim, auto_flush>(skip);
+}
+
+GSState::GIFRegLoop GSState::GetGIFRegLoop(const GIFPath& path)
+{
+	#if defined(_M_AMD64) || defined(_WIN64)
+
+	// registers the generated loop can unpack by itself, anything else (PRIM, A+D, TEX0...) may change the state it was compiled for
+
+	const u32 packed = (1 << GIF_REG_RGBA) | (1 << GIF_REG_STQ) | (1 << GIF_REG_UV) | (1 << GIF_REG_XYZF2) | (1 << GIF_REG_XYZ2) | (1 << GIF_REG_FOG) | (1 << GIF_REG_XYZF3) | (1 << GIF_REG_XYZ3) | (1 << GIF_REG_NOP);
+	const u32 reglist = (1 << GIF_A_D_REG_RGBAQ) | (1 << GIF_A_D_REG_ST) | (1 << GIF_A_D_REG_UV) | (1 << GIF_A_D_REG_XYZF2) | (1 << GIF_A_D_REG_XYZ2) | (1 << GIF_A_D_REG_FOG) | (1 << GIF_A_D_REG_XYZF3) | (1 << GIF_A_D_REG_XYZ3) | (1 << GIF_A_D_REG_NOP);
+
+	if(!m_gif_jit || m_frameskip || path.nloop == 0 || path.nreg > 12) return NULL;
+
+	GSGIFLoopSelector sel;
+
+	sel.key = 0;
+	sel.reglist = path.tag.FLG == GIF_FLG_REGLIST;
+
+	u32 mask = sel.reglist ? reglist : packed;
+	u64 regs = 0;
+
+	for(u32 i = 0; i < path.nreg; i++)
+	{
+		u32 reg = path.GetReg(i);
+
+		if(!(mask & (1 << reg))) return NULL;
+
+		regs |= (u64)reg << (i * 4);
+	}
+
+	sel.regs = regs;
+	sel.nreg = path.nreg;
+	sel.prim = PRIM->PRIM;
+	sel.auto_flush = m_userhacks_auto_flush;
+	sel.wildhack = m_userhacks_wildhack;
+
+	if(sel.key != m_gif_loop_key)
+	{
+		m_gif_loop = m_gif_loop_map[sel.key];
+		m_gif_loop_key = sel.key;
+	}
+
+	return m_gif_loop;
+
+	#else
+
+	return NULL;
+
+	#endif
+}
+
 void GSState::GIFRegHandlerNull(const GIFReg* RESTRICT r)
 {
 	// ASSERT(0);
@@ -685,11 +765,13 @@ __forceinline void GSState::ApplyPRIM(u32 prim)
 {
 	if(GSUtil::GetPrimClass(m_env.PRIM.PRIM) == GSUtil::GetPrimClass(prim & 7)) // NOTE: assume strips/fans are converted to lists
 	{
-		if((m_env.PRIM.U32[0] ^ prim) & 0x7f8) // all fields except PRIM
-			Flush();
+		u32 diff = (m_env.PRIM.U32[0] ^ prim) & 0x7f8; // all fields except PRIM
+
+		if(diff)
+			FlushIfUsed(diff != 0x100 || ((m_env.PRIM.U32[0] | prim) & 0x10), CONTEXTCHANGE); // FST without TME
 	}
 	else
-		Flush();
+		Flush(CONTEXTCHANGE);
 
 	m_env.PRIM.U32[0] = prim;
 	m_env.PRMODE._PRIM = prim;
@@ -792,8 +874,10 @@ template<int i> void GSState::ApplyTEX0(GIFRegTEX0& TEX0)
 
 	u64 mask = 0x1f78001fffffffffull; // TBP0 TBW PSM TW TH TCC TFX CPSM CSA
 
-	if(wt || PRIM->CTXT == i && ((TEX0.U64 ^ m_env.CTXT[i].TEX0.U64) & mask))
-		Flush();
+	if(wt)
+		Flush(CLUTCHANGE);
+	else if(PRIM->CTXT == i && ((TEX0.U64 ^ m_env.CTXT[i].TEX0.U64) & mask))
+		FlushIfUsed(PRIM->TME || m_clut_load_before_draw, CONTEXTCHANGE);
 
 	TEX0.CPSM &= 0xa; // 1010b
 
@@ -852,6 +936,8 @@ template<int i> void GSState::ApplyTEX0(GIFRegTEX0& TEX0)
 		}
 
 		m_mem.m_clut.Write(m_env.CTXT[i].TEX0, m_env.TEXCLUT);
+
+		m_perfmon.Put(GSPerfMon::ClutLoad);
 	}
 }
 
@@ -941,7 +1027,7 @@ template<int i> void GSState::GIFRegHandlerCLAMP(const GIFReg* RESTRICT r)
 {
 	GL_REG("CLAMP_%d = 0x%x_%x", i, r->u32[1], r->u32[0]);
 	if(PRIM->CTXT == i && r->CLAMP != m_env.CTXT[i].CLAMP)
-		Flush();
+		FlushIfUsed(PRIM->TME, CONTEXTCHANGE);
 
 	m_env.CTXT[i].CLAMP = (GSVector4i)r->CLAMP;
 }
@@ -959,7 +1045,7 @@ template<int i> void GSState::GIFRegHandlerTEX1(const GIFReg* RESTRICT r)
 {
 	GL_REG("TEX1_%d = 0x%x_%x", i, r->u32[1], r->u32[0]);
 	if(PRIM->CTXT == i && r->TEX1 != m_env.CTXT[i].TEX1)
-		Flush();
+		FlushIfUsed(PRIM->TME, CONTEXTCHANGE);
 
 	m_env.CTXT[i].TEX1 = (GSVector4i)r->TEX1;
 }
@@ -990,7 +1076,7 @@ template<int i> void GSState::GIFRegHandlerXYOFFSET(const GIFReg* RESTRICT r)
 	GSVector4i o = (GSVector4i)r->XYOFFSET & GSVector4i::x0000ffff();
 
 	if(!o.eq(m_env.CTXT[i].XYOFFSET))
-		Flush();
+		Flush(CONTEXTCHANGE);
 
 	m_env.CTXT[i].XYOFFSET = o;
 
@@ -1003,7 +1089,7 @@ void GSState::GIFRegHandlerPRMODECONT(const GIFReg* RESTRICT r)
 {
 	GL_REG("PRMODECONT = 0x%x_%x", r->u32[1], r->u32[0]);
 	if(r->PRMODECONT != m_env.PRMODECONT)
-		Flush();
+		Flush(CONTEXTCHANGE);
 
 	m_env.PRMODECONT.AC = r->PRMODECONT.AC;
 
@@ -1020,7 +1106,7 @@ void GSState::GIFRegHandlerPRMODE(const GIFReg* RESTRICT r)
 {
 	GL_REG("PRMODE = 0x%x_%x", r->u32[1], r->u32[0]);
 	if(!m_env.PRMODECONT.AC)
-		Flush();
+		Flush(CONTEXTCHANGE);
 
 	u32 _PRIM = m_env.PRMODE._PRIM;
 	m_env.PRMODE = (GSVector4i)r->PRMODE;
@@ -1035,7 +1121,7 @@ void GSState::GIFRegHandlerTEXCLUT(const GIFReg* RESTRICT r)
 {
 	GL_REG("TEXCLUT = 0x%x_%x", r->u32[1], r->u32[0]);
 	if(r->TEXCLUT != m_env.TEXCLUT)
-		Flush();
+		FlushIfUsed(PRIM->TME || m_clut_load_before_draw, CONTEXTCHANGE);
 
 	m_env.TEXCLUT = (GSVector4i)r->TEXCLUT;
 }
@@ -1043,7 +1129,7 @@ void GSState::GIFRegHandlerTEXCLUT(const GIFReg* RESTRICT r)
 void GSState::GIFRegHandlerSCANMSK(const GIFReg* RESTRICT r)
 {
 	if(r->SCANMSK != m_env.SCANMSK)
-		Flush();
+		Flush(CONTEXTCHANGE);
 
 	m_env.SCANMSK = (GSVector4i)r->SCANMSK;
 }
@@ -1052,7 +1138,7 @@ template<int i> void GSState::GIFRegHandlerMIPTBP1(const GIFReg* RESTRICT r)
 {
 	GL_REG("MIPTBP1_%d = 0x%x_%x", i, r->u32[1], r->u32[0]);
 	if(PRIM->CTXT == i && r->MIPTBP1 != m_env.CTXT[i].MIPTBP1)
-		Flush();
+		FlushIfUsed(PRIM->TME, CONTEXTCHANGE);
 
 	m_env.CTXT[i].MIPTBP1 = (GSVector4i)r->MIPTBP1;
 }
@@ -1061,7 +1147,7 @@ template<int i> void GSState::GIFRegHandlerMIPTBP2(const GIFReg* RESTRICT r)
 {
 	GL_REG("MIPTBP2_%d = 0x%x_%x", i, r->u32[1], r->u32[0]);
 	if(PRIM->CTXT == i && r->MIPTBP2 != m_env.CTXT[i].MIPTBP2)
-		Flush();
+		FlushIfUsed(PRIM->TME, CONTEXTCHANGE);
 
 	m_env.CTXT[i].MIPTBP2 = (GSVector4i)r->MIPTBP2;
 }
@@ -1070,7 +1156,7 @@ void GSState::GIFRegHandlerTEXA(const GIFReg* RESTRICT r)
 {
 	GL_REG("TEXA = 0x%x_%x", r->u32[1], r->u32[0]);
 	if(r->TEXA != m_env.TEXA)
-		Flush();
+		FlushIfUsed(PRIM->TME, CONTEXTCHANGE);
 
 	m_env.TEXA = (GSVector4i)r->TEXA;
 }
@@ -1079,7 +1165,7 @@ void GSState::GIFRegHandlerFOGCOL(const GIFReg* RESTRICT r)
 {
 	GL_REG("FOGCOL = 0x%x_%x", r->u32[1], r->u32[0]);
 	if(r->FOGCOL != m_env.FOGCOL)
-		Flush();
+		FlushIfUsed(PRIM->FGE, CONTEXTCHANGE);
 
 	m_env.FOGCOL = (GSVector4i)r->FOGCOL;
 }
@@ -1092,7 +1178,7 @@ void GSState::GIFRegHandlerTEXFLUSH(const GIFReg* RESTRICT r)
 template<int i> void GSState::GIFRegHandlerSCISSOR(const GIFReg* RESTRICT r)
 {
 	if(PRIM->CTXT == i && r->SCISSOR != m_env.CTXT[i].SCISSOR)
-		Flush();
+		Flush(CONTEXTCHANGE);
 
 	m_env.CTXT[i].SCISSOR = (GSVector4i)r->SCISSOR;
 
@@ -1104,7 +1190,7 @@ template<int i> void GSState::GIFRegHandlerSCISSOR(const GIFReg* RESTRICT r)
 template<int i> void GSState::GIFRegHandlerALPHA(const GIFReg* RESTRICT r)
 {
 	if(PRIM->CTXT == i && r->ALPHA != m_env.CTXT[i].ALPHA)
-		Flush();
+		FlushIfUsed(PRIM->ABE || PRIM->AA1 || m_env.PABE.PABE, CONTEXTCHANGE);
 
 	m_env.CTXT[i].ALPHA = (GSVector4i)r->ALPHA;
 
@@ -1119,7 +1205,7 @@ void GSState::GIFRegHandlerDIMX(const GIFReg* RESTRICT r)
 
 	if(r->DIMX != m_env.DIMX)
 	{
-		Flush();
+		FlushIfUsed(m_env.DTHE.DTHE, CONTEXTCHANGE);
 
 		update = true;
 	}
@@ -1135,7 +1221,7 @@ void GSState::GIFRegHandlerDIMX(const GIFReg* RESTRICT r)
 void GSState::GIFRegHandlerDTHE(const GIFReg* RESTRICT r)
 {
 	if(r->DTHE != m_env.DTHE)
-		Flush();
+		Flush(CONTEXTCHANGE);
 
 	m_env.DTHE = (GSVector4i)r->DTHE;
 }
@@ -1143,7 +1229,7 @@ void GSState::GIFRegHandlerDTHE(const GIFReg* RESTRICT r)
 void GSState::GIFRegHandlerCOLCLAMP(const GIFReg* RESTRICT r)
 {
 	if(r->COLCLAMP != m_env.COLCLAMP)
-		Flush();
+		Flush(CONTEXTCHANGE);
 
 	m_env.COLCLAMP = (GSVector4i)r->COLCLAMP;
 }
@@ -1151,7 +1237,19 @@ void GSState::GIFRegHandlerCOLCLAMP(const GIFReg* RESTRICT r)
 template<int i> void GSState::GIFRegHandlerTEST(const GIFReg* RESTRICT r)
 {
 	if(PRIM->CTXT == i && r->TEST != m_env.CTXT[i].TEST)
-		Flush();
+	{
+		// the alpha test fields do not matter while ATE stays off, DATM while DATE stays off
+
+		u32 a = m_env.CTXT[i].TEST.U32[0];
+		u32 b = r->TEST.U32[0];
+
+		u32 mask = 0x7ffff;
+
+		if(((a | b) & 0x0001) == 0) mask &= ~0x3ffe; // ATST AREF AFAIL
+		if(((a | b) & 0x4000) == 0) mask &= ~0x8000; // DATM
+
+		FlushIfUsed(((a ^ b) & mask) != 0 || r->TEST.U32[1] != m_env.CTXT[i].TEST.U32[1], CONTEXTCHANGE);
+	}
 
 	m_env.CTXT[i].TEST = (GSVector4i)r->TEST;
 }
@@ -1159,7 +1257,7 @@ template<int i> void GSState::GIFRegHandlerTEST(const GIFReg* RESTRICT r)
 void GSState::GIFRegHandlerPABE(const GIFReg* RESTRICT r)
 {
 	if(r->PABE != m_env.PABE)
-		Flush();
+		Flush(CONTEXTCHANGE);
 
 	m_env.PABE = (GSVector4i)r->PABE;
 }
@@ -1167,7 +1265,7 @@ void GSState::GIFRegHandlerPABE(const GIFReg* RESTRICT r)
 template<int i> void GSState::GIFRegHandlerFBA(const GIFReg* RESTRICT r)
 {
 	if(PRIM->CTXT == i && r->FBA != m_env.CTXT[i].FBA)
-		Flush();
+		Flush(CONTEXTCHANGE);
 
 	m_env.CTXT[i].FBA = (GSVector4i)r->FBA;
 }
@@ -1177,7 +1275,7 @@ template<int i> void GSState::GIFRegHandlerFRAME(const GIFReg* RESTRICT r)
 	GL_REG("FRAME_%d = 0x%x_%x", i, r->u32[1], r->u32[0]);
 	if(PRIM->CTXT == i && r->FRAME != m_env.CTXT[i].FRAME)
 	{
-		Flush();
+		Flush(CONTEXTCHANGE);
 	}
 
 	if((m_env.CTXT[i].FRAME.U32[0] ^ r->FRAME.U32[0]) & 0x3f3f01ff) // FBP FBW PSM
@@ -1232,7 +1330,7 @@ template<int i> void GSState::GIFRegHandlerZBUF(const GIFReg* RESTRICT r)
 	}
 
 	if(PRIM->CTXT == i && ZBUF != m_env.CTXT[i].ZBUF)
-		Flush();
+		Flush(CONTEXTCHANGE);
 
 	if((m_env.CTXT[i].ZBUF.U32[0] ^ ZBUF.U32[0]) & 0x3f0001ff) // ZBP PSM
 	{
@@ -1284,7 +1382,7 @@ void GSState::GIFRegHandlerTRXREG(const GIFReg* RESTRICT r)
 void GSState::GIFRegHandlerTRXDIR(const GIFReg* RESTRICT r)
 {
 	GL_REG("TRXDIR = 0x%x_%x", r->u32[1], r->u32[0]);
-	Flush();
+	Flush(GSTRANSFER);
 
 	m_env.TRXDIR = (GSVector4i)r->TRXDIR;
 
@@ -1318,11 +1416,31 @@ void GSState::GIFRegHandlerHWREG(const GIFReg* RESTRICT r)
 	Write((u8*)r, 8); // haunting ground
 }
 
-void GSState::Flush()
+void GSState::Flush(GSFlushReason reason)
 {
 	FlushWrite();
 
-	FlushPrim();
+	FlushPrim(reason);
+}
+
+void GSState::FlushIfUsed(bool used, GSFlushReason reason)
+{
+	// Only the state the pending primitives depend on has to flush them, otherwise the next
+	// primitives are appended to the same draw.
+
+	if(used)
+	{
+		Flush(reason);
+	}
+	else
+	{
+		FlushWrite();
+
+		if(m_index.tail > 0)
+		{
+			m_merge_stats.merged++;
+		}
+	}
 }
 
 void GSState::FlushWrite()
@@ -1342,23 +1460,26 @@ void GSState::FlushWrite()
 
 	GSLocalMemory::writeImage wi = GSLocalMemory::m_psm[m_env.BITBLTBUF.DPSM].wi;
 
-	(m_mem.*wi)(m_tr.x, m_tr.y, &m_tr.buff[m_tr.start], len, m_env.BITBLTBUF, m_env.TRXPOS, m_env.TRXREG);
+	wi(m_mem, m_tr.x, m_tr.y, &m_tr.buff[m_tr.start], len, m_env.BITBLTBUF, m_env.TRXPOS, m_env.TRXREG);
 
 	m_tr.start += len;
 }
 
-void GSState::FlushPrim()
+void GSState::FlushPrim(GSFlushReason reason)
 {
 	if(m_index.tail > 0)
 	{
 		GL_REG("FlushPrim ctxt %d", PRIM->CTXT);
 
+		m_perfmon.Flush(reason);
+
 		// Some games (Harley Davidson/Virtua Fighter) do dirty trick with multiple contexts cluts
 		// In doubt, always reload the clut before a draw.
 		// Note: perf impact is likely slow enough as WriteTest will likely be false.
 		if (m_clut_load_before_draw) {
 			if (m_mem.m_clut.WriteTest(m_context->TEX0, m_env.TEXCLUT)) {
 				m_mem.m_clut.Write(m_context->TEX0, m_env.TEXCLUT);
+				m_perfmon.Put(GSPerfMon::ClutLoad);
 			}
 		}
 
@@ -1404,6 +1525,12 @@ void GSState::FlushPrim()
 
 			m_context->SaveReg();
 
+			m_merge_stats.draws++;
+
+			m_perfmon.Put(GSPerfMon::Draw);
+			m_perfmon.Put(GSPerfMon::Prim, m_index.tail / GSUtil::GetClassVertexCount(m_vt.m_primclass));
+			m_perfmon.Put(GSPerfMon::Vertex, m_vertex.next);
+
 			try {
 				Draw();
 			} catch (GSDXRecoverableError&) {
@@ -1477,13 +1604,15 @@ void GSState::Write(const u8* mem, int len)
 	if(!m_tr.Update(w, h, psm.trbpp, len))
 		return;
 
+	m_perfmon.Put(GSPerfMon::WriteBytes, len);
+
 	GL_CACHE("Write! ...  => 0x%x W:%d F:%s (DIR %d%d), dPos(%d %d) size(%d %d)",
 		blit.DBP, blit.DBW, psm_str(blit.DPSM),
 		m_env.TRXPOS.DIRX, m_env.TRXPOS.DIRY,
 		m_env.TRXPOS.DSAX, m_env.TRXPOS.DSAY, w, h);
 
 	if(PRIM->TME && (blit.DBP == m_context->TEX0.TBP0 || blit.DBP == m_context->TEX0.CBP)) // TODO: hmmmm
-		FlushPrim();
+		FlushPrim(UPLOADDIRTYTEX);
 
 	if(m_tr.end == 0 && len >= m_tr.total)
 	{
@@ -1500,7 +1629,7 @@ void GSState::Write(const u8* mem, int len)
 
 		InvalidateVideoMem(blit, r);
 
-		(m_mem.*psm.wi)(m_tr.x, m_tr.y, mem, m_tr.total, blit, m_env.TRXPOS, m_env.TRXREG);
+		psm.wi(m_mem, m_tr.x, m_tr.y, mem, m_tr.total, blit, m_env.TRXPOS, m_env.TRXREG);
 
 		m_tr.start = m_tr.end = m_tr.total;
 	}
@@ -1550,7 +1679,9 @@ void GSState::Read(u8* mem, int len)
 	if(!m_tr.Update(w, h, bpp, len))
 		return;
 
-	m_mem.ReadImageX(m_tr.x, m_tr.y, mem, len, m_env.BITBLTBUF, m_env.TRXPOS, m_env.TRXREG);
+	m_perfmon.Put(GSPerfMon::ReadBytes, len);
+
+	GSLocalMemory::m_psm[m_env.BITBLTBUF.SPSM].ri(m_mem, m_tr.x, m_tr.y, mem, len, m_env.BITBLTBUF, m_env.TRXPOS, m_env.TRXREG);
 }
 
 void GSState::Move()
@@ -1754,6 +1885,11 @@ void GSState::Move()
 
 void GSState::SoftReset(u32 mask)
 {
+	if(m_dump)
+	{
+		m_dump->SoftReset(mask);
+	}
+
 	if(mask & 1)
 	{
 		memset(&m_path[0], 0, sizeof(GIFPath));
@@ -1770,7 +1906,14 @@ void GSState::SoftReset(u32 mask)
 
 void GSState::ReadFIFO(u8* mem, int size)
 {
-	Flush();
+	GSPerfMonAutoTimer pmat(m_perfmon);
+
+	Flush(DOWNLOADFIFO);
+
+	if(m_dump)
+	{
+		m_dump->ReadFIFO(size);
+	}
 
 	size *= 16;
 
@@ -1784,6 +1927,8 @@ template void GSState::Transfer<3>(const u8* mem, u32 size);
 
 template<int index> void GSState::Transfer(const u8* mem, u32 size)
 {
+	GSPerfMonAutoTimer pmat(m_perfmon);
+
 	const u8* start = mem;
 
 	GIFPath& path = m_path[index];
@@ -1843,6 +1988,13 @@ template<int index> void GSState::Transfer(const u8* mem, u32 size)
 					{
 					case GIFPath::TYPE_UNKNOWN:
 
+						if(GIFRegLoop loop = GetGIFRegLoop(path))
+						{
+							loop(mem, path.nloop);
+
+							mem += total * sizeof(GIFPackedReg);
+						}
+						else
 						{
 							u32 reg = 0;
 
@@ -1910,7 +2062,25 @@ template<int index> void GSState::Transfer(const u8* mem, u32 size)
 
 			case GIF_FLG_REGLIST:
 
-				// TODO: do it similar to packed operation
+				// all data available and starting at the first register? then the whole loop can go through the compiled version
+
+				total = path.nloop * path.nreg;
+
+				if(path.reg == 0 && size >= (total + 1) / 2)
+				{
+					if(GIFRegLoop loop = GetGIFRegLoop(path))
+					{
+						loop(mem, path.nloop);
+
+						mem += ((total + 1) & ~1) * sizeof(GIFReg); // odd register counts are padded to a qword
+
+						size -= (total + 1) / 2;
+
+						path.nloop = 0;
+
+						break;
+					}
+				}
 
 				size *= 2;
 
@@ -1992,6 +2162,11 @@ template<int index> void GSState::Transfer(const u8* mem, u32 size)
 			path.nloop = 0;
 		}
 	}
+
+	if(m_dump && mem > start)
+	{
+		m_dump->Transfer(index, start, mem - start);
+	}
 }
 
 template<class T> static void WriteState(u8*& dst, T* src, size_t len = sizeof(T))
@@ -2019,7 +2194,7 @@ int GSState::Freeze(GSFreezeData* fd, bool sizeonly)
 		return -1;
 	}
 
-	Flush();
+	Flush(SAVESTATE);
 
 	u8* data = fd->data;
 
@@ -2113,7 +2288,7 @@ int GSState::Defrost(const GSFreezeData* fd)
 		return -1;
 	}
 
-	Flush();
+	Flush(LOADSTATE);
 
 	Reset();
 
@@ -2522,7 +2697,7 @@ __forceinline void GSState::VertexKick(u32 skip)
 	}
 
 	if (auto_flush && PRIM->TME && (m_context->FRAME.Block() == m_context->TEX0.TBP0))
-		FlushPrim();
+		FlushPrim(AUTOFLUSH);
 }
 
 void GSState::GetTextureMinMax(GSVector4i& r, const GIFRegTEX0& TEX0, const GIFRegCLAMP& CLAMP, bool linear)
@@ -27,6 +27,8 @@
 #include "GSLocalMemory.h"
 #include "GSDrawingContext.h"
 #include "GSDrawingEnvironment.h"
+#include "GSDump.h"
+#include "GSPerfMon.h"
 #include "Renderers/Common/GSVertex.h"
 #include "Renderers/Common/GSVertexTrace.h"
 #include "GSUtil.h"
@@ -34,6 +36,7 @@
 #include "Renderers/Common/GSDevice.h"
 #include "GSCrc.h"
 #include "GSAlignedClass.h"
+#include "GSGIFCodeGenerator.h"
 
 struct GSFrameInfo
 {
@@ -83,6 +86,22 @@ class GSState : public GSAlignedClass<32>
 	template<u32 prim, bool auto_flush> void GIFPackedRegHandlerSTQRGBAXYZ2(const GIFPackedReg* RESTRICT r, u32 size);
 	void GIFPackedRegHandlerNOP(const GIFPackedReg* RESTRICT r, u32 size);
 
+	// PACKED and REGLIST loops with a vertex-only register layout are compiled (see GSGIFCodeGenerator)
+
+	friend class GSGIFCodeGenerator;
+
+	typedef void (*GIFRegLoop)(const u8* RESTRICT mem, u32 nloop);
+	typedef void (*GIFVertexKickHandler)(GSState* RESTRICT state, u32 skip);
+
+	GSCodeGeneratorFunctionMap<GSGIFCodeGenerator, u64, GIFRegLoop> m_gif_loop_map;
+	GIFVertexKickHandler m_fpGIFVertexKick[8];
+	GIFRegLoop m_gif_loop;
+	u64 m_gif_loop_key;
+	bool m_gif_jit;
+
+	template<u32 prim, bool auto_flush> static void GIFVertexKick(GSState* RESTRICT state, u32 skip);
+	GIFRegLoop GetGIFRegLoop(const GIFPath& path);
+
 	template<int i> void ApplyTEX0(GIFRegTEX0& TEX0);
 	void ApplyPRIM(u32 prim);
 
@@ -131,6 +150,10 @@ class GSState : public GSAlignedClass<32>
 
 	bool m_clut_load_before_draw;
 
+	struct {u64 draws, merged;} m_merge_stats; // merged: state changes the pending primitives did not depend on
+
+	void FlushIfUsed(bool used, GSFlushReason reason);
+
 	struct GSTransferBuffer
 	{
 		int x, y;
@@ -213,6 +236,8 @@ public:
 	CRC::Game m_game;
 	int m_options;
 	int m_frameskip;
+	std::unique_ptr<GSDumpBase> m_dump;
+	GSPerfMon m_perfmon;
 	bool m_NTSC_Saturation;
 	bool m_nativeres;
 	int m_mipmap;
@@ -242,8 +267,8 @@ public:
 	float GetTvRefreshRate();
 
 	virtual void Reset();
-	void Flush();
-	void FlushPrim();
+	void Flush(GSFlushReason reason);
+	void FlushPrim(GSFlushReason reason);
 	void FlushWrite();
 	virtual void Draw() = 0;
 	virtual void PurgePool() = 0;
@@ -256,7 +281,7 @@ public:
 	void InitReadFIFO(u8* mem, int len);
 
 	void SoftReset(u32 mask);
-	void WriteCSR(u32 csr) {m_regs->CSR.U32[1] = csr;}
+	void WriteCSR(u32 csr) {m_regs->CSR.U32[1] = csr; if(m_dump) m_dump->WriteCSR(csr);}
 	void ReadFIFO(u8* mem, int size);
 	template<int index> void Transfer(const u8* mem, u32 size);
 	int Freeze(GSFreezeData* fd, bool sizeonly);
@@ -25,96 +25,231 @@
 #include <functional>
 #include <condition_variable>
 #include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
 
 #include "GS.h"
-#include "Utilities/boost_spsc_queue.hpp"
 
-template<class T, int CAPACITY> class GSJobQueue final
+// Bounded lock-free work queue, the stealing half of a Chase-Lev deque. One
+// thread pushes at the bottom and any number of threads take from the top.
+// T must be trivially copyable, a thief may read a slot before losing the race
+// for it.
+template<class T, int CAPACITY> class GSWorkStealingQueue final
 {
-private:
-	std::thread m_thread;
-	std::function<void(T&)> m_func;
-	bool m_exit;
-	ringbuffer_base<T, CAPACITY> m_queue;
+	static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+
+	alignas(64) std::atomic<size_t> m_top;
+	alignas(64) std::atomic<size_t> m_bottom;
+	alignas(64) T m_buff[CAPACITY];
+
+public:
+	GSWorkStealingQueue() : m_top(0), m_bottom(0) {}
+
+	bool IsEmpty() const
+	{
+		return m_bottom.load(std::memory_order_seq_cst) <= m_top.load(std::memory_order_seq_cst);
+	}
+
+	bool Push(const T& item)
+	{
+		size_t b = m_bottom.load(std::memory_order_relaxed);
+		size_t t = m_top.load(std::memory_order_acquire);
+
+		if(b - t >= CAPACITY)
+			return false;
+
+		m_buff[b & (CAPACITY - 1)] = item;
+
+		m_bottom.store(b + 1, std::memory_order_seq_cst);
+
+		return true;
+	}
+
+	bool Steal(T& item)
+	{
+		size_t t = m_top.load(std::memory_order_acquire);
+		size_t b = m_bottom.load(std::memory_order_acquire);
+
+		if(t >= b)
+			return false;
+
+		item = m_buff[t & (CAPACITY - 1)];
+
+		return m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst);
+	}
+};
+
+// Fixed set of worker threads, each with its own GSWorkStealingQueue. Items
+// are pushed by a single producer thread to the queue of a chosen worker; a
+// worker that runs dry steals from the others. Idle workers spin for a short
+// while before they park, and Wait() does the same on the producer side.
+template<class T, int CAPACITY> class GSWorkerPool final
+{
+	struct alignas(64) Worker
+	{
+		GSWorkStealingQueue<T, CAPACITY> queue;
+		std::thread thread;
+	};
+
+	enum {SPIN_COUNT = 2000};
+
+	std::function<void(int, T&)> m_func;
+	std::vector<std::unique_ptr<Worker>> m_workers;
+	int m_spin;
+
+	alignas(64) std::atomic<int> m_pending;
+	std::atomic<int> m_sleeping;
+	std::atomic<bool> m_waiting;
+	std::atomic<bool> m_exit;
 
 	std::mutex m_lock;
-	std::mutex m_wait_lock;
-	std::condition_variable m_empty;
 	std::condition_variable m_notempty;
+	std::condition_variable m_empty;
 
-	void ThreadProc() {
-		std::unique_lock<std::mutex> l(m_lock);
+	bool TryGet(int id, T& item)
+	{
+		int n = (int)m_workers.size();
 
-		while (true) {
+		for(int i = 0; i < n; i++)
+		{
+			if(m_workers[(id + i) % n]->queue.Steal(item))
+				return true;
+		}
 
-			while (m_queue.empty()) {
-				if (m_exit)
-					return;
+		return false;
+	}
 
-				m_notempty.wait(l);
-			}
+	bool HasWork() const
+	{
+		for(const auto& w : m_workers)
+		{
+			if(!w->queue.IsEmpty())
+				return true;
+		}
 
-			l.unlock();
+		return false;
+	}
 
-			while (m_queue.consume_one(*this))
-				;
+	void ThreadProc(int id)
+	{
+		T item;
 
+		while(true)
+		{
+			bool found = TryGet(id, item);
+
+			for(int i = 0; !found && i < m_spin; i++)
 			{
-				std::lock_guard<std::mutex> wait_guard(m_wait_lock);
+				_mm_pause();
+
+				found = TryGet(id, item);
 			}
-			m_empty.notify_one();
 
-			l.lock();
+			if(!found)
+			{
+				std::unique_lock<std::mutex> l(m_lock);
+
+				m_sleeping++;
+
+				while(!HasWork() && !m_exit)
+					m_notempty.wait(l);
+
+				m_sleeping--;
+
+				if(m_exit)
+					return;
+
+				continue;
+			}
+
+			m_func(id, item);
+
+			if(m_pending.fetch_sub(1) == 1 && m_waiting)
+			{
+				std::lock_guard<std::mutex> l(m_lock);
+
+				m_empty.notify_all();
+			}
 		}
 	}
 
 public:
-	GSJobQueue(std::function<void(T&)> func) :
-		m_func(func),
-		m_exit(false)
+	GSWorkerPool(int threads, std::function<void(int, T&)> func)
+		: m_func(func)
+		, m_pending(0)
+		, m_sleeping(0)
+		, m_waiting(false)
+		, m_exit(false)
 	{
-		m_thread = std::thread(&GSJobQueue::ThreadProc, this);
+		// spinning only pays off when every worker and the producer have a core of their own
+
+		m_spin = (int)std::thread::hardware_concurrency() > threads ? SPIN_COUNT : 0;
+
+		for(int i = 0; i < threads; i++)
+			m_workers.push_back(std::unique_ptr<Worker>(new Worker()));
+
+		for(int i = 0; i < threads; i++)
+			m_workers[i]->thread = std::thread(&GSWorkerPool::ThreadProc, this, i);
 	}
 
-	~GSJobQueue()
+	~GSWorkerPool()
 	{
 		{
 			std::lock_guard<std::mutex> l(m_lock);
 			m_exit = true;
 		}
-		m_notempty.notify_one();
+		m_notempty.notify_all();
 
-		m_thread.join();
+		for(auto& w : m_workers)
+			w->thread.join();
 	}
 
-	bool IsEmpty()
+	bool IsEmpty() const
 	{
-		return m_queue.empty();
+		return m_pending == 0;
 	}
 
-	void Push(const T& item) {
-		while(!m_queue.push(item))
+	// Call Wake() after a batch of pushes, parked workers don't notice them on their own
+
+	void Push(const T& item, int worker)
+	{
+		m_pending++;
+
+		while(!m_workers[worker]->queue.Push(item))
+		{
+			Wake();
+
 			std::this_thread::yield();
+		}
+	}
 
+	void Wake()
+	{
+		if(m_sleeping > 0)
 		{
-			std::lock_guard<std::mutex> l(m_lock);
+			{
+				std::lock_guard<std::mutex> l(m_lock);
+			}
+			m_notempty.notify_all();
 		}
-		m_notempty.notify_one();
 	}
 
 	void Wait()
 	{
-		if (IsEmpty())
+		for(int i = 0; !IsEmpty() && i < m_spin; i++)
+			_mm_pause();
+
+		if(IsEmpty())
 			return;
 
-		std::unique_lock<std::mutex> l(m_wait_lock);
-		while (!IsEmpty())
-			m_empty.wait(l);
+		std::unique_lock<std::mutex> l(m_lock);
 
-		assert(IsEmpty());
-	}
+		m_waiting = true;
+
+		while(!IsEmpty())
+			m_empty.wait(l);
 
-	void operator() (T& item) {
-		m_func(item);
+		m_waiting = false;
 	}
 };
@@ -22,6 +22,10 @@
 #include "Pcsx2Types.h"
 
 #include "GSUtil.h"
+#include "GSVector.h"
+#include "GSMultiISA.h"
+#include "xbyak/xbyak_util.h"
+#include "options_tools.h"
 
 #ifdef _WIN32
 #include "Renderers/DX11/GSDevice11.h"
@@ -98,11 +102,34 @@ public:
 
 } s_maps;
 
+GSISA g_gs_isa = GSISA::Native;
+
 void GSUtil::Init()
 {
 	s_maps.Init();
 }
 
+void GSUtil::SelectISA()
+{
+#ifdef MULTI_ISA
+	Xbyak::util::Cpu cpu;
+
+	if(cpu.has(Xbyak::util::Cpu::tAVX2) && cpu.has(Xbyak::util::Cpu::tBMI1) && cpu.has(Xbyak::util::Cpu::tBMI2))
+		g_gs_isa = GSISA::AVX2;
+	else if(cpu.has(Xbyak::util::Cpu::tAVX))
+		g_gs_isa = GSISA::AVX;
+	else
+		g_gs_isa = GSISA::SSE41;
+
+	if(!cpu.has(Xbyak::util::Cpu::tSSE41))
+		log_cb(RETRO_LOG_ERROR, "GSdx: this build requires SSE4.1\n");
+
+	static const char* names[] = {"native", "SSE4.1", "AVX", "AVX2"};
+
+	log_cb(RETRO_LOG_INFO, "GSdx: using %s code paths\n", names[(int)g_gs_isa]);
+#endif
+}
+
 GS_PRIM_CLASS GSUtil::GetPrimClass(u32 prim)
 {
 	return (GS_PRIM_CLASS)s_maps.PrimClassField[prim];
@@ -148,6 +175,67 @@ CRCHackLevel GSUtil::GetRecommendedCRCHackLevel(GSRendererType type)
 	return type == GSRendererType::OGL_HW ? CRCHackLevel::Partial : CRCHackLevel::Full;
 }
 
+// xxh3-style hash of one 256 byte gs memory block, two 64-bit lanes per vector, one key per 16 bytes
+
+u64 GSUtil::HashBlock(const void* block)
+{
+	const GSVector4i* RESTRICT src = (const GSVector4i*)block;
+
+	static const GSVector4i key[16] =
+	{
+		GSVector4i(0xa1b965f4, 0x6e789e6a, 0x8009454f, 0x06c45d18),
+		GSVector4i(0x724c81ec, 0xf88bb8a8, 0x51a8749b, 0x1b39896a),
+		GSVector4i(0x747ea2ea, 0x53cb9f0c, 0x1f4532e1, 0x2c829abe),
+		GSVector4i(0xc916ab3c, 0xc584133a, 0x41c98ac3, 0x3ee57890),
+		GSVector4i(0x368cb0a6, 0xf3b8488c, 0x3cb13d09, 0x657eecdd),
+		GSVector4i(0x055bdef6, 0xc2d326e0, 0xe0bbdb7b, 0x8621a03f),
+		GSVector4i(0x983aa92f, 0x8e1f7555, 0x00cc4d19, 0xb54e0f16),
+		GSVector4i(0x971d80ab, 0x84bb3f97, 0x75521255, 0x7d29825c),
+		GSVector4i(0x2b7f7f86, 0xc3cf1710, 0x83914f64, 0x3466e9a0),
+		GSVector4i(0x5a4485ac, 0xd81a8d2b, 0x100b9ed7, 0xdb01602b),
+		GSVector4i(0x1825f10d, 0xa9038a92, 0x0dca2f6a, 0xedf5f1d9),
+		GSVector4i(0x7bd2634c, 0x54496ad6, 0xf5407269, 0xdd7c01d4),
+		GSVector4i(0xdb4c4f7b, 0x935e82f1, 0x92233300, 0x69b82ebc),
+		GSVector4i(0x7de1d510, 0x40d29eb5, 0xb45c6316, 0xa2f09dab),
+		GSVector4i(0x0f4d3872, 0xee521d7a, 0x72f3454f, 0xf16952ee),
+		GSVector4i(0xa8e40225, 0x377d35de, 0x4963bab0, 0x0c7de806),
+	};
+
+	GSVector4i acc0(0xc2b2ae3d, 0x27d4eb2f, 0x165667b1, 0x9e3779b1);
+	GSVector4i acc1(0x85ebca77, 0xc2b2ae63, 0x27d4eb4f, 0x61c88647);
+
+	for(int i = 0; i < 16; i += 2)
+	{
+		GSVector4i d0 = src[i + 0];
+		GSVector4i d1 = src[i + 1];
+
+		GSVector4i k0 = d0 ^ key[i + 0];
+		GSVector4i k1 = d1 ^ key[i + 1];
+
+		acc0 = acc0.add64(d0.zwxy()).add64(k0.mul32lu(k0.yxwz()));
+		acc1 = acc1.add64(d1.zwxy()).add64(k1.mul32lu(k1.yxwz()));
+	}
+
+	alignas(16) u64 lane[4];
+
+	GSVector4i::store<true>(&lane[0], acc0);
+	GSVector4i::store<true>(&lane[2], acc1);
+
+	u64 h = 256 * 0x9e3779b185ebca87ull;
+
+	for(int i = 0; i < 4; i++)
+	{
+		u64 a = lane[i] ^ (lane[i] >> 47);
+
+		h = (h ^ a) * 0x165667919e3779f9ull;
+		h ^= h >> 37;
+	}
+
+	h ^= h >> 32;
+
+	return h | 1; // 0 is reserved for blocks never read
+}
+
 const char* psm_str(int psm)
 {
 	switch(psm) {
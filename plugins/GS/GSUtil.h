@@ -28,6 +28,7 @@ class GSUtil
 {
 public:
 	static void Init();
+	static void SelectISA();
 
 	static GS_PRIM_CLASS GetPrimClass(u32 prim);
 	static int GetVertexCount(u32 prim);
@@ -40,6 +41,8 @@ public:
 	static bool HasCompatibleBits(u32 spsm, u32 dpsm);
 
 	static CRCHackLevel GetRecommendedCRCHackLevel(GSRendererType type);
+
+	static u64 HashBlock(const void* block); // 256 bytes, never 0
 };
 
 const char* psm_str(int psm);
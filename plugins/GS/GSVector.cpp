@@ -125,7 +125,7 @@ void GSVector8::InitVectors()
 
 #endif
 
-#if _M_SSE >= 0x501
+#if defined(_M_AVX2)
 GSVector8i GSVector8i::m_xff[33];
 GSVector8i GSVector8i::m_x0f[33];
 
@@ -51,28 +51,28 @@ public:
 		struct {T v[2];};
 	};
 
-	GSVector2T()
+	__forceinline GSVector2T()
 	{
 	}
 
-	GSVector2T(T x)
+	__forceinline GSVector2T(T x)
 	{
 		this->x = x;
 		this->y = x;
 	}
 
-	GSVector2T(T x, T y)
+	__forceinline GSVector2T(T x, T y)
 	{
 		this->x = x;
 		this->y = y;
 	}
 
-	bool operator == (const GSVector2T& v) const
+	__forceinline bool operator == (const GSVector2T& v) const
 	{
 		return x == v.x && y == v.y;
 	}
 
-	bool operator != (const GSVector2T& v) const
+	__forceinline bool operator != (const GSVector2T& v) const
 	{
 		return x != v.x || y != v.y;
 	}
@@ -90,7 +90,7 @@ class GSVector8;
 
 #endif
 
-#if _M_SSE >= 0x501
+#if defined(_M_AVX2)
 
 class GSVector8i;
 
@@ -114,7 +114,7 @@ __forceinline GSVector4::GSVector4(const GSVector4i& v)
 	m = _mm_cvtepi32_ps(v);
 }
 
-#if _M_SSE >= 0x501
+#if defined(_M_AVX2)
 
 __forceinline GSVector8i::GSVector8i(const GSVector8& v, bool truncate)
 {
@@ -164,7 +164,7 @@ __forceinline GSVector8 GSVector8::cast(const GSVector4& v)
 
 #endif
 
-#if _M_SSE >= 0x501
+#if defined(_M_AVX2)
 
 __forceinline GSVector4i GSVector4i::cast(const GSVector8i& v)
 {
@@ -143,7 +143,7 @@ public:
 
 	#endif
 
-	#if _M_SSE >= 0x501
+	#if defined(_M_AVX2)
 
 	__forceinline static GSVector4 cast(const GSVector8i& v);
 
@@ -116,7 +116,7 @@ public:
 
 	#endif
 
-	#if _M_SSE >= 0x501
+	#if defined(_M_AVX2)
 
 	__forceinline static GSVector4i cast(const GSVector8i& v);
 
@@ -900,6 +900,11 @@ public:
 		return GSVector4i(_mm_add_epi32(m, v.m));
 	}
 
+	__forceinline GSVector4i add64(const GSVector4i& v) const
+	{
+		return GSVector4i(_mm_add_epi64(m, v.m));
+	}
+
 	__forceinline GSVector4i adds8(const GSVector4i& v) const
 	{
 		return GSVector4i(_mm_adds_epi8(m, v.m));
@@ -980,6 +985,13 @@ public:
 		return GSVector4i(_mm_mullo_epi16(m, v.m));
 	}
 
+	__forceinline GSVector4i mul32lu(const GSVector4i& v) const
+	{
+		// low 32 bits of each 64-bit lane, full 64-bit products
+
+		return GSVector4i(_mm_mul_epu32(m, v.m));
+	}
+
 	#if _M_SSE >= 0x301
 
 	__forceinline GSVector4i mul16hrs(const GSVector4i& v) const
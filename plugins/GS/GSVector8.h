@@ -119,7 +119,7 @@ public:
 		this->m = m;
 	}
 
-	#if _M_SSE >= 0x501
+	#if defined(_M_AVX2)
 
 	__forceinline explicit GSVector8(const GSVector8i& v);
 
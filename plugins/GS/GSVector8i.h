@@ -23,7 +23,7 @@
 
 #include "stdafx.h"
 
-#if _M_SSE >= 0x501
+#if defined(_M_AVX2)
 
 class alignas(32) GSVector8i
 {
@@ -1113,7 +1113,7 @@ public:
 
 	#ifdef _M_AMD64
 
-	__forceinline static GSVector8i loadq(int64 i)
+	__forceinline static GSVector8i loadq(s64 i)
 	{
 		return cast(GSVector4i::loadq(i));
 	}
@@ -1154,7 +1154,7 @@ public:
 
 	#ifdef _M_AMD64
 
-	__forceinline static int64 storeq(const GSVector8i& v)
+	__forceinline static s64 storeq(const GSVector8i& v)
 	{
 		return GSVector4i::storeq(GSVector4i::cast(v));
 	}
@@ -1188,6 +1188,19 @@ public:
 
 	// TODO: swizzling
 
+	__forceinline static void sw4(GSVector8i& a, GSVector8i& b)
+	{
+		const __m256i epi32_0f0f0f0f = _mm256_set1_epi32(0x0f0f0f0f);
+
+		GSVector8i mask(epi32_0f0f0f0f);
+
+		GSVector8i c = (b << 4).blend(a, mask);
+		GSVector8i d = b.blend(a >> 4, mask);
+
+		a = c.upl8(d);
+		b = c.uph8(d);
+	}
+
 	__forceinline static void sw8(GSVector8i& a, GSVector8i& b)
 	{
 		GSVector8i c = a;
@@ -197,6 +197,7 @@ public:
 	virtual void OMSetRenderTargets(GSTexture* rt, GSTexture* ds, const GSVector4i* scissor = NULL) {}
 
 	GSTexture* GetCurrent();
+	void SetCurrent(GSTexture* t) {m_current = t;} // a finished frame that bypasses Merge/Interlace
 
 	void Merge(GSTexture* sTex[3], GSVector4* sRect, GSVector4* dRect, const GSVector2i& fs, const GSRegPMODE& PMODE, const GSRegEXTBUF& EXTBUF, const GSVector4& c);
 	void Interlace(const GSVector2i& ds, int field, int mode, float yoffset);
@@ -23,6 +23,9 @@
 
 #include "Pcsx2Types.h"
 
+#include <mutex>
+#include <set>
+
 #include "../../GS.h"
 #include "../../GSCodeBuffer.h"
 
@@ -103,14 +106,29 @@ class GSCodeGeneratorFunctionMap : public GSFunctionMap<KEY, VALUE>
 	void* m_param;
 	std::unordered_map<u64, VALUE> m_cgmap;
 	GSCodeBuffer m_cb;
+	std::mutex m_lock; // Prepare can run on another thread than the one drawing
 
 public:
 	GSCodeGeneratorFunctionMap(const char* name, void* param)
 		: m_param(param) { }
 	~GSCodeGeneratorFunctionMap() { }
 
+	void Prepare(KEY key)
+	{
+		GetDefaultFunction(key);
+	}
+
+	void GetKeys(std::set<u64>& keys)
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+
+		for(const auto& i : m_cgmap) keys.insert(i.first);
+	}
+
 	VALUE GetDefaultFunction(KEY key)
 	{
+		std::lock_guard<std::mutex> lock(m_lock);
+
 		VALUE ret = NULL;
 
 		auto i = m_cgmap.find(key);
@@ -20,6 +20,8 @@
  */
 
 #include "GSRenderer.h"
+#include "options_tools.h"
+#include <ctime>
 
 GSRenderer::GSRenderer()
 	: m_texture_shuffle(false)
@@ -241,25 +243,34 @@ bool GSRenderer::Merge(int field)
 
 		GSVector4 c = GSVector4((int)m_regs->BGCOLOR.R, (int)m_regs->BGCOLOR.G, (int)m_regs->BGCOLOR.B, (int)m_regs->PMODE.ALP) / 255;
 
-		m_dev->Merge(tex, src_hw, dst, fs, m_regs->PMODE, m_regs->EXTBUF, c);
+		int field2 = 0;
+		int mode = -1;
 
 		if(m_regs->SMODE2.INT && m_interlace > 0)
 		{
 			if(m_interlace == 7 && m_regs->SMODE2.FFMD) // Auto interlace enabled / Odd frame interlace setting
 			{
-				int field2 = 0;
-				int mode = 2;
-				m_dev->Interlace(ds, field ^ field2, mode, tex[1] ? tex[1]->GetScale().y : tex[0]->GetScale().y);
+				field2 = 0;
+				mode = 2;
 			}
 			else
 			{
-				int field2 = 1 - ((m_interlace - 1) & 1);
-				int mode = (m_interlace - 1) >> 1;
+				field2 = 1 - ((m_interlace - 1) & 1);
+				mode = (m_interlace - 1) >> 1;
+			}
+		}
+
+		if(!MergeOutput(tex, src_hw, dst, fs, ds, field ^ field2, mode))
+		{
+			m_dev->Merge(tex, src_hw, dst, fs, m_regs->PMODE, m_regs->EXTBUF, c);
+
+			if(mode >= 0)
+			{
 				m_dev->Interlace(ds, field ^ field2, mode, tex[1] ? tex[1]->GetScale().y : tex[0]->GetScale().y);
 			}
 		}
 
-		if(m_fxaa)
+		if(m_fxaa && m_dev->GetCurrent())
 			m_dev->FXAA();
 	}
 
@@ -271,9 +282,56 @@ GSVector2i GSRenderer::GetInternalResolution()
 	return m_real_size;
 }
 
+void GSRenderer::UpdateCapture()
+{
+	if(option_gs_capture && !m_dump)
+	{
+		const char* save_dir = nullptr;
+
+		if(!environ_cb(RETRO_ENVIRONMENT_GET_SAVE_DIRECTORY, &save_dir) || !save_dir)
+			save_dir = ".";
+
+		char stamp[32];
+		time_t now = time(nullptr);
+		strftime(stamp, sizeof(stamp), "%Y%m%d%H%M%S", localtime(&now));
+
+		char fn[64];
+		snprintf(fn, sizeof(fn), "/gs_%08X_%s", m_crc, stamp);
+
+		GSFreezeData fd = {0, nullptr};
+		Freeze(&fd, true);
+		std::vector<u8> state(fd.size);
+		fd.data = state.data();
+		Freeze(&fd, false);
+
+		m_dump = std::unique_ptr<GSDumpBase>(new GSDumpXz(std::string(save_dir) + fn, m_crc, fd, m_regs));
+
+		if(!m_dump->IsOpen())
+			m_dump.reset();
+		else
+			log_cb(RETRO_LOG_INFO, "GS capture started: %s%s.gs.xz\n", save_dir, fn);
+	}
+	else if(!option_gs_capture && m_dump)
+	{
+		log_cb(RETRO_LOG_INFO, "GS capture stopped after %d frames\n", m_dump->GetFrames());
+		m_dump.reset();
+	}
+}
+
 void GSRenderer::VSync(int field)
 {
-	Flush();
+	GSPerfMonAutoTimer pmat(m_perfmon);
+
+	// The frame is closed before the capture state is looked at, so a
+	// capture started here begins with the transfers of the next frame.
+	if(m_dump)
+		m_dump->VSync(field, m_regs);
+
+	UpdateCapture();
+
+	Flush(VSYNC);
+
+	m_perfmon.Update();
 
 	if(!Merge(field ? 1 : 0))
 		return;
@@ -27,6 +27,7 @@
 class GSRenderer : public GSState
 {
 	bool Merge(int field);
+	void UpdateCapture();
 
 protected:
 	int m_dithering;
@@ -39,6 +40,10 @@ protected:
 	virtual GSTexture* GetOutput(int i, int& y_offset) = 0;
 	virtual GSTexture* GetFeedbackOutput() { return nullptr; }
 
+	// Renderers that keep their output in host memory can merge and deinterlace it themselves,
+	// returning false leaves it to GSDevice::Merge and GSDevice::Interlace.
+	virtual bool MergeOutput(GSTexture* tex[3], GSVector4* src, GSVector4* dst, const GSVector2i& fs, const GSVector2i& ds, int field, int mode) { return false; }
+
 public:
 	GSDevice* m_dev;
 
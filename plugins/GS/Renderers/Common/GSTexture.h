@@ -49,6 +49,9 @@ public:
 	virtual bool Update(const GSVector4i& r, const void* data, int pitch, int layer = 0) = 0;
 	virtual bool Map(GSMap& m, const GSVector4i* r = NULL, int layer = 0) = 0;
 	virtual void Unmap() = 0;
+	// Starts copying r of an offscreen texture to host memory without waiting for it, the
+	// next Map of the same rectangle waits for the copy instead of reading the texture.
+	virtual bool Download(const GSVector4i& r) {return false;}
 	virtual void GenerateMipmap() {}
 	virtual u32 GetID() { return 0; }
 
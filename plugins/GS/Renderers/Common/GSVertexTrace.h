@@ -27,9 +27,12 @@
 #include "GSVertex.h"
 #include "../SW/GSVertexSW.h"
 #include "../HW/GSVertexHW.h"
+#include "../../GSMultiISA.h"
 
 class GSState;
 
+MULTI_ISA_DEF(class GSVertexTraceFMM;)
+
 class alignas(32) GSVertexTrace : public GSAlignedClass<32>
 {
 	BiFiltering m_force_filter;
@@ -41,15 +44,17 @@ public:
 
 protected:
 	const GSState* m_state;
+	const GSDrawingContext* m_context; // m_state->m_context for FindMinMax, which does not see GSState
 
 	static GSVector4 s_minmax;
 
-	typedef void (GSVertexTrace::*FindMinMaxPtr)(const void* vertex, const u32* index, int count);
+	// FindMinMax is built per instruction set, see GSVertexTraceFMM.cpp
 
-	FindMinMaxPtr m_fmm[2][2][2][2][2][4];
+	MULTI_ISA_FRIEND(GSVertexTraceFMM)
 
-	template<GS_PRIM_CLASS primclass, u32 iip, u32 tme, u32 fst, u32 color, u32 accurate_stq>
-	void FindMinMax(const void* vertex, const u32* index, int count);
+	typedef void (*FindMinMaxPtr)(GSVertexTrace& vt, const void* vertex, const u32* index, int count);
+
+	FindMinMaxPtr m_fmm[2][2][2][2][2][4];
 
 public:
 	GS_PRIM_CLASS m_primclass;
@@ -85,3 +90,5 @@ public:
 
 	void CorrectDepthTrace(const void* vertex, int count);
 };
+
+MULTI_ISA_DEF(void GSVertexTracePopulateFunctions(GSVertexTrace& vt);)
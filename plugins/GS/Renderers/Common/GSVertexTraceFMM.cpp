@@ -0,0 +1,581 @@
+/*
+ *	Copyright (C) 2007-2009 Gabest
+ *	http://www.gabest.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNU Make; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "Pcsx2Types.h"
+
+#include "GSVertexTrace.h"
+
+// The vertex bounds of every draw. The file is built once per instruction set (see
+// GSMultiISA.h), GSVertexTrace calls the FindMinMax copy that PopulateFunctions picks.
+
+MULTI_ISA_UNSHARED_START
+
+class GSVertexTraceFMM
+{
+	template<GS_PRIM_CLASS primclass, u32 iip, u32 tme, u32 fst, u32 color, u32 accurate_stq>
+	static void FindMinMax(GSVertexTrace& vt, const void* vertex, const u32* index, int count);
+
+public:
+	static void PopulateFunctions(GSVertexTrace& vt);
+};
+
+void GSVertexTracePopulateFunctions(GSVertexTrace& vt)
+{
+	GSVertexTraceFMM::PopulateFunctions(vt);
+}
+
+void GSVertexTraceFMM::PopulateFunctions(GSVertexTrace& vt)
+{
+	#define InitUpdate3(P, IIP, TME, FST, COLOR) \
+		vt.m_fmm[0][COLOR][FST][TME][IIP][P] = &GSVertexTraceFMM::FindMinMax<P, IIP, TME, FST, COLOR, 0>; \
+		vt.m_fmm[1][COLOR][FST][TME][IIP][P] = &GSVertexTraceFMM::FindMinMax<P, IIP, TME, FST, COLOR, 1>; \
+
+	#define InitUpdate2(P, IIP, TME) \
+		InitUpdate3(P, IIP, TME, 0, 0) \
+		InitUpdate3(P, IIP, TME, 0, 1) \
+		InitUpdate3(P, IIP, TME, 1, 0) \
+		InitUpdate3(P, IIP, TME, 1, 1) \
+
+	#define InitUpdate(P) \
+		InitUpdate2(P, 0, 0) \
+		InitUpdate2(P, 0, 1) \
+		InitUpdate2(P, 1, 0) \
+		InitUpdate2(P, 1, 1) \
+
+	InitUpdate(GS_POINT_CLASS);
+	InitUpdate(GS_LINE_CLASS);
+	InitUpdate(GS_TRIANGLE_CLASS);
+	InitUpdate(GS_SPRITE_CLASS);
+}
+
+template<GS_PRIM_CLASS primclass, u32 iip, u32 tme, u32 fst, u32 color, u32 accurate_stq>
+void GSVertexTraceFMM::FindMinMax(GSVertexTrace& vt, const void* vertex, const u32* index, int count)
+{
+	const GSDrawingContext* context = vt.m_context;
+
+	int n = 1;
+
+	switch(primclass)
+	{
+	case GS_POINT_CLASS:
+		n = 1;
+		break;
+	case GS_LINE_CLASS:
+	case GS_SPRITE_CLASS:
+		n = 2;
+		break;
+	case GS_TRIANGLE_CLASS:
+		n = 3;
+		break;
+	}
+
+	GSVector4 tmin  = GSVertexTrace::s_minmax.xxxx();
+	GSVector4 tmax  = GSVertexTrace::s_minmax.yyyy();
+	GSVector4i cmin = GSVector4i::xffffffff();
+	GSVector4i cmax = GSVector4i::zero();
+
+	#if _M_SSE >= 0x401
+
+	GSVector4i pmin = GSVector4i::xffffffff();
+	GSVector4i pmax = GSVector4i::zero();
+
+	#else
+
+	GSVector4 pmin = GSVertexTrace::s_minmax.xxxx();
+	GSVector4 pmax = GSVertexTrace::s_minmax.yyyy();
+	
+	#endif
+
+	const GSVertex* RESTRICT v = (GSVertex*)vertex;
+
+	#if defined(_M_AVX2)
+
+	// Two vertices per iteration, one in each 128-bit lane, doing the same per vertex work as
+	// the loop below. Apart from the flat shaded color every vertex counts the same way, so the
+	// index list is walked in pairs whatever n is. Lines and sprites are exactly one pair, for
+	// sprites q and fog come from the second vertex.
+
+	GSVector8 tmin8 = GSVector8(GSVertexTrace::s_minmax.xxxx());
+	GSVector8 tmax8 = GSVector8(GSVertexTrace::s_minmax.yyyy());
+	GSVector8i cmin8 = GSVector8i::xffffffff();
+	GSVector8i cmax8 = GSVector8i::zero();
+	GSVector8i pmin8 = GSVector8i::xffffffff();
+	GSVector8i pmax8 = GSVector8i::zero();
+
+	auto minmax = [&](u32 i0, u32 i1)
+	{
+		GSVector8i c = GSVector8i::load(&v[i0].m[0], &v[i1].m[0]);
+		GSVector8i xyzf = GSVector8i::load(&v[i0].m[1], &v[i1].m[1]);
+
+		if(color)
+		{
+			if(iip || primclass == GS_POINT_CLASS)
+			{
+				cmin8 = cmin8.min_u8(c);
+				cmax8 = cmax8.max_u8(c);
+			}
+			else if(primclass == GS_LINE_CLASS || primclass == GS_SPRITE_CLASS)
+			{
+				cmin8 = cmin8.min_u8(c.bb());
+				cmax8 = cmax8.max_u8(c.bb());
+			}
+		}
+
+		if(tme)
+		{
+			if(!fst)
+			{
+				GSVector8 stq = GSVector8::cast(c);
+
+				GSVector8 q = primclass == GS_SPRITE_CLASS ? stq.wwww().bb() : stq.wwww();
+
+				if(accurate_stq)
+					stq = (stq.xyww() / q).xyww(q);
+				else
+					stq = (stq.xyww() * q.rcpnr()).xyww(q);
+
+				tmin8 = tmin8.min(stq);
+				tmax8 = tmax8.max(stq);
+			}
+			else
+			{
+				GSVector8 st = GSVector8(xyzf.uph16()).xyxy();
+
+				tmin8 = tmin8.min(st);
+				tmax8 = tmax8.max(st);
+			}
+		}
+
+		GSVector8i xy = xyzf.upl16();
+		GSVector8i z = xyzf.yyyy();
+		GSVector8i p = xy.blend16<0xf0>(z.uph32(primclass == GS_SPRITE_CLASS ? xyzf.bb() : xyzf));
+
+		pmin8 = pmin8.min_u32(p);
+		pmax8 = pmax8.max_u32(p);
+	};
+
+	int i = 0;
+
+	for(; i < (count & ~1); i += 2)
+	{
+		minmax(index[i + 0], index[i + 1]);
+	}
+
+	if(i < count)
+	{
+		minmax(index[i], index[i]); // odd number of points or triangles, the last vertex goes to both lanes
+	}
+
+	tmin = tmin8.extract<0>().min(tmin8.extract<1>());
+	tmax = tmax8.extract<0>().max(tmax8.extract<1>());
+	cmin = cmin8.extract<0>().min_u8(cmin8.extract<1>());
+	cmax = cmax8.extract<0>().max_u8(cmax8.extract<1>());
+	pmin = pmin8.extract<0>().min_u32(pmin8.extract<1>());
+	pmax = pmax8.extract<0>().max_u32(pmax8.extract<1>());
+
+	if(color && !iip && primclass == GS_TRIANGLE_CLASS)
+	{
+		for(i = n - 1; i < count; i += n)
+		{
+			GSVector4i c(v[index[i]].m[0]);
+
+			cmin = cmin.min_u8(c);
+			cmax = cmax.max_u8(c);
+		}
+	}
+
+	#else
+
+	for(int i = 0; i < count; i += n)
+	{
+		if(primclass == GS_POINT_CLASS)
+		{
+			GSVector4i c(v[index[i]].m[0]);
+
+			if(color)
+			{
+				cmin = cmin.min_u8(c);
+				cmax = cmax.max_u8(c);
+			}
+
+			if(tme)
+			{
+				if(!fst)
+				{
+					GSVector4 stq = GSVector4::cast(c);
+
+					GSVector4 q = stq.wwww();
+
+					if (accurate_stq)
+						stq = (stq.xyww() / q).xyww(q);
+					else
+						stq = (stq.xyww() * q.rcpnr()).xyww(q);
+
+					tmin = tmin.min(stq);
+					tmax = tmax.max(stq);
+				}
+				else
+				{
+					GSVector4i uv(v[index[i]].m[1]);
+
+					GSVector4 st = GSVector4(uv.uph16()).xyxy();
+
+					tmin = tmin.min(st);
+					tmax = tmax.max(st);
+				}
+			}
+
+			GSVector4i xyzf(v[index[i]].m[1]);
+
+			GSVector4i xy = xyzf.upl16();
+			GSVector4i z = xyzf.yyyy();
+
+			#if _M_SSE >= 0x401
+
+			GSVector4i p = xy.blend16<0xf0>(z.uph32(xyzf));
+
+			pmin = pmin.min_u32(p);
+			pmax = pmax.max_u32(p);
+
+			#else
+
+			GSVector4 p = GSVector4(xy.upl64(z.srl32(1).upl32(xyzf.wwww())));
+
+			pmin = pmin.min(p);
+			pmax = pmax.max(p);
+
+			#endif
+		}
+		else if(primclass == GS_LINE_CLASS)
+		{
+			GSVector4i c0(v[index[i + 0]].m[0]);
+			GSVector4i c1(v[index[i + 1]].m[0]);
+
+			if(color)
+			{
+				if(iip)
+				{
+					cmin = cmin.min_u8(c0.min_u8(c1));
+					cmax = cmax.max_u8(c0.max_u8(c1));
+				}
+				else
+				{
+					cmin = cmin.min_u8(c1);
+					cmax = cmax.max_u8(c1);
+				}
+			}
+
+			if(tme)
+			{
+				if(!fst)
+				{
+					GSVector4 stq0 = GSVector4::cast(c0);
+					GSVector4 stq1 = GSVector4::cast(c1);
+
+					if(accurate_stq)
+					{
+						GSVector4 q = stq0.wwww(stq1);
+
+						stq0 = (stq0.xyww() / q.xxxx()).xyww(stq0);
+						stq1 = (stq1.xyww() / q.zzzz()).xyww(stq1);
+					}
+					else
+					{
+						GSVector4 q = stq0.wwww(stq1).rcpnr();
+
+						stq0 = (stq0.xyww() * q.xxxx()).xyww(stq0);
+						stq1 = (stq1.xyww() * q.zzzz()).xyww(stq1);
+					}
+
+					tmin = tmin.min(stq0.min(stq1));
+					tmax = tmax.max(stq0.max(stq1));
+				}
+				else
+				{
+					GSVector4i uv0(v[index[i + 0]].m[1]);
+					GSVector4i uv1(v[index[i + 1]].m[1]);
+
+					GSVector4 st0 = GSVector4(uv0.uph16()).xyxy();
+					GSVector4 st1 = GSVector4(uv1.uph16()).xyxy();
+
+					tmin = tmin.min(st0.min(st1));
+					tmax = tmax.max(st0.max(st1));
+				}
+			}
+
+			GSVector4i xyzf0(v[index[i + 0]].m[1]);
+			GSVector4i xyzf1(v[index[i + 1]].m[1]);
+
+			GSVector4i xy0 = xyzf0.upl16();
+			GSVector4i z0 = xyzf0.yyyy();
+			GSVector4i xy1 = xyzf1.upl16();
+			GSVector4i z1 = xyzf1.yyyy();
+
+			#if _M_SSE >= 0x401
+
+			GSVector4i p0 = xy0.blend16<0xf0>(z0.uph32(xyzf0));
+			GSVector4i p1 = xy1.blend16<0xf0>(z1.uph32(xyzf1));
+
+			pmin = pmin.min_u32(p0.min_u32(p1));
+			pmax = pmax.max_u32(p0.max_u32(p1));
+
+			#else
+
+			GSVector4 p0 = GSVector4(xy0.upl64(z0.srl32(1).upl32(xyzf0.wwww())));
+			GSVector4 p1 = GSVector4(xy1.upl64(z1.srl32(1).upl32(xyzf1.wwww())));
+
+			pmin = pmin.min(p0.min(p1));
+			pmax = pmax.max(p0.max(p1));
+
+			#endif
+		}
+		else if(primclass == GS_TRIANGLE_CLASS)
+		{
+			GSVector4i c0(v[index[i + 0]].m[0]);
+			GSVector4i c1(v[index[i + 1]].m[0]);
+			GSVector4i c2(v[index[i + 2]].m[0]);
+
+			if(color)
+			{
+				if(iip)
+				{
+					cmin = cmin.min_u8(c2).min_u8(c0.min_u8(c1));
+					cmax = cmax.max_u8(c2).max_u8(c0.max_u8(c1));
+				}
+				else
+				{
+					cmin = cmin.min_u8(c2);
+					cmax = cmax.max_u8(c2);
+				}
+			}
+
+			if(tme)
+			{
+				if(!fst)
+				{
+					GSVector4 stq0 = GSVector4::cast(c0);
+					GSVector4 stq1 = GSVector4::cast(c1);
+					GSVector4 stq2 = GSVector4::cast(c2);
+
+					if(accurate_stq)
+					{
+						GSVector4 q = stq0.wwww(stq1).xzww(stq2);
+
+						stq0 = (stq0.xyww() / q.xxxx()).xyww(stq0);
+						stq1 = (stq1.xyww() / q.yyyy()).xyww(stq1);
+						stq2 = (stq2.xyww() / q.zzzz()).xyww(stq2);
+					}
+					else
+					{
+						GSVector4 q = stq0.wwww(stq1).xzww(stq2).rcpnr();
+
+						stq0 = (stq0.xyww() * q.xxxx()).xyww(stq0);
+						stq1 = (stq1.xyww() * q.yyyy()).xyww(stq1);
+						stq2 = (stq2.xyww() * q.zzzz()).xyww(stq2);
+					}
+
+					tmin = tmin.min(stq2).min(stq0.min(stq1));
+					tmax = tmax.max(stq2).max(stq0.max(stq1));
+				}
+				else
+				{
+					GSVector4i uv0(v[index[i + 0]].m[1]);
+					GSVector4i uv1(v[index[i + 1]].m[1]);
+					GSVector4i uv2(v[index[i + 2]].m[1]);
+
+					GSVector4 st0 = GSVector4(uv0.uph16()).xyxy();
+					GSVector4 st1 = GSVector4(uv1.uph16()).xyxy();
+					GSVector4 st2 = GSVector4(uv2.uph16()).xyxy();
+
+					tmin = tmin.min(st2).min(st0.min(st1));
+					tmax = tmax.max(st2).max(st0.max(st1));
+				}
+			}
+
+			GSVector4i xyzf0(v[index[i + 0]].m[1]);
+			GSVector4i xyzf1(v[index[i + 1]].m[1]);
+			GSVector4i xyzf2(v[index[i + 2]].m[1]);
+
+			GSVector4i xy0 = xyzf0.upl16();
+			GSVector4i z0 = xyzf0.yyyy();
+			GSVector4i xy1 = xyzf1.upl16();
+			GSVector4i z1 = xyzf1.yyyy();
+			GSVector4i xy2 = xyzf2.upl16();
+			GSVector4i z2 = xyzf2.yyyy();
+
+			#if _M_SSE >= 0x401
+
+			GSVector4i p0 = xy0.blend16<0xf0>(z0.uph32(xyzf0));
+			GSVector4i p1 = xy1.blend16<0xf0>(z1.uph32(xyzf1));
+			GSVector4i p2 = xy2.blend16<0xf0>(z2.uph32(xyzf2));
+
+			pmin = pmin.min_u32(p2).min_u32(p0.min_u32(p1));
+			pmax = pmax.max_u32(p2).max_u32(p0.max_u32(p1));
+
+			#else
+
+			GSVector4 p0 = GSVector4(xy0.upl64(z0.srl32(1).upl32(xyzf0.wwww())));
+			GSVector4 p1 = GSVector4(xy1.upl64(z1.srl32(1).upl32(xyzf1.wwww())));
+			GSVector4 p2 = GSVector4(xy2.upl64(z2.srl32(1).upl32(xyzf2.wwww())));
+
+			pmin = pmin.min(p2).min(p0.min(p1));
+			pmax = pmax.max(p2).max(p0.max(p1));
+
+			#endif
+		}
+		else if(primclass == GS_SPRITE_CLASS)
+		{
+			GSVector4i c0(v[index[i + 0]].m[0]);
+			GSVector4i c1(v[index[i + 1]].m[0]);
+
+			if(color)
+			{
+				if(iip)
+				{
+					cmin = cmin.min_u8(c0.min_u8(c1));
+					cmax = cmax.max_u8(c0.max_u8(c1));
+				}
+				else
+				{
+					cmin = cmin.min_u8(c1);
+					cmax = cmax.max_u8(c1);
+				}
+			}
+
+			if(tme)
+			{
+				if(!fst)
+				{
+					GSVector4 stq0 = GSVector4::cast(c0);
+					GSVector4 stq1 = GSVector4::cast(c1);
+
+					if(accurate_stq)
+					{
+						GSVector4 q = stq1.wwww();
+
+						stq0 = (stq0.xyww() / q).xyww(stq1);
+						stq1 = (stq1.xyww() / q).xyww(stq1);
+					}
+					else
+					{
+						GSVector4 q = stq1.wwww().rcpnr();
+
+						stq0 = (stq0.xyww() * q).xyww(stq1);
+						stq1 = (stq1.xyww() * q).xyww(stq1);
+					}
+
+					tmin = tmin.min(stq0.min(stq1));
+					tmax = tmax.max(stq0.max(stq1));
+				}
+				else
+				{
+					GSVector4i uv0(v[index[i + 0]].m[1]);
+					GSVector4i uv1(v[index[i + 1]].m[1]);
+
+					GSVector4 st0 = GSVector4(uv0.uph16()).xyxy();
+					GSVector4 st1 = GSVector4(uv1.uph16()).xyxy();
+
+					tmin = tmin.min(st0.min(st1));
+					tmax = tmax.max(st0.max(st1));
+				}
+			}
+
+			GSVector4i xyzf0(v[index[i + 0]].m[1]);
+			GSVector4i xyzf1(v[index[i + 1]].m[1]);
+
+			GSVector4i xy0 = xyzf0.upl16();
+			GSVector4i z0 = xyzf0.yyyy();
+			GSVector4i xy1 = xyzf1.upl16();
+			GSVector4i z1 = xyzf1.yyyy();
+
+			#if _M_SSE >= 0x401
+
+			GSVector4i p0 = xy0.blend16<0xf0>(z0.uph32(xyzf1));
+			GSVector4i p1 = xy1.blend16<0xf0>(z1.uph32(xyzf1));
+
+			pmin = pmin.min_u32(p0.min_u32(p1));
+			pmax = pmax.max_u32(p0.max_u32(p1));
+
+			#else
+
+			GSVector4 p0 = GSVector4(xy0.upl64(z0.srl32(1).upl32(xyzf1.wwww())));
+			GSVector4 p1 = GSVector4(xy1.upl64(z1.srl32(1).upl32(xyzf1.wwww())));
+
+			pmin = pmin.min(p0.min(p1));
+			pmax = pmax.max(p0.max(p1));
+
+			#endif
+		}
+	}
+
+	#endif
+
+	// FIXME/WARNING. A division by 2 is done on the depth. I suspect to avoid
+	// negative value. However it means that we lost the lsb bit. m_eq.z could
+	// be true if depth isn't constant but close enough. It also imply that
+	// pmin.z & 1 == 0 and pax.z & 1 == 0
+
+	#if _M_SSE >= 0x401
+
+	pmin = pmin.blend16<0x30>(pmin.srl32(1));
+	pmax = pmax.blend16<0x30>(pmax.srl32(1));
+
+	#endif
+
+	GSVector4 o(context->XYOFFSET);
+	GSVector4 s(1.0f / 16, 1.0f / 16, 2.0f, 1.0f);
+
+	vt.m_min.p = (GSVector4(pmin) - o) * s;
+	vt.m_max.p = (GSVector4(pmax) - o) * s;
+
+	if(tme)
+	{
+		if(fst)
+		{
+			s = GSVector4(1.0f / 16, 1.0f).xxyy();
+		}
+		else
+		{
+			s = GSVector4(1 << context->TEX0.TW, 1 << context->TEX0.TH, 1, 1);
+		}
+
+		vt.m_min.t = tmin * s;
+		vt.m_max.t = tmax * s;
+	}
+	else
+	{
+		vt.m_min.t = GSVector4::zero();
+		vt.m_max.t = GSVector4::zero();
+	}
+
+	if(color)
+	{
+		vt.m_min.c = cmin.zzzz().u8to32();
+		vt.m_max.c = cmax.zzzz().u8to32();
+	}
+	else
+	{
+		vt.m_min.c = GSVector4i::zero();
+		vt.m_max.c = GSVector4i::zero();
+	}
+}
+
+MULTI_ISA_UNSHARED_END
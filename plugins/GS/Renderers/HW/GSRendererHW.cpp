@@ -370,6 +370,8 @@ void GSRendererHW::Reset()
 
 void GSRendererHW::VSync(int field)
 {
+	GSPerfMonAutoTimer pmat(m_perfmon);
+
 	//Check if the frame buffer width or display width has changed
 	SetScaling();
 
@@ -1375,6 +1377,16 @@ void GSRendererHW::Draw()
 	// The rectangle of the draw
 	m_r = GSVector4i(m_vt.m_min.p.xyxy(m_vt.m_max.p)).rintersect(GSVector4i(context->scissor.in));
 
+	if(m_hacks.m_oi)
+	{
+		// the hacks write the targets in their own ways, none of them is current in local memory anymore
+
+		const GSVector4i all(0, 0, INT_MAX, INT_MAX);
+
+		if(rt) rt->m_drawn = all;
+		if(ds) ds->m_drawn = all;
+	}
+
 	if(m_hacks.m_oi && !(this->*m_hacks.m_oi)(rt_tex, ds_tex, m_src))
 	{
 		//log_cb(RETRO_LOG_WARN, "Warning skipping a draw call (%d)\n", s_n);
@@ -1469,6 +1481,7 @@ void GSRendererHW::Draw()
 	{
 		//rt->m_valid = rt->m_valid.runion(r);
 		rt->UpdateValidity(m_r);
+		rt->m_drawn = rt->m_drawn.runion(m_r);
 
 		m_tc->InvalidateVideoMem(context->offset.fb, m_r, false);
 
@@ -1479,6 +1492,7 @@ void GSRendererHW::Draw()
 	{
 		//ds->m_valid = ds->m_valid.runion(r);
 		ds->UpdateValidity(m_r);
+		ds->m_drawn = ds->m_drawn.runion(m_r);
 
 		m_tc->InvalidateVideoMem(context->offset.zb, m_r, false);
 
@@ -23,11 +23,14 @@
 
 #include "GSTextureCache.h"
 #include "GSRendererHW.h"
+#include "GSTextureCacheRows.h"
 #include "../../GSUtil.h"
 #include "options_tools.h"
 
 bool GSTextureCache::m_disable_partial_invalidation = false;
 bool GSTextureCache::m_wrap_gs_mem = false;
+bool GSTextureCache::m_texture_hash = false;
+GSTextureCache::HashStats GSTextureCache::m_hash_stats;
 
 GSTextureCache::GSTextureCache(GSRenderer* r)
 	: m_renderer(r)
@@ -41,9 +44,12 @@ GSTextureCache::GSTextureCache(GSRenderer* r)
 	m_can_convert_depth            = true;
 	m_cpu_fb_conversion            = hack_fb_conversion;
 	m_texture_inside_rt            = false;
+	m_async_readback               = theApp.GetConfigB("UserHacks_AsyncReadback");
 	m_wrap_gs_mem                  = false;
-	
+	m_texture_hash                 = option_value(BOOL_PCSX2_OPT_TEXTURE_HASH, KeyOptionBool::return_type);
 
+	memset(&m_hash_stats, 0, sizeof(m_hash_stats));
+	memset(&m_read_stats, 0, sizeof(m_read_stats));
 
 	m_paltex = theApp.GetConfigB("paltex");
 	m_crc_hack_level = theApp.GetConfigT<CRCHackLevel>("crc_hack_level");
@@ -60,6 +66,18 @@ GSTextureCache::GSTextureCache(GSRenderer* r)
 
 GSTextureCache::~GSTextureCache()
 {
+	if(m_texture_hash)
+	{
+		log_cb(RETRO_LOG_INFO, "GSdx: texture hash reused %llu of %llu block reads\n",
+			(unsigned long long)m_hash_stats.reused, (unsigned long long)m_hash_stats.blocks);
+	}
+
+	if(m_read_stats.skipped + m_read_stats.sync + m_read_stats.async > 0)
+	{
+		log_cb(RETRO_LOG_INFO, "GSdx: target read backs: %llu served from local memory, %llu waited for the gpu, %llu from the previous download\n",
+			(unsigned long long)m_read_stats.skipped, (unsigned long long)m_read_stats.sync, (unsigned long long)m_read_stats.async);
+	}
+
 	RemoveAll();
 
 	m_texture_inside_rt_cache.clear();
@@ -73,9 +91,9 @@ void GSTextureCache::RemovePartial()
 
 	for (int type = 0; type < 2; type++)
 	{
-		for (auto t : m_dst[type]) delete t;
+		auto& list = m_dst[type];
 
-		m_dst[type].clear();
+		while (!list.empty()) RemoveTarget(list.back());
 	}
 }
 
@@ -85,12 +103,14 @@ void GSTextureCache::RemoveAll()
 
 	for(int type = 0; type < 2; type++)
 	{
-		for (auto t : m_dst[type]) delete t;
+		auto& list = m_dst[type];
 
-		m_dst[type].clear();
+		while (!list.empty()) RemoveTarget(list.back());
 	}
 
 	m_palette_map.Clear();
+
+	RemoveDownloads(-1);
 }
 
 GSTextureCache::Source* GSTextureCache::LookupDepthSource(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, const GSVector4i& r, bool palette)
@@ -288,7 +308,7 @@ GSTextureCache::Source* GSTextureCache::LookupSource(const GIFRegTEX0& TEX0, con
 						// There is no dedicated shader to handle 4-bit conversion (Stuntman has been confirmed to use 4-bit).
 						// Direct3D10/11 and OpenGL support 8-bit fb conversion but don't render some corner cases properly (Harry Potter games).
 						// The hack can fix glitches in some games.
-						Read(t, t->m_valid);
+						ReadBack(t, t->m_valid, false);
 					else
 						dst = t;
 
@@ -438,6 +458,11 @@ GSTextureCache::Source* GSTextureCache::LookupSource(const GIFRegTEX0& TEX0, con
 		src = CreateSource(TEX0, TEXA, dst, half_right, x_offset, y_offset);
 		new_source = true;
 
+		m_renderer->m_perfmon.Put(GSPerfMon::TextureMiss);
+	}
+	else
+	{
+		m_renderer->m_perfmon.Put(GSPerfMon::TextureHit);
 	}
 
 	if (src->m_palette && !new_source && !src->ClutMatch({ clut, psm_s.pal })) {
@@ -481,6 +506,109 @@ bool GSTextureCache::ShallSearchTextureInsideRt()
 	return m_texture_inside_rt || (m_renderer->m_game.flags & CRC::Flags::TextureInsideRt);
 }
 
+bool GSTextureCache::AsyncReadback()
+{
+	return m_async_readback || (m_renderer->m_game.flags & CRC::Flags::AsyncReadback);
+}
+
+void GSTextureCache::ReadBack(Target* t, const GSVector4i& r, bool async)
+{
+	GSVector4i drawn = t->m_drawn.rintersect(t->m_valid);
+
+	if(r.rintersect(drawn).rempty())
+	{
+		// nothing was rendered there since local memory was written by the target or the
+		// target was uploaded from it
+		m_read_stats.skipped++;
+
+		return;
+	}
+
+	if(async && AsyncReadback() && ReadAsync(t, r))
+	{
+		// local memory got an older image, m_drawn stays for the next read back
+		m_read_stats.async++;
+
+		return;
+	}
+
+	Read(t, r);
+
+	m_read_stats.sync++;
+
+	// Read does nothing while the target waits for an upload
+
+	if(t->m_dirty.empty() && r.rintersect(drawn).eq(drawn))
+	{
+		t->m_drawn = GSVector4i::zero();
+	}
+}
+
+u32 GSTextureCache::DownloadKey(const GIFRegTEX0& TEX0)
+{
+	return TEX0.TBP0 | (TEX0.TBW << 14) | (TEX0.PSM << 20);
+}
+
+u64 GSTextureCache::DownloadKey(const GSVector4i& r)
+{
+	return (u64)(u16)r.left | ((u64)(u16)r.top << 16) | ((u64)(u16)r.right << 32) | ((u64)(u16)r.bottom << 48);
+}
+
+GSTexture* GSTextureCache::TakeDownload(const GIFRegTEX0& TEX0, const GSVector4i& r)
+{
+	u32 tex0 = DownloadKey(TEX0);
+	u64 rect = DownloadKey(r);
+
+	for(auto i = m_downloads.begin(); i != m_downloads.end(); ++i)
+	{
+		if(i->tex0 == tex0 && i->rect == rect)
+		{
+			GSTexture* tex = i->tex;
+
+			m_downloads.erase(i);
+
+			return tex;
+		}
+	}
+
+	return NULL;
+}
+
+void GSTextureCache::AddDownload(const GIFRegTEX0& TEX0, const GSVector4i& r, GSTexture* tex)
+{
+	// a few areas read back every frame at most, drop the oldest one beyond that
+
+	if(m_downloads.size() >= 4)
+	{
+		delete m_downloads.front().tex;
+
+		m_downloads.erase(m_downloads.begin());
+	}
+
+	m_downloads.push_back({DownloadKey(TEX0), DownloadKey(r), tex, 0});
+}
+
+void GSTextureCache::RemoveDownloads(int maxage)
+{
+	// A pending download must not go back to the texture pool, the next user of the
+	// texture would map its data. Downloads nobody asked for within a frame are too old
+	// to be served.
+
+	for(auto i = m_downloads.begin(); i != m_downloads.end(); )
+	{
+		if(i->age > maxage)
+		{
+			delete i->tex;
+
+			i = m_downloads.erase(i);
+		}
+		else
+		{
+			++i;
+		}
+	}
+}
+
 GSTextureCache::Target* GSTextureCache::LookupTarget(const GIFRegTEX0& TEX0, int w, int h, int type, bool used, u32 fbmask)
 {
 	const GSLocalMemory::psm_t& psm_s = GSLocalMemory::m_psm[TEX0.PSM];
@@ -547,6 +675,9 @@ GSTextureCache::Target* GSTextureCache::LookupTarget(const GIFRegTEX0& TEX0, int
 				shader = (fmt_16_bits) ? ShaderConvert_FLOAT16_TO_RGB5A1 : ShaderConvert_FLOAT32_TO_RGBA8;
 			}
 			m_renderer->m_dev->StretchRect(dst_match->m_texture, sRect, dst->m_texture, dRect, shader, false);
+
+			// same memory, the conversion is only ahead of local memory where dst_match was
+			dst->m_drawn = dst_match->m_drawn;
 		}
 	}
 
@@ -713,8 +844,7 @@ void GSTextureCache::InvalidateVideoMemType(int type, u32 bp)
 					t->m_TEX0.TBP0);
 #endif
 
-			list.erase(i);
-			delete t;
+			RemoveTarget(t);
 
 			break;
 		}
@@ -791,6 +921,7 @@ void GSTextureCache::InvalidateVideoMem(GSOffset* off, const GSVector4i& rect, b
 							t->m_TEX0.TBP0);
 #endif
 					m_renderer->m_dev->ClearRenderTarget(t->m_texture, 0);
+					t->m_drawn = GSVector4i(0, 0, INT_MAX, INT_MAX);
 				}
 			}
 		}
@@ -866,105 +997,116 @@ void GSTextureCache::InvalidateVideoMem(GSOffset* off, const GSVector4i& rect, b
 
 	if(!target) return;
 
+	// A target is only touched below if it starts on bp or a whole number of rows of bw
+	// pages before or after it, and not further down than the transfer goes. Those are
+	// looked up by page instead of walking m_dst.
+
+	int page = bp >> 5;
+	int first;
+	int last;
+
+	GetTargetRows(page, (int)bw, r.bottom, GSLocalMemory::m_psm[psm].pgs.y, MAX_PAGES, first, last);
+
 	for(int type = 0; type < 2; type++)
 	{
-		auto& list = m_dst[type];
-		for(auto i = list.begin(); i != list.end(); )
+		for(int row = first; row <= last; row++)
 		{
-			auto j = i++;
-			Target* t = *j;
-
-			// GH: (I think) this code is completely broken. Typical issue:
-			// EE write an alpha channel into 32 bits texture
-			// Results: the target is deleted (because HasCompatibleBits is false)
-			//
-			// Major issues are expected if the game try to reuse the target
-			// If we dirty the RT, it will likely upload partially invalid data.
-			// (The color on the previous example)
-			if(GSUtil::HasSharedBits(bp, psm, t->m_TEX0.TBP0, t->m_TEX0.PSM))
+			auto& list = m_dst_map[type][page + row * (int)bw];
+			for(auto i = list.begin(); i != list.end(); )
 			{
-				if(!found && GSUtil::HasCompatibleBits(psm, t->m_TEX0.PSM))
+				Target* t = *i++;
+
+				// GH: (I think) this code is completely broken. Typical issue:
+				// EE write an alpha channel into 32 bits texture
+				// Results: the target is deleted (because HasCompatibleBits is false)
+				//
+				// Major issues are expected if the game try to reuse the target
+				// If we dirty the RT, it will likely upload partially invalid data.
+				// (The color on the previous example)
+				if(GSUtil::HasSharedBits(bp, psm, t->m_TEX0.TBP0, t->m_TEX0.PSM))
 				{
+					if(!found && GSUtil::HasCompatibleBits(psm, t->m_TEX0.PSM))
+					{
 #if 0
-					log_cb(RETRO_LOG_DEBUG, "TC: Dirty Target(%s) %d (0x%x) r(%d,%d,%d,%d)\n", to_string(type),
-								t->m_texture ? t->m_texture->GetID() : 0,
-								t->m_TEX0.TBP0, r.x, r.y, r.z, r.w);
+						log_cb(RETRO_LOG_DEBUG, "TC: Dirty Target(%s) %d (0x%x) r(%d,%d,%d,%d)\n", to_string(type),
+									t->m_texture ? t->m_texture->GetID() : 0,
+									t->m_TEX0.TBP0, r.x, r.y, r.z, r.w);
 #endif
-					t->m_dirty.push_back(GSDirtyRect(r, psm));
-					t->m_TEX0.TBW = bw;
-				}
-				else
-				{
-					list.erase(j);
+						t->m_dirty.push_back(GSDirtyRect(r, psm));
+						t->m_TEX0.TBW = bw;
+					}
+					else
+					{
 #if 0
-					log_cb(RETRO_LOG_DEBUG, "TC: Remove Target(%s) %d (0x%x)\n", to_string(type),
-								t->m_texture ? t->m_texture->GetID() : 0,
-								t->m_TEX0.TBP0);
+						log_cb(RETRO_LOG_DEBUG, "TC: Remove Target(%s) %d (0x%x)\n", to_string(type),
+									t->m_texture ? t->m_texture->GetID() : 0,
+									t->m_TEX0.TBP0);
 #endif
-					delete t;
-					continue;
+						RemoveTarget(t);
+						continue;
+					}
+				} else if (bp == t->m_TEX0.TBP0) {
+					// EE writes the ALPHA channel. Mark it as invalid for
+					// the texture cache. Otherwise it will generate a wrong
+					// hit on the texture cache.
+					// Game: Conflict - Desert Storm (flickering)
+					t->m_dirty_alpha = false;
 				}
-			} else if (bp == t->m_TEX0.TBP0) {
-				// EE writes the ALPHA channel. Mark it as invalid for
-				// the texture cache. Otherwise it will generate a wrong
-				// hit on the texture cache.
-				// Game: Conflict - Desert Storm (flickering)
-				t->m_dirty_alpha = false;
-			}
 
-			// GH: Try to detect texture write that will overlap with a target buffer
-			if(GSUtil::HasSharedBits(psm, t->m_TEX0.PSM)) {
-				if (bp < t->m_TEX0.TBP0)
-				{
-					u32 rowsize = bw * 8192;
-					u32 offset = (u32)((t->m_TEX0.TBP0 - bp) * 256);
-
-					if(rowsize > 0 && offset % rowsize == 0)
+				// GH: Try to detect texture write that will overlap with a target buffer
+				if(GSUtil::HasSharedBits(psm, t->m_TEX0.PSM)) {
+					if (bp < t->m_TEX0.TBP0)
 					{
-						int y = GSLocalMemory::m_psm[psm].pgs.y * offset / rowsize;
+						u32 rowsize = bw * 8192;
+						u32 offset = (u32)((t->m_TEX0.TBP0 - bp) * 256);
 
-						if(r.bottom > y)
+						if(rowsize > 0 && offset % rowsize == 0)
 						{
+							int y = GSLocalMemory::m_psm[psm].pgs.y * offset / rowsize;
+
+							if(r.bottom > y)
+							{
 #if 0
-							log_cb(RETRO_LOG_DEBUG, "TC: Dirty After Target(%s) %d (0x%x)\n", to_string(type),
-									t->m_texture ? t->m_texture->GetID() : 0,
-									t->m_TEX0.TBP0);
+								log_cb(RETRO_LOG_DEBUG, "TC: Dirty After Target(%s) %d (0x%x)\n", to_string(type),
+										t->m_texture ? t->m_texture->GetID() : 0,
+										t->m_TEX0.TBP0);
 #endif
-							// TODO: do not add this rect above too
-							t->m_dirty.push_back(GSDirtyRect(GSVector4i(r.left, r.top - y, r.right, r.bottom - y), psm));
-							t->m_TEX0.TBW = bw;
-							continue;
+								// TODO: do not add this rect above too
+								t->m_dirty.push_back(GSDirtyRect(GSVector4i(r.left, r.top - y, r.right, r.bottom - y), psm));
+								t->m_TEX0.TBW = bw;
+								continue;
+							}
 						}
 					}
-				}
 
-				// FIXME: this code "fixes" black FMV issue with rule of rose.
+					// FIXME: this code "fixes" black FMV issue with rule of rose.
 #if 1
-				// Greg: I'm not sure the 'bw' equality is required but it won't hurt too much
-				//
-				// Ben 10 Alien Force : Vilgax Attacks uses a small temporary target for multiple textures (different bw)
-				// It is too complex to handle, and purpose of the code was to handle FMV (large bw). So let's skip small
-				// (128 pixels) target
-				if (bw > 2 && t->m_TEX0.TBW == bw && t->Inside(bp, bw, psm, rect) && GSUtil::HasCompatibleBits(psm, t->m_TEX0.PSM)) {
-					u32 rowsize = bw * 8192u;
-					u32 offset = (u32)((bp - t->m_TEX0.TBP0) * 256);
+					// Greg: I'm not sure the 'bw' equality is required but it won't hurt too much
+					//
+					// Ben 10 Alien Force : Vilgax Attacks uses a small temporary target for multiple textures (different bw)
+					// It is too complex to handle, and purpose of the code was to handle FMV (large bw). So let's skip small
+					// (128 pixels) target
+					if (bw > 2 && t->m_TEX0.TBW == bw && t->Inside(bp, bw, psm, rect) && GSUtil::HasCompatibleBits(psm, t->m_TEX0.PSM)) {
+						u32 rowsize = bw * 8192u;
+						u32 offset = (u32)((bp - t->m_TEX0.TBP0) * 256);
 
-					if(rowsize > 0 && offset % rowsize == 0) {
-						int y = GSLocalMemory::m_psm[psm].pgs.y * offset / rowsize;
+						if(rowsize > 0 && offset % rowsize == 0) {
+							int y = GSLocalMemory::m_psm[psm].pgs.y * offset / rowsize;
 
 #if 0
-						log_cb(RETRO_LOG_DEBUG, "TC: Dirty in the middle of Target(%s) %d (0x%x->0x%x) pos(%d,%d => %d,%d) bw:%u\n", to_string(type),
-								t->m_texture ? t->m_texture->GetID() : 0,
-								t->m_TEX0.TBP0, t->m_end_block,
-								r.left, r.top + y, r.right, r.bottom + y, bw);
+							log_cb(RETRO_LOG_DEBUG, "TC: Dirty in the middle of Target(%s) %d (0x%x->0x%x) pos(%d,%d => %d,%d) bw:%u\n", to_string(type),
+									t->m_texture ? t->m_texture->GetID() : 0,
+									t->m_TEX0.TBP0, t->m_end_block,
+									r.left, r.top + y, r.right, r.bottom + y, bw);
 #endif
 
-						t->m_dirty.push_back(GSDirtyRect(GSVector4i(r.left, r.top + y, r.right, r.bottom + y), psm));
-						t->m_TEX0.TBW = bw;
-						continue;
+							t->m_dirty.push_back(GSDirtyRect(GSVector4i(r.left, r.top + y, r.right, r.bottom + y), psm));
+							t->m_TEX0.TBW = bw;
+							continue;
+						}
 					}
-				}
 #endif
+				}
 			}
 		}
 	}
@@ -985,7 +1127,7 @@ void GSTextureCache::InvalidateLocalMem(GSOffset* off, const GSVector4i& r)
 			for(auto t : m_dst[DepthStencil]) {
 				if(GSUtil::HasSharedBits(bp, psm, t->m_TEX0.TBP0, t->m_TEX0.PSM)) {
 					if (GSUtil::HasCompatibleBits(psm, t->m_TEX0.PSM))
-						Read(t, r.rintersect(t->m_valid));
+						ReadBack(t, r.rintersect(t->m_valid), true);
 				}
 			}
 		}
@@ -1023,12 +1165,12 @@ void GSTextureCache::InvalidateLocalMem(GSOffset* off, const GSVector4i& r)
 				if (t->m_32_bits_fmt && t->m_TEX0.PSM > PSM_PSMCT24)
 					t->m_TEX0.PSM = PSM_PSMCT32;
 				if (GSTextureCache::m_disable_partial_invalidation) {
-					Read(t, r.rintersect(t->m_valid));
+					ReadBack(t, r.rintersect(t->m_valid), true);
 				} else {
 					if (r.x == 0 && r.y == 0) // Full screen read?
-						Read(t, t->m_valid);
+						ReadBack(t, t->m_valid, true);
 					else // Block level read?
-						Read(t, r.rintersect(t->m_valid));
+						ReadBack(t, r.rintersect(t->m_valid), true);
 				}
 			}
 		}
@@ -1125,8 +1267,8 @@ void GSTextureCache::InvalidateVideoMemSubTarget(GSTextureCache::Target* rt)
 					rt->m_TEX0.TBP0, rt->m_end_block, t->m_TEX0.TBP0, t->m_end_block);
 #endif
 
-			i = list.erase(i);
-			delete t;
+			++i;
+			RemoveTarget(t);
 		} else {
 			++i;
 		}
@@ -1157,6 +1299,10 @@ void GSTextureCache::IncAge()
 
 	m_src.m_used = false;
 
+	for(auto& d : m_downloads) d.age++;
+
+	RemoveDownloads(1);
+
 	// Clearing of Rendertargets causes flickering in many scene transitions.
 	// Sigh, this seems to be used to invalidate surfaces. So set a huge maxage to avoid flicker,
 	// but still invalidate surfaces. (Disgaea 2 fmv when booting the game through the BIOS)
@@ -1179,17 +1325,16 @@ void GSTextureCache::IncAge()
 				t->m_32_bits_fmt = false;
 			}
 
+			++i;
+
 			if(++t->m_age > maxage)
 			{
-				i = list.erase(i);
 #if 0
 				log_cb(RETRO_LOG_DEBUG, "TC: Remove Target(%s): %d (0x%x) due to age\n", to_string(type),
 							t->m_texture ? t->m_texture->GetID() : 0,
 							t->m_TEX0.TBP0);
 #endif
-				delete t;
-			} else {
-				++i;
+				RemoveTarget(t);
 			}
 		}
 	}
@@ -1546,11 +1691,20 @@ GSTextureCache::Target* GSTextureCache::CreateTarget(const GIFRegTEX0& TEX0, int
 		t->m_texture = m_renderer->m_dev->CreateSparseDepthStencil(w, h);
 	}
 
-	m_dst[type].push_front(t);
+	t->m_dst_it = m_dst[type].InsertFront(t);
+	t->m_map_it = m_dst_map[type][TEX0.TBP0 >> 5].InsertFront(t);
 
 	return t;
 }
 
+void GSTextureCache::RemoveTarget(Target* t)
+{
+	m_dst[t->m_type].EraseIndex(t->m_dst_it);
+	m_dst_map[t->m_type][t->m_TEX0.TBP0 >> 5].EraseIndex(t->m_map_it);
+
+	delete t;
+}
+
 // GSTextureCache::Surface
 
 GSTextureCache::Surface::Surface(GSRenderer* r, u8* temp)
@@ -1667,6 +1821,15 @@ void GSTextureCache::Source::Update(const GSVector4i& rect, int layer)
 
 	u32 blocks = 0;
 
+	// mipmap layers share m_valid with the base level, only the base level is hashed
+
+	bool hash = m_texture_hash && layer == 0;
+
+	if(hash && m_block_hash.empty())
+	{
+		m_block_hash.resize((tw / bs.x) * (th / bs.y), 0);
+	}
+
 	if(m_repeating)
 	{
 		for(int y = r.top; y < r.bottom; y += bs.y)
@@ -1688,6 +1851,8 @@ void GSTextureCache::Source::Update(const GSVector4i& rect, int layer)
 					{
 						m_valid[row] |= col;
 
+						if(hash && Unchanged(block, x, y)) continue;
+
 						Write(GSVector4i(x, y, x + bs.x, y + bs.y), layer);
 
 						blocks++;
@@ -1717,6 +1882,8 @@ void GSTextureCache::Source::Update(const GSVector4i& rect, int layer)
 					{
 						m_valid[row] |= col;
 
+						if(hash && Unchanged(block, x, y)) continue;
+
 						Write(GSVector4i(x, y, x + bs.x, y + bs.y), layer);
 
 						blocks++;
@@ -1730,6 +1897,39 @@ void GSTextureCache::Source::Update(const GSVector4i& rect, int layer)
 		Flush(m_write.count, layer);
 }
 
+bool GSTextureCache::Source::Unchanged(u32 block, int x, int y)
+{
+	// The block was invalidated, but if the gs memory behind it holds the same bytes as when
+	// it was read last time the texture already has the right texels (TEX0, TEXA and the
+	// clut are fixed for a source).
+
+	const GSVector2i& bs = GSLocalMemory::m_psm[m_TEX0.PSM].bs;
+
+	int pitch = std::max<int>(1 << m_TEX0.TW, bs.x) / bs.x;
+
+	size_t i = (size_t)(y / bs.y) * pitch + x / bs.x;
+
+	if(x >= pitch * bs.x || i >= m_block_hash.size())
+	{
+		return false;
+	}
+
+	u64 h = GSUtil::HashBlock(m_renderer->m_mem.BlockPtr(block));
+
+	m_hash_stats.blocks++;
+
+	if(m_block_hash[i] == h)
+	{
+		m_hash_stats.reused++;
+
+		return true;
+	}
+
+	m_block_hash[i] = h;
+
+	return false;
+}
+
 void GSTextureCache::Source::UpdateLayer(const GIFRegTEX0& TEX0, const GSVector4i& rect, int layer)
 {
 	if (layer > 6)
@@ -1814,13 +2014,15 @@ void GSTextureCache::Source::Flush(u32 count, int layer)
 
 	u8* buff = m_temp;
 
+	m_renderer->m_perfmon.Put(GSPerfMon::TextureUpload, count);
+
 	for(u32 i = 0; i < count; i++)
 	{
 		GSVector4i r = m_write.rect[i];
 
 		if((r > tr).mask() & 0xff00)
 		{
-			(mem.*rtx)(off, r, buff, pitch, m_TEXA);
+			rtx(mem, off, r, buff, pitch, m_TEXA);
 
 			m_texture->Update(r.rintersect(tr), buff, pitch, layer);
 		}
@@ -1830,13 +2032,13 @@ void GSTextureCache::Source::Flush(u32 count, int layer)
 
 			if(m_texture->Map(m, &r, layer))
 			{
-				(mem.*rtx)(off, r, m.bits, m.pitch, m_TEXA);
+				rtx(mem, off, r, m.bits, m.pitch, m_TEXA);
 
 				m_texture->Unmap();
 			}
 			else
 			{
-				(mem.*rtx)(off, r, buff, pitch, m_TEXA);
+				rtx(mem, off, r, buff, pitch, m_TEXA);
 
 				m_texture->Update(r, buff, pitch, layer);
 			}
@@ -1869,6 +2071,7 @@ GSTextureCache::Target::Target(GSRenderer* r, const GIFRegTEX0& TEX0, u8* temp,
 	m_dirty_alpha = GSLocalMemory::m_psm[TEX0.PSM].trbpp != 24;
 
 	m_valid = GSVector4i::zero();
+	m_drawn = GSVector4i::zero();
 }
 
 void GSTextureCache::Target::Update()
@@ -106,6 +106,7 @@ public:
 
 		void Write(const GSVector4i& r, int layer);
 		void Flush(u32 count, int layer);
+		bool Unchanged(u32 block, int x, int y);
 
 	public:
 		std::shared_ptr<Palette> m_palette_obj;
@@ -125,6 +126,8 @@ public:
 		// Keep a GSTextureCache::SourceMap::m_map iterator to allow fast erase
 		std::array<u16, MAX_PAGES> m_erase_it;
 		u32* m_pages_as_bit;
+		// Content hash of the gs memory block each texture block was last read from (0: never read)
+		std::vector<u64> m_block_hash;
 
 	public:
 		Source(GSRenderer* r, const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, u8* temp, bool dummy_container = false);
@@ -143,8 +146,11 @@ public:
 		bool m_used;
 		GSDirtyRectList m_dirty;
 		GSVector4i m_valid;
+		GSVector4i m_drawn; // rendered since the last read back, local memory is current outside of it
 		bool m_depth_supported;
 		bool m_dirty_alpha;
+		u16 m_dst_it; // positions in m_dst and m_dst_map, see RemoveTarget
+		u16 m_map_it;
 
 	public:
 		Target(GSRenderer* r, const GIFRegTEX0& TEX0, u8* temp, bool depth_supported);
@@ -208,6 +214,7 @@ protected:
 	PaletteMap m_palette_map;
 	SourceMap m_src;
 	FastList<Target*> m_dst[2];
+	std::array<FastList<Target*>, MAX_PAGES> m_dst_map[2]; // m_dst by the page of TBP0, which does not change
 	bool m_paltex;
 	bool m_preload_frame;
 	u8* m_temp;
@@ -217,11 +224,43 @@ protected:
 	static bool m_disable_partial_invalidation;
 	bool m_texture_inside_rt;
 	static bool m_wrap_gs_mem;
+	static bool m_texture_hash;
+	static struct HashStats {u64 blocks, reused;} m_hash_stats; // reused blocks skipped both the conversion and the upload
+	bool m_async_readback;
+	struct {u64 skipped, sync, async;} m_read_stats;
+
+	// Offscreen copies of targets being downloaded for the next read back of the same area,
+	// see ReadAsync. The key is the memory the target covers, not the target.
+
+	struct Download
+	{
+		u32 tex0;
+		u64 rect;
+		GSTexture* tex;
+		int age;
+	};
+
+	std::vector<Download> m_downloads;
+
+	static u32 DownloadKey(const GIFRegTEX0& TEX0);
+	static u64 DownloadKey(const GSVector4i& r);
+	GSTexture* TakeDownload(const GIFRegTEX0& TEX0, const GSVector4i& r);
+	void AddDownload(const GIFRegTEX0& TEX0, const GSVector4i& r, GSTexture* tex);
+	void RemoveDownloads(int maxage);
+
+	// Writes the target to local memory. Only the part drawn since the last read back is
+	// read, with async the game may get the result of the previous read back instead.
+	void ReadBack(Target* t, const GSVector4i& r, bool async);
+
+	// Serves the read back from the download started by the previous one and starts the
+	// next download, returns false if there is no download to serve it yet.
+	virtual bool ReadAsync(Target* t, const GSVector4i& r) {return false;}
 	u8 m_texture_inside_rt_cache_size = 255;
 	std::vector<TexInsideRtCacheEntry> m_texture_inside_rt_cache;
 
 	virtual Source* CreateSource(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, Target* t = NULL, bool half_right = false, int x_offset = 0, int y_offset = 0);
 	virtual Target* CreateTarget(const GIFRegTEX0& TEX0, int w, int h, int type);
+	void RemoveTarget(Target* t);
 
 	virtual int Get8bitFormat() = 0;
 
@@ -252,6 +291,7 @@ public:
 	void ScaleTexture(GSTexture* texture);
 
 	bool ShallSearchTextureInsideRt();
+	bool AsyncReadback();
 
 	const char* to_string(int type) {
 		return (type == DepthStencil) ? "Depth" : "Color";
@@ -0,0 +1,45 @@
+/*
+ *	Copyright (C) 2007-2009 Gabest
+ *	http://www.gabest.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNU Make; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#pragma once
+
+// Kept out of GSTextureCache.h so tests/ctest/GS can check it without the renderer.
+//
+// A transfer to bp/bw only touches a target in GSTextureCache::InvalidateVideoMem if the
+// target starts on bp, a whole number of bw page rows after it but not below the bottom of
+// the transfer, or (bw > 2, the Inside() case kept for Rule of Rose FMVs) a whole number of rows before it.
+// Returns the rows, relative to the page of bp, that the targets are looked up on.
+
+inline void GetTargetRows(int page, int bw, int bottom, int pgs_y, int max_pages, int& first, int& last)
+{
+	first = 0;
+	last = 0;
+
+	if(bw > 0)
+	{
+		if(bw > 2) first = -(page / bw);
+
+		last = (bottom - 1) / pgs_y;
+
+		if(last > (max_pages - 1 - page) / bw) last = (max_pages - 1 - page) / bw;
+		if(last < 0) last = 0;
+	}
+}
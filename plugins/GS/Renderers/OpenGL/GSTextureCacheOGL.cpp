@@ -27,45 +27,94 @@ GSTextureCacheOGL::GSTextureCacheOGL(GSRenderer* r)
 {
 }
 
-void GSTextureCacheOGL::Read(Target* t, const GSVector4i& r)
+bool GSTextureCacheOGL::GetReadFormat(u32 psm, GLuint& fmt, int& ps_shader)
 {
-	if (!t->m_dirty.empty() || r.width() == 0 || r.height() == 0)
-		return;
-
-	const GIFRegTEX0& TEX0 = t->m_TEX0;
-
-	GLuint fmt;
-	int ps_shader;
-	switch (TEX0.PSM)
+	switch (psm)
 	{
 		case PSM_PSMCT32:
 		case PSM_PSMCT24:
 			fmt = GL_RGBA8;
 			ps_shader = ShaderConvert_COPY;
-			break;
+			return true;
 
 		case PSM_PSMCT16:
 		case PSM_PSMCT16S:
 			fmt = GL_R16UI;
 			ps_shader = ShaderConvert_RGBA8_TO_16_BITS;
-			break;
+			return true;
 
 		case PSM_PSMZ32:
 		case PSM_PSMZ24:
 			fmt = GL_R32UI;
 			ps_shader = ShaderConvert_FLOAT32_TO_32_BITS;
-			break;
+			return true;
 
 		case PSM_PSMZ16:
 		case PSM_PSMZ16S:
 			fmt = GL_R16UI;
 			ps_shader = ShaderConvert_FLOAT32_TO_32_BITS;
-			break;
+			return true;
 
 		default:
-			return;
+			return false;
 	}
+}
 
+GSTexture* GSTextureCacheOGL::CopyTarget(Target* t, const GSVector4i& r, GLuint fmt, int ps_shader)
+{
+	GSVector4 src = GSVector4(r) * GSVector4(t->m_texture->GetScale()).xyxy() / GSVector4(t->m_texture->GetSize()).xyxy();
+
+	return m_renderer->m_dev->CopyOffscreen(t->m_texture, src, r.width(), r.height(), fmt, ps_shader);
+}
+
+void GSTextureCacheOGL::WriteTarget(const GIFRegTEX0& TEX0, GSTexture* offscreen, const GSVector4i& r)
+{
+	GSTexture::GSMap m;
+	GSVector4i r_offscreen(0, 0, r.width(), r.height());
+
+	if(offscreen->Map(m, &r_offscreen))
+	{
+		// TODO: block level write
+
+		GSOffset* off = m_renderer->m_mem.GetOffset(TEX0.TBP0, TEX0.TBW, TEX0.PSM);
+
+		switch(TEX0.PSM)
+		{
+			case PSM_PSMCT32:
+			case PSM_PSMZ32:
+				m_renderer->m_mem.WritePixel32(m.bits, m.pitch, off, r);
+				break;
+			case PSM_PSMCT24:
+			case PSM_PSMZ24:
+				m_renderer->m_mem.WritePixel24(m.bits, m.pitch, off, r);
+				break;
+			case PSM_PSMCT16:
+			case PSM_PSMCT16S:
+			case PSM_PSMZ16:
+			case PSM_PSMZ16S:
+				m_renderer->m_mem.WritePixel16(m.bits, m.pitch, off, r);
+				break;
+
+			default:
+				ASSERT(0);
+		}
+
+		offscreen->Unmap();
+	}
+}
+
+void GSTextureCacheOGL::Read(Target* t, const GSVector4i& r)
+{
+	if (!t->m_dirty.empty() || r.width() == 0 || r.height() == 0)
+		return;
+
+	const GIFRegTEX0& TEX0 = t->m_TEX0;
+
+	GLuint fmt;
+	int ps_shader;
+
+	if (!GetReadFormat(TEX0.PSM, fmt, ps_shader))
+		return;
 
 	// Yes lots of logging, but I'm not confident with this code
 	GL_PUSH("Texture Cache Read. Format(0x%x)", TEX0.PSM);
@@ -73,46 +122,52 @@ void GSTextureCacheOGL::Read(Target* t, const GSVector4i& r)
 	GL_PERF("TC: Read Back Target: %d (0x%x)[fmt: 0x%x]. Size %dx%d",
 			t->m_texture->GetID(), TEX0.TBP0, TEX0.PSM, r.width(), r.height());
 
-	GSVector4 src = GSVector4(r) * GSVector4(t->m_texture->GetScale()).xyxy() / GSVector4(t->m_texture->GetSize()).xyxy();
-
-	if(GSTexture* offscreen = m_renderer->m_dev->CopyOffscreen(t->m_texture, src, r.width(), r.height(), fmt, ps_shader))
+	if(GSTexture* offscreen = CopyTarget(t, r, fmt, ps_shader))
 	{
-		GSTexture::GSMap m;
-		GSVector4i r_offscreen(0, 0, r.width(), r.height());
+		WriteTarget(TEX0, offscreen, r);
 
-		if(offscreen->Map(m, &r_offscreen))
-		{
-			// TODO: block level write
+		// FIXME invalidate data
+		m_renderer->m_dev->Recycle(offscreen);
+	}
+}
 
-			GSOffset* off = m_renderer->m_mem.GetOffset(TEX0.TBP0, TEX0.TBW, TEX0.PSM);
+bool GSTextureCacheOGL::ReadAsync(Target* t, const GSVector4i& r)
+{
+	if (!t->m_dirty.empty() || r.width() == 0 || r.height() == 0)
+		return true; // Read would not read anything either
+
+	const GIFRegTEX0& TEX0 = t->m_TEX0;
 
-			switch(TEX0.PSM)
-			{
-				case PSM_PSMCT32:
-				case PSM_PSMZ32:
-					m_renderer->m_mem.WritePixel32(m.bits, m.pitch, off, r);
-					break;
-				case PSM_PSMCT24:
-				case PSM_PSMZ24:
-					m_renderer->m_mem.WritePixel24(m.bits, m.pitch, off, r);
-					break;
-				case PSM_PSMCT16:
-				case PSM_PSMCT16S:
-				case PSM_PSMZ16:
-				case PSM_PSMZ16S:
-					m_renderer->m_mem.WritePixel16(m.bits, m.pitch, off, r);
-					break;
-
-				default:
-					ASSERT(0);
-			}
+	GLuint fmt;
+	int ps_shader;
 
-			offscreen->Unmap();
-		}
+	if (!GetReadFormat(TEX0.PSM, fmt, ps_shader))
+		return true;
 
-		// FIXME invalidate data
-		m_renderer->m_dev->Recycle(offscreen);
+	GL_PUSH("Texture Cache Async Read. Format(0x%x)", TEX0.PSM);
+
+	GSTexture* prev = TakeDownload(TEX0, r);
+
+	// The copy of the current image for the next read back of this area. The download
+	// runs while the gpu catches up, only the next read back waits for it.
+
+	if(GSTexture* next = CopyTarget(t, r, fmt, ps_shader))
+	{
+		if(next->Download(GSVector4i(0, 0, r.width(), r.height())))
+			AddDownload(TEX0, r, next);
+		else
+			m_renderer->m_dev->Recycle(next);
+	}
+
+	if(prev != NULL)
+	{
+		WriteTarget(TEX0, prev, r);
+
+		// Map has finished the download, the texture can be reused
+		m_renderer->m_dev->Recycle(prev);
 	}
+
+	return prev != NULL;
 }
 
 void GSTextureCacheOGL::Read(Source* t, const GSVector4i& r)
@@ -30,8 +30,13 @@ class GSTextureCacheOGL final : public GSTextureCache
 protected:
 	int Get8bitFormat() { return GL_R8;}
 
+	bool GetReadFormat(u32 psm, GLuint& fmt, int& ps_shader);
+	GSTexture* CopyTarget(Target* t, const GSVector4i& r, GLuint fmt, int ps_shader);
+	void WriteTarget(const GIFRegTEX0& TEX0, GSTexture* offscreen, const GSVector4i& r);
+
 	void Read(Target* t, const GSVector4i& r);
 	void Read(Source* t, const GSVector4i& r);
+	bool ReadAsync(Target* t, const GSVector4i& r);
 
 public:
 	GSTextureCacheOGL(GSRenderer* r);
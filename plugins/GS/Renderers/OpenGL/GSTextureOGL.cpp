@@ -159,6 +159,7 @@ namespace PboPool {
 
 GSTextureOGL::GSTextureOGL(int type, int w, int h, int format, GLuint fbo_read, bool mipmap)
 	: m_clean(false), m_generate_mipmap(true), m_local_buffer(nullptr), m_r_x(0), m_r_y(0), m_r_w(0), m_r_h(0), m_layer(0)
+	, m_pack_buffer(0), m_pack_fence(0), m_pack_mapped(false)
 {
 	// OpenGL didn't like dimensions of size 0
 	m_size.x = std::max(1,w);
@@ -348,6 +349,12 @@ GSTextureOGL::~GSTextureOGL()
 
 	glDeleteTextures(1, &m_texture_id);
 
+	if (m_pack_fence)
+		glDeleteSync(m_pack_fence);
+
+	if (m_pack_buffer)
+		glDeleteBuffers(1, &m_pack_buffer);
+
 	GLState::available_vram += m_mem_usage;
 
 	if (m_local_buffer)
@@ -448,8 +455,25 @@ bool GSTextureOGL::Map(GSMap& m, const GSVector4i* _r, int layer)
 	m.pitch = row_byte;
 
 	if (m_type == GSTexture::Offscreen) {
+		if (m_pack_fence) {
+			// A Download is pending, it has likely completed by now
+			glClientWaitSync(m_pack_fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+			glDeleteSync(m_pack_fence);
+			m_pack_fence = 0;
+
+			if (r.x == m_r_x && r.y == m_r_y && r.width() == m_r_w && r.height() == m_r_h) {
+				m.bits = (u8*)glMapNamedBufferRange(m_pack_buffer, 0, r.height() * row_byte, GL_MAP_READ_BIT);
+
+				if (m.bits) {
+					m_pack_mapped = true;
+
+					return true;
+				}
+			}
+		}
+
 		// The fastest way will be to use a PBO to read the data asynchronously. Unfortunately GSdx
-		// architecture is waiting the data right now.
+		// architecture is waiting the data right now. Download does it when the caller can wait.
 
 #ifdef GL_EXT_TEX_SUB_IMAGE
 		// Maybe it is as good as the code below. I don't know
@@ -502,6 +526,11 @@ bool GSTextureOGL::Map(GSMap& m, const GSVector4i* _r, int layer)
 
 void GSTextureOGL::Unmap()
 {
+	if (m_pack_mapped) {
+		glUnmapNamedBuffer(m_pack_buffer);
+		m_pack_mapped = false;
+	}
+
 	if (m_type == GSTexture::Texture || m_type == GSTexture::RenderTarget) {
 
 		PboPool::Unmap();
@@ -519,6 +548,41 @@ void GSTextureOGL::Unmap()
 	}
 }
 
+bool GSTextureOGL::Download(const GSVector4i& r)
+{
+	if (m_type != GSTexture::Offscreen)
+		return false;
+
+	if (m_pack_buffer == 0) {
+		glCreateBuffers(1, &m_pack_buffer);
+		glNamedBufferData(m_pack_buffer, m_size.x * m_size.y * 4, NULL, GL_STREAM_READ);
+	}
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, m_fbo_read);
+	glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_texture_id, 0);
+
+	glPixelStorei(GL_PACK_ALIGNMENT, 1u << m_int_shift);
+
+	// With a pack buffer bound the read only queues the copy
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pack_buffer);
+	glReadPixels(r.x, r.y, r.width(), r.height(), m_int_format, m_int_type, (void*)0);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, GL_DEFAULT_FRAMEBUFFER);
+
+	if (m_pack_fence)
+		glDeleteSync(m_pack_fence);
+
+	m_pack_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+	m_r_x = r.x;
+	m_r_y = r.y;
+	m_r_w = r.width();
+	m_r_h = r.height();
+
+	return true;
+}
+
 void GSTextureOGL::GenerateMipmap()
 {
 	if (m_generate_mipmap && m_max_layer > 1) {
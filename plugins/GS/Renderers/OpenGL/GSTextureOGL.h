@@ -63,6 +63,11 @@ class GSTextureOGL final : public GSTexture
 		GLenum m_int_type;
 		u32 m_int_shift;
 
+		// Download of an offscreen texture, m_r_* is its rectangle
+		GLuint m_pack_buffer;
+		GLsync m_pack_fence;
+		bool m_pack_mapped;
+
 		// Allow to track size of allocated memory
 		u32 m_mem_usage;
 
@@ -73,6 +78,7 @@ class GSTextureOGL final : public GSTexture
 		bool Update(const GSVector4i& r, const void* data, int pitch, int layer = 0) final;
 		bool Map(GSMap& m, const GSVector4i* r = NULL, int layer = 0) final;
 		void Unmap() final;
+		bool Download(const GSVector4i& r) final;
 		void GenerateMipmap() final;
 
 		bool IsBackbuffer() { return (m_type == GSTexture::Backbuffer); }
@@ -88,6 +88,15 @@ void GSDrawScanline::BeginDraw(const GSRasterizerData* data)
 		m_dr = NULL;
 	}
 
+	if(m_global.sel.IsCopyRect())
+	{
+		m_dc = (DrawCopyPtr)&GSDrawScanline::DrawCopy;
+	}
+	else
+	{
+		m_dc = NULL;
+	}
+
 	// doesn't need all bits => less functions generated
 
 	GSScanlineSelector sel;
@@ -112,6 +121,18 @@ void GSDrawScanline::EndDraw(u64 frame, int actual, int total)
 {
 }
 
+void GSDrawScanline::GetSelectors(std::set<u64>& ds, std::set<u64>& sp)
+{
+	m_ds_map.GetKeys(ds);
+	m_sp_map.GetKeys(sp);
+}
+
+void GSDrawScanline::PrepareSelectors(const std::set<u64>& ds, const std::set<u64>& sp)
+{
+	for(u64 key : ds) m_ds_map.Prepare(key);
+	for(u64 key : sp) m_sp_map.Prepare(key);
+}
+
 void GSDrawScanline::DrawRect(const GSVector4i& r, const GSVertexSW& v)
 {
 	ASSERT(r.y >= 0);
@@ -119,6 +140,57 @@ void GSDrawScanline::DrawRect(const GSVector4i& r, const GSVertexSW& v)
 
 	// FIXME: sometimes the frame and z buffer may overlap, the outcome is undefined
 
+	DrawRectZ(r, v);
+
+	u32 m;
+
+	#if _M_SSE >= 0x501
+	m = m_global.fm;
+	#else
+	m = m_global.fm.U32[0];
+	#endif
+
+	if(m != 0xffffffff)
+	{
+		const int* fbr = m_global.fbr;
+		const int* fbc = m_global.fbc;
+
+		u32 c = (GSVector4i(v.c) >> 7).rgba32();
+
+		if(m_global.sel.fba)
+		{
+			c |= 0x80000000;
+		}
+
+		if(m_global.sel.fpsm != 2)
+		{
+			if(m == 0)
+			{
+				DrawRectT<u32, false>(fbr, fbc, r, c, m);
+			}
+			else
+			{
+				DrawRectT<u32, true>(fbr, fbc, r, c, m);
+			}
+		}
+		else
+		{
+			c = ((c & 0xf8) >> 3) | ((c & 0xf800) >> 6) | ((c & 0xf80000) >> 9) | ((c & 0x80000000) >> 16);
+
+			if((m & 0xffff) == 0)
+			{
+				DrawRectT<u16, false>(fbr, fbc, r, c, m);
+			}
+			else
+			{
+				DrawRectT<u16, true>(fbr, fbc, r, c, m);
+			}
+		}
+	}
+}
+
+void GSDrawScanline::DrawRectZ(const GSVector4i& r, const GSVertexSW& v)
+{
 	u32 m;
 
 	#if _M_SSE >= 0x501
@@ -157,6 +229,62 @@ void GSDrawScanline::DrawRect(const GSVector4i& r, const GSVertexSW& v)
 			}
 		}
 	}
+}
+
+bool GSDrawScanline::DrawCopy(const GSVector4i& r, const GSVertexSW& scan)
+{
+	ASSERT(r.y >= 0);
+	ASSERT(r.w >= 0);
+
+	u32 c = (GSVector4i(scan.c) >> 7).rgba32();
+
+	// modulate only passes the texels through unchanged when the vertex color is 1.0
+
+	if(m_global.sel.tfx == TFX_MODULATE)
+	{
+		if((c & 0x00ffffff) != 0x00808080 || m_global.sel.tcc && (c >> 24) != 0x80)
+		{
+			return false;
+		}
+	}
+
+	// texels are addressed like the scanline code does it, 16.16 fixed point truncated,
+	// the rows are stepped in float the same way, every texel has to be inside the texture
+	// (clamp and repeat are identities there)
+
+	int umax = m_global.t.mask.U32[0] ? m_global.t.min.U16[0] : m_global.t.max.U16[0];
+	int vmax = m_global.t.mask.U32[2] ? m_global.t.min.U16[4] : m_global.t.max.U16[4];
+
+	float s = scan.t.x;
+	float t = scan.t.y;
+
+	if(!(s >= 0 && s < 65536.0f * 1024 && t >= 0 && t < 65536.0f * 1024))
+	{
+		return false;
+	}
+
+	int u = (int)s >> 16;
+
+	if(u + r.width() - 1 > umax)
+	{
+		return false;
+	}
+
+	float tb = t;
+
+	for(int y = r.top + 1; y < r.bottom; y++)
+	{
+		tb += 65536.0f;
+	}
+
+	if(((int)tb >> 16) > vmax)
+	{
+		return false;
+	}
+
+	DrawRectZ(r, scan);
+
+	u32 m;
 
 	#if _M_SSE >= 0x501
 	m = m_global.fm;
@@ -169,38 +297,137 @@ void GSDrawScanline::DrawRect(const GSVector4i& r, const GSVertexSW& v)
 		const int* fbr = m_global.fbr;
 		const int* fbc = m_global.fbc;
 
-		u32 c = (GSVector4i(v.c) >> 7).rgba32();
+		const u32* tex = (const u32*)m_global.tex[0];
+
+		int shift = m_global.sel.tw + 3;
+
+		// texel alpha, or the vertex alpha without tcc, fba forces the top bit
+
+		u32 am = m_global.sel.tcc ? 0xffffffff : 0x00ffffff;
+		u32 ao = m_global.sel.tcc ? 0 : (c & 0xff000000);
 
 		if(m_global.sel.fba)
 		{
-			c |= 0x80000000;
+			ao |= 0x80000000;
 		}
 
 		if(m_global.sel.fpsm != 2)
 		{
 			if(m == 0)
 			{
-				DrawRectT<u32, false>(fbr, fbc, r, c, m);
+				CopyRectT<u32, false>(fbr, fbc, r, tex, shift, u, t, am, ao, m);
 			}
 			else
 			{
-				DrawRectT<u32, true>(fbr, fbc, r, c, m);
+				CopyRectT<u32, true>(fbr, fbc, r, tex, shift, u, t, am, ao, m);
 			}
 		}
 		else
 		{
-			c = ((c & 0xf8) >> 3) | ((c & 0xf800) >> 6) | ((c & 0xf80000) >> 9) | ((c & 0x80000000) >> 16);
-
 			if((m & 0xffff) == 0)
 			{
-				DrawRectT<u16, false>(fbr, fbc, r, c, m);
+				CopyRectT<u16, false>(fbr, fbc, r, tex, shift, u, t, am, ao, m);
 			}
 			else
 			{
-				DrawRectT<u16, true>(fbr, fbc, r, c, m);
+				CopyRectT<u16, true>(fbr, fbc, r, tex, shift, u, t, am, ao, m);
 			}
 		}
 	}
+
+	return true;
+}
+
+template<class T, bool masked>
+void GSDrawScanline::CopyRectT(const int* RESTRICT row, const int* RESTRICT col, const GSVector4i& r, const u32* RESTRICT tex, int shift, int u, float t, u32 am, u32 ao, u32 m)
+{
+	T* vm = (T*)m_global.vm;
+
+	GSVector4i amask((int)am);
+	GSVector4i aor((int)ao);
+	GSVector4i mask((int)m);
+
+	for(int y = r.y; y < r.w; y++, t += 65536.0f)
+	{
+		const u32* RESTRICT s = &tex[(((int)t >> 16) << shift) + u - r.x];
+
+		T* RESTRICT d = &vm[row[y]];
+
+		int x = r.x;
+
+		if(sizeof(T) == sizeof(u32))
+		{
+			// an even pixel and the next one are neighbours in a column (columnTable32),
+			// four texels go out as two qwords
+
+			if(x & 1)
+			{
+				u32 c = (s[x] & am) | ao;
+
+				d[col[x]] = (T)(!masked ? c : ((c & ~m) | (d[col[x]] & m)));
+
+				x++;
+			}
+
+			for(; x + 4 <= r.z; x += 4)
+			{
+				ASSERT(col[x + 1] == col[x] + 1 && col[x + 3] == col[x + 2] + 1);
+
+				T* p0 = &d[col[x + 0]];
+				T* p2 = &d[col[x + 2]];
+
+				GSVector4i c = (GSVector4i::load<false>(&s[x]) & amask) | aor;
+
+				if(masked)
+				{
+					c = c.andnot(mask) | (GSVector4i::load(p0, p2) & mask);
+				}
+
+				GSVector4i::store(p0, p2, c);
+			}
+		}
+		else
+		{
+			// the pixels of a 16 bit column are interleaved (columnTable16), only the
+			// conversion is done four at a time
+
+			for(; x + 4 <= r.z; x += 4)
+			{
+				GSVector4i c = (GSVector4i::load<false>(&s[x]) & amask) | aor;
+
+				c = (c & GSVector4i(0xf8)).srl32(3) | (c & GSVector4i(0xf800)).srl32(6) | (c & GSVector4i(0xf80000)).srl32(9) | c.srl32(31).sll32(15);
+
+				if(masked)
+				{
+					c = c.andnot(mask);
+
+					d[col[x + 0]] = (T)(c.extract32<0>() | (d[col[x + 0]] & m));
+					d[col[x + 1]] = (T)(c.extract32<1>() | (d[col[x + 1]] & m));
+					d[col[x + 2]] = (T)(c.extract32<2>() | (d[col[x + 2]] & m));
+					d[col[x + 3]] = (T)(c.extract32<3>() | (d[col[x + 3]] & m));
+				}
+				else
+				{
+					d[col[x + 0]] = (T)c.extract32<0>();
+					d[col[x + 1]] = (T)c.extract32<1>();
+					d[col[x + 2]] = (T)c.extract32<2>();
+					d[col[x + 3]] = (T)c.extract32<3>();
+				}
+			}
+		}
+
+		for(; x < r.z; x++)
+		{
+			u32 c = (s[x] & am) | ao;
+
+			if(sizeof(T) == sizeof(u16))
+			{
+				c = ((c & 0xf8) >> 3) | ((c & 0xf800) >> 6) | ((c & 0xf80000) >> 9) | ((c & 0x80000000) >> 16);
+			}
+
+			d[col[x]] = (T)(!masked ? c : ((c & ~m) | (d[col[x]] & m)));
+		}
+	}
 }
 
 template<class T, bool masked>
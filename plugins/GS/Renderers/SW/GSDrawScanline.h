@@ -45,12 +45,17 @@ protected:
 	GSCodeGeneratorFunctionMap<GSSetupPrimCodeGenerator, u64, SetupPrimPtr> m_sp_map;
 	GSCodeGeneratorFunctionMap<GSDrawScanlineCodeGenerator, u64, DrawScanlinePtr> m_ds_map;
 
+	void DrawRectZ(const GSVector4i& r, const GSVertexSW& v);
+
 	template<class T, bool masked>
 	void DrawRectT(const int* RESTRICT row, const int* RESTRICT col, const GSVector4i& r, u32 c, u32 m);
 
 	template<class T, bool masked>
 	__forceinline void FillRect(const int* RESTRICT row, const int* RESTRICT col, const GSVector4i& r, u32 c, u32 m);
 
+	template<class T, bool masked>
+	void CopyRectT(const int* RESTRICT row, const int* RESTRICT col, const GSVector4i& r, const u32* RESTRICT tex, int shift, int u, float t, u32 am, u32 ao, u32 m);
+
 	#if _M_SSE >= 0x501
 
 	template<class T, bool masked>
@@ -71,6 +76,9 @@ public:
 
 	void BeginDraw(const GSRasterizerData* data);
 	void EndDraw(u64 frame, int actual, int total);
+	void GetSelectors(std::set<u64>& ds, std::set<u64>& sp);
+	void PrepareSelectors(const std::set<u64>& ds, const std::set<u64>& sp);
 
 	void DrawRect(const GSVector4i& r, const GSVertexSW& v);
+	bool DrawCopy(const GSVector4i& r, const GSVertexSW& scan);
 };
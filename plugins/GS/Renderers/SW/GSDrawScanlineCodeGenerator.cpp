@@ -36,6 +36,7 @@ GSDrawScanlineCodeGenerator::GSDrawScanlineCodeGenerator(void* param, u64 key, v
 	: GSCodeGenerator(code, maxsize)
 	, m_local(*(GSScanlineLocalData*)param)
 	, m_rip(false)
+	, m_avx512vl(theApp.GetConfigB("sw_avx512") && m_cpu.has(util::Cpu::tAVX512F) && m_cpu.has(util::Cpu::tAVX512VL))
 {
 	m_sel.key = key;
 
@@ -183,7 +184,11 @@ void GSDrawScanlineCodeGenerator::alltrue(const Xmm& test)
 
 void GSDrawScanlineCodeGenerator::blend(const Xmm& a, const Xmm& b, const Xmm& mask)
 {
-	if(m_cpu.has(util::Cpu::tAVX))
+	if(m_avx512vl)
+	{
+		vpternlogd(a, b, mask, 0xd8); // a = mask ? b : a
+	}
+	else if(m_cpu.has(util::Cpu::tAVX))
 	{
 		vpand(b, mask);
 		vpandn(mask, a);
@@ -200,7 +205,11 @@ void GSDrawScanlineCodeGenerator::blend(const Xmm& a, const Xmm& b, const Xmm& m
 
 void GSDrawScanlineCodeGenerator::blendr(const Xmm& b, const Xmm& a, const Xmm& mask)
 {
-	if(m_cpu.has(util::Cpu::tAVX))
+	if(m_avx512vl)
+	{
+		vpternlogd(b, a, mask, 0xe4); // b = mask ? b : a
+	}
+	else if(m_cpu.has(util::Cpu::tAVX))
 	{
 		vpand(b, mask);
 		vpandn(mask, a);
@@ -40,6 +40,7 @@ class GSDrawScanlineCodeGenerator : public GSCodeGenerator
 	GSScanlineSelector m_sel;
 	GSScanlineLocalData& m_local;
 	bool m_rip;
+	bool m_avx512vl; // EVEX forms on xmm/ymm: opmask compares and vpternlogd (opt-in, sw_avx512)
 
 	void Generate();
 
@@ -113,6 +114,7 @@ class GSDrawScanlineCodeGenerator : public GSCodeGenerator
 	void AlphaTFX_AVX();
 	void ReadMask_AVX();
 	void TestAlpha_AVX();
+	void TestAlpha_AVX512();
 	void ColorTFX_AVX();
 	void Fog_AVX();
 	void ReadFrame_AVX();
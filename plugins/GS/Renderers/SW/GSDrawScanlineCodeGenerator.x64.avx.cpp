@@ -650,9 +650,9 @@ void GSDrawScanlineCodeGenerator::TestZ_AVX(const Xmm& temp1, const Xmm& temp2)
 			vpslld(xmm0, 1);
 
 			vcvttps2dq(xmm1, _z);
-			vpcmpeqd(xmm2, xmm2);
-			vpsrld(xmm2, 31);
-			vpand(xmm1, xmm2);
+			vpcmpeqd(temp1, temp1);
+			vpsrld(temp1, 31);
+			vpand(xmm1, temp1);
 
 			vpor(xmm0, xmm1);
 		}
@@ -698,18 +698,46 @@ void GSDrawScanlineCodeGenerator::TestZ_AVX(const Xmm& temp1, const Xmm& temp2)
 			vpsrld(xmm1, static_cast<u8>(m_sel.zpsm * 8));
 		}
 
+		if(m_avx512vl)
+		{
+			// compare into k1 and or it into test, the unsigned compare replaces the bias below
+
+			bool sign = !(m_sel.zoverflow || m_sel.zpsm == 0);
+
+			switch(m_sel.ztst)
+			{
+			case ZTST_GEQUAL:
+				// test |= zs < zd;
+				if(sign) vpcmpd(k1, xmm0, xmm1, 1);
+				else vpcmpud(k1, xmm0, xmm1, 1);
+				vpternlogd(_test | k1, _test, _test, 0xff);
+				break;
+
+			case ZTST_GREATER:
+				// test |= zs <= zd;
+				if(sign) vpcmpd(k1, xmm0, xmm1, 2);
+				else vpcmpud(k1, xmm0, xmm1, 2);
+				vpternlogd(_test | k1, _test, _test, 0xff);
+				break;
+			}
+
+			alltrue(_test);
+
+			return;
+		}
+
 		if(m_sel.zoverflow || m_sel.zpsm == 0)
 		{
 			// GSVector4i o = GSVector4i::x80000000();
 
-			vpcmpeqd(xmm2, xmm2);
-			vpslld(xmm2, 31);
+			vpcmpeqd(temp1, temp1);
+			vpslld(temp1, 31);
 
 			// GSVector4i zso = zs - o;
 			// GSVector4i zdo = zd - o;
 
-			vpsubd(xmm0, xmm2);
-			vpsubd(xmm1, xmm2);
+			vpsubd(xmm0, temp1);
+			vpsubd(xmm1, temp1);
 		}
 
 		switch(m_sel.ztst)
@@ -723,8 +751,8 @@ void GSDrawScanlineCodeGenerator::TestZ_AVX(const Xmm& temp1, const Xmm& temp2)
 		case ZTST_GREATER: // TODO: tidus hair and chocobo wings only appear fully when this is tested as ZTST_GEQUAL
 			// test |= zso <= zdo; // ~(zso > zdo)
 			vpcmpgtd(xmm0, xmm1);
-			vpcmpeqd(xmm2, xmm2);
-			vpxor(xmm0, xmm2);
+			vpcmpeqd(temp1, temp1);
+			vpxor(xmm0, temp1);
 			vpor(_test, xmm0);
 			break;
 		}
@@ -1294,6 +1322,13 @@ void GSDrawScanlineCodeGenerator::ReadMask_AVX()
 
 void GSDrawScanlineCodeGenerator::TestAlpha_AVX()
 {
+	if(m_avx512vl)
+	{
+		TestAlpha_AVX512();
+
+		return;
+	}
+
 	switch(m_sel.atst)
 	{
 	case ATST_NEVER:
@@ -1470,6 +1505,76 @@ void GSDrawScanlineCodeGenerator::ReadFrame_AVX()
 	ReadPixel_AVX(_fd, rbx);
 }
 
+void GSDrawScanlineCodeGenerator::TestAlpha_AVX512()
+{
+	// t stays in k1, the fail actions are masked all-ones writes
+
+	switch(m_sel.atst)
+	{
+	case ATST_NEVER:
+		// t = GSVector4i::xffffffff();
+		kxnorw(k1, k1, k1);
+		break;
+
+	case ATST_ALWAYS:
+		return;
+
+	case ATST_LESS:
+	case ATST_LEQUAL:
+		// t = (ga >> 16) > m_local.gd->aref;
+		vpsrld(xmm1, _ga, 16);
+		vpcmpd(k1, xmm1, _rip_global(aref), 6);
+		break;
+
+	case ATST_EQUAL:
+		// t = (ga >> 16) != m_local.gd->aref;
+		vpsrld(xmm1, _ga, 16);
+		vpcmpd(k1, xmm1, _rip_global(aref), 4);
+		break;
+
+	case ATST_GEQUAL:
+	case ATST_GREATER:
+		// t = (ga >> 16) < m_local.gd->aref;
+		vpsrld(xmm1, _ga, 16);
+		vpcmpd(k1, xmm1, _rip_global(aref), 1);
+		break;
+
+	case ATST_NOTEQUAL:
+		// t = (ga >> 16) == m_local.gd->aref;
+		vpsrld(xmm1, _ga, 16);
+		vpcmpd(k1, xmm1, _rip_global(aref), 0);
+		break;
+	}
+
+	switch(m_sel.afail)
+	{
+	case AFAIL_KEEP:
+		// test |= t;
+		vpternlogd(_test | k1, _test, _test, 0xff);
+		alltrue(_test);
+		break;
+
+	case AFAIL_FB_ONLY:
+		// zm |= t;
+		vpternlogd(_zm | k1, _zm, _zm, 0xff);
+		break;
+
+	case AFAIL_ZB_ONLY:
+		// fm |= t;
+		vpternlogd(_fm | k1, _fm, _fm, 0xff);
+		break;
+
+	case AFAIL_RGB_ONLY:
+		// zm |= t;
+		vpternlogd(_zm | k1, _zm, _zm, 0xff);
+		// fm |= t & GSVector4i::xff000000();
+		vpternlogd(xmm1, xmm1, xmm1, 0xff);
+		vpslld(xmm1, 24);
+		vpord(_fm | k1, _fm, xmm1);
+		break;
+	}
+}
+
 void GSDrawScanlineCodeGenerator::TestDestAlpha_AVX()
 {
 	if(!m_sel.date || m_sel.fpsm != 0 && m_sel.fpsm != 2)
@@ -1479,6 +1584,27 @@ void GSDrawScanlineCodeGenerator::TestDestAlpha_AVX()
 
 	// test |= ((fd [<< 16]) ^ m_local.gd->datm).sra32(31);
 
+	if(m_sel.datm && m_avx512vl)
+	{
+		// test |= ~(fd [<< 16]).sra32(31);
+
+		if(m_sel.fpsm == 2)
+		{
+			vpslld(xmm1, _fd, 16);
+			vpsrad(xmm1, 31);
+		}
+		else
+		{
+			vpsrad(xmm1, _fd, 31);
+		}
+
+		vpternlogd(_test, xmm1, xmm1, 0xf3);
+
+		alltrue(_test);
+
+		return;
+	}
+
 	if(m_sel.datm)
 	{
 		if(m_sel.fpsm == 2)
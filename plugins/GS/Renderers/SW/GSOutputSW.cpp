@@ -0,0 +1,254 @@
+/*
+ *	Copyright (C) 2007-2009 Gabest
+ *	http://www.gabest.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNU Make; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "Pcsx2Types.h"
+
+#include "GSOutputSW.h"
+
+GSOutputSW::GSOutputSW()
+{
+	memset(&m_merge, 0, sizeof(m_merge));
+	memset(&m_weave, 0, sizeof(m_weave));
+	memset(&m_line, 0, sizeof(m_line));
+	memset(&m_state, 0, sizeof(m_state));
+
+	MULTI_ISA_SELECT(GSOutputSWPopulateFunctions)(m_row);
+}
+
+GSOutputSW::~GSOutputSW()
+{
+	_aligned_free(m_merge.data);
+	_aligned_free(m_weave.data);
+	_aligned_free(m_line.data);
+}
+
+bool GSOutputSW::Resize(Buffer& b, const GSVector2i& size)
+{
+	if(b.data == NULL || b.size != size)
+	{
+		_aligned_free(b.data);
+
+		b.data = (u32*)_aligned_malloc(size.x * size.y * sizeof(u32), 32);
+		b.size = size;
+
+		// a new render target starts out black on the device too
+
+		memset(b.data, 0, size.x * size.y * sizeof(u32));
+
+		return true;
+	}
+
+	return false;
+}
+
+GSVector2i GSOutputSW::GetSize(const GSVector2i& fs, const GSVector2i& ds, int mode) const
+{
+	return mode >= 0 && mode <= 2 ? ds : fs;
+}
+
+void GSOutputSW::Copy(u32* RESTRICT dst, const GSTexture::GSMap& m, const GSVector2i& size, int sx, int sy, int n, bool blend)
+{
+	// reads outside the source repeat its edge like the clamping sampler does
+
+	const u32* src = (const u32*)(m.bits + m.pitch * std::min(std::max(sy, 0), size.y - 1));
+
+	BlendRowPtr fn = m_row.blend_row[m_state.PMODE.MMOD][m_state.PMODE.AMOD];
+
+	u32 alp = m_state.PMODE.ALP;
+
+	int i = 0;
+
+	for(; i < n && sx + i < 0; i++)
+	{
+		if(blend) fn(&dst[i], &src[0], 1, alp);
+		else dst[i] = src[0];
+	}
+
+	int k = std::min(n, size.x - sx);
+
+	if(k > i)
+	{
+		if(blend) fn(&dst[i], &src[sx + i], k - i, alp);
+		else memcpy(&dst[i], &src[sx + i], (k - i) * sizeof(u32));
+
+		i = k;
+	}
+
+	for(; i < n; i++)
+	{
+		if(blend) fn(&dst[i], &src[size.x - 1], 1, alp);
+		else dst[i] = src[size.x - 1];
+	}
+}
+
+void GSOutputSW::MergeLine(u32* RESTRICT dst, int y)
+{
+	// same order as GSDevice::DoMerge: background, the second circuit copied, the first
+	// one blended over it
+
+	int w = m_state.width;
+
+	GSVector4i bg((int)m_state.bg);
+
+	int x = 0;
+
+	for(; x <= w - 4; x += 4)
+	{
+		GSVector4i::store<false>(&dst[x], bg);
+	}
+
+	for(; x < w; x++)
+	{
+		dst[x] = m_state.bg;
+	}
+
+	for(int i = 1; i >= 0; i--)
+	{
+		const Circuit& c = m_state.c[i];
+
+		if(c.tex == NULL || y < c.r.top || y >= c.r.bottom)
+			continue;
+
+		int l = std::max(c.r.left, 0);
+		int r = std::min(c.r.right, w);
+
+		if(l < r)
+		{
+			Copy(&dst[l], m_state.m[i], c.tex->GetSize(), c.src.x + l - c.r.left, c.src.y + y - c.r.top, r - l, i == 0);
+		}
+	}
+}
+
+void GSOutputSW::Merge(const Circuit c[2], const GSVector2i& fs, const GSVector2i& ds, const GSRegPMODE& PMODE, u32 bg, int field, int mode, u8* dst, int pitch)
+{
+	m_state.PMODE = PMODE;
+	m_state.bg = bg;
+	m_state.width = fs.x;
+
+	for(int i = 0; i < 2; i++)
+	{
+		m_state.c[i] = c[i];
+
+		// SLBG selects the background instead of the second circuit
+
+		if(i == 1 && PMODE.SLBG)
+			m_state.c[i].tex = NULL;
+
+		if(m_state.c[i].tex == NULL)
+			continue;
+
+		if(i == 1 && m_state.c[1].tex == m_state.c[0].tex)
+			m_state.m[1] = m_state.m[0]; // both circuits read the same frame
+		else if(!m_state.c[i].tex->Map(m_state.m[i]))
+			m_state.c[i].tex = NULL;
+	}
+
+	if(mode == 0 || mode == 2) // weave or blend
+	{
+		// only the lines of this field are drawn, the others are still the previous field
+
+		Resize(m_weave, ds);
+
+		for(int y = 0; y < ds.y; y++)
+		{
+			if((y & 1) != field)
+			{
+				MergeLine(&m_weave.data[y * ds.x], (2 * y + 1) * fs.y / (2 * ds.y));
+			}
+		}
+
+		for(int y = 0; y < ds.y; y++, dst += pitch)
+		{
+			const u32* line = &m_weave.data[y * ds.x];
+
+			if(mode == 2)
+			{
+				const u32* prev = y > 0 ? line - ds.x : line;
+				const u32* next = y < ds.y - 1 ? line + ds.x : line;
+
+				m_row.blend_lines((u32*)dst, prev, line, next, ds.x);
+			}
+			else
+			{
+				memcpy(dst, line, ds.x * sizeof(u32));
+			}
+		}
+	}
+	else if(mode == 1) // bob
+	{
+		// the field is stretched to the full height and moved down by one line on odd
+		// fields, the line above it is left as it was
+
+		Resize(m_merge, fs);
+
+		for(int y = 0; y < fs.y; y++)
+		{
+			MergeLine(&m_merge.data[y * fs.x], y);
+		}
+
+		Resize(m_weave, ds);
+
+		for(int y = field; y < ds.y; y++)
+		{
+			// center of the line in the source, 8 bit fraction
+
+			int pos = std::max((2 * (y - field) + 1) * fs.y * 128 / ds.y - 128, 0);
+
+			const u32* a = &m_merge.data[std::min(pos >> 8, fs.y - 1) * fs.x];
+			const u32* b = &m_merge.data[std::min((pos >> 8) + 1, fs.y - 1) * fs.x];
+
+			u32* line = &m_weave.data[y * ds.x];
+
+			if((pos & 0xff) == 0)
+			{
+				memcpy(line, a, ds.x * sizeof(u32));
+			}
+			else
+			{
+				m_row.lerp_lines(line, a, b, ds.x, pos & 0xff);
+			}
+		}
+
+		for(int y = 0; y < ds.y; y++, dst += pitch)
+		{
+			memcpy(dst, &m_weave.data[y * ds.x], ds.x * sizeof(u32));
+		}
+	}
+	else
+	{
+		// blending reads the destination back, dst is likely uncached upload memory
+
+		Resize(m_line, GSVector2i(fs.x, 1));
+
+		for(int y = 0; y < fs.y; y++, dst += pitch)
+		{
+			MergeLine(m_line.data, y);
+
+			memcpy(dst, m_line.data, fs.x * sizeof(u32));
+		}
+	}
+
+	if(m_state.c[0].tex != NULL)
+		m_state.c[0].tex->Unmap();
+
+	if(m_state.c[1].tex != NULL && m_state.c[1].tex != m_state.c[0].tex)
+		m_state.c[1].tex->Unmap();
+}
@@ -0,0 +1,95 @@
+/*
+ *	Copyright (C) 2007-2009 Gabest
+ *	http://www.gabest.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNU Make; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#pragma once
+
+#include "../../GS.h"
+#include "../../GSAlignedClass.h"
+#include "../../GSMultiISA.h"
+#include "GSTextureSW.h"
+
+// PCRTC merge and deinterlacing of the software renderer output. It does on the CPU what
+// GSDevice::Merge and GSDevice::Interlace do with shaders, so a frame of the software
+// renderer reaches the device as one finished image instead of one or two uploads and
+// a few passes.
+
+class GSOutputSW : public GSAlignedClass<32>
+{
+public:
+	struct Circuit
+	{
+		GSTextureSW* tex; // NULL if the circuit is off
+		GSVector4i r; // destination rectangle in the merged image
+		GSVector2i src; // top left corner of r in tex
+	};
+
+	// the row functions are built per instruction set, see GSOutputSWMultiISA.cpp
+
+	typedef void (*BlendRowPtr)(u32* RESTRICT dst, const u32* RESTRICT src, int n, u32 alp);
+	typedef void (*BlendLinesPtr)(u32* RESTRICT dst, const u32* RESTRICT a, const u32* RESTRICT b, const u32* RESTRICT c, int n);
+	typedef void (*LerpLinesPtr)(u32* RESTRICT dst, const u32* RESTRICT a, const u32* RESTRICT b, int n, int f);
+
+	struct RowFunctions
+	{
+		BlendRowPtr blend_row[2][2]; // [MMOD][AMOD]
+		BlendLinesPtr blend_lines;
+		LerpLinesPtr lerp_lines;
+	};
+
+private:
+	RowFunctions m_row;
+
+	struct Buffer
+	{
+		u32* data;
+		GSVector2i size;
+	};
+
+	Buffer m_merge; // whole merged image, bob reads two lines of it for every output line
+	Buffer m_weave; // weave and bob leave every other line as it was, so it has to survive the frame
+	Buffer m_line;
+
+	struct
+	{
+		Circuit c[2];
+		GSTexture::GSMap m[2];
+		GSRegPMODE PMODE;
+		u32 bg;
+		int width;
+	} m_state;
+
+	bool Resize(Buffer& b, const GSVector2i& size);
+
+	void Copy(u32* RESTRICT dst, const GSTexture::GSMap& m, const GSVector2i& size, int sx, int sy, int n, bool blend);
+	void MergeLine(u32* RESTRICT dst, int y);
+
+public:
+	GSOutputSW();
+	virtual ~GSOutputSW();
+
+	// mode and field are the arguments of GSDevice::Interlace, mode is -1 for progressive output
+
+	GSVector2i GetSize(const GSVector2i& fs, const GSVector2i& ds, int mode) const;
+
+	void Merge(const Circuit c[2], const GSVector2i& fs, const GSVector2i& ds, const GSRegPMODE& PMODE, u32 bg, int field, int mode, u8* dst, int pitch);
+};
+
+MULTI_ISA_DEF(void GSOutputSWPopulateFunctions(GSOutputSW::RowFunctions& f);)
@@ -0,0 +1,197 @@
+/*
+ *	Copyright (C) 2007-2009 Gabest
+ *	http://www.gabest.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNU Make; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "Pcsx2Types.h"
+
+#include "GSOutputSW.h"
+
+// The row functions of GSOutputSW. The file is built once per instruction set (see
+// GSMultiISA.h), 8 pixels at a time with AVX2 and 4 otherwise, the rest of the row is
+// done one pixel at a time.
+
+MULTI_ISA_UNSHARED_START
+
+#if _M_SSE >= 0x501
+typedef GSVector8i GSVectorRow;
+#else
+typedef GSVector4i GSVectorRow;
+#endif
+
+class GSOutputSWFunctions
+{
+	enum {Step = sizeof(GSVectorRow) / sizeof(u32)};
+
+	// x / 255 rounded to nearest, for x up to 255 * 255 + 128
+
+	static __forceinline u32 Div255(u32 x)
+	{
+		x += 128;
+
+		return (x + (x >> 8)) >> 8;
+	}
+
+	static __forceinline GSVectorRow Div255(const GSVectorRow& x)
+	{
+		GSVectorRow t = x.add16(GSVectorRow((int)0x00800080));
+
+		return t.add16(t.srl16(8)).srl16(8);
+	}
+
+	template<bool mmod, bool amod>
+	static __forceinline GSVectorRow Blend(const GSVectorRow& s, const GSVectorRow& d, const GSVectorRow& alp)
+	{
+		// MMOD = 0 blends with twice the alpha of the pixel, saturated like the shader output
+
+		GSVectorRow a = mmod ? alp : s.wwwwlh().add16(s.wwwwlh()).min_u16(GSVectorRow::x00ff());
+
+		GSVectorRow c = Div255(s.mul16l(a).add16(d.mul16l(GSVectorRow::x00ff().sub16(a))));
+
+		// AMOD = 1 keeps the alpha of the second circuit (or the background)
+
+		return c.blend16<0x88>(amod ? d : a);
+	}
+
+	template<bool mmod, bool amod>
+	static void BlendRow(u32* RESTRICT dst, const u32* RESTRICT src, int n, u32 alp)
+	{
+		GSVectorRow a((int)(alp | (alp << 16)));
+
+		int i = 0;
+
+		for(; i <= n - Step; i += Step)
+		{
+			GSVectorRow s = GSVectorRow::load<false>(&src[i]);
+			GSVectorRow d = GSVectorRow::load<false>(&dst[i]);
+
+			GSVectorRow lo = Blend<mmod, amod>(s.upl8(), d.upl8(), a);
+			GSVectorRow hi = Blend<mmod, amod>(s.uph8(), d.uph8(), a);
+
+			GSVectorRow::store<false>(&dst[i], lo.pu16(hi));
+		}
+
+		for(; i < n; i++)
+		{
+			u32 s = src[i];
+			u32 d = dst[i];
+
+			u32 sa = (s >> 23) & 0x1fe;
+
+			if(mmod) sa = alp;
+			else if(sa > 255) sa = 255;
+
+			u32 c = 0;
+
+			for(int j = 0; j < 24; j += 8)
+			{
+				c |= Div255(((s >> j) & 0xff) * sa + ((d >> j) & 0xff) * (255 - sa)) << j;
+			}
+
+			dst[i] = c | ((amod ? d >> 24 : sa) << 24);
+		}
+	}
+
+	// (a + 2b + c) / 4, the blend filter of GSDevice::Interlace
+
+	static void BlendLines(u32* RESTRICT dst, const u32* RESTRICT a, const u32* RESTRICT b, const u32* RESTRICT c, int n)
+	{
+		GSVectorRow r((int)0x00020002);
+
+		int i = 0;
+
+		for(; i <= n - Step; i += Step)
+		{
+			GSVectorRow va = GSVectorRow::load<false>(&a[i]);
+			GSVectorRow vb = GSVectorRow::load<false>(&b[i]);
+			GSVectorRow vc = GSVectorRow::load<false>(&c[i]);
+
+			GSVectorRow lo = va.upl8().add16(vb.upl8().sll16(1)).add16(vc.upl8()).add16(r).srl16(2);
+			GSVectorRow hi = va.uph8().add16(vb.uph8().sll16(1)).add16(vc.uph8()).add16(r).srl16(2);
+
+			GSVectorRow::store<false>(&dst[i], lo.pu16(hi));
+		}
+
+		for(; i < n; i++)
+		{
+			u32 p = 0;
+
+			for(int j = 0; j < 32; j += 8)
+			{
+				p |= ((((a[i] >> j) & 0xff) + ((b[i] >> j) & 0xff) * 2 + ((c[i] >> j) & 0xff) + 2) >> 2) << j;
+			}
+
+			dst[i] = p;
+		}
+	}
+
+	// a + (b - a) * f / 256, the bilinear filter of the bob stretch
+
+	static void LerpLines(u32* RESTRICT dst, const u32* RESTRICT a, const u32* RESTRICT b, int n, int f)
+	{
+		GSVectorRow fa((int)((256 - f) | ((256 - f) << 16)));
+		GSVectorRow fb((int)(f | (f << 16)));
+		GSVectorRow r((int)0x00800080);
+
+		int i = 0;
+
+		for(; i <= n - Step; i += Step)
+		{
+			GSVectorRow va = GSVectorRow::load<false>(&a[i]);
+			GSVectorRow vb = GSVectorRow::load<false>(&b[i]);
+
+			GSVectorRow lo = va.upl8().mul16l(fa).add16(vb.upl8().mul16l(fb)).add16(r).srl16(8);
+			GSVectorRow hi = va.uph8().mul16l(fa).add16(vb.uph8().mul16l(fb)).add16(r).srl16(8);
+
+			GSVectorRow::store<false>(&dst[i], lo.pu16(hi));
+		}
+
+		for(; i < n; i++)
+		{
+			u32 p = 0;
+
+			for(int j = 0; j < 32; j += 8)
+			{
+				p |= ((((a[i] >> j) & 0xff) * (256 - f) + ((b[i] >> j) & 0xff) * f + 128) >> 8) << j;
+			}
+
+			dst[i] = p;
+		}
+	}
+
+public:
+	static void PopulateFunctions(GSOutputSW::RowFunctions& f);
+};
+
+void GSOutputSWPopulateFunctions(GSOutputSW::RowFunctions& f)
+{
+	GSOutputSWFunctions::PopulateFunctions(f);
+}
+
+void GSOutputSWFunctions::PopulateFunctions(GSOutputSW::RowFunctions& f)
+{
+	f.blend_row[0][0] = &GSOutputSWFunctions::BlendRow<false, false>;
+	f.blend_row[0][1] = &GSOutputSWFunctions::BlendRow<false, true>;
+	f.blend_row[1][0] = &GSOutputSWFunctions::BlendRow<true, false>;
+	f.blend_row[1][1] = &GSOutputSWFunctions::BlendRow<true, true>;
+	f.blend_lines = &GSOutputSWFunctions::BlendLines;
+	f.lerp_lines = &GSOutputSWFunctions::LerpLines;
+}
+
+MULTI_ISA_UNSHARED_END
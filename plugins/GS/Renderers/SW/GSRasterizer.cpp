@@ -38,34 +38,20 @@ static int compute_best_thread_height(int threads) {
 	return 4;
 }
 
-GSRasterizer::GSRasterizer(IDrawScanline* ds, int id, int threads)
+GSRasterizer::GSRasterizer(IDrawScanline* ds)
 	: m_ds(ds)
-	, m_id(id)
-	, m_threads(threads)
 {
 	memset(&m_pixels, 0, sizeof(m_pixels));
 
-	m_thread_height = compute_best_thread_height(threads);
+	m_band.top = 0;
+	m_band.bottom = 2048;
 
 	m_edge.buff = (GSVertexSW*)vmalloc(sizeof(GSVertexSW) * 2048, false);
 	m_edge.count = 0;
-
-	int rows = (2048 >> m_thread_height) + 16;
-	m_scanline = (u8*)_aligned_malloc(rows, 64);
-
-	int row = 0;
-
-	while(row < rows)
-	{
-		for(int i = 0; i < threads; i++, row++)
-			m_scanline[row] = i == id ? 1 : 0;
-	}
 }
 
 GSRasterizer::~GSRasterizer()
 {
-	_aligned_free(m_scanline);
-
 	if(m_edge.buff != NULL) vmfree(m_edge.buff, sizeof(GSVertexSW) * 2048);
 
 	delete m_ds;
@@ -75,44 +61,12 @@ bool GSRasterizer::IsOneOfMyScanlines(int top) const
 {
 	ASSERT(top >= 0 && top < 2048);
 
-	return m_scanline[top >> m_thread_height] != 0;
+	return m_band.top <= top && top < m_band.bottom;
 }
 
-bool GSRasterizer::IsOneOfMyScanlines(int top, int bottom) const
+void GSRasterizer::Queue(GSRasterizerData* data)
 {
-	ASSERT(top >= 0 && top < 2048 && bottom >= 0 && bottom < 2048);
-
-	top = top >> m_thread_height;
-	bottom = (bottom + (1 << m_thread_height) - 1) >> m_thread_height;
-
-	while(top < bottom)
-	{
-		if(m_scanline[top++])
-		{
-			return true;
-		}
-	}
-
-	return false;
-}
-
-int GSRasterizer::FindMyNextScanline(int top) const
-{
-	int i = top >> m_thread_height;
-
-	if(m_scanline[i] == 0)
-	{
-		while(m_scanline[++i] == 0);
-
-		top = i << m_thread_height;
-	}
-
-	return top;
-}
-
-void GSRasterizer::Queue(const std::shared_ptr<GSRasterizerData>& data)
-{
-	Draw(data.get());
+	Draw(data);
 }
 
 int GSRasterizer::GetPixels(bool reset)
@@ -127,10 +81,40 @@ int GSRasterizer::GetPixels(bool reset)
 	return pixels;
 }
 
-void GSRasterizer::Draw(GSRasterizerData* data)
+void GSRasterizer::Draw(GSRasterizerData* data, int band)
 {
 	if(data->vertex != NULL && data->vertex_count == 0 || data->index != NULL && data->index_count == 0) return;
 
+	if(band >= 0)
+	{
+		m_band.top = band << data->bin_shift;
+		m_band.bottom = (band + 1) << data->bin_shift;
+
+		int state = data->bin_state.load(std::memory_order_acquire);
+
+		if(state != GSRasterizerData::BinNone && state != GSRasterizerData::BinDone)
+		{
+			if(state == GSRasterizerData::BinPending && data->bin_state.compare_exchange_strong(state, GSRasterizerData::BinRunning))
+			{
+				Bin(data);
+
+				data->bin_state.store(GSRasterizerData::BinDone, std::memory_order_release);
+			}
+			else
+			{
+				while(data->bin_state.load(std::memory_order_acquire) != GSRasterizerData::BinDone)
+				{
+					std::this_thread::yield();
+				}
+			}
+		}
+	}
+	else
+	{
+		m_band.top = 0;
+		m_band.bottom = 2048;
+	}
+
 	m_pixels.actual = 0;
 	m_pixels.total = 0;
 
@@ -150,7 +134,11 @@ void GSRasterizer::Draw(GSRasterizerData* data)
 	m_fscissor_x = GSVector4(data->scissor).xzxz();
 	m_fscissor_y = GSVector4(data->scissor).ywyw();
 
-	switch(data->primclass)
+	if(band >= 0 && data->bin_state.load(std::memory_order_relaxed) == GSRasterizerData::BinDone)
+	{
+		DrawBin(data, band - data->bin_first);
+	}
+	else switch(data->primclass)
 	{
 	case GS_POINT_CLASS:
 
@@ -225,6 +213,176 @@ void GSRasterizer::Draw(GSRasterizerData* data)
 	m_ds->EndDraw(data->frame, m_pixels.actual, m_pixels.total);
 }
 
+void GSRasterizer::Bin(GSRasterizerData* data)
+{
+	// Runs once per draw, sorts the primitives into the bands they touch so
+	// the other workers don't have to look at all of them. Triangles are set
+	// up here as well and only scanned by the band workers.
+
+	m_scissor = data->scissor;
+	m_fscissor_x = GSVector4(data->scissor).xzxz();
+	m_fscissor_y = GSVector4(data->scissor).ywyw();
+
+	const int n = data->primclass == GS_TRIANGLE_CLASS ? 3 : data->primclass == GS_POINT_CLASS ? 1 : 2;
+	const int prims = data->GetPrimCount();
+	const int first = data->bin_first;
+	const int count = data->bin_count;
+	const int shift = data->bin_shift;
+
+	const GSVertexSW* vertex = data->vertex;
+	const u32* index = data->index;
+
+	u32 tmp_index[] = {0, 1, 2};
+
+	TriangleSetup* ts = NULL;
+
+	if(data->primclass == GS_TRIANGLE_CLASS)
+	{
+		ts = (TriangleSetup*)_aligned_malloc(sizeof(TriangleSetup) * prims, 32);
+
+		data->bin_setup = (u8*)ts;
+	}
+
+	// the band range of each primitive is kept behind the offsets until the second pass
+
+	u32* offset = (u32*)_aligned_malloc(sizeof(u32) * (count + 1 + prims), 32);
+	u32* range = offset + count + 1;
+
+	memset(offset, 0, sizeof(u32) * (count + 1));
+
+	int total = 0;
+
+	for(int k = 0; k < prims; k++)
+	{
+		const GSVertexSW* v = index != NULL ? vertex : vertex + k * n;
+		const u32* i = index != NULL ? index + k * n : tmp_index;
+
+		range[k] = 0;
+
+		if(ts != NULL && !SetupTriangle(v, i, ts[k]))
+		{
+			continue;
+		}
+
+		GSVector4 pmin = v[i[0]].p;
+		GSVector4 pmax = pmin;
+
+		for(int j = 1; j < n; j++)
+		{
+			pmin = pmin.min(v[i[j]].p);
+			pmax = pmax.max(v[i[j]].p);
+		}
+
+		// conservative, lines and aa1 edges may round down to the row above the first pixel center
+
+		GSVector4i y = GSVector4i(pmin.yyyy(pmax).floor());
+
+		int top = std::max<int>(y.x, m_scissor.top);
+		int bottom = std::min<int>(y.z + 2, m_scissor.bottom);
+
+		if(top >= bottom)
+		{
+			continue;
+		}
+
+		int b0 = std::max((top >> shift) - first, 0);
+		int b1 = std::min(((bottom - 1) >> shift) - first + 1, count);
+
+		if(b0 >= b1)
+		{
+			continue;
+		}
+
+		range[k] = b0 | (b1 << 16);
+
+		for(int b = b0; b < b1; b++)
+		{
+			offset[b]++;
+		}
+
+		total += b1 - b0;
+	}
+
+	// offset[b] becomes the end of band b, filling backwards moves it to the start
+
+	for(int b = 1; b < count; b++)
+	{
+		offset[b] += offset[b - 1];
+	}
+
+	offset[count] = total;
+
+	u32* prim = (u32*)_aligned_malloc(sizeof(u32) * std::max(total, 1), 32);
+
+	for(int k = prims - 1; k >= 0; k--)
+	{
+		for(int b = range[k] & 0xffff, b1 = range[k] >> 16; b < b1; b++)
+		{
+			prim[--offset[b]] = k;
+		}
+	}
+
+	data->bin_offset = offset;
+	data->bin_prim = prim;
+}
+
+void GSRasterizer::DrawBin(GSRasterizerData* data, int band)
+{
+	const u32* RESTRICT p = data->bin_prim + data->bin_offset[band];
+	const u32* RESTRICT pe = data->bin_prim + data->bin_offset[band + 1];
+
+	const GSVertexSW* vertex = data->vertex;
+	const u32* index = data->index;
+
+	u32 tmp_index[] = {0, 1, 2};
+
+	switch(data->primclass)
+	{
+	case GS_POINT_CLASS:
+
+		for(; p < pe; p++)
+		{
+			if(index != NULL) DrawPoint<true>(vertex, 0, &index[*p], 1);
+			else DrawPoint<true>(&vertex[*p], 1, NULL, 0);
+		}
+
+		break;
+
+	case GS_LINE_CLASS:
+
+		for(; p < pe; p++)
+		{
+			if(index != NULL) DrawLine(vertex, &index[*p * 2]);
+			else DrawLine(&vertex[*p * 2], tmp_index);
+		}
+
+		break;
+
+	case GS_TRIANGLE_CLASS:
+
+		for(const TriangleSetup* ts = (const TriangleSetup*)data->bin_setup; p < pe; p++)
+		{
+			if(index != NULL) DrawTriangle(ts[*p], vertex, &index[*p * 3]);
+			else DrawTriangle(ts[*p], &vertex[*p * 3], tmp_index);
+		}
+
+		break;
+
+	case GS_SPRITE_CLASS:
+
+		for(; p < pe; p++)
+		{
+			if(index != NULL) DrawSprite(vertex, &index[*p * 2]);
+			else DrawSprite(&vertex[*p * 2], tmp_index);
+		}
+
+		break;
+
+	default:
+		__assume(0);
+	}
+}
+
 template<bool scissor_test>
 void GSRasterizer::DrawPoint(const GSVertexSW* vertex, int vertex_count, const u32* index, int index_count)
 {
@@ -385,7 +543,7 @@ static const u8 s_ysort[8][4] =
 
 #if _M_SSE >= 0x501
 
-void GSRasterizer::DrawTriangle(const GSVertexSW* vertex, const u32* index)
+bool GSRasterizer::SetupTriangle(const GSVertexSW* vertex, const u32* index, TriangleSetup& RESTRICT ts)
 {
 	GSVertexSW2 dv[3];
 	GSVertexSW2 edge;
@@ -418,7 +576,7 @@ void GSRasterizer::DrawTriangle(const GSVertexSW* vertex, const u32* index)
 	// if(i == 1) => y0 == y1 < y2
 	// if(i == 4) => y0 < y1 == y2
 
-	if(m1 == 7) return; // y0 == y1 == y2
+	if(m1 == 7) return false; // y0 == y1 == y2
 
 	GSVector4 tbf = y0011.xzxz(y1221).ceil();
 	GSVector4 tbmax = tbf.max(m_fscissor_y);
@@ -437,7 +595,7 @@ void GSRasterizer::DrawTriangle(const GSVertexSW* vertex, const u32* index)
 
 	int m2 = cross.upl(cross == GSVector4::zero()).mask();
 
-	if(m2 & 2) return;
+	if(m2 & 2) return false;
 
 	m2 &= 1;
 
@@ -466,6 +624,9 @@ void GSRasterizer::DrawTriangle(const GSVertexSW* vertex, const u32* index)
 	dedge.p = dv[0].p * _dxy01c.zzzz().extract<0>() - dv[1].p * _dxy01c.xxxx().extract<0>();
 	dedge.tc = dv[0].tc * _dxy01c.zzzz() - dv[1].tc * _dxy01c.xxxx();
 
+	ts.top[0] = ts.bottom[0] = 0;
+	ts.top[1] = ts.bottom[1] = 0;
+
 	if(m1 & 1)
 	{
 		if(tb.y < tb.w)
@@ -475,7 +636,11 @@ void GSRasterizer::DrawTriangle(const GSVertexSW* vertex, const u32* index)
 			edge.p = edge.p.insert32<0, 1>(vertex[i[m2]].p);
 			dedge.p = ddx[2 - (m2 << 1)].yzzw(dedge.p);
 
-			DrawTriangleSection(tb.x, tb.w, edge, dedge, dscan, vertex[i[1 - m2]].p);
+			ts.edge[0] = edge;
+			ts.dedge[0] = dedge;
+			ts.p0[0] = vertex[i[1 - m2]].p;
+			ts.top[0] = tb.x;
+			ts.bottom[0] = tb.w;
 		}
 	}
 	else
@@ -487,7 +652,11 @@ void GSRasterizer::DrawTriangle(const GSVertexSW* vertex, const u32* index)
 			edge.p = edge.p.xxzw();
 			dedge.p = ddx[m2].xyzw(dedge.p);
 
-			DrawTriangleSection(tb.x, tb.z, edge, dedge, dscan, v0.p);
+			ts.edge[0] = edge;
+			ts.dedge[0] = dedge;
+			ts.p0[0] = v0.p;
+			ts.top[0] = tb.x;
+			ts.bottom[0] = tb.z;
 		}
 
 		if(tb.y < tb.w)
@@ -497,30 +666,24 @@ void GSRasterizer::DrawTriangle(const GSVertexSW* vertex, const u32* index)
 			edge.p = (v0.p.xxxx() + ddx[m2] * dv[0].p.yyyy()).xyzw(edge.p);
 			dedge.p = ddx[2 - (m2 << 1)].yzzw(dedge.p);
 
-			DrawTriangleSection(tb.y, tb.w, edge, dedge, dscan, v1.p);
+			ts.edge[1] = edge;
+			ts.dedge[1] = dedge;
+			ts.p0[1] = v1.p;
+			ts.top[1] = tb.y;
+			ts.bottom[1] = tb.w;
 		}
 	}
 
-	Flush(vertex, index, (GSVertexSW&)dscan);
-
-	if(m_ds->HasEdge())
-	{
-		GSVector4 a = dx.abs() < dy.abs(); // |dx| <= |dy|
-		GSVector4 b = dx < GSVector4::zero(); // dx < 0
-		GSVector4 c = cross < GSVector4::zero(); // longest.p.x < 0
+	ts.dscan = dscan;
 
-		int orientation = a.mask();
-		int side = ((a | b) ^ c).mask() ^ 2; // evil
+	ts.i[0] = i[0];
+	ts.i[1] = i[1];
+	ts.i[2] = i[2];
 
-		DrawEdge((GSVertexSW&)v0, (GSVertexSW&)v1, (GSVertexSW&)dv[0], orientation & 1, side & 1);
-		DrawEdge((GSVertexSW&)v0, (GSVertexSW&)v2, (GSVertexSW&)dv[1], orientation & 2, side & 2);
-		DrawEdge((GSVertexSW&)v1, (GSVertexSW&)v2, (GSVertexSW&)dv[2], orientation & 4, side & 4);
-
-		Flush(vertex, index, GSVertexSW::zero(), true);
-	}
+	return true;
 }
 
-void GSRasterizer::DrawTriangleSection(int top, int bottom, GSVertexSW2& edge, const GSVertexSW2& dedge, const GSVertexSW2& dscan, const GSVector4& p0)
+void GSRasterizer::DrawTriangleSection(int top, int bottom, const GSVertexSW2& edge, const GSVertexSW2& dedge, const GSVertexSW2& dscan, const GSVector4& p0)
 {
 	ASSERT(top < bottom);
 	ASSERT(edge.p.x <= edge.p.y);
@@ -529,8 +692,6 @@ void GSRasterizer::DrawTriangleSection(int top, int bottom, GSVertexSW2& edge, c
 
 	GSVector4 scissor = m_fscissor_x;
 
-	top = FindMyNextScanline(top);
-
 	while(top < bottom)
 	{
 		GSVector8 dy(GSVector4(top) - p0.yyyy());
@@ -562,11 +723,6 @@ void GSRasterizer::DrawTriangleSection(int top, int bottom, GSVertexSW2& edge, c
 		}
 
 		top++;
-
-		if(!IsOneOfMyScanlines(top))
-		{
-			top += (m_threads - 1) << m_thread_height;
-		}
 	}
 
 	m_edge.count += e - &m_edge.buff[m_edge.count];
@@ -574,7 +730,7 @@ void GSRasterizer::DrawTriangleSection(int top, int bottom, GSVertexSW2& edge, c
 
 #else
 
-void GSRasterizer::DrawTriangle(const GSVertexSW* vertex, const u32* index)
+bool GSRasterizer::SetupTriangle(const GSVertexSW* vertex, const u32* index, TriangleSetup& RESTRICT ts)
 {
 	GSVertexSW dv[3];
 	GSVertexSW edge;
@@ -605,7 +761,7 @@ void GSRasterizer::DrawTriangle(const GSVertexSW* vertex, const u32* index)
 	// if(i == 1) => y0 == y1 < y2
 	// if(i == 4) => y0 < y1 == y2
 
-	if(m1 == 7) return; // y0 == y1 == y2
+	if(m1 == 7) return false; // y0 == y1 == y2
 
 	GSVector4 tbf = y0011.xzxz(y1221).ceil();
 	GSVector4 tbmax = tbf.max(m_fscissor_y);
@@ -624,7 +780,7 @@ void GSRasterizer::DrawTriangle(const GSVertexSW* vertex, const u32* index)
 
 	int m2 = cross.upl(cross == GSVector4::zero()).mask();
 
-	if(m2 & 2) return;
+	if(m2 & 2) return false;
 
 	m2 &= 1;
 
@@ -655,6 +811,9 @@ void GSRasterizer::DrawTriangle(const GSVertexSW* vertex, const u32* index)
 	dedge.t = dv[0].t * dxy01c.zzzz() - dv[1].t * dxy01c.xxxx();
 	dedge.c = dv[0].c * dxy01c.zzzz() - dv[1].c * dxy01c.xxxx();
 
+	ts.top[0] = ts.bottom[0] = 0;
+	ts.top[1] = ts.bottom[1] = 0;
+
 	if(m1 & 1)
 	{
 		if(tb.y < tb.w)
@@ -664,7 +823,11 @@ void GSRasterizer::DrawTriangle(const GSVertexSW* vertex, const u32* index)
 			edge.p = edge.p.insert32<0, 1>(vertex[i[m2]].p);
 			dedge.p = ddx[2 - (m2 << 1)].yzzw(dedge.p);
 
-			DrawTriangleSection(tb.x, tb.w, edge, dedge, dscan, vertex[i[1 - m2]].p);
+			ts.edge[0] = edge;
+			ts.dedge[0] = dedge;
+			ts.p0[0] = vertex[i[1 - m2]].p;
+			ts.top[0] = tb.x;
+			ts.bottom[0] = tb.w;
 		}
 	}
 	else
@@ -676,7 +839,11 @@ void GSRasterizer::DrawTriangle(const GSVertexSW* vertex, const u32* index)
 			edge.p = edge.p.xxzw();
 			dedge.p = ddx[m2].xyzw(dedge.p);
 
-			DrawTriangleSection(tb.x, tb.z, edge, dedge, dscan, v0.p);
+			ts.edge[0] = edge;
+			ts.dedge[0] = dedge;
+			ts.p0[0] = v0.p;
+			ts.top[0] = tb.x;
+			ts.bottom[0] = tb.z;
 		}
 
 		if(tb.y < tb.w)
@@ -686,30 +853,24 @@ void GSRasterizer::DrawTriangle(const GSVertexSW* vertex, const u32* index)
 			edge.p = (v0.p.xxxx() + ddx[m2] * dv[0].p.yyyy()).xyzw(edge.p);
 			dedge.p = ddx[2 - (m2 << 1)].yzzw(dedge.p);
 
-			DrawTriangleSection(tb.y, tb.w, edge, dedge, dscan, v1.p);
+			ts.edge[1] = edge;
+			ts.dedge[1] = dedge;
+			ts.p0[1] = v1.p;
+			ts.top[1] = tb.y;
+			ts.bottom[1] = tb.w;
 		}
 	}
 
-	Flush(vertex, index, dscan);
+	ts.dscan = dscan;
 
-	if(m_ds->HasEdge())
-	{
-		GSVector4 a = dx.abs() < dy.abs(); // |dx| <= |dy|
-		GSVector4 b = dx < GSVector4::zero(); // dx < 0
-		GSVector4 c = cross < GSVector4::zero(); // longest.p.x < 0
-
-		int orientation = a.mask();
-		int side = ((a | b) ^ c).mask() ^ 2; // evil
+	ts.i[0] = i[0];
+	ts.i[1] = i[1];
+	ts.i[2] = i[2];
 
-		DrawEdge(v0, v1, dv[0], orientation & 1, side & 1);
-		DrawEdge(v0, v2, dv[1], orientation & 2, side & 2);
-		DrawEdge(v1, v2, dv[2], orientation & 4, side & 4);
-
-		Flush(vertex, index, GSVertexSW::zero(), true);
-	}
+	return true;
 }
 
-void GSRasterizer::DrawTriangleSection(int top, int bottom, GSVertexSW& edge, const GSVertexSW& dedge, const GSVertexSW& dscan, const GSVector4& p0)
+void GSRasterizer::DrawTriangleSection(int top, int bottom, const GSVertexSW& edge, const GSVertexSW& dedge, const GSVertexSW& dscan, const GSVector4& p0)
 {
 	ASSERT(top < bottom);
 	ASSERT(edge.p.x <= edge.p.y);
@@ -718,8 +879,6 @@ void GSRasterizer::DrawTriangleSection(int top, int bottom, GSVertexSW& edge, co
 
 	GSVector4 scissor = m_fscissor_x;
 
-	top = FindMyNextScanline(top);
-
 	while(top < bottom)
 	{
 		GSVector4 dy = GSVector4(top) - p0.yyyy();
@@ -753,17 +912,78 @@ void GSRasterizer::DrawTriangleSection(int top, int bottom, GSVertexSW& edge, co
 		}
 
 		top++;
+	}
 
-		if(!IsOneOfMyScanlines(top))
+	m_edge.count += e - &m_edge.buff[m_edge.count];
+}
+
+#endif
+
+void GSRasterizer::DrawTriangle(const GSVertexSW* vertex, const u32* index)
+{
+	TriangleSetup ts;
+
+	if(SetupTriangle(vertex, index, ts))
+	{
+		DrawTriangle(ts, vertex, index);
+	}
+}
+
+void GSRasterizer::DrawTriangle(const TriangleSetup& ts, const GSVertexSW* vertex, const u32* index)
+{
+	for(int j = 0; j < 2; j++)
+	{
+		int top = std::max<int>(ts.top[j], m_band.top);
+		int bottom = std::min<int>(ts.bottom[j], m_band.bottom);
+
+		if(top < bottom)
 		{
-			top += (m_threads - 1) << m_thread_height;
+			DrawTriangleSection(top, bottom, ts.edge[j], ts.dedge[j], ts.dscan, ts.p0[j]);
 		}
 	}
 
-	m_edge.count += e - &m_edge.buff[m_edge.count];
+	Flush(vertex, index, (const GSVertexSW&)ts.dscan);
+
+	if(m_ds->HasEdge())
+	{
+		DrawTriangleEdge(vertex, index, ts.i);
+	}
 }
 
-#endif
+void GSRasterizer::DrawTriangleEdge(const GSVertexSW* vertex, const u32* index, const int* i)
+{
+	const GSVertexSW& v0 = vertex[i[0]];
+	const GSVertexSW& v1 = vertex[i[1]];
+	const GSVertexSW& v2 = vertex[i[2]];
+
+	GSVertexSW dv[3];
+
+	dv[0] = v1 - v0;
+	dv[1] = v2 - v0;
+	dv[2] = v2 - v1;
+
+	GSVector4 cross = dv[0].p * dv[1].p.yxwz();
+
+	cross = (cross - cross.yxwz()).yyyy(); // select the second component, the negated cross product
+
+	GSVector4 dxy01 = dv[0].p.xyxy(dv[1].p);
+
+	GSVector4 dx = dxy01.xzxy(dv[2].p);
+	GSVector4 dy = dxy01.ywyx(dv[2].p);
+
+	GSVector4 a = dx.abs() < dy.abs(); // |dx| <= |dy|
+	GSVector4 b = dx < GSVector4::zero(); // dx < 0
+	GSVector4 c = cross < GSVector4::zero(); // longest.p.x < 0
+
+	int orientation = a.mask();
+	int side = ((a | b) ^ c).mask() ^ 2; // evil
+
+	DrawEdge(v0, v1, dv[0], orientation & 1, side & 1);
+	DrawEdge(v0, v2, dv[1], orientation & 2, side & 2);
+	DrawEdge(v1, v2, dv[2], orientation & 4, side & 4);
+
+	Flush(vertex, index, GSVertexSW::zero(), true);
+}
 
 void GSRasterizer::DrawSprite(const GSVertexSW* vertex, const u32* index)
 {
@@ -791,7 +1011,10 @@ void GSRasterizer::DrawSprite(const GSVertexSW* vertex, const u32* index)
 
 	if(m_ds->IsSolidRect())
 	{
-		if(m_threads == 1)
+		r.top = std::max<int>(r.top, m_band.top);
+		r.bottom = std::min<int>(r.bottom, m_band.bottom);
+
+		if(r.top < r.bottom)
 		{
 			m_ds->DrawRect(r, scan);
 
@@ -800,26 +1023,6 @@ void GSRasterizer::DrawSprite(const GSVertexSW* vertex, const u32* index)
 			m_pixels.actual += pixels;
 			m_pixels.total += pixels;
 		}
-		else
-		{
-			int top = FindMyNextScanline(r.top);
-			int bottom = r.bottom;
-
-			while(top < bottom)
-			{
-				r.top = top;
-				r.bottom = std::min<int>((top + (1 << m_thread_height)) & ~((1 << m_thread_height) - 1), bottom);
-
-				m_ds->DrawRect(r, scan);
-
-				int pixels = r.width() * r.height();
-
-				m_pixels.actual += pixels;
-				m_pixels.total += pixels;
-
-				top = r.bottom + ((m_threads - 1) << m_thread_height);
-			}
-		}
 
 		return;
 	}
@@ -841,6 +1044,38 @@ void GSRasterizer::DrawSprite(const GSVertexSW* vertex, const u32* index)
 	if((m & 2) == 0) scan.t += dedge.t * prestep.yyyy();
 	if((m & 1) == 0) scan.t += dscan.t * prestep.xxxx();
 
+	// keep stepping from the top of the sprite, so every band sees the same texture coordinates
+
+	int bottom = std::min<int>(r.bottom, m_band.bottom);
+
+	if(r.top >= bottom) return;
+
+	if(m_ds->IsCopyRect() && ((dt == GSVector4(65536.0f)).mask() & 3) == 3)
+	{
+		// one texel per pixel, the texture rows can be copied without the scanline code
+
+		GSVertexSW copy = scan;
+
+		int top = r.top;
+
+		for(; top < m_band.top && top < bottom; top++)
+		{
+			copy.t += dedge.t;
+		}
+
+		if(top >= bottom) return;
+
+		if(m_ds->DrawCopy(GSVector4i(r.left, top, r.right, bottom), copy))
+		{
+			int pixels = r.width() * (bottom - top);
+
+			m_pixels.actual += pixels;
+			m_pixels.total += pixels;
+
+			return;
+		}
+	}
+
 	m_ds->SetupPrim(vertex, index, dscan);
 
 	while(1)
@@ -850,7 +1085,7 @@ void GSRasterizer::DrawSprite(const GSVertexSW* vertex, const u32* index)
 			DrawScanline(r.width(), r.left, r.top, scan);
 		}
 
-		if(++r.top >= r.bottom) break;
+		if(++r.top >= bottom) break;
 
 		scan.t += dedge.t;
 	}
@@ -1131,68 +1366,141 @@ GSRasterizerList::GSRasterizerList(int threads)
 {
 	m_thread_height = compute_best_thread_height(threads);
 
-	int rows = (2048 >> m_thread_height) + 16;
-	m_scanline = (u8*)_aligned_malloc(rows, 64);
+	int count = (2048 >> m_thread_height) + 1;
 
-	int row = 0;
+	m_bands = std::unique_ptr<Band[]>(new Band[count]);
 
-	while(row < rows)
+	for(int i = 0; i < count; i++)
 	{
-		for(int i = 0; i < threads; i++, row++)
-		{
-			m_scanline[row] = (u8)i;
-		}
+		m_bands[i].scheduled = false;
 	}
 }
 
 GSRasterizerList::~GSRasterizerList()
 {
-	_aligned_free(m_scanline);
+	Sync();
+
+	m_workers.reset();
 }
 
-void GSRasterizerList::Queue(const std::shared_ptr<GSRasterizerData>& data)
+void GSRasterizerList::DrawBand(int id, int band)
+{
+	GSRasterizer* r = m_r[id].get();
+	Band& b = m_bands[band];
+
+	while(true)
+	{
+		GSRasterizerData* data;
+
+		while(b.queue.pop(data))
+		{
+			r->Draw(data, band);
+
+			data->Release();
+		}
+
+		// Queue() pushes before it looks at the flag, check again after dropping it
+
+		b.scheduled.store(false);
+
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		if(b.queue.empty() || b.scheduled.exchange(true))
+		{
+			break;
+		}
+	}
+}
+
+void GSRasterizerList::Queue(GSRasterizerData* data)
 {
 	GSVector4i r = data->bbox.rintersect(data->scissor);
 
 	ASSERT(r.top >= 0 && r.top < 2048 && r.bottom >= 0 && r.bottom < 2048);
 
 	int top = r.top >> m_thread_height;
-	int bottom = std::min<int>((r.bottom + (1 << m_thread_height) - 1) >> m_thread_height, top + m_workers.size());
+	int bottom = (r.bottom + (1 << m_thread_height) - 1) >> m_thread_height;
 
-	while(top < bottom)
+	if(top >= bottom)
 	{
-		m_workers[m_scanline[top++]]->Push(data);
+		return;
+	}
+
+	data->bin_shift = m_thread_height;
+
+	if(bottom - top > 1 && data->GetPrimCount() > 1)
+	{
+		data->bin_first = top;
+		data->bin_count = bottom - top;
+		data->bin_state = GSRasterizerData::BinPending;
+	}
+
+	data->AddRef(bottom - top);
+
+	int threads = (int)m_r.size();
+	bool pushed = false;
+
+	for(int i = top; i < bottom; i++)
+	{
+		Band& b = m_bands[i];
+
+		while(!b.queue.push(data))
+		{
+			m_workers->Wake();
+
+			std::this_thread::yield();
+		}
+
+		if(!b.scheduled.exchange(true))
+		{
+			m_workers->Push(i, i % threads);
+
+			pushed = true;
+		}
+	}
+
+	if(pushed)
+	{
+		m_workers->Wake();
 	}
 }
 
 void GSRasterizerList::Sync()
 {
-	if(!IsSynced())
-	{
-		for(size_t i = 0; i < m_workers.size(); i++)
-			m_workers[i]->Wait();
-	}
+	m_workers->Wait();
 }
 
 bool GSRasterizerList::IsSynced() const
 {
-	for(size_t i = 0; i < m_workers.size(); i++)
-	{
-		if(!m_workers[i]->IsEmpty())
-			return false;
-	}
-
-	return true;
+	return m_workers->IsEmpty();
 }
 
 int GSRasterizerList::GetPixels(bool reset)
 {
 	int pixels = 0;
 
-	for(size_t i = 0; i < m_workers.size(); i++)
+	for(size_t i = 0; i < m_r.size(); i++)
 	{
 		pixels += m_r[i]->GetPixels(reset);
 	}
 
 	return pixels;
 }
+
+void GSRasterizerList::GetSelectors(std::set<u64>& ds, std::set<u64>& sp)
+{
+	for(size_t i = 0; i < m_r.size(); i++)
+	{
+		m_r[i]->GetSelectors(ds, sp);
+	}
+}
+
+void GSRasterizerList::PrepareSelectors(const std::set<u64>& ds, const std::set<u64>& sp)
+{
+	// any worker may pick up any band, so each one needs the code
+
+	for(size_t i = 0; i < m_r.size(); i++)
+	{
+		m_r[i]->PrepareSelectors(ds, sp);
+	}
+}
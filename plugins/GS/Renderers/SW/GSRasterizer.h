@@ -27,11 +27,16 @@
 #include "GSVertexSW.h"
 #include "../../GSAlignedClass.h"
 #include "../../GSThread_CXX11.h"
+#include "Utilities/boost_spsc_queue.hpp"
+
+#include <set>
 
 class alignas(32) GSRasterizerData : public GSAlignedClass<32>
 {
 	static int s_counter;
 
+	std::atomic<int> m_refs;
+
 public:
 	GSVector4i scissor;
 	GSVector4i bbox;
@@ -45,8 +50,23 @@ public:
 	int pixels;
 	int counter;
 
+	// Band binning for GSRasterizerList. The list decides whether a draw is
+	// worth binning when it is queued; the first worker to reach the draw then
+	// does the primitive setup and fills the bins (GSRasterizer::Bin).
+
+	enum {BinNone, BinPending, BinRunning, BinDone};
+
+	std::atomic<int> bin_state;
+	int bin_shift; // log2 of the band height
+	int bin_first; // first band covered by bbox & scissor
+	int bin_count;
+	u8* bin_setup; // GSRasterizer::TriangleSetup for each triangle
+	u32* bin_offset; // bin_count + 1 offsets into bin_prim
+	u32* bin_prim; // primitive numbers of each band, in submission order
+
 	GSRasterizerData() 
-		: scissor(GSVector4i::zero())
+		: m_refs(1)
+		, scissor(GSVector4i::zero())
 		, bbox(GSVector4i::zero())
 		, primclass(GS_INVALID_CLASS)
 		, buff(NULL)
@@ -56,6 +76,13 @@ public:
 		, index_count(0)
 		, frame(0)
 		, pixels(0)
+		, bin_state(BinNone)
+		, bin_shift(11)
+		, bin_first(0)
+		, bin_count(0)
+		, bin_setup(NULL)
+		, bin_offset(NULL)
+		, bin_prim(NULL)
 	{
 		counter = s_counter++;
 	}
@@ -63,6 +90,33 @@ public:
 	virtual ~GSRasterizerData() 
 	{
 		if(buff != NULL) _aligned_free(buff);
+		if(bin_setup != NULL) _aligned_free(bin_setup);
+		if(bin_offset != NULL) _aligned_free(bin_offset);
+		if(bin_prim != NULL) _aligned_free(bin_prim);
+	}
+
+	// The creator holds the first reference, GSRasterizerList adds one per band.
+
+	void AddRef(int n = 1)
+	{
+		m_refs.fetch_add(n, std::memory_order_relaxed);
+	}
+
+	void Release()
+	{
+		if(m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			delete this;
+		}
+	}
+
+	int GetPrimCount() const
+	{
+		static const int s_prim_vertices[] = {1, 2, 3, 2};
+
+		int n = s_prim_vertices[primclass];
+
+		return (index != NULL ? index_count : vertex_count) / n;
 	}
 };
 
@@ -72,28 +126,35 @@ public:
 	typedef void (*SetupPrimPtr)(const GSVertexSW* vertex, const u32* index, const GSVertexSW& dscan);
 	typedef void (__fastcall *DrawScanlinePtr)(int pixels, int left, int top, const GSVertexSW& scan);
 	typedef void (IDrawScanline::*DrawRectPtr)(const GSVector4i& r, const GSVertexSW& v); // TODO: jit
+	typedef bool (IDrawScanline::*DrawCopyPtr)(const GSVector4i& r, const GSVertexSW& scan);
 
 protected:
 	SetupPrimPtr m_sp;
 	DrawScanlinePtr m_ds;
 	DrawScanlinePtr m_de;
 	DrawRectPtr m_dr;
+	DrawCopyPtr m_dc;
 
 public:
-	IDrawScanline() : m_sp(NULL), m_ds(NULL), m_de(NULL), m_dr(NULL) {}
+	IDrawScanline() : m_sp(NULL), m_ds(NULL), m_de(NULL), m_dr(NULL), m_dc(NULL) {}
 	virtual ~IDrawScanline() {}
 
 	virtual void BeginDraw(const GSRasterizerData* data) = 0;
 	virtual void EndDraw(u64 frame, int actual, int total) = 0;
 
+	// selectors that already have code, and generating code ahead of the draw that needs it
+	virtual void GetSelectors(std::set<u64>& ds, std::set<u64>& sp) {}
+	virtual void PrepareSelectors(const std::set<u64>& ds, const std::set<u64>& sp) {}
+
 	__forceinline void SetupPrim(const GSVertexSW* vertex, const u32* index, const GSVertexSW& dscan) {m_sp(vertex, index, dscan);}
 	__forceinline void DrawScanline(int pixels, int left, int top, const GSVertexSW& scan) {m_ds(pixels, left, top, scan);}
 	__forceinline void DrawEdge(int pixels, int left, int top, const GSVertexSW& scan) {m_de(pixels, left, top, scan);}
 	__forceinline void DrawRect(const GSVector4i& r, const GSVertexSW& v) {(this->*m_dr)(r, v);}
-
+	__forceinline bool DrawCopy(const GSVector4i& r, const GSVertexSW& scan) {return (this->*m_dc)(r, scan);}
 
 	__forceinline bool HasEdge() const {return m_de != NULL;}
 	__forceinline bool IsSolidRect() const {return m_dr != NULL;}
+	__forceinline bool IsCopyRect() const {return m_dc != NULL;}
 };
 
 class IRasterizer : public GSAlignedClass<32>
@@ -101,20 +162,31 @@ class IRasterizer : public GSAlignedClass<32>
 public:
 	virtual ~IRasterizer() {}
 
-	virtual void Queue(const std::shared_ptr<GSRasterizerData>& data) = 0;
+	virtual void Queue(GSRasterizerData* data) = 0;
 	virtual void Sync() = 0;
 	virtual bool IsSynced() const = 0;
 	virtual int GetPixels(bool reset = true) = 0;
+	virtual void GetSelectors(std::set<u64>& ds, std::set<u64>& sp) = 0;
+	virtual void PrepareSelectors(const std::set<u64>& ds, const std::set<u64>& sp) = 0;
 };
 
 class alignas(32) GSRasterizer : public IRasterizer
 {
 protected:
+	struct alignas(32) TriangleSetup
+	{
+		#if _M_SSE >= 0x501
+		GSVertexSW2 edge[2], dedge[2], dscan;
+		#else
+		GSVertexSW edge[2], dedge[2], dscan;
+		#endif
+		GSVector4 p0[2];
+		int top[2], bottom[2]; // empty section if top >= bottom
+		int i[3]; // y sorted, for the aa1 edges
+	};
+
 	IDrawScanline* m_ds;
-	int m_id;
-	int m_threads;
-	int m_thread_height;
-	u8* m_scanline;
+	struct {int top, bottom;} m_band;
 	GSVector4i m_scissor;
 	GSVector4 m_fscissor_x;
 	GSVector4 m_fscissor_y;
@@ -127,12 +199,16 @@ protected:
 	void DrawPoint(const GSVertexSW* vertex, int vertex_count, const u32* index, int index_count);
 	void DrawLine(const GSVertexSW* vertex, const u32* index);
 	void DrawTriangle(const GSVertexSW* vertex, const u32* index);
+	void DrawTriangle(const TriangleSetup& ts, const GSVertexSW* vertex, const u32* index);
+	void DrawTriangleEdge(const GSVertexSW* vertex, const u32* index, const int* i);
 	void DrawSprite(const GSVertexSW* vertex, const u32* index);
 
+	bool SetupTriangle(const GSVertexSW* vertex, const u32* index, TriangleSetup& RESTRICT ts);
+
 	#if _M_SSE >= 0x501
-	__forceinline void DrawTriangleSection(int top, int bottom, GSVertexSW2& edge, const GSVertexSW2& dedge, const GSVertexSW2& dscan, const GSVector4& p0);
+	__forceinline void DrawTriangleSection(int top, int bottom, const GSVertexSW2& edge, const GSVertexSW2& dedge, const GSVertexSW2& dscan, const GSVector4& p0);
 	#else
-	__forceinline void DrawTriangleSection(int top, int bottom, GSVertexSW& edge, const GSVertexSW& dedge, const GSVertexSW& dscan, const GSVector4& p0);
+	__forceinline void DrawTriangleSection(int top, int bottom, const GSVertexSW& edge, const GSVertexSW& dedge, const GSVertexSW& dscan, const GSVector4& p0);
 	#endif
 
 	void DrawEdge(const GSVertexSW& v0, const GSVertexSW& v1, const GSVertexSW& dv, int orientation, int side);
@@ -143,37 +219,54 @@ protected:
 	__forceinline void DrawScanline(int pixels, int left, int top, const GSVertexSW& scan);
 	__forceinline void DrawEdge(int pixels, int left, int top, const GSVertexSW& scan);
 
+	void Bin(GSRasterizerData* data);
+	void DrawBin(GSRasterizerData* data, int band);
+
 public:
-	GSRasterizer(IDrawScanline* ds, int id, int threads);
+	GSRasterizer(IDrawScanline* ds);
 	virtual ~GSRasterizer();
 
 	__forceinline bool IsOneOfMyScanlines(int top) const;
-	__forceinline bool IsOneOfMyScanlines(int top, int bottom) const;
-	__forceinline int FindMyNextScanline(int top) const;
 
-	void Draw(GSRasterizerData* data);
+	// band < 0 draws every scanline, otherwise only the rows of that band
+	void Draw(GSRasterizerData* data, int band = -1);
 
 	// IRasterizer
 
-	void Queue(const std::shared_ptr<GSRasterizerData>& data);
+	void Queue(GSRasterizerData* data);
 	void Sync() {}
 	bool IsSynced() const {return true;}
 	int GetPixels(bool reset);
+	void GetSelectors(std::set<u64>& ds, std::set<u64>& sp) {m_ds->GetSelectors(ds, sp);}
+	void PrepareSelectors(const std::set<u64>& ds, const std::set<u64>& sp) {m_ds->PrepareSelectors(ds, sp);}
 };
 
+// Splits the screen into bands of 1 << extrathreads_height scanlines. A draw
+// is appended to the queue of every band it covers, and a band with pending
+// draws is handed to the worker pool as a single item. The worker holding a
+// band drains its queue in order, so a band is never drawn by two threads at
+// once and the draws that touch it keep their order.
 class GSRasterizerList : public IRasterizer
 {
 protected:
-	using GSWorker = GSJobQueue<std::shared_ptr<GSRasterizerData>, 65536>;
+	struct alignas(64) Band
+	{
+		ringbuffer_base<GSRasterizerData*, 1024> queue;
+		std::atomic<bool> scheduled; // owned by the pool until the queue is drained
+	};
+
+	using GSWorkers = GSWorkerPool<int, 2048>;
 
 	// Worker threads depend on the rasterizers, so don't change the order.
 	std::vector<std::unique_ptr<GSRasterizer>> m_r;
-	std::vector<std::unique_ptr<GSWorker>> m_workers;
-	u8* m_scanline;
+	std::unique_ptr<Band[]> m_bands;
+	std::unique_ptr<GSWorkers> m_workers;
 	int m_thread_height;
 
 	GSRasterizerList(int threads);
 
+	void DrawBand(int id, int band);
+
 public:
 	virtual ~GSRasterizerList();
 
@@ -183,26 +276,27 @@ public:
 
 		if(threads == 0)
 		{
-			return new GSRasterizer(new DS(), 0, 1);
+			return new GSRasterizer(new DS());
 		}
 
 		GSRasterizerList* rl = new GSRasterizerList(threads);
 
 		for(int i = 0; i < threads; i++)
 		{
-			rl->m_r.push_back(std::unique_ptr<GSRasterizer>(new GSRasterizer(new DS(), i, threads)));
-			auto &r = *rl->m_r[i];
-			rl->m_workers.push_back(std::unique_ptr<GSWorker>(new GSWorker(
-				[&r](std::shared_ptr<GSRasterizerData> &item) { r.Draw(item.get()); })));
+			rl->m_r.push_back(std::unique_ptr<GSRasterizer>(new GSRasterizer(new DS())));
 		}
 
+		rl->m_workers = std::unique_ptr<GSWorkers>(new GSWorkers(threads, [rl](int id, int& band) { rl->DrawBand(id, band); }));
+
 		return rl;
 	}
 
 	// IRasterizer
 
-	void Queue(const std::shared_ptr<GSRasterizerData>& data);
+	void Queue(GSRasterizerData* data);
 	void Sync();
 	bool IsSynced() const;
 	int GetPixels(bool reset);
+	void GetSelectors(std::set<u64>& ds, std::set<u64>& sp);
+	void PrepareSelectors(const std::set<u64>& ds, const std::set<u64>& sp);
 };
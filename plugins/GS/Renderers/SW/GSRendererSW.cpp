@@ -22,6 +22,7 @@
 #include "Pcsx2Types.h"
 
 #include "GSRendererSW.h"
+#include "options_tools.h"
 
 GSVector4 GSRendererSW::m_pos_scale;
 #if _M_SSE >= 0x501
@@ -45,11 +46,15 @@ GSRendererSW::GSRendererSW(int threads)
 	m_tc = new GSTextureCacheSW(this);
 
 	memset(m_texture, 0, sizeof(m_texture));
+	m_texture_host = false;
 
 	m_rl = GSRasterizerList::Create<GSDrawScanline>(threads);
 
 	m_output = (u8*)_aligned_malloc(1024 * 1024 * sizeof(u32), 32);
 
+	m_output_sw = theApp.GetConfigB("sw_merge_cpu") ? new GSOutputSW() : NULL;
+	m_frame = NULL;
+
 	for (u32 i = 0; i < countof(m_fzb_pages); i++) {
 		m_fzb_pages[i] = 0;
 	}
@@ -57,6 +62,8 @@ GSRendererSW::GSRendererSW(int threads)
 		m_tex_pages[i] = 0;
 	}
 
+	memset(&m_sync_stats, 0, sizeof(m_sync_stats));
+
 	#define InitCVB2(P, Q) \
 		m_cvb[P][0][0][Q] = &GSRendererSW::ConvertVertexBuffer<P, 0, 0, Q>; \
 		m_cvb[P][0][1][Q] = &GSRendererSW::ConvertVertexBuffer<P, 0, 1, Q>; \
@@ -82,6 +89,28 @@ GSRendererSW::GSRendererSW(int threads)
 
 GSRendererSW::~GSRendererSW()
 {
+	for(int i = 0; i < SyncStats::Reasons; i++)
+	{
+		if(m_sync_stats.count[i] == 0) continue;
+
+		std::string hist;
+
+		for(int j = 0; j < SyncStats::Buckets; j++)
+		{
+			hist += " " + std::to_string(m_sync_stats.hist[i][j]);
+		}
+
+		log_cb(RETRO_LOG_INFO, "GSdx: SW sync reason %d: %llu stalls, %.3f ms, log2 us histogram:%s\n",
+			i - 1, (unsigned long long)m_sync_stats.count[i], m_sync_stats.stall_us[i] / 1000.0, hist.c_str());
+	}
+
+	if(m_prepare.joinable())
+	{
+		m_prepare.join();
+	}
+
+	SaveSelectors();
+
 	delete m_tc;
 
 	for(size_t i = 0; i < countof(m_texture); i++)
@@ -89,11 +118,146 @@ GSRendererSW::~GSRendererSW()
 		delete m_texture[i];
 	}
 
+	delete m_frame;
+	delete m_output_sw;
+
 	delete m_rl;
 
 	_aligned_free(m_output);
 }
 
+void GSRendererSW::SetGameCRC(u32 crc, int options)
+{
+	bool changed = crc != m_crc;
+
+	if(changed)
+	{
+		if(m_prepare.joinable())
+		{
+			m_prepare.join();
+		}
+
+		SaveSelectors();
+	}
+
+	GSRenderer::SetGameCRC(crc, options);
+
+	if(changed)
+	{
+		LoadSelectors();
+	}
+}
+
+// The scanline and setup-prim selectors a game ends up using are saved per CRC. When
+// the game is started again their code is generated on a separate thread right away,
+// rather than stalling the first draw that needs each of them. Only the selectors
+// are kept, the generated code has the address of its GSDrawScanline baked in.
+
+static const u32 s_selectors_magic = 0x4b4a5347; // "GSJK"
+static const u32 s_selectors_version = 1; // bump when the GSScanlineSelector bits change
+
+std::string GSRendererSW::GetSelectorsPath() const
+{
+	const char* save_dir = nullptr;
+
+	if(m_crc == 0 || !environ_cb(RETRO_ENVIRONMENT_GET_SAVE_DIRECTORY, &save_dir) || !save_dir)
+	{
+		return std::string();
+	}
+
+	return format("%s/gs_jit_%08X.bin", save_dir, m_crc);
+}
+
+void GSRendererSW::LoadSelectors()
+{
+	std::string path = GetSelectorsPath();
+
+	if(path.empty())
+	{
+		return;
+	}
+
+	FILE* fp = fopen(path.c_str(), "rb");
+
+	if(fp == NULL)
+	{
+		return;
+	}
+
+	u32 header[4]; // magic, version, scanline count, setup-prim count
+	std::vector<u64> keys;
+
+	bool ok = fread(header, sizeof(header), 1, fp) == 1
+		&& header[0] == s_selectors_magic
+		&& header[1] == s_selectors_version
+		&& header[2] <= 0x10000 && header[3] <= 0x10000;
+
+	if(ok)
+	{
+		keys.resize(header[2] + header[3]);
+
+		ok = fread(keys.data(), sizeof(u64), keys.size(), fp) == keys.size();
+	}
+
+	fclose(fp);
+
+	if(!ok)
+	{
+		log_cb(RETRO_LOG_WARN, "GSdx: ignoring %s\n", path.c_str());
+
+		return;
+	}
+
+	std::set<u64> ds(keys.begin(), keys.begin() + header[2]);
+	std::set<u64> sp(keys.begin() + header[2], keys.end());
+
+	log_cb(RETRO_LOG_INFO, "GSdx: preparing %d scanline and %d setup functions\n", (int)ds.size(), (int)sp.size());
+
+	m_prepare = std::thread([this, ds, sp]() { m_rl->PrepareSelectors(ds, sp); });
+}
+
+void GSRendererSW::SaveSelectors()
+{
+	std::string path = GetSelectorsPath();
+
+	if(path.empty())
+	{
+		return;
+	}
+
+	std::set<u64> ds, sp;
+
+	m_rl->GetSelectors(ds, sp);
+
+	if(ds.empty())
+	{
+		return;
+	}
+
+	std::vector<u64> keys(ds.begin(), ds.end());
+
+	keys.insert(keys.end(), sp.begin(), sp.end());
+
+	u32 header[4] = {s_selectors_magic, s_selectors_version, (u32)ds.size(), (u32)sp.size()};
+
+	FILE* fp = fopen(path.c_str(), "wb");
+
+	if(fp == NULL)
+	{
+		return;
+	}
+
+	bool ok = fwrite(header, sizeof(header), 1, fp) == 1
+		&& fwrite(keys.data(), sizeof(u64), keys.size(), fp) == keys.size();
+
+	fclose(fp);
+
+	if(!ok)
+	{
+		remove(path.c_str());
+	}
+}
+
 void GSRendererSW::Reset()
 {
 	Sync(-1);
@@ -105,7 +269,12 @@ void GSRendererSW::Reset()
 
 void GSRendererSW::VSync(int field)
 {
+	GSPerfMonAutoTimer pmat(m_perfmon);
+
 	Sync(0); // IncAge might delete a cached texture in use
+
+	m_perfmon.Put(GSPerfMon::Fillrate, m_rl->GetPixels()); // the threads are idle, their counters can be read
+
 	GSRenderer::VSync(field);
 	m_tc->IncAge();
 }
@@ -118,6 +287,10 @@ void GSRendererSW::ResetDevice()
 
 		m_texture[i] = NULL;
 	}
+
+	delete m_frame;
+
+	m_frame = NULL;
 }
 
 GSTexture* GSRendererSW::GetOutput(int i, int& y_offset)
@@ -131,7 +304,51 @@ GSTexture* GSRendererSW::GetOutput(int i, int& y_offset)
 
 	// TODO: round up bottom
 
-	if(m_dev->ResizeTexture(&m_texture[i], w, h))
+	// The feedback write is merged by the device (see MergeOutput), the textures have to
+	// be device ones for that frame
+
+	bool host = m_output_sw != NULL && !m_regs->EXTWRITE.WRITE;
+
+	if(host != m_texture_host)
+	{
+		for(size_t j = 0; j < countof(m_texture); j++)
+		{
+			delete m_texture[j];
+
+			m_texture[j] = NULL;
+		}
+
+		m_texture_host = host;
+	}
+
+	if(host)
+	{
+		// the output stays in host memory for MergeOutput, the height is padded for the
+		// block aligned read
+
+		GSVector2i size(w, (h + 31) & ~31);
+
+		if(m_texture[i] == NULL || m_texture[i]->GetSize() != size)
+		{
+			delete m_texture[i];
+
+			m_texture[i] = w > 0 && h > 0 ? new GSTextureSW(GSTexture::Texture, size.x, size.y) : NULL;
+		}
+
+		GSTexture::GSMap m;
+
+		if(m_texture[i] != NULL && m_texture[i]->Map(m))
+		{
+			GSVector4i r(0, 0, w, h);
+
+			const GSLocalMemory::psm_t& psm = GSLocalMemory::m_psm[DISPFB.PSM];
+
+			psm.rtx(m_mem, m_mem.GetOffset(DISPFB.Block(), DISPFB.FBW, DISPFB.PSM), r.ralign<Align_Outside>(psm.bs), m.bits, m.pitch, m_env.TEXA);
+
+			m_texture[i]->Unmap();
+		}
+	}
+	else if(m_dev->ResizeTexture(&m_texture[i], w, h))
 	{
 		static int pitch = 1024 * 4;
 
@@ -139,7 +356,7 @@ GSTexture* GSRendererSW::GetOutput(int i, int& y_offset)
 
 		const GSLocalMemory::psm_t& psm = GSLocalMemory::m_psm[DISPFB.PSM];
 
-		(m_mem.*psm.rtx)(m_mem.GetOffset(DISPFB.Block(), DISPFB.FBW, DISPFB.PSM), r.ralign<Align_Outside>(psm.bs), m_output, pitch, m_env.TEXA);
+		psm.rtx(m_mem, m_mem.GetOffset(DISPFB.Block(), DISPFB.FBW, DISPFB.PSM), r.ralign<Align_Outside>(psm.bs), m_output, pitch, m_env.TEXA);
 
 		m_texture[i]->Update(r, m_output, pitch);
 	}
@@ -147,6 +364,70 @@ GSTexture* GSRendererSW::GetOutput(int i, int& y_offset)
 	return m_texture[i];
 }
 
+bool GSRendererSW::MergeOutput(GSTexture* tex[3], GSVector4* src, GSVector4* dst, const GSVector2i& fs, const GSVector2i& ds, int field, int mode)
+{
+	// The feedback write (EXTWRITE) goes through the device path, it needs the merge
+	// result on the device to copy it back
+
+	if(m_output_sw == NULL || m_regs->EXTWRITE.WRITE)
+	{
+		return false;
+	}
+
+	// GetOutput has left the circuits in GSTextureSW, the rectangles are back in pixels
+	// (the software renderer does not scale).
+
+	GSOutputSW::Circuit c[2];
+
+	for(int i = 0; i < 2; i++)
+	{
+		c[i].tex = (GSTextureSW*)tex[i];
+
+		if(c[i].tex != NULL)
+		{
+			GSVector4i sr(src[i] * GSVector4(tex[i]->GetSize()).xyxy() + GSVector4(0.5f));
+
+			c[i].r = GSVector4i(dst[i] + GSVector4(0.5f));
+			c[i].src = GSVector2i(sr.x, sr.y);
+		}
+	}
+
+	GSVector2i size = m_output_sw->GetSize(fs, ds, mode);
+
+	if(size.x <= 0 || size.y <= 0 || !m_dev->ResizeTarget(&m_frame, size.x, size.y))
+	{
+		m_dev->SetCurrent(NULL);
+
+		return true;
+	}
+
+	const GSRegPMODE& PMODE = m_regs->PMODE;
+	const GSRegBGCOLOR& BGCOLOR = m_regs->BGCOLOR;
+
+	u32 bg = BGCOLOR.R | (BGCOLOR.G << 8) | (BGCOLOR.B << 16) | (PMODE.ALP << 24);
+
+	GSTexture::GSMap m;
+
+	if(m_frame->Map(m))
+	{
+		m_output_sw->Merge(c, fs, ds, PMODE, bg, field, mode, m.bits, m.pitch);
+
+		m_frame->Unmap();
+	}
+	else
+	{
+		m_frame_tmp.resize(size.x * size.y);
+
+		m_output_sw->Merge(c, fs, ds, PMODE, bg, field, mode, (u8*)m_frame_tmp.data(), size.x * sizeof(u32));
+
+		m_frame->Update(GSVector4i(0, 0, size.x, size.y), m_frame_tmp.data(), size.x * sizeof(u32));
+	}
+
+	m_dev->SetCurrent(m_frame);
+
+	return true;
+}
+
 GSTexture* GSRendererSW::GetFeedbackOutput()
 {
 	int dummy;
@@ -340,8 +621,6 @@ void GSRendererSW::Draw()
 
 	SharedData* sd = new SharedData(this);
 
-	std::shared_ptr<GSRasterizerData> data(sd);
-
 	sd->primclass = m_vt.m_primclass;
 	sd->buff = (u8*)_aligned_malloc(sizeof(GSVertexSW) * ((m_vertex.next + 1) & ~1) + sizeof(u32) * m_index.tail, 64);
 	sd->vertex = (GSVertexSW*)sd->buff;
@@ -377,7 +656,11 @@ void GSRendererSW::Draw()
 	sd->bbox    = bbox;
 
 	if(!GetScanlineGlobalData(sd))
+	{
+		sd->Release();
+
 		return;
+	}
 
 	//
 
@@ -396,19 +679,13 @@ void GSRendererSW::Draw()
 		zb_pages = m_context->offset.zb->GetPages(r);
 	}
 
-	// check if there is an overlap between this and previous targets
+	// wait for the queued draws whose targets overlap this one
 
-	if(CheckTargetPages(fb_pages, zb_pages, r))
-	{
-		sd->m_syncpoint = SharedData::SyncTarget;
-	}
+	CheckTargetPages(fb_pages, zb_pages, r);
 
-	// check if the texture is not part of a target currently in use
+	// wait for the queued draws still rendering into the texture
 
-	if(CheckSourcePages(sd))
-	{
-		sd->m_syncpoint = SharedData::SyncSource;
-	}
+	SyncSourcePages(sd);
 
 	// addref source and target pages
 
@@ -416,29 +693,19 @@ void GSRendererSW::Draw()
 
 	//
 
-	{
-		Queue(data);
-	}
+	Queue(sd);
+
+	sd->Release();
 }
 
-void GSRendererSW::Queue(std::shared_ptr<GSRasterizerData>& item)
+void GSRendererSW::Queue(GSRasterizerData* item)
 {
-	SharedData* sd = (SharedData*)item.get();
-
-	if(sd->m_syncpoint == SharedData::SyncSource) 
-	{
-		Sync(4);
-	}
+	SharedData* sd = (SharedData*)item;
 
 	// update previously invalidated parts
 
 	sd->UpdateSource();
 
-	if(sd->m_syncpoint == SharedData::SyncTarget)
-	{
-		Sync(5);
-	}
-
 	m_rl->Queue(item);
 
 	// invalidate new parts rendered onto
@@ -458,7 +725,57 @@ void GSRendererSW::Queue(std::shared_ptr<GSRasterizerData>& item)
 
 void GSRendererSW::Sync(int reason)
 {
+	if(m_rl->IsSynced()) return;
+
+	auto start = std::chrono::steady_clock::now();
+
 	m_rl->Sync();
+
+	AddSyncStats(reason, start);
+}
+
+bool GSRendererSW::SyncPages(const u32* pages, int reason, bool tex)
+{
+	// Page counters only go down while the GS thread waits here, so this is a fence on
+	// the queued draws that reference these pages. Later, unrelated draws keep running.
+
+	auto busy = [&](u32 page) {return m_fzb_pages[page] != 0 || (tex && m_tex_pages[page] != 0);};
+
+	const u32* p = pages;
+
+	while(*p != GSOffset::EOP && !busy(*p)) p++;
+
+	if(*p == GSOffset::EOP) return false;
+
+	auto start = std::chrono::steady_clock::now();
+
+	for(; *p != GSOffset::EOP; p++)
+	{
+		while(busy(*p))
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	AddSyncStats(reason, start);
+
+	return true;
+}
+
+void GSRendererSW::AddSyncStats(int reason, std::chrono::steady_clock::time_point start)
+{
+	u64 us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+	int i = reason + 1;
+	int j = 0;
+
+	while(j < SyncStats::Buckets - 1 && (us >> j) != 0) j++;
+
+	m_sync_stats.count[i]++;
+	m_sync_stats.stall_us[i] += us;
+	m_sync_stats.hist[i][j]++;
+
+	m_perfmon.Sync(reason);
 }
 
 void GSRendererSW::InvalidateVideoMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r)
@@ -471,15 +788,7 @@ void GSRendererSW::InvalidateVideoMem(const GIFRegBITBLTBUF& BITBLTBUF, const GS
 
 	if(!m_rl->IsSynced())
 	{
-		for(u32* RESTRICT p = m_tmp_pages; *p != GSOffset::EOP; p++)
-		{
-			if(m_fzb_pages[*p] | m_tex_pages[*p])
-			{
-				Sync(6);
-
-				break;
-			}
-		}
+		SyncPages(m_tmp_pages, 6, true);
 	}
 
 	m_tc->InvalidatePages(m_tmp_pages, off->psm); // if texture update runs on a thread and Sync(5) happens then this must come later
@@ -493,15 +802,7 @@ void GSRendererSW::InvalidateLocalMem(const GIFRegBITBLTBUF& BITBLTBUF, const GS
 
 		off->GetPages(r, m_tmp_pages);
 
-		for(u32* RESTRICT p = m_tmp_pages; *p != GSOffset::EOP; p++)
-		{
-			if(m_fzb_pages[*p])
-			{
-				Sync(7);
-
-				break;
-			}
-		}
+		SyncPages(m_tmp_pages, 7, false);
 	}
 }
 
@@ -690,13 +991,19 @@ bool GSRendererSW::CheckTargetPages(const u32* fb_pages, const u32* zb_pages, co
 		}
 	}
 
+	if(res)
+	{
+		if(fb_pages != NULL) SyncPages(fb_pages, 5, true);
+		if(zb_pages != NULL) SyncPages(zb_pages, 5, true);
+	}
+
 	if(!fb && fb_pages != NULL) delete [] fb_pages;
 	if(!zb && zb_pages != NULL) delete [] zb_pages;
 
 	return res;
 }
 
-bool GSRendererSW::CheckSourcePages(SharedData* sd)
+void GSRendererSW::SyncSourcePages(SharedData* sd)
 {
 	if(!m_rl->IsSynced())
 	{
@@ -704,21 +1011,11 @@ bool GSRendererSW::CheckSourcePages(SharedData* sd)
 		{
 			sd->m_tex[i].t->m_offset->GetPages(sd->m_tex[i].r, m_tmp_pages);
 
-			u32* pages = m_tmp_pages; // sd->m_tex[i].t->m_pages.n;
+			// TODO: 8H 4HL 4HH texture at the same place as the render target (24 bit, or 32-bit where the alpha channel is masked, Valkyrie Profile 2)
 
-			for(const u32* p = pages; *p != GSOffset::EOP; p++)
-			{
-				// TODO: 8H 4HL 4HH texture at the same place as the render target (24 bit, or 32-bit where the alpha channel is masked, Valkyrie Profile 2)
-
-				if(m_fzb_pages[*p]) // currently being drawn to? => sync
-				{
-					return true;
-				}
-			}
+			SyncPages(m_tmp_pages, 4, false); // currently being drawn to? => wait for those draws
 		}
 	}
-
-	return false;
 }
 
 #include "GSTextureSW.h"
@@ -1198,7 +1495,6 @@ GSRendererSW::SharedData::SharedData(GSRendererSW* parent)
 	, m_fpsm(0)
 	, m_zpsm(0)
 	, m_using_pages(false)
-	, m_syncpoint(SyncNone)
 {
 	m_tex[0].t = NULL;
 
@@ -23,8 +23,11 @@
 
 #include "Pcsx2Types.h"
 
+#include <chrono>
+
 #include "GSTextureCacheSW.h"
 #include "GSDrawScanline.h"
+#include "GSOutputSW.h"
 
 class GSRendererSW : public GSRenderer
 {
@@ -49,7 +52,6 @@ class GSRendererSW : public GSRenderer
 		int m_zpsm;
 		bool m_using_pages;
 		TextureLevel m_tex[7 + 1]; // NULL terminated
-		enum {SyncNone, SyncSource, SyncTarget} m_syncpoint;
 
 	public:
 		SharedData(GSRendererSW* parent);
@@ -73,23 +75,45 @@ protected:
 	IRasterizer* m_rl;
 	GSTextureCacheSW* m_tc;
 	GSTexture* m_texture[2];
+	bool m_texture_host; // m_texture[] are GSTextureSW read by MergeOutput
 	u8* m_output;
+	GSOutputSW* m_output_sw; // NULL when the device merges the output
+	GSTexture* m_frame;
+	std::vector<u32> m_frame_tmp;
 	GSPixelOffset4* m_fzb;
 	GSVector4i m_fzb_bbox;
 	u32 m_fzb_cur_pages[16];
 	std::atomic<u32> m_fzb_pages[512]; // uint16 frame/zbuf pages interleaved
 	std::atomic<u16> m_tex_pages[512];
 	u32 m_tmp_pages[512 + 1];
+	std::thread m_prepare;
+
+public:
+	struct SyncStats
+	{
+		enum {Reasons = 9, Buckets = 16}; // reason -1 .. 7, log2 microseconds
+
+		u64 count[Reasons];
+		u64 stall_us[Reasons];
+		u64 hist[Reasons][Buckets]; // [n] counts stalls of 2^(n-1) to 2^n us, the last one is open ended
+	};
+
+protected:
+	SyncStats m_sync_stats;
+
+	void AddSyncStats(int reason, std::chrono::steady_clock::time_point start);
 
 	void Reset();
 	void VSync(int field);
 	void ResetDevice();
 	GSTexture* GetOutput(int i, int& y_offset);
 	GSTexture* GetFeedbackOutput();
+	bool MergeOutput(GSTexture* tex[3], GSVector4* src, GSVector4* dst, const GSVector2i& fs, const GSVector2i& ds, int field, int mode);
 
 	void Draw();
-	void Queue(std::shared_ptr<GSRasterizerData>& item);
+	void Queue(GSRasterizerData* item);
 	void Sync(int reason);
+	bool SyncPages(const u32* pages, int reason, bool tex);
 	void InvalidateVideoMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r);
 	void InvalidateLocalMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r, bool clut = false);
 
@@ -97,13 +121,21 @@ protected:
 	void ReleasePages(const u32* pages, const int type);
 
 	bool CheckTargetPages(const u32* fb_pages, const u32* zb_pages, const GSVector4i& r);
-	bool CheckSourcePages(SharedData* sd);
+	void SyncSourcePages(SharedData* sd);
 
 	bool GetScanlineGlobalData(SharedData* data);
 
+	std::string GetSelectorsPath() const;
+	void LoadSelectors();
+	void SaveSelectors();
+
 public:
 	static void InitVectors();
 
+	const SyncStats& GetSyncStats() const {return m_sync_stats;}
+
 	GSRendererSW(int threads);
 	virtual ~GSRendererSW();
+
+	void SetGameCRC(u32 crc, int options);
 };
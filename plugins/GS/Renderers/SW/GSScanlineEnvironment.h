@@ -111,6 +111,26 @@ union GSScanlineSelector
 			&& fge == 0;
 	}
 
+	bool IsCopyRect() const
+	{
+		return prim == GS_SPRITE_CLASS
+			&& iip == 0
+			&& (tfx == TFX_DECAL || tfx == TFX_MODULATE)
+			&& fst == 1
+			&& ltf == 0
+			&& tlu == 0
+			&& mmin == 0
+			&& wms <= CLAMP_CLAMP
+			&& wmt <= CLAMP_CLAMP
+			&& abe == 0
+			&& ztst <= 1
+			&& zclamp == 0
+			&& atst <= 1
+			&& date == 0
+			&& fge == 0
+			&& !(fpsm == 2 && dthe);
+	}
+
 	void Print() const
 	{
 		fprintf(stderr, "fpsm:%d zpsm:%d ztst:%d ztest:%d atst:%d afail:%d iip:%d rfb:%d fb:%d zb:%d zw:%d "
@@ -23,6 +23,8 @@
 
 GSTextureCacheSW::GSTextureCacheSW(GSState* state)
 	: m_state(state)
+	, m_words(0)
+	, m_psm_used(0)
 {
 }
 
@@ -31,25 +33,31 @@ GSTextureCacheSW::~GSTextureCacheSW()
 	RemoveAll();
 }
 
-GSTextureCacheSW::Texture* GSTextureCacheSW::Lookup(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, u32 tw0)
+u64 GSTextureCacheSW::Key(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA)
 {
-	const GSLocalMemory::psm_t& psm = GSLocalMemory::m_psm[TEX0.PSM];
+	u64 key = TEX0.U64 & 0x3ffffffffull; // TBP0 TBW PSM TW TH
 
-	auto& m = m_map[TEX0.TBP0 >> 5];
+	const GSLocalMemory::psm_t& psm = GSLocalMemory::m_psm[TEX0.PSM];
 
-	for(auto i = m.begin(); i != m.end(); ++i)
+	if((psm.trbpp == 16 || psm.trbpp == 24) && TEX0.TCC)
 	{
-		Texture* t = *i;
+		key |= ((u64)TEXA.TA0 << 34) | ((u64)TEXA.AEM << 42) | ((u64)TEXA.TA1 << 43) | (1ull << 51);
+	}
 
-		if(((TEX0.U32[0] ^ t->m_TEX0.U32[0]) | ((TEX0.U32[1] ^ t->m_TEX0.U32[1]) & 3)) != 0) // TBP0 TBW PSM TW TH
-		{
-			continue;
-		}
+	return key;
+}
 
-		if((psm.trbpp == 16 || psm.trbpp == 24) && TEX0.TCC && TEXA != t->m_TEXA)
-		{
-			continue;
-		}
+GSTextureCacheSW::Texture* GSTextureCacheSW::Lookup(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, u32 tw0)
+{
+	u64 key = Key(TEX0, TEXA);
+
+	Texture*& head = m_index[key];
+
+	// tw0 == 0 takes a texture of any width
+
+	for(Texture** link = &head; *link != NULL; link = &(*link)->m_next)
+	{
+		Texture* t = *link;
 
 		if(tw0 != 0 && t->m_tw != tw0)
 		{
@@ -57,88 +65,254 @@ GSTextureCacheSW::Texture* GSTextureCacheSW::Lookup(const GIFRegTEX0& TEX0, cons
 		}
 
 		// Lookup hit
-		m.MoveFront(i.Index());
+		m_state->m_perfmon.Put(GSPerfMon::TextureHit);
+
+		*link = t->m_next;
+		t->m_next = head;
+		head = t;
+
+		Validate(t);
 		t->m_age = 0;
 		return t;
 	}
 
 	// Lookup miss
+	m_state->m_perfmon.Put(GSPerfMon::TextureMiss);
+
 	Texture* t = new Texture(m_state, tw0, TEX0, TEXA);
 
-	m_textures.insert(t);
+	if(m_free_slots.empty())
+	{
+		Grow();
+	}
+
+	t->m_key = key;
+	t->m_next = head;
+	t->m_slot = m_free_slots.back();
+
+	m_free_slots.pop_back();
+
+	m_slots[t->m_slot] = t;
+	head = t;
+
+	const u32 w = t->m_slot >> 6;
+	const u64 bit = 1ull << (t->m_slot & 63);
 
 	for(const u32* p = t->m_pages.n; *p != GSOffset::EOP; p++)
 	{
-		const u32 page = *p;
-		t->m_erase_it[page] = m_map[page].InsertFront(t);
+		m_page_tex[*p * m_words + w] |= bit;
 	}
 
+	m_psm_tex[TEX0.PSM * m_words + w] |= bit;
+	m_psm_used |= 1ull << TEX0.PSM;
+
 	return t;
 }
 
 void GSTextureCacheSW::InvalidatePages(const u32* pages, u32 psm)
 {
-	for(const u32* p = pages; *p != GSOffset::EOP; p++)
+	// the textures sharing bits with psm, then every page marks all of its textures at once
+
+	u64* RESTRICT mask = m_mask.data();
+
+	u64 any = 0;
+
+	for(u32 i = 0; i < m_words; i++)
 	{
-		const u32 page = *p;
-		
-		for(Texture* t : m_map[page])
+		mask[i] = 0;
+	}
+
+	for(u32 k = 0; k < 2; k++)
+	{
+		u32 used = (u32)(m_psm_used >> (k * 32));
+
+		unsigned long j;
+
+		while(_BitScanForward(&j, used))
 		{
-			if(GSUtil::HasSharedBits(psm, t->m_sharedbits))
+			used ^= 1U << j;
+
+			u32 tpsm = k * 32 + j;
+
+			if(GSUtil::HasSharedBits(psm, GSUtil::HasSharedBitsPtr(tpsm)))
 			{
-				u32* RESTRICT valid = t->m_valid;
+				const u64* RESTRICT tex = &m_psm_tex[tpsm * m_words];
 
-				if(t->m_repeating)
-				{
-					for(const GSVector2i& j : t->m_p2t[page])
-					{
-						valid[j.x] &= j.y;
-					}
-				}
-				else
+				for(u32 i = 0; i < m_words; i++)
 				{
-					valid[page] = 0;
+					mask[i] |= tex[i];
+					any |= tex[i];
 				}
-
-				t->m_complete = false;
 			}
 		}
 	}
-}
 
-void GSTextureCacheSW::RemoveAll()
-{
-	for(auto i : m_textures) delete i;
+	if(any == 0)
+	{
+		return;
+	}
 
-	m_textures.clear();
+	u64* RESTRICT tex_dirty = m_tex_dirty.data();
 
-	for(auto& l : m_map)
+	for(const u32* p = pages; *p != GSOffset::EOP; p++)
 	{
-		l.clear();
+		const u64* RESTRICT tex = &m_page_tex[*p * m_words];
+		u64* RESTRICT dirty = &m_page_dirty[*p * m_words];
+
+		for(u32 i = 0; i < m_words; i++)
+		{
+			u64 bits = tex[i] & mask[i];
+
+			dirty[i] |= bits;
+			tex_dirty[i] |= bits;
+		}
 	}
 }
 
-void GSTextureCacheSW::IncAge()
+void GSTextureCacheSW::Validate(Texture* t)
 {
-	for(auto i = m_textures.begin(); i != m_textures.end(); )
+	// apply the invalidations since the last lookup
+
+	const u32 w = t->m_slot >> 6;
+	const u64 bit = 1ull << (t->m_slot & 63);
+
+	if((m_tex_dirty[w] & bit) == 0)
+	{
+		return;
+	}
+
+	m_tex_dirty[w] &= ~bit;
+
+	u32* RESTRICT valid = t->m_valid;
+
+	for(const u32* p = t->m_pages.n; *p != GSOffset::EOP; p++)
 	{
-		Texture* t = *i;
+		const u32 page = *p;
 
-		if(++t->m_age > 10)
+		u64& dirty = m_page_dirty[page * m_words + w];
+
+		if(dirty & bit)
 		{
-			i = m_textures.erase(i);
+			dirty &= ~bit;
 
-			for(const u32* p = t->m_pages.n; *p != GSOffset::EOP; p++)
+			if(t->m_repeating)
+			{
+				for(const GSVector2i& j : t->m_p2t[page])
+				{
+					valid[j.x] &= j.y;
+				}
+			}
+			else
 			{
-				const u32 page = *p;
-				m_map[page].EraseIndex(t->m_erase_it[page]);
+				valid[page] = 0;
 			}
+		}
+	}
+
+	t->m_complete = false;
+}
 
-			delete t;
+void GSTextureCacheSW::Grow()
+{
+	// double the bitsets, the new slots are handed out lowest first
+
+	u32 words = std::max<u32>(m_words * 2, 1);
+
+	auto resize = [this, words](std::vector<u64>& v, u32 rows)
+	{
+		std::vector<u64> tmp(rows * words, 0);
+
+		for(u32 i = 0; i < rows; i++)
+		{
+			for(u32 j = 0; j < m_words; j++)
+			{
+				tmp[i * words + j] = v[i * m_words + j];
+			}
 		}
-		else
+
+		v.swap(tmp);
+	};
+
+	resize(m_page_tex, MAX_PAGES);
+	resize(m_page_dirty, MAX_PAGES);
+	resize(m_tex_dirty, 1);
+	resize(m_psm_tex, 64);
+
+	m_mask.resize(words);
+
+	m_slots.resize(words * 64, NULL);
+
+	for(u32 i = words * 64; i > m_words * 64; i--)
+	{
+		m_free_slots.push_back(i - 1);
+	}
+
+	m_words = words;
+}
+
+void GSTextureCacheSW::Remove(Texture* t)
+{
+	const u32 w = t->m_slot >> 6;
+	const u64 bit = 1ull << (t->m_slot & 63);
+
+	for(const u32* p = t->m_pages.n; *p != GSOffset::EOP; p++)
+	{
+		m_page_tex[*p * m_words + w] &= ~bit;
+		m_page_dirty[*p * m_words + w] &= ~bit;
+	}
+
+	m_tex_dirty[w] &= ~bit;
+	m_psm_tex[t->m_TEX0.PSM * m_words + w] &= ~bit;
+
+	m_slots[t->m_slot] = NULL;
+	m_free_slots.push_back(t->m_slot);
+
+	auto i = m_index.find(t->m_key);
+
+	Texture** link = &i->second;
+
+	while(*link != t)
+	{
+		link = &(*link)->m_next;
+	}
+
+	*link = t->m_next;
+
+	if(i->second == NULL)
+	{
+		m_index.erase(i);
+	}
+
+	delete t;
+}
+
+void GSTextureCacheSW::RemoveAll()
+{
+	for(Texture* t : m_slots)
+	{
+		delete t;
+	}
+
+	m_index.clear();
+	m_slots.clear();
+	m_free_slots.clear();
+
+	m_words = 0;
+	m_page_tex.clear();
+	m_page_dirty.clear();
+	m_tex_dirty.clear();
+	m_psm_tex.clear();
+	m_mask.clear();
+	m_psm_used = 0;
+}
+
+void GSTextureCacheSW::IncAge()
+{
+	for(Texture* t : m_slots)
+	{
+		if(t != NULL && ++t->m_age > 10)
 		{
-			++i;
+			Remove(t);
 		}
 	}
 }
@@ -150,6 +324,9 @@ GSTextureCacheSW::Texture::Texture(GSState* state, u32 tw0, const GIFRegTEX0& TE
 	, m_buff(NULL)
 	, m_tw(tw0)
 	, m_age(0)
+	, m_key(0)
+	, m_next(NULL)
+	, m_slot(0)
 	, m_complete(false)
 	, m_p2t(NULL)
 {
@@ -263,7 +440,7 @@ bool GSTextureCacheSW::Texture::Update(const GSVector4i& rect)
 				{
 					m_valid[row] |= col;
 
-					(mem.*rtxbP)(block, &dst[x << shift], pitch, m_TEXA);
+					rtxbP(mem, block, &dst[x << shift], pitch, m_TEXA);
 
 					blocks++;
 				}
@@ -287,7 +464,7 @@ bool GSTextureCacheSW::Texture::Update(const GSVector4i& rect)
 				{
 					m_valid[row] |= col;
 
-					(mem.*rtxbP)(block, &dst[x << shift], pitch, m_TEXA);
+					rtxbP(mem, block, &dst[x << shift], pitch, m_TEXA);
 
 					blocks++;
 				}
@@ -295,6 +472,11 @@ bool GSTextureCacheSW::Texture::Update(const GSVector4i& rect)
 		}
 	}
 
+	if(blocks > 0)
+	{
+		m_state->m_perfmon.Put(GSPerfMon::TextureUpload);
+	}
+
 	return true;
 }
 
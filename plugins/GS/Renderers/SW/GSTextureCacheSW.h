@@ -21,12 +21,11 @@
 
 #pragma once
 
-#include <unordered_set>
+#include <unordered_map>
 
 #include "Pcsx2Types.h"
 
 #include "../Common/GSRenderer.h"
-#include "../Common/GSFastList.h"
 
 class GSTextureCacheSW
 {
@@ -41,11 +40,13 @@ public:
 		void* m_buff;
 		u32 m_tw;
 		u32 m_age;
+		u64 m_key;
+		Texture* m_next; // next with the same m_key
+		u32 m_slot;
 		bool m_complete;
 		bool m_repeating;
 		std::vector<GSVector2i>* m_p2t;
 		u32 m_valid[MAX_PAGES];
-		std::array<u16, MAX_PAGES> m_erase_it;
 		struct {u32 bm[16]; const u32* n;} m_pages;
 		const u32* RESTRICT m_sharedbits;
 
@@ -62,8 +63,25 @@ public:
 
 protected:
 	GSState* m_state;
-	std::unordered_set<Texture*> m_textures;
-	std::array<FastList<Texture*>, MAX_PAGES> m_map;
+	std::unordered_map<u64, Texture*> m_index; // Key() -> textures by m_next, most recently used first
+	std::vector<Texture*> m_slots; // NULL: free
+	std::vector<u32> m_free_slots;
+
+	// bitsets with one bit per slot, m_words u64 each
+
+	u32 m_words;
+	std::vector<u64> m_page_tex; // [page] textures covering the page
+	std::vector<u64> m_page_dirty; // [page] textures invalidated on the page, applied to m_valid by the next Lookup
+	std::vector<u64> m_tex_dirty; // textures with entries in m_page_dirty
+	std::vector<u64> m_psm_tex; // [psm] textures by TEX0.PSM
+	std::vector<u64> m_mask;
+	u64 m_psm_used;
+
+	static u64 Key(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA);
+
+	void Grow();
+	void Validate(Texture* t);
+	void Remove(Texture* t);
 
 public:
 	GSTextureCacheSW(GSState* state);
@@ -168,6 +168,15 @@
 
 #endif
 
+// GSVector8i and the block swizzling built on it only need the instruction set, the x64
+// AVX2 scanline JIT is what keeps _M_SSE at 0x500 there
+
+#if _M_SSE >= 0x501 || defined(__AVX2__)
+
+	#define _M_AVX2 1
+
+#endif
+
 #if _M_SSE >= 0x200
 
 	#include <xmmintrin.h>
@@ -0,0 +1,37 @@
+# Fails when an object of one ISA copy defines a global symbol outside NAMESPACE
+# usage: cmake -DNM=nm -DNAMESPACE=GSAVX2 -DOBJECTS=a.o;b.o -P check_isa_symbols.cmake
+
+set(failed 0)
+
+foreach(obj ${OBJECTS})
+	execute_process(COMMAND ${NM} -C --defined-only ${obj}
+		OUTPUT_VARIABLE symbols
+		RESULT_VARIABLE result)
+
+	if(NOT result EQUAL 0)
+		message(FATAL_ERROR "${NM} failed on ${obj}")
+	endif()
+
+	string(REPLACE "\n" ";" symbols "${symbols}")
+
+	foreach(line ${symbols})
+		# "address type name", lower case types are local
+		if(NOT line MATCHES "^[0-9a-fA-F]* [TWVuDBRi] (.*)$")
+			continue()
+		endif()
+
+		set(name "${CMAKE_MATCH_1}")
+
+		# anything that names an entity of the ISA namespace is unique to this copy
+		if(name MATCHES "${NAMESPACE}::" OR name STREQUAL "DW.ref.__gxx_personality_v0")
+			continue()
+		endif()
+
+		message(SEND_ERROR "${obj}: ${name} is shared with the other ISA copies")
+		math(EXPR failed "${failed} + 1")
+	endforeach()
+endforeach()
+
+if(failed GREATER 0)
+	message(FATAL_ERROR "${failed} symbols defined outside ${NAMESPACE}")
+endif()
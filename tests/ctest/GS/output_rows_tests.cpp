@@ -0,0 +1,192 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2020  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// GSOutputSW merges and deinterlaces software renderer frames on the CPU instead of the
+// merge and interlace shaders of GSDevice. Checks its row functions against the shader
+// formulas evaluated exactly and rounded to nearest (ties up) like the unorm8 target:
+//
+// - merge ps_main0/ps_main1 with the SRC_ALPHA, INV_SRC_ALPHA merge blend: the alpha is
+//   twice the pixel alpha clamped to 1 (MMOD = 0) or ALP / 255 (MMOD = 1), and it is written
+//   unless AMOD = 1 masks it
+// - interlace ps_main2: (c0 + c1 * 2 + c2) / 4
+// - the bilinear stretch of bob: a * (256 - f) / 256 + b * f / 256
+//
+// Rows of every length up to 40 cover the vector loop and the per pixel tail.
+
+#include "stdafx.h"
+#include "Renderers/SW/GSOutputSW.h"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+static u32 RoundDiv(u32 n, u32 d)
+{
+	return (2 * n + d) / (2 * d);
+}
+
+static u32 Channel(u32 c, int i)
+{
+	return (c >> (i * 8)) & 0xff;
+}
+
+static u32 RefBlend(u32 s, u32 d, bool mmod, bool amod, u32 alp)
+{
+	u32 a = mmod ? alp : std::min<u32>(Channel(s, 3) * 2, 255);
+
+	u32 c = 0;
+
+	for(int i = 0; i < 3; i++)
+	{
+		c |= RoundDiv(Channel(s, i) * a + Channel(d, i) * (255 - a), 255) << (i * 8);
+	}
+
+	return c | ((amod ? Channel(d, 3) : a) << 24);
+}
+
+static u32 RefBlendLines(u32 a, u32 b, u32 c)
+{
+	u32 p = 0;
+
+	for(int i = 0; i < 4; i++)
+	{
+		p |= RoundDiv(Channel(a, i) + Channel(b, i) * 2 + Channel(c, i), 4) << (i * 8);
+	}
+
+	return p;
+}
+
+static u32 RefLerpLines(u32 a, u32 b, int f)
+{
+	u32 p = 0;
+
+	for(int i = 0; i < 4; i++)
+	{
+		p |= RoundDiv(Channel(a, i) * (256 - f) + Channel(b, i) * f, 256) << (i * 8);
+	}
+
+	return p;
+}
+
+static long s_failed = 0;
+
+static void Check(const char* name, int n, int i, u32 got, u32 ref)
+{
+	if(got != ref && s_failed++ < 10)
+	{
+		fprintf(stderr, "%s: n=%d pixel %d is %08x, the shader formula gives %08x\n", name, n, i, got, ref);
+	}
+}
+
+int main()
+{
+	GSOutputSW::RowFunctions f;
+
+	MULTI_ISA_SELECT(GSOutputSWPopulateFunctions)(f);
+
+	std::mt19937 rng(1234);
+
+	std::vector<u32> a(256), b(256), c(256), dst(256);
+
+	// every source channel, destination channel and alpha, in rows of 256 destinations
+
+	for(int mmod = 0; mmod < 2; mmod++)
+	{
+		for(int amod = 0; amod < 2; amod++)
+		{
+			char name[32];
+
+			snprintf(name, sizeof(name), "blend_row[%d][%d]", mmod, amod);
+
+			for(u32 alpha = 0; alpha < 256; alpha++)
+			{
+				for(u32 sc = 0; sc < 256; sc++)
+				{
+					u32 alp = mmod ? alpha : rng() & 0xff;
+					u32 s = (mmod ? rng() & 0xff : alpha) << 24 | sc * 0x010101;
+
+					for(u32 i = 0; i < 256; i++)
+					{
+						a[i] = s;
+						b[i] = dst[i] = i * 0x010101 | (rng() & 0xff) << 24;
+					}
+
+					f.blend_row[mmod][amod](dst.data(), a.data(), 256, alp);
+
+					for(int i = 0; i < 256; i++)
+					{
+						Check(name, 256, i, dst[i], RefBlend(a[i], b[i], mmod != 0, amod != 0, alp));
+					}
+				}
+			}
+
+			for(int it = 0; it < 100000; it++)
+			{
+				int n = it % 41;
+				u32 alp = rng() & 0xff;
+
+				for(int i = 0; i < n; i++)
+				{
+					a[i] = rng();
+					b[i] = dst[i] = rng();
+				}
+
+				f.blend_row[mmod][amod](dst.data(), a.data(), n, alp);
+
+				for(int i = 0; i < n; i++)
+				{
+					Check(name, n, i, dst[i], RefBlend(a[i], b[i], mmod != 0, amod != 0, alp));
+				}
+			}
+		}
+	}
+
+	for(int it = 0; it < 200000; it++)
+	{
+		int n = it % 41;
+
+		for(int i = 0; i < n; i++)
+		{
+			// a quarter of the rows at the extremes, where the 16-bit sums are largest
+
+			u32 m = it % 4 == 0 ? 0xff00ff00 ^ (rng() & 0x00ff00ff) : 0;
+
+			a[i] = rng() | m;
+			b[i] = rng() | m;
+			c[i] = rng() | m;
+		}
+
+		f.blend_lines(dst.data(), a.data(), b.data(), c.data(), n);
+
+		for(int i = 0; i < n; i++)
+		{
+			Check("blend_lines", n, i, dst[i], RefBlendLines(a[i], b[i], c[i]));
+		}
+
+		int k = rng() & 0xff;
+
+		f.lerp_lines(dst.data(), a.data(), b.data(), n, k);
+
+		for(int i = 0; i < n; i++)
+		{
+			Check("lerp_lines", n, i, dst[i], RefLerpLines(a[i], b[i], k));
+		}
+	}
+
+	if(s_failed)
+		fprintf(stderr, "%ld pixels differ from the shader formulas\n", s_failed);
+
+	return s_failed ? 1 : 0;
+}
@@ -0,0 +1,107 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2020  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// GSTextureCache::InvalidateVideoMem only looks for the targets a transfer can touch in the
+// m_dst_map buckets on the rows GetTargetRows() returns. Checks, over random transfers and
+// target start addresses, that every target the checks in InvalidateVideoMem can act on
+// starts on one of those rows, so looking them up by page misses none of them.
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+
+#include "Renderers/HW/GSTextureCacheRows.h"
+
+typedef uint32_t u32;
+
+static const int MAX_PAGES = 512;
+
+// Whether InvalidateVideoMem(bp, bw, rect with this bottom) can dirty or remove a target at tbp0,
+// as the loop over all of m_dst decided it: tbp0 == bp, the "dirty after target" rows below bp,
+// or the rule of rose Inside() rows above it.
+static bool touches(u32 bp, u32 bw, int bottom, int pgs_y, u32 tbp0)
+{
+	if(tbp0 == bp) return true;
+
+	u32 rowsize = bw * 8192u;
+
+	if(bp < tbp0)
+	{
+		u32 offset = (tbp0 - bp) * 256;
+
+		if(rowsize > 0 && offset % rowsize == 0)
+		{
+			int y = pgs_y * offset / rowsize;
+
+			if(bottom > y) return true;
+		}
+	}
+	else if(bw > 2)
+	{
+		u32 offset = (bp - tbp0) * 256;
+
+		if(rowsize > 0 && offset % rowsize == 0) return true;
+	}
+
+	return false;
+}
+
+int main()
+{
+	static const u32 s_bw[] = {0, 1, 2, 3, 4, 5, 8, 10, 16, 20, 32, 63};
+	static const int s_pgs_y[] = {32, 64, 128};
+
+	std::mt19937 rng(1234);
+	long failed = 0, total = 0;
+
+	for(int it = 0; it < 2000000; it++)
+	{
+		u32 bw = rng() % 4 ? s_bw[rng() % (sizeof(s_bw) / sizeof(s_bw[0]))] : rng() % 64;
+		u32 bp = rng() % 0x4000;
+		int pgs_y = s_pgs_y[rng() % 3];
+		int bottom = (int)(rng() % 1030) - 5;
+
+		// Mostly targets a whole number of rows away from bp, where the checks can match
+		int tbp0 = bw > 0 && rng() % 10 < 7 ? (int)bp + ((int)(rng() % 81) - 40) * (int)bw * 32 + (rng() % 4 == 0) : (int)(rng() % 0x4000);
+
+		if(tbp0 < 0 || tbp0 >= 0x4000) continue;
+
+		total++;
+
+		if(!touches(bp, bw, bottom, pgs_y, (u32)tbp0)) continue;
+
+		int page = bp >> 5;
+		int first, last;
+
+		GetTargetRows(page, (int)bw, bottom, pgs_y, MAX_PAGES, first, last);
+
+		bool hit = false;
+
+		for(int row = first; row <= last && !hit; row++)
+		{
+			hit = page + row * (int)bw == (tbp0 >> 5);
+		}
+
+		if(!hit && failed++ < 10)
+		{
+			fprintf(stderr, "bp=%04x bw=%u bottom=%d pgs.y=%d tbp0=%04x: rows %d..%d miss the target\n", bp, bw, bottom, pgs_y, tbp0, first, last);
+		}
+	}
+
+	if(failed)
+		fprintf(stderr, "%ld of %ld targets are not on the rows InvalidateVideoMem looks up\n", failed, total);
+
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,312 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2020  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Checks the vector FMAC ops in pcsx2/VUfmac.inl against a per-field reference built the
+// way the scalar ops were: vuDouble() on each operand, then VU_MACx_UPDATE (or
+// VU_MACx_CLEAR for masked fields) and VU_STAT_UPDATE. Results, MAC and status flags must
+// match bit for bit, with and without DAZ/FTZ.
+
+#include <immintrin.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+typedef uint32_t u32;
+
+#if defined(_MSC_VER)
+#define __fi __forceinline
+#define __ri __declspec(noinline)
+#define __aligned16 __declspec(align(16))
+#else
+#define __fi inline __attribute__((always_inline))
+#define __ri __attribute__((noinline))
+#define __aligned16 __attribute__((aligned(16)))
+#endif
+
+// Just the parts of VURegs the FMAC ops touch
+union VECTOR
+{
+	struct { float x, y, z, w; } f;
+	struct { u32 x, y, z, w; } i;
+	u32 UL[4];
+};
+
+struct REG_VI
+{
+	u32 UL;
+	u32 pad[3];
+};
+
+enum { REG_I = 21, REG_Q = 22 };
+
+struct __aligned16 VURegs
+{
+	VECTOR VF[32];
+	REG_VI VI[32];
+	VECTOR ACC;
+	u32 code;
+	u32 macflag;
+	u32 statusflag;
+};
+
+#define _Ft_ ((VU->code >> 16) & 0x1F)
+#define _Fs_ ((VU->code >> 11) & 0x1F)
+#define _Fd_ ((VU->code >>  6) & 0x1F)
+#define _XYZW ((VU->code>>21) & 0xF)
+
+// Same as VUflags.cpp
+static void VU_STAT_UPDATE(VURegs * VU)
+{
+	int newflag = 0;
+	if (VU->macflag & 0x000F) newflag = 0x1;
+	if (VU->macflag & 0x00F0) newflag |= 0x2;
+	if (VU->macflag & 0x0F00) newflag |= 0x4;
+	if (VU->macflag & 0xF000) newflag |= 0x8;
+	VU->statusflag = (VU->statusflag&0xc30)|newflag|((VU->statusflag&0xf)<<6);
+}
+
+static __aligned16 VECTOR RDzero;
+
+#include "VUfmac.inl"
+
+_vuFMAC_OPS(ADD,  _vuFMAC_Fd, )
+_vuFMAC_OPS(ADD,  &VU->ACC,  A)
+_vuFMAC_OPS(SUB,  _vuFMAC_Fd, )
+_vuFMAC_OPS(SUB,  &VU->ACC,  A)
+_vuFMAC_OPS(MUL,  _vuFMAC_Fd, )
+_vuFMAC_OPS(MUL,  &VU->ACC,  A)
+_vuFMAC_OPS(MADD, _vuFMAC_Fd, )
+_vuFMAC_OPS(MADD, &VU->ACC,  A)
+_vuFMAC_OPS(MSUB, _vuFMAC_Fd, )
+_vuFMAC_OPS(MSUB, &VU->ACC,  A)
+
+_vuFMAC_OPS_I(ADD,  _vuFMAC_Fd, )
+_vuFMAC_OPS_I(ADD,  &VU->ACC,  A)
+_vuFMAC_OPS_I(SUB,  _vuFMAC_Fd, )
+_vuFMAC_OPS_I(SUB,  &VU->ACC,  A)
+_vuFMAC_OPS_I(MUL,  _vuFMAC_Fd, )
+_vuFMAC_OPS_I(MUL,  &VU->ACC,  A)
+_vuFMAC_OPS_I(MADD, _vuFMAC_Fd, )
+_vuFMAC_OPS_I(MADD, &VU->ACC,  A)
+_vuFMAC_OPS_I(MSUB, _vuFMAC_Fd, )
+_vuFMAC_OPS_I(MSUB, &VU->ACC,  A)
+
+// ---------------------------------------------------------------------------------------
+// Per-field reference, from VUops.cpp/VUflags.cpp before the vector rewrite
+// ---------------------------------------------------------------------------------------
+
+static float vuDouble(u32 f)
+{
+	switch (f & 0x7f800000)
+	{
+		case 0x0:
+			f &= 0x80000000;
+			break;
+		case 0x7f800000:
+			f = (f & 0x80000000) | 0x7f7fffff;
+			break;
+	}
+	float r;
+	memcpy(&r, &f, 4);
+	return r;
+}
+
+static u32 VU_MAC_UPDATE(int shift, VURegs * VU, float f)
+{
+	u32 v;
+	memcpy(&v, &f, 4);
+	int exp = (v >> 23) & 0xff;
+	u32 s = v & 0x80000000;
+
+	if (s)
+		VU->macflag |= 0x0010<<shift;
+	else
+		VU->macflag &= ~(0x0010<<shift);
+
+	if (f == 0)
+	{
+		VU->macflag = (VU->macflag & ~(0x1100<<shift)) | (0x0001<<shift);
+		return v;
+	}
+
+	switch (exp)
+	{
+		case 0:
+			VU->macflag = (VU->macflag&~(0x1000<<shift)) | (0x0101<<shift);
+			return s;
+		case 255:
+			VU->macflag = (VU->macflag&~(0x0100<<shift)) | (0x1000<<shift);
+			return s|0x7f7fffff;
+		default:
+			VU->macflag = (VU->macflag & ~(0x1101<<shift));
+			return v;
+	}
+}
+
+enum RefOp { OP_ADD, OP_SUB, OP_MUL, OP_MADD, OP_MSUB };
+enum RefFt { FT_VEC, FT_I, FT_Q, FT_X, FT_Y, FT_Z, FT_W };
+
+static void refFMAC(VURegs * VU, RefOp op, RefFt ftSel, bool toAcc)
+{
+	VECTOR * dst = toAcc ? &VU->ACC : (_Fd_ == 0) ? &RDzero : &VU->VF[_Fd_];
+	// All operands are read before any field is written, as on the VU. The old per-field
+	// code re-read VF[_Ft_] after storing to it on the broadcast forms when fd == ft.
+	const VECTOR fs  = VU->VF[_Fs_];
+	const VECTOR ft  = VU->VF[_Ft_];
+	const VECTOR acc = VU->ACC;
+	for (int n = 0; n < 4; n++)
+	{
+		const int shift = 3 - n;
+		if (!((VU->code >> (24 - n)) & 1))
+		{
+			VU->macflag &= ~(0x1111<<shift);
+			continue;
+		}
+
+		u32 t;
+		switch (ftSel)
+		{
+			case FT_VEC: t = ft.UL[n]; break;
+			case FT_I:   t = VU->VI[REG_I].UL; break;
+			case FT_Q:   t = VU->VI[REG_Q].UL; break;
+			default:     t = ft.UL[ftSel - FT_X]; break;
+		}
+
+		const float a = vuDouble(fs.UL[n]);
+		const float b = vuDouble(t);
+		// volatile keeps the compiler from contracting MADD/MSUB into an fma
+		volatile float prod = a * b;
+		float r;
+		switch (op)
+		{
+			case OP_ADD:  r = a + b; break;
+			case OP_SUB:  r = a - b; break;
+			case OP_MUL:  r = prod; break;
+			case OP_MADD: r = vuDouble(acc.UL[n]) + prod; break;
+			default:      r = vuDouble(acc.UL[n]) - prod; break;
+		}
+		dst->UL[n] = VU_MAC_UPDATE(shift, VU, r);
+	}
+	VU_STAT_UPDATE(VU);
+}
+
+// ---------------------------------------------------------------------------------------
+
+typedef void (*FmacFn)(VURegs*);
+
+struct FmacTest
+{
+	const char* name;
+	FmacFn fn;
+	RefOp op;
+	RefFt ft;
+	bool acc;
+};
+
+#define FMAC_TEST(OP, SUFFIX, FT, ACC) { #OP #SUFFIX, _vu##OP##SUFFIX, OP_##OP, FT, ACC }
+#define FMAC_TESTS(OP) \
+	FMAC_TEST(OP, ,   FT_VEC, false), FMAC_TEST(OP, i,  FT_I, false), FMAC_TEST(OP, q,  FT_Q, false), \
+	FMAC_TEST(OP, x,  FT_X, false),   FMAC_TEST(OP, y,  FT_Y, false), FMAC_TEST(OP, z,  FT_Z, false), \
+	FMAC_TEST(OP, w,  FT_W, false), \
+	FMAC_TEST(OP, A,  FT_VEC, true),  FMAC_TEST(OP, Ai, FT_I, true),  FMAC_TEST(OP, Aq, FT_Q, true), \
+	FMAC_TEST(OP, Ax, FT_X, true),    FMAC_TEST(OP, Ay, FT_Y, true),  FMAC_TEST(OP, Az, FT_Z, true), \
+	FMAC_TEST(OP, Aw, FT_W, true)
+
+static const FmacTest s_tests[] = {
+	FMAC_TESTS(ADD), FMAC_TESTS(SUB), FMAC_TESTS(MUL), FMAC_TESTS(MADD), FMAC_TESTS(MSUB)
+};
+
+static std::mt19937 s_rng(1234);
+
+// Mostly values around the denormal/overflow edges, where the flag logic matters
+static u32 randomValue()
+{
+	static const u32 special[] = {
+		0x00000000, 0x80000000, 0x00000001, 0x80000001, 0x007fffff, 0x00800000, 0x00800001,
+		0x7f800000, 0xff800000, 0x7fc00000, 0x7f7fffff, 0xff7fffff, 0x7f000000, 0x3f800000,
+		0xbf800000,
+	};
+
+	switch (s_rng() % 4)
+	{
+		case 0:
+			return special[s_rng() % (sizeof(special) / sizeof(special[0]))];
+		case 1:
+		{
+			// exponent near 0 or 255
+			u32 e = s_rng() % 2 ? 0xf0 + s_rng() % 16 : s_rng() % 16;
+			return (s_rng() & 0x807fffff) | (e << 23);
+		}
+		default:
+			return s_rng();
+	}
+}
+
+int main()
+{
+	static const u32 mxcsr[] = { 0x1f80, 0x1f80 | 0x8040 }; // default, DAZ|FTZ
+	static VURegs ref, vec;
+	const u32 oldCsr = _mm_getcsr();
+	long failed = 0, total = 0;
+
+	for (u32 csr : mxcsr)
+	{
+		_mm_setcsr(csr);
+		for (int it = 0; it < 20000; it++)
+		{
+			for (int r = 0; r < 32; r++)
+				for (int n = 0; n < 4; n++)
+					ref.VF[r].UL[n] = randomValue();
+			for (int n = 0; n < 4; n++)
+				ref.ACC.UL[n] = randomValue();
+			ref.VI[REG_I].UL = randomValue();
+			ref.VI[REG_Q].UL = randomValue();
+			ref.macflag    = s_rng();
+			ref.statusflag = s_rng() & 0xfff;
+			// dest mask, ft, fs, fd
+			ref.code       = s_rng() & 0x01ffffc0;
+
+			for (const FmacTest& t : s_tests)
+			{
+				memcpy(&vec, &ref, sizeof(ref));
+				const VECTOR zero = ref.VF[0];
+
+				RDzero = zero;
+				refFMAC(&ref, t.op, t.ft, t.acc);
+				const VECTOR refZero = RDzero;
+
+				RDzero = zero;
+				t.fn(&vec);
+				total++;
+
+				if (memcmp(&ref, &vec, sizeof(ref)) || memcmp(&refZero, &RDzero, sizeof(RDzero)))
+				{
+					if (failed++ < 10)
+						fprintf(stderr, "%s: mxcsr=%04x code=%08x mac %08x/%08x status %03x/%03x\n",
+							t.name, csr, ref.code, ref.macflag, vec.macflag, ref.statusflag, vec.statusflag);
+					memcpy(&ref, &vec, sizeof(ref));
+				}
+			}
+		}
+	}
+	_mm_setcsr(oldCsr);
+
+	if (failed)
+		fprintf(stderr, "%ld of %ld FMAC results differ from the per-field reference\n", failed, total);
+
+	return failed ? 1 : 0;
+}
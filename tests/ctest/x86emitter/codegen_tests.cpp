@@ -0,0 +1,91 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2020  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Byte exact encoding checks, the expected bytes come from GNU as.
+
+#include <wx/string.h>
+
+#include "Pcsx2Defs.h"
+#include "Utilities/Exceptions.h"
+#include "Utilities/General.h"
+#include "x86emitter/x86emitter.h"
+
+#include <cstdio>
+#include <cstring>
+#include <functional>
+
+using namespace x86Emitter;
+
+static int s_failed = 0;
+
+static void check(const char* name, const std::function<void()>& emit, const char* expected)
+{
+	u8 code[64];
+	char str[sizeof(code) * 3 + 1] = {};
+
+	xSetPtr(code);
+	emit();
+
+	for (u8* p = code; p < xGetPtr(); p++)
+		sprintf(&str[(p - code) * 3], p + 1 < xGetPtr() ? "%02x " : "%02x", *p);
+
+	if (strcmp(str, expected) != 0)
+	{
+		fprintf(stderr, "%s: got %s, expected %s\n", name, str, expected);
+		s_failed++;
+	}
+}
+
+#define CODEGEN_TEST(code, expected) check(#code, [] { code; }, expected)
+
+int main()
+{
+#ifdef __M_X86_64
+	// 2 bytes prefix, high register in ModRM.reg and in VEX.vvvv
+	CODEGEN_TEST(xVADD.PS(xmm1, xmm2, xmm3), "c5 e8 58 cb");
+	CODEGEN_TEST(xVADD.PS(xmm8, xmm2, xmm3), "c5 68 58 c3");
+	CODEGEN_TEST(xVADD.PS(xmm1, xmm10, xmm3), "c5 a8 58 cb");
+	CODEGEN_TEST(xVANDN.PS(xmm3, xmm4, xmm5), "c5 d8 55 dd");
+	CODEGEN_TEST(xVXOR.PD(xmm0, xmm0, xmm0), "c5 f9 57 c0");
+
+	// high register in ModRM.rm needs VEX.B, so the 3 bytes prefix
+	CODEGEN_TEST(xVADD.PS(xmm1, xmm2, xmm9), "c4 c1 68 58 c9");
+	CODEGEN_TEST(xVADD.SD(xmm15, xmm14, xmm13), "c4 41 0b 58 fd");
+
+	// memory operands
+	CODEGEN_TEST(xVMUL.SS(xmm1, xmm2, ptr[rax]), "c5 ea 59 08");
+	CODEGEN_TEST(xVMUL.SS(xmm1, xmm2, ptr[r8]), "c4 c1 6a 59 08");
+	CODEGEN_TEST(xVSUB.PS(xmm1, xmm2, ptr[r9 * 4 + rax + 0x10]), "c4 a1 68 5c 4c 88 10");
+	CODEGEN_TEST(xVSUB.PS(xmm1, xmm2, ptr[rax * 2 + r12]), "c4 c1 68 5c 0c 44");
+	CODEGEN_TEST(xVDIV.PD(xmm1, xmm2, ptr[rbp]), "c5 e9 5e 4d 00");
+
+	// immediates, 0F3A map
+	CODEGEN_TEST(xVBLEND.PS(xmm1, xmm2, xmm3, 5), "c4 e3 69 0c cb 05");
+	CODEGEN_TEST(xVBLEND.PD(xmm9, xmm2, ptr[rcx + 0x100], 2), "c4 63 69 0d 89 00 01 00 00 02");
+	CODEGEN_TEST(xVSHUF.PS(xmm1, xmm2, xmm3, 0x1b), "c5 e8 c6 cb 1b");
+	CODEGEN_TEST(xVSHUF.PS(xmm1, xmm2, xmm11, 0x1b), "c4 c1 68 c6 cb 1b");
+	CODEGEN_TEST(xVPSHUF.D(xmm1, xmm12, 0x39), "c4 c1 79 70 cc 39");
+	CODEGEN_TEST(xVPSHUF.D(xmm1, ptr[rdx], 0x39), "c5 f9 70 0a 39");
+
+	// BMI shares xOpWriteC4
+	CODEGEN_TEST(xPDEP(rax, rbx, rcx), "c4 e2 e3 f5 c1");
+	CODEGEN_TEST(xANDN_S(eax, ebx, ptr[r8]), "c4 c2 60 f2 00");
+#endif
+
+	if (s_failed)
+		fprintf(stderr, "%d x86emitter encoding tests failed\n", s_failed);
+
+	return s_failed ? 1 : 0;
+}